@@ -0,0 +1,263 @@
+/**
+ * @file aig.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "aig.h"
+#include "compiler.h"
+#include "operations.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace jazz {
+
+    Aig::Aig() : fanins0{0}, fanins1{0}, strash(64, 0) {}
+
+    Aig::Lit Aig::addInput(Expr symbol) {
+        if (symbol.isTrivial())
+            symbol = Expr(("i" + std::to_string(input_nodes.size())).c_str());
+        auto node = static_cast<unsigned>(fanins0.size());
+        fanins0.push_back(NO_FANIN);
+        fanins1.push_back(static_cast<Lit>(input_nodes.size()));
+        input_nodes.push_back(node);
+        input_symbols.push_back(std::move(symbol));
+        return makeLit(node);
+    }
+
+    Aig::Lit Aig::findAnd(Lit a, Lit b) const {
+        if (a > b)
+            std::swap(a, b);
+        if (a == FALSE_LIT || a == negate(b))
+            return FALSE_LIT;
+        if (a == TRUE_LIT || a == b)
+            return b;
+
+        for (auto i = hashOf(a, b);; i = (i + 1) & (strash.size() - 1)) {
+            auto node = strash[i];
+            if (node == 0)
+                return ~0u;
+            if (fanins0[node] == a && fanins1[node] == b)
+                return makeLit(node);
+        }
+    }
+
+    Aig::Lit Aig::andOf(Lit a, Lit b) {
+        if (nodeOf(a) >= numNodes() || nodeOf(b) >= numNodes())
+            throw std::out_of_range("Aig::andOf(): literal out of range");
+        auto found = findAnd(a, b);
+        if (found != ~0u)
+            return found;
+
+        if (a > b)
+            std::swap(a, b);
+        auto node = static_cast<unsigned>(fanins0.size());
+        fanins0.push_back(a);
+        fanins1.push_back(b);
+        if (2 * numAnds() > strash.size())
+            rehash();
+        else {
+            auto i = hashOf(a, b);
+            while (strash[i] != 0)
+                i = (i + 1) & (strash.size() - 1);
+            strash[i] = node;
+        }
+        return makeLit(node);
+    }
+
+    Aig::Lit Aig::xorOf(Lit a, Lit b) {
+        return orOf(andOf(a, negate(b)), andOf(negate(a), b));
+    }
+
+    Aig::Lit Aig::muxOf(Lit sel, Lit a, Lit b) {
+        return orOf(andOf(sel, a), andOf(negate(sel), b));
+    }
+
+    std::size_t Aig::addOutput(Lit lit) {
+        if (nodeOf(lit) >= numNodes())
+            throw std::out_of_range("Aig::addOutput(): literal out of range");
+        outputs.push_back(lit);
+        return outputs.size() - 1;
+    }
+
+    void Aig::rehash() {
+        strash.assign(strash.size() * 2, 0);
+        for (unsigned node = 1; node < numNodes(); ++node) {
+            if (!isAnd(node))
+                continue;
+            auto i = hashOf(fanins0[node], fanins1[node]);
+            while (strash[i] != 0)
+                i = (i + 1) & (strash.size() - 1);
+            strash[i] = node;
+        }
+    }
+
+    unsigned Aig::depth() const {
+        std::vector<unsigned> levels(numNodes(), 0);
+        for (unsigned node = 1; node < numNodes(); ++node) {
+            if (isAnd(node))
+                levels[node] = 1 + std::max(levels[nodeOf(fanins0[node])], levels[nodeOf(fanins1[node])]);
+        }
+        unsigned res = 0;
+        for (auto lit: outputs)
+            res = std::max(res, levels[nodeOf(lit)]);
+        return res;
+    }
+
+    std::vector<bool> Aig::evaluate(const std::vector<bool> &input_values) const {
+        if (input_values.size() != numInputs())
+            throw std::invalid_argument("Aig::evaluate(): wrong number of input values");
+        std::vector<char> values(numNodes(), 0);
+        for (unsigned node = 1; node < numNodes(); ++node) {
+            if (isInput(node))
+                values[node] = input_values[fanins1[node]];
+            else
+                values[node] = (values[nodeOf(fanins0[node])] ^ isComplemented(fanins0[node])) &&
+                               (values[nodeOf(fanins1[node])] ^ isComplemented(fanins1[node]));
+        }
+        std::vector<bool> res;
+        res.reserve(outputs.size());
+        for (auto lit: outputs)
+            res.push_back(values[nodeOf(lit)] ^ isComplemented(lit));
+        return res;
+    }
+
+    std::vector<std::uint64_t> Aig::simulate(const std::vector<std::uint64_t> &input_words) const {
+        if (input_words.size() != numInputs())
+            throw std::invalid_argument("Aig::simulate(): wrong number of input words");
+        std::vector<std::uint64_t> words(numNodes(), 0);
+        for (unsigned node = 1; node < numNodes(); ++node) {
+            if (isInput(node))
+                words[node] = input_words[fanins1[node]];
+            else
+                words[node] = valueOf(words, fanins0[node]) & valueOf(words, fanins1[node]);
+        }
+        return words;
+    }
+
+    Aig Aig::cleanup() const {
+        std::vector<char> reachable(numNodes(), 0);
+        for (auto lit: outputs)
+            reachable[nodeOf(lit)] = 1;
+        for (auto node = static_cast<unsigned>(numNodes()); node-- > 1;) {
+            if (reachable[node] && isAnd(node)) {
+                reachable[nodeOf(fanins0[node])] = 1;
+                reachable[nodeOf(fanins1[node])] = 1;
+            }
+        }
+
+        Aig res;
+        std::vector<Lit> map(numNodes(), FALSE_LIT);
+        for (std::size_t i = 0; i < numInputs(); ++i)
+            map[input_nodes[i]] = res.addInput(input_symbols[i]);
+        auto mapped = [&map](Lit lit) { return map[nodeOf(lit)] ^ (lit & 1u); };
+        for (unsigned node = 1; node < numNodes(); ++node) {
+            if (reachable[node] && isAnd(node))
+                map[node] = res.andOf(mapped(fanins0[node]), mapped(fanins1[node]));
+        }
+        for (auto lit: outputs)
+            res.addOutput(mapped(lit));
+        return res;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // conversions
+    //////////////////////////////////////////////////////////////////////////
+
+    Aig toAIG(const Expr &root) {
+        return toAIG(std::vector<Expr>{root});
+    }
+
+    Aig toAIG(const std::vector<Expr> &roots) {
+        auto program = compile(roots);
+        Aig aig;
+        std::vector<Aig::Lit> slots(program.size(), Aig::FALSE_LIT);
+        auto literal = [&slots](unsigned lit) {
+            return slots[Program::slotOf(lit)] ^ (Program::isComplemented(lit) ? 1u : 0u);
+        };
+
+        std::vector<Aig::Lit> level;
+        for (std::size_t slot = 0; slot < program.size(); ++slot) {
+            const auto &inst = program.instruction(slot);
+            switch (inst.op) {
+                case Program::OP_CONST:
+                    slots[slot] = Aig::FALSE_LIT;
+                    break;
+                case Program::OP_INPUT:
+                    slots[slot] = aig.addInput(program.input(inst.first));
+                    break;
+                case Program::OP_AND: {
+                    // a balanced tree keeps the depth logarithmic in the fanin count
+                    const unsigned *lits = program.fanins(slot);
+                    level.clear();
+                    for (unsigned i = 0; i < inst.count; ++i)
+                        level.push_back(literal(lits[i]));
+                    while (level.size() > 1) {
+                        std::size_t j = 0;
+                        for (std::size_t i = 0; i + 1 < level.size(); i += 2)
+                            level[j++] = aig.andOf(level[i], level[i + 1]);
+                        if (level.size() % 2)
+                            level[j++] = level.back();
+                        level.resize(j);
+                    }
+                    slots[slot] = level.empty() ? Aig::TRUE_LIT : level[0];
+                    break;
+                }
+            }
+        }
+        for (std::size_t k = 0; k < program.numOutputs(); ++k)
+            aig.addOutput(literal(program.output(k)));
+        return aig;
+    }
+
+    Expr toExpr(const Aig &aig, Aig::Lit lit) {
+        if (Aig::nodeOf(lit) >= aig.numNodes())
+            throw std::out_of_range("toExpr(): literal out of range");
+
+        // the cone of the literal, gates have smaller fanins so one backward sweep is enough
+        auto root = Aig::nodeOf(lit);
+        std::vector<char> in_cone(root + 1, 0);
+        in_cone[root] = 1;
+        for (auto node = root + 1; node-- > 1;) {
+            if (in_cone[node] && aig.isAnd(node)) {
+                in_cone[Aig::nodeOf(aig.fanin0(node))] = 1;
+                in_cone[Aig::nodeOf(aig.fanin1(node))] = 1;
+            }
+        }
+
+        std::unordered_map<unsigned, Expr> exprs{{0u, Expr(false)}};
+        auto literal = [&exprs](Aig::Lit l) {
+            const auto &e = exprs.at(Aig::nodeOf(l));
+            return Aig::isComplemented(l) ? !e : e;
+        };
+        for (unsigned node = 1; node <= root; ++node) {
+            if (!in_cone[node])
+                continue;
+            if (aig.isInput(node))
+                exprs.emplace(node, aig.inputSymbol(static_cast<std::size_t>(aig.inputIndex(node))));
+            else
+                exprs.emplace(node, literal(aig.fanin0(node)) & literal(aig.fanin1(node)));
+        }
+        return literal(lit);
+    }
+
+}// namespace jazz
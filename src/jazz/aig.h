@@ -0,0 +1,175 @@
+/**
+ * @file aig.h
+ *
+ * And-inverter graphs with structural hashing.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_AIG_H
+#define BOOLEAN_ALGEBRA_AIG_H
+
+#include "expr.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace jazz {
+
+    /**
+     * A compact circuit of two-input AND gates and inverters.
+     *
+     * Nodes are numbered in topological order: node 0 is the constant false, then come the
+     * inputs and gates in creation order, a gate always has smaller fanins. Edges are 32-bit
+     * literals, the node index shifted left by one with the complement in the lowest bit.
+     *
+     * Fanins are kept in two parallel arrays and gates are hashed by their fanins, so that
+     * creating a gate that already exists returns the existing one. A gate costs 8 bytes of
+     * fanins plus its share of the hash table, whose 4-byte slots are kept at most half full,
+     * so 8 to 16 bytes more: 16 to 24 bytes in total.
+     */
+    class Aig {
+    public:
+        using Lit = unsigned;
+
+        static constexpr Lit FALSE_LIT = 0;
+        static constexpr Lit TRUE_LIT = 1;
+
+        static Lit makeLit(unsigned node, bool complemented = false) {
+            return (node << 1) | (complemented ? 1u : 0u);
+        }
+
+        static unsigned nodeOf(Lit lit) { return lit >> 1; }
+        static bool isComplemented(Lit lit) { return lit & 1u; }
+        static Lit negate(Lit lit) { return lit ^ 1u; }
+        static Lit regular(Lit lit) { return lit & ~1u; }
+
+    public:
+        Aig();
+
+        /**
+         * Add an input.
+         * @param symbol  The symbol it stands for, a fresh one named i<index> by default.
+         * @return The positive literal of the input.
+         */
+        Lit addInput(Expr symbol = Expr());
+
+        /**
+         * The literal of a.b. Constants, a.a and a.!a are folded and existing gates reused.
+         */
+        Lit andOf(Lit a, Lit b);
+
+        Lit orOf(Lit a, Lit b) { return negate(andOf(negate(a), negate(b))); }
+        Lit xorOf(Lit a, Lit b);
+        Lit muxOf(Lit sel, Lit a, Lit b);
+
+        /**
+         * Find an existing gate without creating it.
+         * @return The literal, or ~0u if a.b is neither trivial nor an existing gate.
+         */
+        Lit findAnd(Lit a, Lit b) const;
+
+        std::size_t addOutput(Lit lit);
+        std::size_t numOutputs() const { return outputs.size(); }
+        Lit output(std::size_t k) const { return outputs[k]; }
+        void setOutput(std::size_t k, Lit lit) { outputs[k] = lit; }
+
+        /**
+         * Number of nodes, the constant and the inputs included.
+         */
+        std::size_t numNodes() const { return fanins0.size(); }
+        std::size_t numInputs() const { return input_nodes.size(); }
+        std::size_t numAnds() const { return fanins0.size() - 1 - input_nodes.size(); }
+
+        bool isConstant(unsigned node) const { return node == 0; }
+        bool isInput(unsigned node) const { return node != 0 && fanins0[node] == NO_FANIN; }
+        bool isAnd(unsigned node) const { return node != 0 && fanins0[node] != NO_FANIN; }
+
+        Lit fanin0(unsigned node) const { return fanins0[node]; }
+        Lit fanin1(unsigned node) const { return fanins1[node]; }
+
+        unsigned inputNode(std::size_t i) const { return input_nodes[i]; }
+        const Expr &inputSymbol(std::size_t i) const { return input_symbols[i]; }
+
+        /**
+         * The input index of a node, or -1 if it is not an input.
+         */
+        int inputIndex(unsigned node) const { return isInput(node) ? static_cast<int>(fanins1[node]) : -1; }
+
+        /**
+         * Number of gates on the longest path from an input to an output.
+         */
+        unsigned depth() const;
+
+        /**
+         * Evaluate all outputs for one assignment of the inputs.
+         */
+        std::vector<bool> evaluate(const std::vector<bool> &input_values) const;
+
+        /**
+         * Evaluate 64 assignments at once.
+         * @param input_words  One word per input, bit i belongs to the i-th assignment.
+         * @return One word per node.
+         */
+        std::vector<std::uint64_t> simulate(const std::vector<std::uint64_t> &input_words) const;
+
+        static std::uint64_t valueOf(const std::vector<std::uint64_t> &words, Lit lit) {
+            return words[lit >> 1] ^ (std::uint64_t(0) - (lit & 1u));
+        }
+
+        /**
+         * A copy keeping only the nodes reachable from the outputs, all inputs are kept.
+         */
+        Aig cleanup() const;
+
+    private:
+        static constexpr Lit NO_FANIN = ~0u;
+
+        std::size_t hashOf(Lit a, Lit b) const {
+            auto h = std::uint64_t(a) * 0x9e3779b97f4a7c15ull ^ std::uint64_t(b) * 0xc2b2ae3d27d4eb4full;
+            return static_cast<std::size_t>(h ^ (h >> 29)) & (strash.size() - 1);
+        }
+
+        void rehash();
+
+    private:
+        std::vector<Lit> fanins0;
+        std::vector<Lit> fanins1;///< the input index for inputs
+        std::vector<unsigned> input_nodes;
+        std::vector<Expr> input_symbols;
+        std::vector<Lit> outputs;
+        std::vector<unsigned> strash;///< open addressing over gate nodes, 0 for empty
+    };
+
+    /**
+     * Build the AIG of one or more expressions, one output per root.
+     *
+     * The expressions are compiled first, n-ary gates are split into balanced trees.
+     */
+    Aig toAIG(const Expr &root);
+    Aig toAIG(const std::vector<Expr> &roots);
+
+    /**
+     * Convert the cone of a literal back to an expression over the input symbols, shared
+     * gates become shared sub-expressions.
+     */
+    Expr toExpr(const Aig &aig, Aig::Lit lit);
+
+}// namespace jazz
+
+#endif//BOOLEAN_ALGEBRA_AIG_H
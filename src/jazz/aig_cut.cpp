@@ -0,0 +1,145 @@
+/**
+ * @file aig_cut.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "aig_cut.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace jazz {
+
+    Cut Cut::trivial(unsigned node) {
+        Cut cut;
+        cut.size = 1;
+        cut.leaves[0] = node;
+        cut.truth = tt::var(0);
+        cut.signature = std::uint64_t(1) << (node % 64);
+        return cut;
+    }
+
+    bool Cut::dominates(const Cut &other) const {
+        if (size > other.size || (signature & ~other.signature) != 0)
+            return false;
+        unsigned j = 0;
+        for (unsigned i = 0; i < size; ++i) {
+            while (j < other.size && other.leaves[j] < leaves[i])
+                ++j;
+            if (j == other.size || other.leaves[j] != leaves[i])
+                return false;
+        }
+        return true;
+    }
+
+    static bool mergeLeaves(const Cut &a, const Cut &b, unsigned k, Cut &res) {
+        unsigned i = 0, j = 0, n = 0;
+        while (i < a.size || j < b.size) {
+            unsigned leaf;
+            if (j == b.size || (i < a.size && a.leaves[i] < b.leaves[j]))
+                leaf = a.leaves[i++];
+            else if (i == a.size || b.leaves[j] < a.leaves[i])
+                leaf = b.leaves[j++];
+            else {
+                leaf = a.leaves[i++];
+                ++j;
+            }
+            if (n == k)
+                return false;
+            res.leaves[n++] = leaf;
+        }
+        res.size = n;
+        res.signature = a.signature | b.signature;
+        return true;
+    }
+
+    /**
+     * Express the function of a cut over the leaves of a larger cut.
+     */
+    static tt::Table stretch(const Cut &from, const Cut &to) {
+        if (from.size == to.size)
+            return from.truth;
+
+        unsigned pos[tt::MAX_VARS];
+        for (unsigned i = 0, j = 0; i < from.size; ++i) {
+            while (to.leaves[j] != from.leaves[i])
+                ++j;
+            pos[i] = j;
+        }
+        tt::Table res = 0;
+        for (unsigned m = 0; m < (1u << to.size); ++m) {
+            unsigned src = 0;
+            for (unsigned i = 0; i < from.size; ++i)
+                src |= ((m >> pos[i]) & 1u) << i;
+            res |= ((from.truth >> src) & 1u) << m;
+        }
+        return tt::replicate(res, to.size);
+    }
+
+    bool mergeCuts(const Cut &cut0, bool complemented0, const Cut &cut1, bool complemented1, unsigned k,
+                   Cut &result) {
+        if (!mergeLeaves(cut0, cut1, k, result))
+            return false;
+        auto t0 = stretch(cut0, result) ^ (complemented0 ? ~tt::Table(0) : 0);
+        auto t1 = stretch(cut1, result) ^ (complemented1 ? ~tt::Table(0) : 0);
+        result.truth = t0 & t1;
+        return true;
+    }
+
+    std::vector<std::vector<Cut>> enumerateCuts(const Aig &aig, unsigned k, unsigned max_cuts) {
+        if (k < 2 || k > tt::MAX_VARS)
+            throw std::invalid_argument("enumerateCuts(): the cut size must be between 2 and 6");
+        if (max_cuts < 2)
+            throw std::invalid_argument("enumerateCuts(): at least two cuts per node are needed");
+
+        std::vector<std::vector<Cut>> cuts(aig.numNodes());
+        std::vector<Cut> candidates;
+        for (unsigned node = 1; node < aig.numNodes(); ++node) {
+            if (aig.isAnd(node)) {
+                auto lit0 = aig.fanin0(node), lit1 = aig.fanin1(node);
+                const auto &cuts0 = cuts[Aig::nodeOf(lit0)];
+                const auto &cuts1 = cuts[Aig::nodeOf(lit1)];
+                candidates.clear();
+                for (const auto &c0: cuts0) {
+                    for (const auto &c1: cuts1) {
+                        Cut cut;
+                        if (!mergeCuts(c0, Aig::isComplemented(lit0), c1, Aig::isComplemented(lit1), k, cut))
+                            continue;
+                        bool dominated = std::any_of(candidates.begin(), candidates.end(),
+                                                     [&cut](const Cut &other) { return other.dominates(cut); });
+                        if (dominated)
+                            continue;
+                        candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                                        [&cut](const Cut &other) { return cut.dominates(other); }),
+                                         candidates.end());
+                        candidates.push_back(cut);
+                    }
+                }
+                std::stable_sort(candidates.begin(), candidates.end(),
+                                 [](const Cut &a, const Cut &b) { return a.size < b.size; });
+                if (candidates.size() > max_cuts - 1)
+                    candidates.resize(max_cuts - 1);
+                cuts[node] = candidates;
+            }
+            cuts[node].push_back(Cut::trivial(node));
+        }
+        return cuts;
+    }
+
+}// namespace jazz
@@ -0,0 +1,77 @@
+/**
+ * @file aig_cut.h
+ *
+ * Enumeration of the k-feasible cuts of an AIG.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_AIG_CUT_H
+#define BOOLEAN_ALGEBRA_AIG_CUT_H
+
+#include "aig.h"
+#include "truth_table.h"
+
+#include <vector>
+
+namespace jazz {
+
+    /**
+     * A set of nodes separating a root from the inputs, with the function of the root over
+     * them: leaf i is variable i of the truth table.
+     */
+    struct Cut {
+        unsigned size = 0;
+        unsigned leaves[tt::MAX_VARS] = {};///< ascending node indices
+        tt::Table truth = 0;
+        std::uint64_t signature = 0;///< one bit per leaf modulo 64, for quick subset tests
+
+        /**
+         * The cut of a node made of the node alone.
+         */
+        static Cut trivial(unsigned node);
+
+        bool isTrivial(unsigned root) const { return size == 1 && leaves[0] == root; }
+
+        /**
+         * Whether every leaf of this cut is a leaf of the other one.
+         */
+        bool dominates(const Cut &other) const;
+    };
+
+    /**
+     * The cut of an AND node from cuts of its two fanins: the union of their leaves, and the
+     * conjunction of their functions, complemented as the fanin edges are.
+     * @return false when the union has more than k leaves.
+     */
+    bool mergeCuts(const Cut &cut0, bool complemented0, const Cut &cut1, bool complemented1, unsigned k,
+                   Cut &result);
+
+    /**
+     * Enumerate the cuts of every node by merging the cuts of the fanins, keeping the
+     * smallest ones.
+     * @param k         The maximal number of leaves, at most 6.
+     * @param max_cuts  The maximal number of cuts kept per node, the trivial cut included.
+     * @return The cuts of every node, indexed by node. The constant has no cut, an input has
+     *         only its trivial cut.
+     */
+    std::vector<std::vector<Cut>> enumerateCuts(const Aig &aig, unsigned k = 4, unsigned max_cuts = 8);
+
+}// namespace jazz
+
+#endif//BOOLEAN_ALGEBRA_AIG_CUT_H
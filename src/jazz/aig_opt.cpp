@@ -0,0 +1,667 @@
+/**
+ * @file aig_opt.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "aig_opt.h"
+#include "aig_cut.h"
+#include "npn.h"
+#include "truth_table.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
+namespace jazz {
+
+    using Lit = Aig::Lit;
+
+    /*
+     * Shared machinery
+     */
+
+    static std::vector<unsigned> fanoutCounts(const Aig &aig) {
+        std::vector<unsigned> refs(aig.numNodes(), 0);
+        for (unsigned node = 1; node < aig.numNodes(); ++node) {
+            if (aig.isAnd(node)) {
+                ++refs[Aig::nodeOf(aig.fanin0(node))];
+                ++refs[Aig::nodeOf(aig.fanin1(node))];
+            }
+        }
+        for (std::size_t k = 0; k < aig.numOutputs(); ++k)
+            ++refs[Aig::nodeOf(aig.output(k))];
+        return refs;
+    }
+
+    /**
+     * The number of ANDs which would disappear with the root, i.e. its maximum fanout-free cone
+     * above the leaves. refs is restored on return.
+     */
+    static unsigned mffcSize(const Aig &aig, unsigned root, const unsigned *leaves, unsigned num_leaves,
+                             std::vector<unsigned> &refs, std::vector<unsigned> &stack, std::vector<unsigned> &touched) {
+        auto isLeaf = [&](unsigned node) {
+            return std::find(leaves, leaves + num_leaves, node) != leaves + num_leaves;
+        };
+        unsigned count = 0;
+        stack.assign(1, root);
+        touched.clear();
+        while (!stack.empty()) {
+            auto node = stack.back();
+            stack.pop_back();
+            ++count;
+            for (auto lit: {aig.fanin0(node), aig.fanin1(node)}) {
+                auto fanin = Aig::nodeOf(lit);
+                if (!aig.isAnd(fanin) || isLeaf(fanin))
+                    continue;
+                touched.push_back(fanin);
+                if (--refs[fanin] == 0)
+                    stack.push_back(fanin);
+            }
+        }
+        for (auto node: touched)
+            ++refs[node];
+        return count;
+    }
+
+    /**
+     * A node to be rebuilt from its leaves instead of being copied.
+     */
+    struct Replacement {
+        unsigned size = 0;
+        unsigned leaves[tt::MAX_VARS] = {};
+        tt::Table truth = 0;
+    };
+
+    using Builder = std::function<Lit(Aig &, const Replacement &, const Lit *)>;
+
+    /**
+     * Copy the part of the graph the outputs need, rebuilding the replaced nodes from their
+     * leaves. The other nodes of the replaced cones are not copied unless something else
+     * still needs them.
+     */
+    static Aig rebuild(const Aig &aig, const std::vector<int> &chosen, const std::vector<Replacement> &replacements,
+                       const Builder &builder) {
+        auto n = static_cast<unsigned>(aig.numNodes());
+        std::vector<char> needed(n, 0);
+        for (std::size_t k = 0; k < aig.numOutputs(); ++k)
+            needed[Aig::nodeOf(aig.output(k))] = 1;
+        for (unsigned node = n; node-- > 1;) {
+            if (!needed[node] || !aig.isAnd(node))
+                continue;
+            if (chosen[node] >= 0) {
+                const auto &r = replacements[chosen[node]];
+                for (unsigned i = 0; i < r.size; ++i)
+                    needed[r.leaves[i]] = 1;
+            } else {
+                needed[Aig::nodeOf(aig.fanin0(node))] = 1;
+                needed[Aig::nodeOf(aig.fanin1(node))] = 1;
+            }
+        }
+
+        Aig res;
+        std::vector<Lit> map(n, Aig::FALSE_LIT);
+        for (std::size_t i = 0; i < aig.numInputs(); ++i)
+            map[aig.inputNode(i)] = res.addInput(aig.inputSymbol(i));
+        auto mapLit = [&map](Lit lit) { return map[Aig::nodeOf(lit)] ^ (lit & 1u); };
+        Lit leaf_lits[tt::MAX_VARS];
+        for (unsigned node = 1; node < n; ++node) {
+            if (!needed[node] || !aig.isAnd(node))
+                continue;
+            if (chosen[node] >= 0) {
+                const auto &r = replacements[chosen[node]];
+                for (unsigned i = 0; i < tt::MAX_VARS; ++i)
+                    leaf_lits[i] = i < r.size ? map[r.leaves[i]] : Aig::FALSE_LIT;
+                map[node] = builder(res, r, leaf_lits);
+            } else {
+                map[node] = res.andOf(mapLit(aig.fanin0(node)), mapLit(aig.fanin1(node)));
+            }
+        }
+        for (std::size_t k = 0; k < aig.numOutputs(); ++k)
+            res.addOutput(mapLit(aig.output(k)));
+        return res.cleanup();
+    }
+
+    /*
+     * Balancing
+     */
+
+    Aig balance(const Aig &aig, unsigned effort) {
+        if (effort == 0)
+            return aig;
+
+        constexpr std::size_t MAX_SHARED_LEAVES = 16;
+        auto n = static_cast<unsigned>(aig.numNodes());
+        auto refs = fanoutCounts(aig);
+
+        // the operands of the tree of ANDs rooted at every needed node
+        std::vector<char> needed(n, 0);
+        std::vector<std::vector<Lit>> operands(n);
+        for (std::size_t k = 0; k < aig.numOutputs(); ++k)
+            needed[Aig::nodeOf(aig.output(k))] = 1;
+        std::vector<Lit> stack;
+        for (unsigned node = n; node-- > 1;) {
+            if (!needed[node] || !aig.isAnd(node))
+                continue;
+            auto &leaves = operands[node];
+            stack.assign({aig.fanin1(node), aig.fanin0(node)});
+            while (!stack.empty()) {
+                auto lit = stack.back();
+                stack.pop_back();
+                auto m = Aig::nodeOf(lit);
+                bool expand = !Aig::isComplemented(lit) && aig.isAnd(m) &&
+                              (refs[m] == 1 || (effort >= 2 && leaves.size() + stack.size() < MAX_SHARED_LEAVES));
+                if (expand) {
+                    stack.push_back(aig.fanin1(m));
+                    stack.push_back(aig.fanin0(m));
+                } else {
+                    leaves.push_back(lit);
+                }
+            }
+            std::sort(leaves.begin(), leaves.end());
+            leaves.erase(std::unique(leaves.begin(), leaves.end()), leaves.end());
+            for (std::size_t i = 0; i + 1 < leaves.size(); ++i) {
+                if (leaves[i + 1] == Aig::negate(leaves[i])) {
+                    leaves.assign(1, Aig::FALSE_LIT);
+                    break;
+                }
+            }
+            for (auto lit: leaves)
+                needed[Aig::nodeOf(lit)] = 1;
+        }
+
+        // rebuild every tree pairing the two shallowest operands first
+        Aig res;
+        std::vector<Lit> map(n, Aig::FALSE_LIT);
+        std::vector<unsigned> levels(1, 0);
+        for (std::size_t i = 0; i < aig.numInputs(); ++i) {
+            map[aig.inputNode(i)] = res.addInput(aig.inputSymbol(i));
+            levels.push_back(0);
+        }
+        using Entry = std::pair<unsigned, Lit>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+        for (unsigned node = 1; node < n; ++node) {
+            if (!needed[node] || !aig.isAnd(node))
+                continue;
+            for (auto lit: operands[node]) {
+                auto mapped = map[Aig::nodeOf(lit)] ^ (lit & 1u);
+                queue.emplace(levels[Aig::nodeOf(mapped)], mapped);
+            }
+            while (queue.size() > 1) {
+                auto a = queue.top();
+                queue.pop();
+                auto b = queue.top();
+                queue.pop();
+                auto lit = res.andOf(a.second, b.second);
+                if (Aig::nodeOf(lit) >= levels.size())
+                    levels.push_back(std::max(a.first, b.first) + 1);
+                queue.emplace(levels[Aig::nodeOf(lit)], lit);
+            }
+            map[node] = queue.top().second;
+            queue.pop();
+        }
+        for (std::size_t k = 0; k < aig.numOutputs(); ++k)
+            res.addOutput(map[Aig::nodeOf(aig.output(k))] ^ (aig.output(k) & 1u));
+        return res.cleanup();
+    }
+
+    /*
+     * Rewriting
+     */
+
+    namespace {
+        enum class Kind : std::uint8_t { CONST, LIT, AND, OR, XOR, MUX };
+
+        /**
+         * How a function of 4 variables is built: from the operand functions g and h, plus
+         * the select variable for a MUX.
+         */
+        struct LibraryEntry {
+            std::uint16_t g = 0;
+            std::uint16_t h = 0;
+            Kind kind = Kind::CONST;
+            std::uint8_t var = 0;
+            std::uint8_t cost = 0;
+        };
+
+        constexpr std::uint16_t VARS4[4] = {0xaaaa, 0xcccc, 0xf0f0, 0xff00};
+
+        std::uint16_t cofactor0(std::uint16_t f, unsigned v) {
+            return static_cast<std::uint16_t>(tt::cofactor0(tt::replicate(f, 4), v));
+        }
+
+        std::uint16_t cofactor1(std::uint16_t f, unsigned v) {
+            return static_cast<std::uint16_t>(tt::cofactor1(tt::replicate(f, 4), v));
+        }
+
+        /**
+         * Every function of 4 variables with the cheapest decomposition found: Shannon
+         * expansions, XOR with a variable, and disjoint-support AND, OR and XOR
+         * bi-decompositions, costed recursively in gates (3 for an XOR or a MUX).
+         */
+        class Library {
+        public:
+            Library() : entries(1u << 16), done(1u << 16, 0) {
+                for (unsigned f = 0; f < (1u << 16); ++f)
+                    solve(static_cast<std::uint16_t>(f));
+            }
+
+            const LibraryEntry &operator[](std::uint16_t f) const { return entries[f]; }
+
+        private:
+            std::vector<LibraryEntry> entries;
+            std::vector<char> done;
+
+            unsigned solve(std::uint16_t f) {
+                if (done[f])
+                    return entries[f].cost;
+                LibraryEntry best;
+                best.cost = 0xff;
+                auto consider = [&best](Kind kind, std::uint16_t g, std::uint16_t h, unsigned var, unsigned cost) {
+                    if (cost < best.cost) {
+                        best.kind = kind;
+                        best.g = g;
+                        best.h = h;
+                        best.var = static_cast<std::uint8_t>(var);
+                        best.cost = static_cast<std::uint8_t>(cost);
+                    }
+                };
+
+                unsigned support = 0;
+                for (unsigned v = 0; v < 4; ++v) {
+                    if (cofactor0(f, v) != cofactor1(f, v))
+                        support |= 1u << v;
+                }
+                if (support == 0) {
+                    consider(Kind::CONST, f, 0, 0, 0);
+                } else if ((support & (support - 1)) == 0) {
+                    consider(Kind::LIT, f, 0, 0, 0);
+                } else {
+                    for (unsigned v = 0; v < 4; ++v) {
+                        if (!(support & (1u << v)))
+                            continue;
+                        auto f0 = cofactor0(f, v), f1 = cofactor1(f, v);
+                        std::uint16_t x = VARS4[v], nx = static_cast<std::uint16_t>(~x);
+                        if (f0 == 0)
+                            consider(Kind::AND, x, f1, v, 1 + solve(f1));
+                        if (f1 == 0)
+                            consider(Kind::AND, nx, f0, v, 1 + solve(f0));
+                        if (f0 == 0xffff)
+                            consider(Kind::OR, nx, f1, v, 1 + solve(f1));
+                        if (f1 == 0xffff)
+                            consider(Kind::OR, x, f0, v, 1 + solve(f0));
+                        if (f0 == static_cast<std::uint16_t>(~f1))
+                            consider(Kind::XOR, x, f0, v, 3 + solve(f0));
+                        consider(Kind::MUX, f1, f0, v, 3 + solve(f1) + solve(f0));
+                    }
+                    // disjoint-support bi-decompositions, the lowest variable always in part a
+                    unsigned low = support & (~support + 1);
+                    for (unsigned a = support; a; a = (a - 1) & support) {
+                        auto b = support & ~a;
+                        if (!(a & low) || b == 0)
+                            continue;
+                        auto exists = [](std::uint16_t t, unsigned vars) {
+                            for (unsigned v = 0; v < 4; ++v) {
+                                if (vars & (1u << v))
+                                    t = static_cast<std::uint16_t>(cofactor0(t, v) | cofactor1(t, v));
+                            }
+                            return t;
+                        };
+                        auto forall = [](std::uint16_t t, unsigned vars) {
+                            for (unsigned v = 0; v < 4; ++v) {
+                                if (vars & (1u << v))
+                                    t = static_cast<std::uint16_t>(cofactor0(t, v) & cofactor1(t, v));
+                            }
+                            return t;
+                        };
+                        auto restrict0 = [](std::uint16_t t, unsigned vars) {
+                            for (unsigned v = 0; v < 4; ++v) {
+                                if (vars & (1u << v))
+                                    t = cofactor0(t, v);
+                            }
+                            return t;
+                        };
+                        auto ga = exists(f, b), hb = exists(f, a);
+                        if ((ga & hb) == f)
+                            consider(Kind::AND, ga, hb, 0, 1 + solve(ga) + solve(hb));
+                        ga = forall(f, b), hb = forall(f, a);
+                        if ((ga | hb) == f)
+                            consider(Kind::OR, ga, hb, 0, 1 + solve(ga) + solve(hb));
+                        ga = restrict0(f, b);
+                        hb = static_cast<std::uint16_t>(restrict0(f, a) ^ restrict0(f, support));
+                        if ((ga ^ hb) == f)
+                            consider(Kind::XOR, ga, hb, 0, 3 + solve(ga) + solve(hb));
+                    }
+                }
+                entries[f] = best;
+                done[f] = 1;
+                return best.cost;
+            }
+        };
+
+        const Library &library() {
+            static const Library lib;
+            return lib;
+        }
+    }// namespace
+
+    unsigned libraryCost(std::uint16_t truth) {
+        return library()[truth].cost;
+    }
+
+    Lit buildFromLibrary(Aig &aig, std::uint16_t truth, const Lit leaves[4]) {
+        const auto &entry = library()[truth];
+        switch (entry.kind) {
+            case Kind::CONST:
+                return truth ? Aig::TRUE_LIT : Aig::FALSE_LIT;
+            case Kind::LIT:
+                for (unsigned v = 0; v < 4; ++v) {
+                    if (truth == VARS4[v])
+                        return leaves[v];
+                    if (truth == static_cast<std::uint16_t>(~VARS4[v]))
+                        return Aig::negate(leaves[v]);
+                }
+                break;
+            case Kind::AND:
+                return aig.andOf(buildFromLibrary(aig, entry.g, leaves), buildFromLibrary(aig, entry.h, leaves));
+            case Kind::OR:
+                return aig.orOf(buildFromLibrary(aig, entry.g, leaves), buildFromLibrary(aig, entry.h, leaves));
+            case Kind::XOR:
+                return aig.xorOf(buildFromLibrary(aig, entry.g, leaves), buildFromLibrary(aig, entry.h, leaves));
+            case Kind::MUX:
+                return aig.muxOf(leaves[entry.var], buildFromLibrary(aig, entry.g, leaves),
+                                 buildFromLibrary(aig, entry.h, leaves));
+        }
+        return Aig::FALSE_LIT;
+    }
+
+    /**
+     * The gates of the cheaper of the library implementation and the graph of the NPN class in
+     * the database.
+     */
+    static unsigned rewriteCost(std::uint16_t truth) {
+        return std::min<unsigned>(libraryCost(truth), NpnDatabase::builtin().entryOf(truth).num_gates);
+    }
+
+    static Lit buildRewrite(Aig &aig, std::uint16_t truth, const Lit leaves[4]) {
+        const auto &database = NpnDatabase::builtin();
+        if (database.entryOf(truth).num_gates < libraryCost(truth))
+            return database.build(aig, truth, leaves);
+        return buildFromLibrary(aig, truth, leaves);
+    }
+
+    static Aig rewriteOnce(const Aig &aig, unsigned max_cuts) {
+        auto cuts = enumerateCuts(aig, 4, max_cuts);
+        auto refs = fanoutCounts(aig);
+        std::vector<int> chosen(aig.numNodes(), -1);
+        std::vector<Replacement> replacements;
+        std::vector<unsigned> stack, touched;
+        for (unsigned node = 1; node < aig.numNodes(); ++node) {
+            if (!aig.isAnd(node) || refs[node] == 0)
+                continue;
+            int best_gain = 0;
+            const Cut *best = nullptr;
+            for (const auto &cut: cuts[node]) {
+                if (cut.isTrivial(node))
+                    continue;
+                auto cost = rewriteCost(static_cast<std::uint16_t>(cut.truth));
+                auto gain = static_cast<int>(mffcSize(aig, node, cut.leaves, cut.size, refs, stack, touched)) -
+                            static_cast<int>(cost);
+                if (gain > best_gain) {
+                    best_gain = gain;
+                    best = &cut;
+                }
+            }
+            if (best) {
+                chosen[node] = static_cast<int>(replacements.size());
+                Replacement r;
+                r.size = best->size;
+                std::copy(best->leaves, best->leaves + best->size, r.leaves);
+                r.truth = best->truth;
+                replacements.push_back(r);
+            }
+        }
+        if (replacements.empty())
+            return aig;
+        return rebuild(aig, chosen, replacements, [](Aig &res, const Replacement &r, const Lit *leaves) {
+            return buildRewrite(res, static_cast<std::uint16_t>(r.truth), leaves);
+        });
+    }
+
+    Aig rewrite(const Aig &aig, unsigned effort) {
+        auto cur = aig.cleanup();
+        for (unsigned round = 0; round < effort; ++round) {
+            auto next = rewriteOnce(cur, 4 + 4 * effort);
+            if (next.numAnds() >= cur.numAnds())
+                break;
+            cur = std::move(next);
+        }
+        return cur;
+    }
+
+    /*
+     * Refactoring
+     */
+
+    /**
+     * Grow a cut from the fanins of the root, each time expanding the leaf which adds the
+     * fewest new leaves, so that reconvergent paths end up inside the cone.
+     * @param cone  Receives the ANDs between the root and the leaves, root included.
+     */
+    static void reconvergentCut(const Aig &aig, unsigned root, unsigned k, Replacement &cut,
+                                std::vector<unsigned> &cone) {
+        cone.assign(1, root);
+        cut.size = 0;
+        auto addLeaf = [&cut](unsigned node) {
+            if (std::find(cut.leaves, cut.leaves + cut.size, node) == cut.leaves + cut.size)
+                cut.leaves[cut.size++] = node;
+        };
+        addLeaf(Aig::nodeOf(aig.fanin0(root)));
+        addLeaf(Aig::nodeOf(aig.fanin1(root)));
+        while (true) {
+            unsigned best = tt::MAX_VARS, best_size = k + 1;
+            for (unsigned i = 0; i < cut.size; ++i) {
+                auto node = cut.leaves[i];
+                if (!aig.isAnd(node))
+                    continue;
+                unsigned size = cut.size - 1;
+                for (auto fanin: {Aig::nodeOf(aig.fanin0(node)), Aig::nodeOf(aig.fanin1(node))}) {
+                    if (std::find(cut.leaves, cut.leaves + cut.size, fanin) == cut.leaves + cut.size)
+                        ++size;
+                }
+                if (size < best_size) {
+                    best = i;
+                    best_size = size;
+                }
+            }
+            if (best == tt::MAX_VARS)
+                break;
+            auto node = cut.leaves[best];
+            cut.leaves[best] = cut.leaves[--cut.size];
+            cone.push_back(node);
+            addLeaf(Aig::nodeOf(aig.fanin0(node)));
+            addLeaf(Aig::nodeOf(aig.fanin1(node)));
+        }
+        std::sort(cut.leaves, cut.leaves + cut.size);
+        std::sort(cone.begin(), cone.end());
+    }
+
+    static tt::Table coneTruth(const Aig &aig, const Replacement &cut, const std::vector<unsigned> &cone) {
+        std::unordered_map<unsigned, tt::Table> values;
+        for (unsigned i = 0; i < cut.size; ++i)
+            values[cut.leaves[i]] = tt::var(i);
+        auto valueOf = [&values](Lit lit) {
+            auto t = values.at(Aig::nodeOf(lit));
+            return Aig::isComplemented(lit) ? ~t : t;
+        };
+        for (auto node: cone)
+            values[node] = valueOf(aig.fanin0(node)) & valueOf(aig.fanin1(node));
+        return values.at(cone.back());
+    }
+
+    /**
+     * Build a sum of products, factoring out the most frequent literal as long as it is shared
+     * by several cubes. Without an AIG only the number of gates is counted.
+     */
+    static Lit factor(Aig *aig, std::vector<tt::Cube> cubes, const Lit *leaves, unsigned &cost) {
+        if (cubes.empty())
+            return Aig::FALSE_LIT;
+        for (const auto &cube: cubes) {
+            if (cube.pos == 0 && cube.neg == 0)
+                return Aig::TRUE_LIT;
+        }
+
+        auto product = [&](const tt::Cube &cube) {
+            Lit res = Aig::TRUE_LIT;
+            bool first = true;
+            for (unsigned v = 0; v < tt::MAX_VARS; ++v) {
+                for (unsigned neg = 0; neg < 2; ++neg) {
+                    if (!((neg ? cube.neg : cube.pos) & (1u << v)))
+                        continue;
+                    if (!first)
+                        ++cost;
+                    first = false;
+                    if (aig)
+                        res = aig->andOf(res, leaves[v] ^ neg);
+                }
+            }
+            return res;
+        };
+        if (cubes.size() == 1)
+            return product(cubes[0]);
+
+        unsigned counts[2 * tt::MAX_VARS] = {};
+        for (const auto &cube: cubes) {
+            for (unsigned v = 0; v < tt::MAX_VARS; ++v) {
+                counts[2 * v] += (cube.pos >> v) & 1u;
+                counts[2 * v + 1] += (cube.neg >> v) & 1u;
+            }
+        }
+        auto best = static_cast<unsigned>(std::max_element(counts, counts + 2 * tt::MAX_VARS) - counts);
+        if (counts[best] <= 1) {
+            Lit res = Aig::FALSE_LIT;
+            for (std::size_t i = 0; i < cubes.size(); ++i) {
+                auto term = product(cubes[i]);
+                if (i > 0)
+                    ++cost;
+                if (aig)
+                    res = aig->orOf(res, term);
+            }
+            return res;
+        }
+
+        auto var = best / 2, neg = best % 2;
+        auto bit = static_cast<std::uint8_t>(1u << var);
+        std::vector<tt::Cube> quotient, rest;
+        for (auto cube: cubes) {
+            auto &lits = neg ? cube.neg : cube.pos;
+            if (lits & bit) {
+                lits &= static_cast<std::uint8_t>(~bit);
+                quotient.push_back(cube);
+            } else {
+                rest.push_back(cube);
+            }
+        }
+        auto q = factor(aig, std::move(quotient), leaves, cost);
+        ++cost;
+        Lit res = aig ? aig->andOf(leaves[var] ^ neg, q) : Aig::FALSE_LIT;
+        if (!rest.empty()) {
+            auto r = factor(aig, std::move(rest), leaves, cost);
+            ++cost;
+            if (aig)
+                res = aig->orOf(res, r);
+        }
+        return res;
+    }
+
+    /**
+     * The cheaper factored form of the function or of its complement.
+     * @return Whether the complement was chosen.
+     */
+    static bool bestCover(const Replacement &cut, std::vector<tt::Cube> &cover, unsigned &cost) {
+        auto on = tt::isop(cut.truth, cut.truth, cut.size);
+        auto off = tt::isop(~cut.truth, ~cut.truth, cut.size);
+        unsigned on_cost = 0, off_cost = 0;
+        factor(nullptr, on, nullptr, on_cost);
+        factor(nullptr, off, nullptr, off_cost);
+        if (off_cost < on_cost) {
+            cover = std::move(off);
+            cost = off_cost;
+            return true;
+        }
+        cover = std::move(on);
+        cost = on_cost;
+        return false;
+    }
+
+    static Aig refactorOnce(const Aig &aig, unsigned k) {
+        auto refs = fanoutCounts(aig);
+        std::vector<int> chosen(aig.numNodes(), -1);
+        std::vector<Replacement> replacements;
+        std::vector<unsigned> cone, stack, touched;
+        std::vector<tt::Cube> cover;
+        for (unsigned node = 1; node < aig.numNodes(); ++node) {
+            if (!aig.isAnd(node) || refs[node] == 0)
+                continue;
+            Replacement cut;
+            reconvergentCut(aig, node, k, cut, cone);
+            if (cone.size() < 2)
+                continue;
+            cut.truth = coneTruth(aig, cut, cone);
+            unsigned cost;
+            bestCover(cut, cover, cost);
+            auto mffc = mffcSize(aig, node, cut.leaves, cut.size, refs, stack, touched);
+            if (mffc > cost) {
+                chosen[node] = static_cast<int>(replacements.size());
+                replacements.push_back(cut);
+            }
+        }
+        if (replacements.empty())
+            return aig;
+        return rebuild(aig, chosen, replacements, [](Aig &res, const Replacement &r, const Lit *leaves) {
+            std::vector<tt::Cube> cover;
+            unsigned cost = 0;
+            bool complemented = bestCover(r, cover, cost);
+            auto lit = factor(&res, std::move(cover), leaves, cost);
+            return complemented ? Aig::negate(lit) : lit;
+        });
+    }
+
+    Aig refactor(const Aig &aig, unsigned effort) {
+        auto cur = aig.cleanup();
+        auto k = effort >= 2 ? 6u : 5u;
+        for (unsigned round = 0; round < effort; ++round) {
+            auto next = refactorOnce(cur, k);
+            if (next.numAnds() >= cur.numAnds())
+                break;
+            cur = std::move(next);
+        }
+        return cur;
+    }
+
+    Aig optimize(const Aig &aig, unsigned effort) {
+        if (effort == 0)
+            return aig;
+        auto res = balance(aig, 1);
+        res = rewrite(res, effort);
+        res = refactor(res, effort);
+        return balance(res, 1);
+    }
+
+}// namespace jazz
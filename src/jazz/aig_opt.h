@@ -0,0 +1,76 @@
+/**
+ * @file aig_opt.h
+ *
+ * Local optimization passes over and-inverter graphs.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_AIG_OPT_H
+#define BOOLEAN_ALGEBRA_AIG_OPT_H
+
+#include "aig.h"
+
+#include <cstdint>
+
+namespace jazz {
+
+    /**
+     * Reduce the depth: every maximal tree of ANDs is collected and rebuilt as a tree of
+     * minimal depth, combining the two shallowest operands first.
+     * @param effort  0 does nothing. At 1 the trees stop at nodes with several fanouts, which
+     *                never adds gates. From 2 on they also go through shared nodes, up to 16
+     *                operands, duplicating logic when it shortens the critical path.
+     */
+    Aig balance(const Aig &aig, unsigned effort = 1);
+
+    /**
+     * Replace the cone of a node over one of its 4-input cuts by the implementation of the
+     * same function from a precomputed library, or by the graph of its NPN class in
+     * NpnDatabase::builtin() when that is smaller, whenever it saves gates.
+     * @param effort  0 does nothing. Otherwise the number of passes, each one keeping
+     *                4 + 4 * effort cuts per node.
+     */
+    Aig rewrite(const Aig &aig, unsigned effort = 1);
+
+    /**
+     * Collapse the cone of a node over a larger reconvergent cut into an irredundant sum of
+     * products, factor it and rebuild it, whenever it saves gates.
+     * @param effort  0 does nothing. At 1 the cuts have 5 leaves, from 2 on they have 6 and
+     *                effort passes are made.
+     */
+    Aig refactor(const Aig &aig, unsigned effort = 1);
+
+    /**
+     * balance, rewrite, refactor, then balance again.
+     */
+    Aig optimize(const Aig &aig, unsigned effort = 1);
+
+    /**
+     * Number of gates of the library implementation of a function of 4 variables.
+     */
+    unsigned libraryCost(std::uint16_t truth);
+
+    /**
+     * Build the library implementation of a function of 4 variables over the given leaves.
+     */
+    Aig::Lit buildFromLibrary(Aig &aig, std::uint16_t truth, const Aig::Lit leaves[4]);
+
+}// namespace jazz
+
+#endif//BOOLEAN_ALGEBRA_AIG_OPT_H
@@ -25,15 +25,47 @@
 #include "utils.h"
 #include "wildcard.h"
 
+#include <mutex>
+
 namespace jazz {
     JAZZ_IMPLEMENT_REGISTERED_CLASS_OPT(Basic, void, print_func<PrintContext>(&Basic::printDelegate));
 }
 
+namespace {
+    /**
+     * The signatures computed so far, keyed by object and spread over shards by address, so
+     * that threads asking for different objects rarely wait on the same lock. Never destroyed,
+     * since expressions with static storage may outlive it.
+     */
+    struct SignatureShard {
+        std::mutex mutex;
+        std::unordered_map<const jazz::Basic *, jazz::Signature> signatures;
+    };
+
+    constexpr std::size_t SIGNATURE_SHARDS = 64;
+
+    SignatureShard &signatureShard(const jazz::Basic *object) {
+        static auto *shards = new SignatureShard[SIGNATURE_SHARDS];
+        // the low bits are the same for every object because of the alignment
+        return shards[(reinterpret_cast<std::uintptr_t>(object) >> 4) % SIGNATURE_SHARDS];
+    }
+}// namespace
+
 // Implicitly assumes that the other class is of the exact same type.
-jazz::Basic::Basic(const jazz::Basic &other) : flags(other.flags & ~STATUS_FLAG_DYNAMIC_ALLOC), hash(other.hash) {
+// The signature is not copied, the copy computes its own on demand.
+jazz::Basic::Basic(const jazz::Basic &other)
+    : flags(other.flags & ~(STATUS_FLAG_DYNAMIC_ALLOC | STATUS_FLAG_SIGNATURE_CALCULATED | STATUS_FLAG_SIGNATURE_STORED)),
+      hash(other.hash) {
+}
+jazz::Basic::~Basic() {
+    if (flags & STATUS_FLAG_SIGNATURE_STORED) {
+        auto &shard = signatureShard(this);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.signatures.erase(this);
+    }
 }
 jazz::Basic &jazz::Basic::operator=(const jazz::Basic &other) {
-    unsigned fl = other.flags & ~STATUS_FLAG_DYNAMIC_ALLOC;
+    unsigned fl = other.flags & ~(STATUS_FLAG_DYNAMIC_ALLOC | STATUS_FLAG_SIGNATURE_CALCULATED | STATUS_FLAG_SIGNATURE_STORED);
     if (typeid(this) != typeid(&other)) {
         // other is a derived class
         fl &= ~STATUS_FLAG_HASH_CALCULATED;
@@ -41,7 +73,8 @@ jazz::Basic &jazz::Basic::operator=(const jazz::Basic &other) {
         hash = other.hash;
     }
 
-    flags = fl;
+    // keep our own entry of the signature table, if any, to erase it on destruction
+    flags = fl | (flags & STATUS_FLAG_SIGNATURE_STORED);
     setRefCount(1);
     return *this;
 }
@@ -66,6 +99,12 @@ unsigned int jazz::Basic::computeHash() const {
     }
     return hash;
 }
+jazz::Signature jazz::Basic::computeSignature() const {
+    if (isTrivial()) {
+        return Signature::constant(trivialValue());
+    }
+    return simulate(*this);
+}
 unsigned jazz::Basic::precedence() const {
     return 70;
 }
@@ -96,6 +135,21 @@ unsigned jazz::Basic::hashValue() const {
         return computeHash();
     }
 }
+jazz::Signature jazz::Basic::signatureValue() const {
+    auto &shard = signatureShard(this);
+    if (flags & STATUS_FLAG_SIGNATURE_CALCULATED) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.signatures[this];
+    }
+    // not under the lock, the symbols look up theirs
+    Signature s = computeSignature();
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.signatures[this] = s;
+    }
+    setFlags(STATUS_FLAG_SIGNATURE_CALCULATED | STATUS_FLAG_SIGNATURE_STORED);
+    return s;
+}
 void jazz::Basic::printDispatch(const jazz::RegisteredClassHierarchy &class_hierarchy, const PrintContext &c, unsigned int level) const {
     auto pHierarchy = &class_hierarchy;
     auto pPrintContext = &c.getClassInfo();
@@ -153,7 +207,7 @@ jazz::Expr jazz::Basic::subs(const jazz::ExprMap &m, unsigned int options) const
         if (!are_ex_trivially_equal(e, new_e)) {
             // something changed, clone the object
             auto *copy = duplicate();
-            copy->clearFlags(STATUS_FLAG_HASH_CALCULATED | STATUS_FLAG_EXPANDED);
+            copy->clearFlags(STATUS_FLAG_HASH_CALCULATED | STATUS_FLAG_EXPANDED | STATUS_FLAG_SIGNATURE_CALCULATED);
             copy->operand(i) = new_e;
 
             // substitute the rest of the operands
@@ -307,7 +361,7 @@ bool jazz::Basic::isEqual(const jazz::Basic &other) const {
 void jazz::Basic::ensureIfModifiable() const {
     if (refCount() > 1)
         throw std::runtime_error("Basic::ensureIfModifiable(): object is shared so can not be modified");
-    clearFlags(STATUS_FLAG_HASH_CALCULATED | STATUS_FLAG_EVALUATED);
+    clearFlags(STATUS_FLAG_HASH_CALCULATED | STATUS_FLAG_EVALUATED | STATUS_FLAG_SIGNATURE_CALCULATED);
 }
 
 bool jazz::Basic::isType(unsigned int info) const {
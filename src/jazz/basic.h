@@ -29,6 +29,7 @@
 #include "print.h"
 #include "ptr.h"
 #include "registration.h"
+#include "signature.h"
 
 #include <unordered_map>
 
@@ -62,7 +63,7 @@ namespace jazz {
     public:
         Basic(const Basic &other);
         Basic &operator=(const Basic &other);
-        virtual ~Basic() = default;
+        virtual ~Basic();
 
         virtual Basic *duplicate() const;
 
@@ -119,6 +120,12 @@ namespace jazz {
          */
         unsigned hashValue() const;
 
+        /**
+         * Get the random simulation signature of the object, computed on first use.
+         * @return
+         */
+        Signature signatureValue() const;
+
         /**
          * Compare the object with another object.
          * @param other
@@ -190,6 +197,17 @@ namespace jazz {
          */
         virtual unsigned int computeHash() const;
 
+        /**
+         * Compute the simulation signature of the object.
+         *
+         * The default simulates the compiled object with simulate(), an object that can not be
+         * compiled is an opaque variable seeded by its hash value. The result is cached by
+         * signatureValue() in a sharded table aside from the object, so only the objects whose
+         * signature is asked for pay for it.
+         * @return
+         */
+        virtual Signature computeSignature() const;
+
         void printDelegate(const jazz::PrintContext &c, unsigned level) const;
 
         /**
@@ -0,0 +1,697 @@
+/**
+ * @file bdd.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "bdd.h"
+#include "compiler.h"
+#include "operations.h"
+#include "symbol.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace jazz::bdd {
+
+    using dd::complement;
+    using dd::indexOf;
+    using dd::isComplemented;
+    using dd::regular;
+
+    //////////////////////////////////////////////////////////////////////////
+    // Bdd
+    //////////////////////////////////////////////////////////////////////////
+
+    Bdd::Bdd(Manager *manager, Edge e) : manager(manager), e(e) {
+        if (manager)
+            manager->ref(e);
+    }
+
+    Bdd::Bdd(const Bdd &other) : manager(other.manager), e(other.e) {
+        if (manager)
+            manager->ref(e);
+    }
+
+    Bdd::Bdd(Bdd &&other) noexcept : manager(other.manager), e(other.e) {
+        other.manager = nullptr;
+    }
+
+    Bdd &Bdd::operator=(const Bdd &other) {
+        if (other.manager)
+            other.manager->ref(other.e);
+        if (manager)
+            manager->deref(e);
+        manager = other.manager;
+        e = other.e;
+        return *this;
+    }
+
+    Bdd &Bdd::operator=(Bdd &&other) noexcept {
+        if (this != &other) {
+            if (manager)
+                manager->deref(e);
+            manager = other.manager;
+            e = other.e;
+            other.manager = nullptr;
+        }
+        return *this;
+    }
+
+    Bdd::~Bdd() {
+        if (manager)
+            manager->deref(e);
+    }
+
+    bool Bdd::isOne() const { return e == Manager::ONE; }
+
+    bool Bdd::isZero() const { return e == Manager::ZERO; }
+
+    bool Bdd::isConstant() const { return regular(e) == Manager::ONE; }
+
+    unsigned Bdd::topVar() const {
+        if (!manager || isConstant())
+            throw std::logic_error("Bdd::topVar(): constant diagram");
+        return manager->table.node(e).var;
+    }
+
+    Bdd Bdd::thenChild() const {
+        Edge high, low;
+        manager->cofactors(e, manager->table.level(topVar()), high, low);
+        return {manager, high};
+    }
+
+    Bdd Bdd::elseChild() const {
+        Edge high, low;
+        manager->cofactors(e, manager->table.level(topVar()), high, low);
+        return {manager, low};
+    }
+
+    std::size_t Bdd::nodeCount() const {
+        if (!manager)
+            return 0;
+        const auto &table = manager->table;
+        std::vector<unsigned> visited;
+        std::vector<Edge> stack{regular(e)};
+        std::size_t count = 0;
+        while (!stack.empty()) {
+            auto f = stack.back();
+            stack.pop_back();
+            auto index = indexOf(f);
+            if (index >= visited.size())
+                visited.resize(index + 1, 0);
+            if (visited[index])
+                continue;
+            visited[index] = 1;
+            ++count;
+            if (!table.isTerminal(f)) {
+                stack.push_back(regular(table.node(f).high));
+                stack.push_back(regular(table.node(f).low));
+            }
+        }
+        return count;
+    }
+
+    bool Bdd::evaluate(const std::vector<bool> &assignment) const {
+        if (!manager)
+            throw std::logic_error("Bdd::evaluate(): empty handle");
+        const auto &table = manager->table;
+        auto f = e;
+        while (!table.isTerminal(f)) {
+            const auto &n = table.node(f);
+            if (n.var >= assignment.size())
+                throw std::out_of_range("Bdd::evaluate(): variable not assigned");
+            f = (assignment[n.var] ? n.high : n.low) ^ (f & 1u);
+        }
+        return f == Manager::ONE;
+    }
+
+    static Manager *commonManager(const Bdd &f, const Bdd &g, const char *func) {
+        if (!f.getManager() || f.getManager() != g.getManager())
+            throw std::invalid_argument(std::string(func) + ": operands of different managers");
+        return f.getManager();
+    }
+
+    Bdd Bdd::operator!() const {
+        return {manager, complement(e)};
+    }
+
+    Bdd Bdd::operator&(const Bdd &other) const {
+        auto m = commonManager(*this, other, "Bdd::operator&()");
+        m->beginOperation();
+        return {m, m->andRec(e, other.e)};
+    }
+
+    Bdd Bdd::operator|(const Bdd &other) const {
+        auto m = commonManager(*this, other, "Bdd::operator|()");
+        m->beginOperation();
+        return {m, complement(m->andRec(complement(e), complement(other.e)))};
+    }
+
+    Bdd Bdd::operator^(const Bdd &other) const {
+        auto m = commonManager(*this, other, "Bdd::operator^()");
+        m->beginOperation();
+        return {m, m->xorRec(e, other.e)};
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Manager
+    //////////////////////////////////////////////////////////////////////////
+
+    Manager::Manager(unsigned cache_bits) : table(1), cache(cache_bits) {}
+
+    unsigned Manager::newVar() {
+        auto v = table.addVar(table.numVars());
+        Expr symbol(("x" + std::to_string(v)).c_str());
+        symbols.push_back(symbol);
+        symbol_vars.emplace(symbol, v);
+        return v;
+    }
+
+    unsigned Manager::varOf(const Expr &symbol) {
+        auto it = symbol_vars.find(symbol);
+        if (it != symbol_vars.end())
+            return it->second;
+        if (!is_a<Symbol>(symbol))
+            throw std::invalid_argument("Manager::varOf(): not a symbol");
+
+        // insert above the first variable created after the symbol
+        auto serial = expr_cast<Symbol>(symbol).getSerial();
+        unsigned level = 0;
+        while (level < table.numVars() && expr_cast<Symbol>(symbols[table.varAt(level)]).getSerial() < serial)
+            ++level;
+
+        auto v = table.addVar(level);
+        symbols.push_back(symbol);
+        symbol_vars.emplace(symbol, v);
+        return v;
+    }
+
+    int Manager::findVar(const Expr &symbol) const {
+        auto it = symbol_vars.find(symbol);
+        return it == symbol_vars.end() ? -1 : static_cast<int>(it->second);
+    }
+
+    Bdd Manager::var(unsigned var) {
+        if (var >= table.numVars())
+            throw std::out_of_range("Manager::var(): variable out of range");
+        return {this, makeNode(var, ONE, ZERO)};
+    }
+
+    Bdd Manager::ite(const Bdd &f, const Bdd &g, const Bdd &h) {
+        if (f.getManager() != this || g.getManager() != this || h.getManager() != this)
+            throw std::invalid_argument("Manager::ite(): operands of different managers");
+        beginOperation();
+        return {this, iteRec(f.edge(), g.edge(), h.edge())};
+    }
+
+    std::size_t Manager::collectGarbage() {
+        auto freed = table.collectGarbage();
+        if (freed)
+            cache.clear();
+        return freed;
+    }
+
+    void Manager::beginOperation() {
+        auto dead = table.numDeadNodes();
+        if (dead > 4096 && dead * 2 > table.numNodes())
+            collectGarbage();
+        if (auto_reorder && table.numLiveNodes() >= next_reorder) {
+            auto size = reorder(auto_options);
+            next_reorder = std::max(reorder_threshold, 2 * size);
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // reordering
+    //////////////////////////////////////////////////////////////////////////
+
+    void Manager::swapLevels(unsigned level) {
+        if (level + 1 >= table.numVars())
+            throw std::out_of_range("Manager::swapLevels(): level out of range");
+        swapAdjacent(level);
+        cache.clear();
+    }
+
+    void Manager::swapAdjacent(unsigned level) {
+        auto x = table.varAt(level);
+        auto y = table.varAt(level + 1);
+
+        // A node of x depending on y becomes a node of y whose children are new nodes of x:
+        // f = x ? (y ? f11 : f10) : (y ? f01 : f00) = y ? (x ? f11 : f01) : (x ? f10 : f00).
+        // The node keeps its index so the edges pointing to it keep their meaning. Its
+        // then-edge stays regular since f11 is.
+        for (auto index: table.nodesOf(x)) {
+            auto f1 = table.node(dd::makeEdge(index)).high;
+            auto f0 = table.node(dd::makeEdge(index)).low;
+            if (table.levelOf(f1) != level + 1 && table.levelOf(f0) != level + 1)
+                continue;
+            Edge f11, f10, f01, f00;
+            cofactors(f1, level + 1, f11, f10);
+            cofactors(f0, level + 1, f01, f00);
+            auto high = makeNode(x, f11, f01);
+            auto low = makeNode(x, f10, f00);
+            table.relabel(index, y, low, high);
+        }
+        table.swapVars(level);
+        // the nodes of y which were only reachable through x are garbage now
+        table.collectGarbage(y);
+    }
+
+    std::size_t Manager::reorder(const SiftingOptions &options) {
+        collectGarbage();
+        cache.clear();
+
+        auto start = std::chrono::steady_clock::now();
+        auto deadline = options.time_limit.count() > 0 ? start + options.time_limit
+                                                       : std::chrono::steady_clock::time_point::max();
+
+        std::vector<unsigned> vars(table.numVars());
+        for (unsigned v = 0; v < vars.size(); ++v)
+            vars[v] = v;
+        std::stable_sort(vars.begin(), vars.end(), [this](unsigned a, unsigned b) {
+            return table.numNodesOf(a) > table.numNodesOf(b);
+        });
+        if (options.max_vars > 0 && options.max_vars < vars.size())
+            vars.resize(options.max_vars);
+
+        for (auto v: vars) {
+            if (std::chrono::steady_clock::now() >= deadline)
+                break;
+            siftVar(v, options, deadline);
+        }
+
+        collectGarbage();
+        cache.clear();
+        ++num_reorderings;
+        return table.numLiveNodes();
+    }
+
+    void Manager::siftVar(unsigned var, const SiftingOptions &options, std::chrono::steady_clock::time_point deadline) {
+        const auto n = table.numVars();
+        auto best = table.numLiveNodes();
+        auto best_level = table.level(var);
+
+        auto record = [&]() {
+            auto size = table.numLiveNodes();
+            if (size < best) {
+                best = size;
+                best_level = table.level(var);
+            }
+            return size <= best * options.max_growth && std::chrono::steady_clock::now() < deadline;
+        };
+        auto moveDown = [&]() {
+            while (table.level(var) + 1 < n) {
+                swapAdjacent(table.level(var));
+                if (!record())
+                    break;
+            }
+        };
+        auto moveUp = [&]() {
+            while (table.level(var) > 0) {
+                swapAdjacent(table.level(var) - 1);
+                if (!record())
+                    break;
+            }
+        };
+
+        // the closer end first
+        if (table.level(var) < n / 2) {
+            moveUp();
+            moveDown();
+        } else {
+            moveDown();
+            moveUp();
+        }
+
+        while (table.level(var) < best_level)
+            swapAdjacent(table.level(var));
+        while (table.level(var) > best_level)
+            swapAdjacent(table.level(var) - 1);
+    }
+
+    void Manager::enableAutoReorder(std::size_t threshold, const SiftingOptions &options) {
+        auto_reorder = true;
+        reorder_threshold = threshold;
+        next_reorder = std::max(threshold, table.numLiveNodes());
+        auto_options = options;
+    }
+
+    std::vector<unsigned> Manager::getOrder() const {
+        std::vector<unsigned> order(table.numVars());
+        for (unsigned level = 0; level < order.size(); ++level)
+            order[level] = table.varAt(level);
+        return order;
+    }
+
+    void Manager::setOrder(const std::vector<unsigned> &order) {
+        std::vector<char> seen(table.numVars(), 0);
+        if (order.size() != seen.size())
+            throw std::invalid_argument("Manager::setOrder(): not a permutation of the variables");
+        for (auto v: order) {
+            if (v >= seen.size() || seen[v])
+                throw std::invalid_argument("Manager::setOrder(): not a permutation of the variables");
+            seen[v] = 1;
+        }
+
+        collectGarbage();
+        for (unsigned level = 0; level < order.size(); ++level) {
+            while (table.level(order[level]) > level)
+                swapAdjacent(table.level(order[level]) - 1);
+        }
+        collectGarbage();
+        cache.clear();
+    }
+
+    Edge Manager::makeNode(unsigned var, Edge high, Edge low) {
+        if (high == low)
+            return high;
+        // keep the then-edge regular
+        if (isComplemented(high))
+            return complement(table.findOrAdd(var, complement(low), complement(high)));
+        return table.findOrAdd(var, low, high);
+    }
+
+    void Manager::cofactors(Edge f, unsigned level, Edge &high, Edge &low) const {
+        if (table.levelOf(f) != level) {
+            high = low = f;
+            return;
+        }
+        const auto &n = table.node(f);
+        auto c = f & 1u;
+        high = n.high ^ c;
+        low = n.low ^ c;
+    }
+
+    Edge Manager::iteRec(Edge f, Edge g, Edge h) {
+        if (f == ONE)
+            return g;
+        if (f == ZERO)
+            return h;
+        if (g == f)
+            g = ONE;
+        else if (g == complement(f))
+            g = ZERO;
+        if (h == f)
+            h = ZERO;
+        else if (h == complement(f))
+            h = ONE;
+        if (g == h)
+            return g;
+        if (g == ONE && h == ZERO)
+            return f;
+        if (g == ZERO && h == ONE)
+            return complement(f);
+
+        // ite(!f, g, h) = ite(f, h, g), and ite(f, !g, !h) = !ite(f, g, h)
+        if (isComplemented(f)) {
+            f = complement(f);
+            std::swap(g, h);
+        }
+        Edge neg = g & 1u;
+        g ^= neg;
+        h ^= neg;
+
+        Edge r;
+        if (cache.lookup(OP_ITE, f, g, h, r))
+            return r ^ neg;
+
+        auto top = std::min({table.levelOf(f), table.levelOf(g), table.levelOf(h)});
+        Edge f1, f0, g1, g0, h1, h0;
+        cofactors(f, top, f1, f0);
+        cofactors(g, top, g1, g0);
+        cofactors(h, top, h1, h0);
+        auto high = iteRec(f1, g1, h1);
+        auto low = iteRec(f0, g0, h0);
+        r = makeNode(table.varAt(top), high, low);
+        cache.insert(OP_ITE, f, g, h, r);
+        return r ^ neg;
+    }
+
+    Edge Manager::andRec(Edge f, Edge g) {
+        if (f == ZERO || g == ZERO || f == complement(g))
+            return ZERO;
+        if (f == ONE || f == g)
+            return g;
+        if (g == ONE)
+            return f;
+        if (f > g)
+            std::swap(f, g);
+
+        Edge r;
+        if (cache.lookup(OP_AND, f, g, 0, r))
+            return r;
+
+        auto top = std::min(table.levelOf(f), table.levelOf(g));
+        Edge f1, f0, g1, g0;
+        cofactors(f, top, f1, f0);
+        cofactors(g, top, g1, g0);
+        auto high = andRec(f1, g1);
+        auto low = andRec(f0, g0);
+        r = makeNode(table.varAt(top), high, low);
+        cache.insert(OP_AND, f, g, 0, r);
+        return r;
+    }
+
+    Edge Manager::xorRec(Edge f, Edge g) {
+        if (f == g)
+            return ZERO;
+        if (f == complement(g))
+            return ONE;
+        if (f == ZERO)
+            return g;
+        if (g == ZERO)
+            return f;
+        if (f == ONE)
+            return complement(g);
+        if (g == ONE)
+            return complement(f);
+
+        // !a ^ b = !(a ^ b)
+        Edge neg = (f ^ g) & 1u;
+        f = regular(f);
+        g = regular(g);
+        if (f > g)
+            std::swap(f, g);
+
+        Edge r;
+        if (cache.lookup(OP_XOR, f, g, 0, r))
+            return r ^ neg;
+
+        auto top = std::min(table.levelOf(f), table.levelOf(g));
+        Edge f1, f0, g1, g0;
+        cofactors(f, top, f1, f0);
+        cofactors(g, top, g1, g0);
+        auto high = xorRec(f1, g1);
+        auto low = xorRec(f0, g0);
+        r = makeNode(table.varAt(top), high, low);
+        cache.insert(OP_XOR, f, g, 0, r);
+        return r ^ neg;
+    }
+
+    Bdd Manager::cofactor(const Bdd &f, unsigned var, bool value) {
+        if (f.getManager() != this)
+            throw std::invalid_argument("Manager::cofactor(): operand of another manager");
+        if (var >= table.numVars())
+            throw std::out_of_range("Manager::cofactor(): variable out of range");
+        beginOperation();
+        return {this, cofactorRec(f.edge(), table.level(var), value)};
+    }
+
+    Bdd Manager::exists(const Bdd &f, const std::vector<unsigned> &vars) {
+        return {this, quantify(f, vars, false, "Manager::exists()")};
+    }
+
+    Bdd Manager::forall(const Bdd &f, const std::vector<unsigned> &vars) {
+        return {this, quantify(f, vars, true, "Manager::forall()")};
+    }
+
+    /**
+     * The variables to quantify become the cube of their positive literals, which is both a
+     * canonical key for the cache and sorted by level.
+     */
+    Edge Manager::quantify(const Bdd &f, const std::vector<unsigned> &vars, bool universal, const char *caller) {
+        if (f.getManager() != this)
+            throw std::invalid_argument(std::string(caller) + ": operand of another manager");
+        for (auto v: vars) {
+            if (v >= table.numVars())
+                throw std::out_of_range(std::string(caller) + ": variable out of range");
+        }
+        beginOperation();
+        Bdd cube = one();
+        for (auto v: vars)
+            cube = Bdd(this, andRec(cube.edge(), makeNode(v, ONE, ZERO)));
+        // forall x. f = !exists x. !f
+        auto neg = universal ? 1u : 0u;
+        return existsRec(f.edge() ^ neg, cube.edge()) ^ neg;
+    }
+
+    Edge Manager::cofactorRec(Edge f, unsigned level, bool value) {
+        // f does not depend on a variable above its top one
+        auto top = table.levelOf(f);
+        if (top > level)
+            return f;
+        Edge f1, f0;
+        if (top == level) {
+            cofactors(f, top, f1, f0);
+            return value ? f1 : f0;
+        }
+
+        Edge neg = f & 1u;
+        f ^= neg;
+        Edge r;
+        if (cache.lookup(OP_COFACTOR, f, level, value, r))
+            return r ^ neg;
+        cofactors(f, top, f1, f0);
+        r = makeNode(table.varAt(top), cofactorRec(f1, level, value), cofactorRec(f0, level, value));
+        cache.insert(OP_COFACTOR, f, level, value, r);
+        return r ^ neg;
+    }
+
+    Edge Manager::existsRec(Edge f, Edge cube) {
+        if (table.isTerminal(f))
+            return f;
+        // skip the variables above f, it does not depend on them
+        auto top = table.levelOf(f);
+        while (table.levelOf(cube) < top)
+            cube = table.node(cube).high;
+        if (cube == ONE)
+            return f;
+
+        Edge r;
+        if (cache.lookup(OP_EXISTS, f, cube, 0, r))
+            return r;
+        Edge f1, f0;
+        cofactors(f, top, f1, f0);
+        if (table.levelOf(cube) == top) {
+            auto rest = table.node(cube).high;
+            auto high = existsRec(f1, rest);
+            // f1 | f0 is already true, f0 need not be quantified
+            r = high == ONE ? ONE : complement(andRec(complement(high), complement(existsRec(f0, rest))));
+        } else {
+            r = makeNode(table.varAt(top), existsRec(f1, cube), existsRec(f0, cube));
+        }
+        cache.insert(OP_EXISTS, f, cube, 0, r);
+        return r;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // conversions
+    //////////////////////////////////////////////////////////////////////////
+
+    Bdd toBDD(Manager &manager, const Expr &e) {
+        auto program = compile(e);
+
+        // a slot is released as soon as its last reader is built
+        std::vector<unsigned> readers(program.size(), 0);
+        for (std::size_t slot = 0; slot < program.size(); ++slot) {
+            const auto &inst = program.instruction(slot);
+            if (inst.op != Program::OP_AND)
+                continue;
+            const unsigned *lits = program.fanins(slot);
+            for (unsigned i = 0; i < inst.count; ++i)
+                ++readers[Program::slotOf(lits[i])];
+        }
+        ++readers[Program::slotOf(program.output(0))];
+
+        auto literal = [&](const std::vector<Bdd> &slots, unsigned lit) {
+            const auto &f = slots[Program::slotOf(lit)];
+            return Program::isComplemented(lit) ? !f : f;
+        };
+
+        std::vector<Bdd> slots(program.size());
+        for (std::size_t slot = 0; slot < program.size(); ++slot) {
+            const auto &inst = program.instruction(slot);
+            switch (inst.op) {
+                case Program::OP_CONST:
+                    slots[slot] = manager.zero();
+                    break;
+                case Program::OP_INPUT:
+                    slots[slot] = manager.var(program.input(inst.first));
+                    break;
+                case Program::OP_AND: {
+                    const unsigned *lits = program.fanins(slot);
+                    auto f = manager.one();
+                    for (unsigned i = 0; i < inst.count; ++i) {
+                        f &= literal(slots, lits[i]);
+                        auto fanin = Program::slotOf(lits[i]);
+                        if (--readers[fanin] == 0)
+                            slots[fanin] = Bdd();
+                    }
+                    slots[slot] = std::move(f);
+                    break;
+                }
+            }
+        }
+        return literal(slots, program.output(0));
+    }
+
+    namespace {
+        class ExprBuilder {
+        public:
+            explicit ExprBuilder(const Manager &manager) : manager(manager), table(manager.nodeTable()) {}
+
+            Expr build(Edge f) {
+                if (f == Manager::ONE)
+                    return true;
+                if (f == Manager::ZERO)
+                    return false;
+                auto e = buildRegular(regular(f));
+                return isComplemented(f) ? !e : e;
+            }
+
+        private:
+            Expr buildRegular(Edge f) {
+                auto it = memo.find(f);
+                if (it != memo.end())
+                    return it->second;
+
+                const auto &n = table.node(f);
+                const auto &x = manager.symbolOf(n.var);
+                auto low = n.low;
+                auto then_expr = build(n.high);
+
+                Expr res;
+                if (n.high == Manager::ONE)
+                    res = low == Manager::ZERO ? x : x | build(low);
+                else if (low == Manager::ZERO)
+                    res = x & then_expr;
+                else if (low == Manager::ONE)
+                    res = !x | then_expr;
+                else
+                    res = (x & then_expr) | (!x & build(low));
+                memo.emplace(f, res);
+                return res;
+            }
+
+        private:
+            const Manager &manager;
+            const dd::NodeTable &table;
+            std::unordered_map<Edge, Expr> memo;
+        };
+    }// namespace
+
+    Expr toExpr(const Bdd &f) {
+        if (!f.getManager())
+            throw std::invalid_argument("toExpr(): empty handle");
+        return ExprBuilder(*f.getManager()).build(f.edge());
+    }
+
+}// namespace jazz::bdd
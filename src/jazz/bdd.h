@@ -0,0 +1,298 @@
+/**
+ * @file bdd.h
+ *
+ * Reduced ordered binary decision diagrams with complemented edges.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_BDD_H
+#define BOOLEAN_ALGEBRA_BDD_H
+
+#include "dd_table.h"
+#include "expr.h"
+
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+
+namespace jazz::bdd {
+
+    using dd::Edge;
+
+    class Manager;
+
+    /**
+     * Limits of a sifting pass.
+     */
+    struct SiftingOptions {
+        /**
+         * A variable stops moving in one direction once the diagram grew by this factor over
+         * the best size seen.
+         */
+        double max_growth = 1.2;
+
+        /**
+         * Stop sifting after this time, zero for no limit. The variable being moved is still
+         * put back at its best level.
+         */
+        std::chrono::milliseconds time_limit{0};
+
+        /**
+         * Sift at most this many variables, the ones with the most nodes first. Zero for all.
+         */
+        unsigned max_vars = 0;
+    };
+
+    /**
+     * A reference-counted handle to a function of a manager.
+     *
+     * Two handles of the same manager are equal if and only if they represent the same
+     * function, the comparison is O(1). Handles must not outlive their manager.
+     */
+    class Bdd {
+    public:
+        Bdd() = default;
+        Bdd(Manager *manager, Edge e);
+        Bdd(const Bdd &other);
+        Bdd(Bdd &&other) noexcept;
+        Bdd &operator=(const Bdd &other);
+        Bdd &operator=(Bdd &&other) noexcept;
+        ~Bdd();
+
+        Manager *getManager() const { return manager; }
+        Edge edge() const { return e; }
+
+        bool isOne() const;
+        bool isZero() const;
+        bool isConstant() const;
+
+        /**
+         * The variable at the root, the diagram must not be constant.
+         */
+        unsigned topVar() const;
+
+        /**
+         * The cofactors with respect to the root variable.
+         */
+        Bdd thenChild() const;
+        Bdd elseChild() const;
+
+        /**
+         * Number of nodes, the terminal included.
+         */
+        std::size_t nodeCount() const;
+
+        /**
+         * Evaluate under an assignment indexed by variable.
+         */
+        bool evaluate(const std::vector<bool> &assignment) const;
+
+        Bdd operator!() const;
+        Bdd operator&(const Bdd &other) const;
+        Bdd operator|(const Bdd &other) const;
+        Bdd operator^(const Bdd &other) const;
+        Bdd &operator&=(const Bdd &other) { return *this = *this & other; }
+        Bdd &operator|=(const Bdd &other) { return *this = *this | other; }
+        Bdd &operator^=(const Bdd &other) { return *this = *this ^ other; }
+
+        bool operator==(const Bdd &other) const { return manager == other.manager && e == other.e; }
+        bool operator!=(const Bdd &other) const { return !(*this == other); }
+
+    private:
+        Manager *manager = nullptr;
+        Edge e = 0;
+    };
+
+    /**
+     * Owns the nodes of a family of diagrams.
+     *
+     * There is a single terminal, ONE; ZERO is its complement. The then-edge of a node is
+     * never complemented, which keeps the representation canonical. Dead nodes are kept for
+     * reuse and freed by garbage collection, which runs between top-level operations once they
+     * outnumber the live ones, and never during one.
+     *
+     * Variables bound to symbols are ordered by the symbol serials, i.e. by creation order
+     * of the symbols, whenever they are bound. The order can be changed afterwards: levels are
+     * swapped in place, so handles stay valid across reordering.
+     */
+    class Manager {
+    public:
+        static constexpr Edge ONE = 0;
+        static constexpr Edge ZERO = 1;
+
+        /**
+         * @param cache_bits  The computed cache has 2^cache_bits entries.
+         */
+        explicit Manager(unsigned cache_bits = 16);
+        Manager(const Manager &) = delete;
+        Manager &operator=(const Manager &) = delete;
+
+        Bdd one() { return {this, ONE}; }
+        Bdd zero() { return {this, ZERO}; }
+
+        /**
+         * Create an anonymous variable at the bottom of the order, named x<index>.
+         */
+        unsigned newVar();
+
+        /**
+         * The variable bound to a symbol, it is created on first use.
+         */
+        unsigned varOf(const Expr &symbol);
+
+        /**
+         * The variable bound to a symbol, or -1.
+         */
+        int findVar(const Expr &symbol) const;
+
+        const Expr &symbolOf(unsigned var) const { return symbols.at(var); }
+
+        /**
+         * The projection function of a variable.
+         */
+        Bdd var(unsigned var);
+        Bdd var(const Expr &symbol) { return var(varOf(symbol)); }
+
+        unsigned numVars() const { return table.numVars(); }
+        unsigned level(unsigned var) const { return table.level(var); }
+        unsigned varAt(unsigned level) const { return table.varAt(level); }
+
+        Bdd ite(const Bdd &f, const Bdd &g, const Bdd &h);
+
+        /**
+         * The restriction of f to var = value.
+         */
+        Bdd cofactor(const Bdd &f, unsigned var, bool value);
+
+        /**
+         * Quantify some variables away. The nodes below the last of them are never visited,
+         * and the results are cached by diagram and set of variables.
+         */
+        Bdd exists(const Bdd &f, const std::vector<unsigned> &vars);
+        Bdd forall(const Bdd &f, const std::vector<unsigned> &vars);
+
+        /**
+         * Number of nodes, dead ones included.
+         */
+        std::size_t numNodes() const { return table.numNodes(); }
+        std::size_t numLiveNodes() const { return table.numLiveNodes(); }
+
+        /**
+         * Free the dead nodes and clear the computed cache.
+         * @return The number of nodes freed.
+         */
+        std::size_t collectGarbage();
+
+        /**
+         * Exchange the variables of two adjacent levels.
+         * @param level  The upper level, the other one is level + 1.
+         */
+        void swapLevels(unsigned level);
+
+        /**
+         * Rudell's sifting: every variable in turn is moved through all the levels and left
+         * where the diagram was the smallest.
+         * @return The number of live nodes afterwards.
+         */
+        std::size_t reorder(const SiftingOptions &options = {});
+
+        /**
+         * Sift automatically before an operation once the number of live nodes reaches a
+         * threshold. The threshold then doubles over the size left by sifting.
+         */
+        void enableAutoReorder(std::size_t threshold = 4096, const SiftingOptions &options = {});
+        void disableAutoReorder() { auto_reorder = false; }
+        unsigned numReorderings() const { return num_reorderings; }
+
+        /**
+         * The variables from the top level to the bottom one.
+         */
+        std::vector<unsigned> getOrder() const;
+
+        /**
+         * Restore an order returned by getOrder(), it must be a permutation of all variables.
+         */
+        void setOrder(const std::vector<unsigned> &order);
+
+        std::size_t cacheLookups() const { return cache.lookups(); }
+        std::size_t cacheHits() const { return cache.hits(); }
+
+        const dd::NodeTable &nodeTable() const { return table; }
+
+    private:
+        friend class Bdd;
+
+        enum Operation : unsigned {
+            OP_ITE,
+            OP_AND,
+            OP_XOR,
+            OP_COFACTOR,
+            OP_EXISTS,
+        };
+
+        void ref(Edge e) { table.ref(e); }
+        void deref(Edge e) { table.deref(e); }
+
+        /**
+         * Collect garbage and reorder if it is worth it, called before every top-level
+         * operation.
+         */
+        void beginOperation();
+
+        void swapAdjacent(unsigned level);
+        void siftVar(unsigned var, const SiftingOptions &options, std::chrono::steady_clock::time_point deadline);
+
+        Edge makeNode(unsigned var, Edge high, Edge low);
+        void cofactors(Edge f, unsigned level, Edge &high, Edge &low) const;
+        Edge iteRec(Edge f, Edge g, Edge h);
+        Edge andRec(Edge f, Edge g);
+        Edge xorRec(Edge f, Edge g);
+        Edge cofactorRec(Edge f, unsigned level, bool value);
+        Edge existsRec(Edge f, Edge cube);
+        Edge quantify(const Bdd &f, const std::vector<unsigned> &vars, bool universal, const char *caller);
+
+    private:
+        dd::NodeTable table;
+        dd::ComputedCache cache;
+        std::vector<Expr> symbols;
+        std::unordered_map<Expr, unsigned, ExprHash, ExprEqual> symbol_vars;
+
+        bool auto_reorder = false;
+        std::size_t reorder_threshold = 0;
+        std::size_t next_reorder = 0;
+        SiftingOptions auto_options;
+        unsigned num_reorderings = 0;
+    };
+
+    /**
+     * Build the diagram of an expression over And, Or, Not, Symbol and Boolean.
+     *
+     * The expression is compiled first, so shared sub-expressions are built once, and
+     * relationals are lowered to gates.
+     */
+    Bdd toBDD(Manager &manager, const Expr &e);
+
+    /**
+     * Convert a diagram back to an expression, a Shannon expansion over its nodes.
+     */
+    Expr toExpr(const Bdd &f);
+
+}// namespace jazz::bdd
+
+#endif//BOOLEAN_ALGEBRA_BDD_H
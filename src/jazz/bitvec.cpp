@@ -0,0 +1,368 @@
+/**
+ * @file bitvec.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "bitvec.h"
+#include "op_and.h"
+#include "op_not.h"
+#include "op_or.h"
+#include "operations.h"
+#include "symbol.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace jazz {
+
+    JAZZ_IMPLEMENT_REGISTERED_CLASS_OPT(BitVec, Basic, print_func<PrintContext>(&BitVec::doPrint));
+    JAZZ_IMPLEMENT_COMPARE_SAME_TYPE(BitVec, other) {
+        JAZZ_ASSERT(is_a<BitVec>(other));
+        const auto &o = static_cast<const BitVec &>(other);
+        if (bits.size() != o.bits.size())
+            return bits.size() < o.bits.size() ? -1 : 1;
+        for (std::size_t i = 0; i < bits.size(); ++i) {
+            int cmp = bits[i].compare(o.bits[i]);
+            if (cmp != 0)
+                return cmp;
+        }
+        return 0;
+    }
+
+    BitVec::BitVec() = default;
+
+    BitVec::BitVec(std::vector<Expr> bits) : bits(std::move(bits)) {
+    }
+
+    std::size_t BitVec::numOperands() const {
+        return bits.size();
+    }
+
+    const Expr &BitVec::operand(int i) const {
+        return bits.at(i);
+    }
+
+    Expr &BitVec::operand(int i) {
+        return bits.at(i);
+    }
+
+    bool BitVec::isType(unsigned int type_flag) const {
+        return type_flag == TYPE_FLAG_BITVEC;
+    }
+
+    void BitVec::doPrint(const jazz::PrintContext &context, unsigned int level) const {
+        context.os << "{";
+        for (std::size_t i = bits.size(); i-- > 0;) {
+            bits[i].print(context, 0);
+            if (i > 0)
+                context.os << ", ";
+        }
+        context.os << "}";
+    }
+
+    static const BitVec &asBitVec(const Expr &e, const char *caller) {
+        if (!is_exactly_a<BitVec>(e))
+            throw std::invalid_argument(std::string(caller) + ": operand is not a bit-vector");
+        return expr_cast<BitVec>(e);
+    }
+
+    static void checkSameWidth(const BitVec &a, const BitVec &b, const char *caller) {
+        if (a.width() != b.width())
+            throw std::invalid_argument(std::string(caller) + ": bit-vectors of different widths");
+    }
+
+    Expr makeBitVec(const char *name, unsigned width) {
+        std::vector<Expr> bits;
+        bits.reserve(width);
+        for (unsigned i = 0; i < width; ++i)
+            bits.emplace_back(create<Symbol>(std::string(name) + "[" + std::to_string(i) + "]"));
+        return create<BitVec>(std::move(bits));
+    }
+
+    Expr makeBitVec(std::vector<Expr> bits) {
+        return create<BitVec>(std::move(bits));
+    }
+
+    Expr constantBitVec(std::uint64_t value, unsigned width) {
+        std::vector<Expr> bits;
+        bits.reserve(width);
+        for (unsigned i = 0; i < width; ++i)
+            bits.emplace_back(i < 64 && ((value >> i) & 1u));
+        return create<BitVec>(std::move(bits));
+    }
+
+    bool isConstantBitVec(const Expr &bv) {
+        const auto &v = asBitVec(bv, "isConstantBitVec()");
+        for (std::size_t i = 0; i < v.width(); ++i)
+            if (!v.bit(i).isTrivial())
+                return false;
+        return true;
+    }
+
+    std::uint64_t bitVecValue(const Expr &bv) {
+        const auto &v = asBitVec(bv, "bitVecValue()");
+        if (v.width() > 64)
+            throw std::out_of_range("bitVecValue(): more than 64 bits");
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i < v.width(); ++i) {
+            if (!v.bit(i).isTrivial())
+                throw std::invalid_argument("bitVecValue(): bit-vector is not constant");
+            if (v.bit(i).trivialValue())
+                value |= std::uint64_t(1) << i;
+        }
+        return value;
+    }
+
+    template<typename F>
+    static Expr bitwise(const Expr &a, const Expr &b, const char *caller, F f) {
+        const auto &x = asBitVec(a, caller);
+        const auto &y = asBitVec(b, caller);
+        checkSameWidth(x, y, caller);
+        std::vector<Expr> bits;
+        bits.reserve(x.width());
+        for (std::size_t i = 0; i < x.width(); ++i)
+            bits.push_back(f(x.bit(i), y.bit(i)));
+        return create<BitVec>(std::move(bits));
+    }
+
+    Expr bvNot(const Expr &a) {
+        const auto &x = asBitVec(a, "bvNot()");
+        std::vector<Expr> bits;
+        bits.reserve(x.width());
+        for (std::size_t i = 0; i < x.width(); ++i)
+            bits.push_back(!x.bit(i));
+        return create<BitVec>(std::move(bits));
+    }
+
+    Expr bvAnd(const Expr &a, const Expr &b) {
+        return bitwise(a, b, "bvAnd()", [](const Expr &p, const Expr &q) { return p & q; });
+    }
+
+    Expr bvOr(const Expr &a, const Expr &b) {
+        return bitwise(a, b, "bvOr()", [](const Expr &p, const Expr &q) { return p | q; });
+    }
+
+    Expr bvXor(const Expr &a, const Expr &b) {
+        return bitwise(a, b, "bvXor()", [](const Expr &p, const Expr &q) { return p ^ q; });
+    }
+
+    /**
+     * Ripple-carry adder, the partial sum a ^ b is shared by the sum and the carry.
+     */
+    static Expr addWithCarry(const BitVec &a, const BitVec &b, Expr carry) {
+        std::vector<Expr> bits;
+        bits.reserve(a.width());
+        for (std::size_t i = 0; i < a.width(); ++i) {
+            Expr half = a.bit(i) ^ b.bit(i);
+            bits.push_back(half ^ carry);
+            carry = (a.bit(i) & b.bit(i)) | (carry & half);
+        }
+        return create<BitVec>(std::move(bits));
+    }
+
+    Expr bvAdd(const Expr &a, const Expr &b) {
+        const auto &x = asBitVec(a, "bvAdd()");
+        const auto &y = asBitVec(b, "bvAdd()");
+        checkSameWidth(x, y, "bvAdd()");
+        return addWithCarry(x, y, false);
+    }
+
+    Expr bvSub(const Expr &a, const Expr &b) {
+        // a - b = a + !b + 1
+        const auto &x = asBitVec(a, "bvSub()");
+        const auto &y = asBitVec(b, "bvSub()");
+        checkSameWidth(x, y, "bvSub()");
+        Expr not_b = bvNot(b);
+        return addWithCarry(x, expr_cast<BitVec>(not_b), true);
+    }
+
+    Expr bvNeg(const Expr &a) {
+        const auto &x = asBitVec(a, "bvNeg()");
+        return bvSub(constantBitVec(0, x.width()), a);
+    }
+
+    Expr bvMul(const Expr &a, const Expr &b) {
+        // shift and add, only the low width bits are kept
+        const auto &x = asBitVec(a, "bvMul()");
+        const auto &y = asBitVec(b, "bvMul()");
+        checkSameWidth(x, y, "bvMul()");
+        auto n = x.width();
+        Expr acc = constantBitVec(0, n);
+        for (std::size_t i = 0; i < n; ++i) {
+            std::vector<Expr> partial(n, Expr(false));
+            for (std::size_t j = 0; i + j < n; ++j)
+                partial[i + j] = x.bit(j) & y.bit(i);
+            Expr p = create<BitVec>(std::move(partial));
+            acc = addWithCarry(expr_cast<BitVec>(acc), expr_cast<BitVec>(p), false);
+        }
+        return acc;
+    }
+
+    static Expr muxBit(const Expr &sel, const Expr &a, const Expr &b) {
+        if (a.isEqual(b))
+            return a;
+        return (sel & a) | (!sel & b);
+    }
+
+    Expr bvMux(const Expr &sel, const Expr &a, const Expr &b) {
+        return bitwise(a, b, "bvMux()", [&sel](const Expr &p, const Expr &q) { return muxBit(sel, p, q); });
+    }
+
+    Expr bvShl(const Expr &a, unsigned amount) {
+        const auto &x = asBitVec(a, "bvShl()");
+        std::vector<Expr> bits(x.width(), Expr(false));
+        for (std::size_t i = amount; i < x.width(); ++i)
+            bits[i] = x.bit(i - amount);
+        return create<BitVec>(std::move(bits));
+    }
+
+    Expr bvShr(const Expr &a, unsigned amount) {
+        const auto &x = asBitVec(a, "bvShr()");
+        std::vector<Expr> bits(x.width(), Expr(false));
+        for (std::size_t i = 0; i + amount < x.width(); ++i)
+            bits[i] = x.bit(i + amount);
+        return create<BitVec>(std::move(bits));
+    }
+
+    template<typename Shift>
+    static Expr barrelShift(const Expr &a, const Expr &amount, const char *caller, Shift shift) {
+        const auto &x = asBitVec(a, caller);
+        const auto &k = asBitVec(amount, caller);
+        // one stage of muxes per bit of the amount
+        Expr res = a;
+        for (std::size_t i = 0; i < k.width(); ++i) {
+            unsigned distance = i < 32 ? unsigned(std::min<std::size_t>(std::size_t(1) << i, x.width())) : unsigned(x.width());
+            res = bvMux(k.bit(i), shift(res, distance), res);
+        }
+        return res;
+    }
+
+    Expr bvShl(const Expr &a, const Expr &amount) {
+        return barrelShift(a, amount, "bvShl()", [](const Expr &v, unsigned d) { return bvShl(v, d); });
+    }
+
+    Expr bvShr(const Expr &a, const Expr &amount) {
+        return barrelShift(a, amount, "bvShr()", [](const Expr &v, unsigned d) { return bvShr(v, d); });
+    }
+
+    Expr bvEq(const Expr &a, const Expr &b) {
+        const auto &x = asBitVec(a, "bvEq()");
+        const auto &y = asBitVec(b, "bvEq()");
+        checkSameWidth(x, y, "bvEq()");
+        std::vector<Expr> equal_bits;
+        equal_bits.reserve(x.width());
+        for (std::size_t i = 0; i < x.width(); ++i)
+            equal_bits.push_back(!(x.bit(i) ^ y.bit(i)));
+        return makeAnd(std::move(equal_bits));
+    }
+
+    Expr bvUlt(const Expr &a, const Expr &b) {
+        const auto &x = asBitVec(a, "bvUlt()");
+        const auto &y = asBitVec(b, "bvUlt()");
+        checkSameWidth(x, y, "bvUlt()");
+        // from the least significant bit up, a higher bit overrides the lower ones unless equal
+        Expr lt = false;
+        for (std::size_t i = 0; i < x.width(); ++i) {
+            const Expr &p = x.bit(i);
+            const Expr &q = y.bit(i);
+            lt = (!p & q) | (!(p ^ q) & lt);
+        }
+        return lt;
+    }
+
+    Expr bvUle(const Expr &a, const Expr &b) {
+        return !bvUlt(b, a);
+    }
+
+    static Expr lowerRelational(Relational::RelationalOp op, const Expr &lhs, const Expr &rhs) {
+        bool lhs_is_bv = is_exactly_a<BitVec>(lhs);
+        bool rhs_is_bv = is_exactly_a<BitVec>(rhs);
+        if (lhs_is_bv != rhs_is_bv)
+            throw std::invalid_argument("lowerRelational(): can not compare a bit-vector with a boolean");
+
+        // a boolean is a 1-bit vector
+        Expr a = lhs_is_bv ? lhs : makeBitVec({lhs});
+        Expr b = rhs_is_bv ? rhs : makeBitVec({rhs});
+        switch (op) {
+            case Relational::EQUAL:
+                return bvEq(a, b);
+            case Relational::NOT_EQUAL:
+                return !bvEq(a, b);
+            case Relational::LESS:
+                return bvUlt(a, b);
+            case Relational::LESS_OR_EQUAL:
+                return bvUle(a, b);
+            case Relational::GREATER:
+                return bvUlt(b, a);
+            case Relational::GREATER_OR_EQUAL:
+                return bvUle(b, a);
+            default:
+                throw std::invalid_argument("lowerRelational(): invalid relational operator");
+        }
+    }
+
+    Expr lowerRelational(const Relational &r) {
+        return lowerRelational(r.getOp(), bitblast(r.left()), bitblast(r.right()));
+    }
+
+    static Expr bitblast(const Expr &e, std::unordered_map<const Basic *, Expr> &memo) {
+        if (e.isTrivial() || e.numOperands() == 0)
+            return e;
+
+        auto found = memo.find(&expr_cast<Basic>(e));
+        if (found != memo.end())
+            return found->second;
+
+        Expr res = e;
+        if (is_exactly_a<Relational>(e)) {
+            const auto &r = expr_cast<Relational>(e);
+            res = lowerRelational(r.getOp(), bitblast(r.left(), memo), bitblast(r.right(), memo));
+        } else if (is_exactly_a<Not>(e)) {
+            Expr operand = bitblast(e.operand(0), memo);
+            if (!are_ex_trivially_equal(operand, e.operand(0)))
+                res = expr_cast<Not>(e).notFlag() ? !operand : operand;
+        } else if (is_exactly_a<And>(e) || is_exactly_a<Or>(e) || is_exactly_a<BitVec>(e)) {
+            std::vector<Expr> operands;
+            bool changed = false;
+            for (std::size_t i = 0; i < e.numOperands(); ++i) {
+                operands.push_back(bitblast(e.operand(i), memo));
+                changed = changed || !are_ex_trivially_equal(operands.back(), e.operand(i));
+            }
+            if (changed) {
+                if (is_exactly_a<BitVec>(e)) {
+                    res = makeBitVec(std::move(operands));
+                } else {
+                    res = is_exactly_a<And>(e) ? makeAnd(std::move(operands)) : makeOr(std::move(operands));
+                }
+            }
+        }
+
+        memo.emplace(&expr_cast<Basic>(e), res);
+        return res;
+    }
+
+    Expr bitblast(const Expr &e) {
+        std::unordered_map<const Basic *, Expr> memo;
+        return bitblast(e, memo);
+    }
+
+}// namespace jazz
@@ -0,0 +1,129 @@
+/**
+ * @file bitvec.h
+ *
+ * Fixed-width bit-vectors and word-level operations built from gates.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_BITVEC_H
+#define BOOLEAN_ALGEBRA_BITVEC_H
+
+#include "basic.h"
+#include "expr.h"
+#include "relational.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace jazz {
+
+    /**
+     * A fixed-width vector of boolean expressions, bit 0 is the least significant bit.
+     *
+     * A bit-vector is an unsigned integer. It is not a boolean value itself, but it can be the
+     * operand of relational operators: `a < b` over two bit-vectors is lowered to a comparator
+     * circuit by bitblast(), and by compile() on the fly.
+     */
+    class BitVec : public Basic {
+        JAZZ_DECLARE_REGISTERED_CLASS(BitVec, Basic);
+
+    public:
+        explicit BitVec(std::vector<Expr> bits);
+
+        std::size_t width() const { return bits.size(); }
+        const Expr &bit(std::size_t i) const { return bits[i]; }
+
+        std::size_t numOperands() const override;
+        const Expr &operand(int i) const override;
+        Expr &operand(int i) override;
+        bool isType(unsigned type_flag) const override;
+
+    protected:
+        void doPrint(const jazz::PrintContext &context, unsigned level) const;
+
+    protected:
+        std::vector<Expr> bits;
+    };
+
+    /**
+     * A bit-vector of fresh symbols named name[0], name[1], ...
+     */
+    Expr makeBitVec(const char *name, unsigned width);
+
+    Expr makeBitVec(std::vector<Expr> bits);
+
+    /**
+     * A constant bit-vector, the value is truncated to the width.
+     */
+    Expr constantBitVec(std::uint64_t value, unsigned width);
+
+    /**
+     * Check whether every bit of a bit-vector is trivial.
+     */
+    bool isConstantBitVec(const Expr &bv);
+
+    /**
+     * The value of a constant bit-vector of at most 64 bits.
+     */
+    std::uint64_t bitVecValue(const Expr &bv);
+
+    // bitwise operations
+    Expr bvNot(const Expr &a);
+    Expr bvAnd(const Expr &a, const Expr &b);
+    Expr bvOr(const Expr &a, const Expr &b);
+    Expr bvXor(const Expr &a, const Expr &b);
+
+    // arithmetic modulo 2^width
+    Expr bvAdd(const Expr &a, const Expr &b);
+    Expr bvSub(const Expr &a, const Expr &b);
+    Expr bvNeg(const Expr &a);
+    Expr bvMul(const Expr &a, const Expr &b);
+
+    /**
+     * Select a when sel is true, b otherwise.
+     */
+    Expr bvMux(const Expr &sel, const Expr &a, const Expr &b);
+
+    // logical shifts, by a constant or by a bit-vector amount (barrel shifter)
+    Expr bvShl(const Expr &a, unsigned amount);
+    Expr bvShr(const Expr &a, unsigned amount);
+    Expr bvShl(const Expr &a, const Expr &amount);
+    Expr bvShr(const Expr &a, const Expr &amount);
+
+    // unsigned comparisons, the results are single boolean expressions
+    Expr bvEq(const Expr &a, const Expr &b);
+    Expr bvUlt(const Expr &a, const Expr &b);
+    Expr bvUle(const Expr &a, const Expr &b);
+
+    /**
+     * Lower a relational to gates.
+     *
+     * Both sides must be bit-vectors of the same width, or both boolean expressions, where
+     * false < true.
+     */
+    Expr lowerRelational(const Relational &r);
+
+    /**
+     * Replace every relational in an expression by its comparator circuit.
+     */
+    Expr bitblast(const Expr &e);
+
+}// namespace jazz
+
+#endif//BOOLEAN_ALGEBRA_BITVEC_H
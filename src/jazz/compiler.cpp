@@ -0,0 +1,322 @@
+/**
+ * @file compiler.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "compiler.h"
+#include "bitvec.h"
+#include "op_and.h"
+#include "op_not.h"
+#include "op_or.h"
+#include "symbol.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace jazz {
+
+    /**
+     * Builds a Program from expressions.
+     *
+     * Nodes are deduplicated by identity through a visited table, and by structure through a
+     * hash table over the sorted fanin literals of the And instructions.
+     */
+    class Compiler {
+    public:
+        explicit Compiler(Program &program) : program(program) {
+            program.instructions.push_back({Program::OP_CONST, 0, 0});
+        }
+
+        void addInput(const Expr &e) {
+            if (!is_a<Symbol>(e))
+                throw std::invalid_argument("compile(): inputs must be symbols");
+            if (program.input_index.find(e) == program.input_index.end())
+                newInput(e);
+        }
+
+        void fixInputs() {
+            fixed_inputs = true;
+        }
+
+        /**
+         * Compile the nodes that have no circuit as inputs instead of throwing.
+         */
+        void allowOpaqueInputs() {
+            opaque_inputs = true;
+        }
+
+        unsigned compile(const Expr &root);
+
+        void addOutput(const Expr &root) {
+            program.outputs.push_back(compile(root));
+        }
+
+    private:
+        static bool isGate(const Expr &e) {
+            if (e.isTrivial())
+                return false;
+            return is_exactly_a<And>(e) || is_exactly_a<Or>(e) || is_exactly_a<Not>(e);
+        }
+
+        unsigned literalOf(const Expr &e) const {
+            return visited.at(&expr_cast<Basic>(e));
+        }
+
+        unsigned build(const Expr &e);
+        unsigned inputLiteral(const Expr &e);
+        unsigned newInput(const Expr &e);
+        unsigned makeAnd(std::vector<unsigned> &lits);
+
+    private:
+        Program &program;
+        bool fixed_inputs = false;
+        bool opaque_inputs = false;
+        std::unordered_map<const Basic *, unsigned> visited;
+        std::unordered_multimap<std::size_t, unsigned> strash;
+        // lowered relationals, kept alive since their nodes are keys of visited.
+        std::vector<Expr> lowered;
+    };
+
+    unsigned Compiler::compile(const Expr &root) {
+        // iterative post-order traversal, deep circuits would overflow the call stack.
+        std::vector<std::pair<const Expr *, bool>> stack;
+        stack.emplace_back(&root, false);
+        while (!stack.empty()) {
+            auto [e, expanded] = stack.back();
+            const Basic *node = &expr_cast<Basic>(*e);
+            if (visited.find(node) != visited.end()) {
+                stack.pop_back();
+                continue;
+            }
+
+            if (!expanded && isGate(*e)) {
+                stack.back().second = true;
+                // push in reverse, so that the operands are visited from left to right.
+                for (std::size_t i = e->numOperands(); i-- > 0;) {
+                    const Expr &child = e->operand(i);
+                    if (visited.find(&expr_cast<Basic>(child)) == visited.end())
+                        stack.emplace_back(&child, false);
+                }
+                continue;
+            }
+
+            stack.pop_back();
+            visited[node] = build(*e);
+        }
+
+        return literalOf(root);
+    }
+
+    unsigned Compiler::build(const Expr &e) {
+        if (e.isTrivial())
+            return e.trivialValue() ? Program::TRUE_LITERAL : Program::FALSE_LITERAL;
+
+        if (is_a<Symbol>(e))
+            return inputLiteral(e);
+
+        if (is_exactly_a<Not>(e)) {
+            unsigned lit = literalOf(e.operand(0));
+            return expr_cast<Not>(e).notFlag() ? lit ^ 1u : lit;
+        }
+
+        bool is_or = is_exactly_a<Or>(e);
+        if (is_or || is_exactly_a<And>(e)) {
+            // p | q is compiled as !(!p & !q)
+            std::vector<unsigned> lits;
+            lits.reserve(e.numOperands());
+            for (std::size_t i = 0; i < e.numOperands(); ++i)
+                lits.push_back(literalOf(e.operand(i)) ^ (is_or ? 1u : 0u));
+            return makeAnd(lits) ^ (is_or ? 1u : 0u);
+        }
+
+        if (is_exactly_a<Relational>(e)) {
+            Expr circuit;
+            try {
+                circuit = bitblast(e);
+            } catch (const std::invalid_argument &) {
+                // no boolean meaning, e.g. a bit-vector compared with a boolean
+                if (!opaque_inputs)
+                    throw;
+                return inputLiteral(e);
+            }
+            lowered.push_back(circuit);
+            return compile(circuit);
+        }
+
+        if (opaque_inputs)
+            return inputLiteral(e);
+        throw std::invalid_argument(std::string("compile(): ") + expr_cast<Basic>(e).getClassName() + " can not be compiled");
+    }
+
+    unsigned Compiler::inputLiteral(const Expr &e) {
+        auto found = program.input_index.find(e);
+        if (found != program.input_index.end())
+            return Program::makeLiteral(program.input_slots[found->second]);
+
+        if (fixed_inputs)
+            throw std::invalid_argument("compile(): symbol is not in the input list");
+        return newInput(e);
+    }
+
+    unsigned Compiler::newInput(const Expr &e) {
+        auto index = static_cast<unsigned>(program.inputs.size());
+        auto slot = static_cast<unsigned>(program.instructions.size());
+        program.instructions.push_back({Program::OP_INPUT, index, 0});
+        program.inputs.push_back(e);
+        program.input_slots.push_back(slot);
+        program.input_index.emplace(e, index);
+        return Program::makeLiteral(slot);
+    }
+
+    unsigned Compiler::makeAnd(std::vector<unsigned> &lits) {
+        std::sort(lits.begin(), lits.end());
+        lits.erase(std::unique(lits.begin(), lits.end()), lits.end());
+
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < lits.size(); ++i) {
+            unsigned lit = lits[i];
+            if (lit == Program::FALSE_LITERAL)
+                return Program::FALSE_LITERAL;
+            if (lit == Program::TRUE_LITERAL)
+                continue;
+            // p and !p are adjacent after sorting
+            if (n > 0 && (lits[n - 1] ^ 1u) == lit)
+                return Program::FALSE_LITERAL;
+            lits[n++] = lit;
+        }
+        lits.resize(n);
+
+        if (lits.empty())
+            return Program::TRUE_LITERAL;
+        if (lits.size() == 1)
+            return lits[0];
+
+        std::size_t h = lits.size();
+        for (auto lit : lits)
+            h = (h ^ lit) * 0x100000001b3ull;
+
+        auto range = strash.equal_range(h);
+        for (auto it = range.first; it != range.second; ++it) {
+            const auto &inst = program.instructions[it->second];
+            if (inst.count == lits.size() && std::equal(lits.begin(), lits.end(), program.fanins(it->second)))
+                return Program::makeLiteral(it->second);
+        }
+
+        auto slot = static_cast<unsigned>(program.instructions.size());
+        auto first = static_cast<unsigned>(program.fanin_literals.size());
+        program.fanin_literals.insert(program.fanin_literals.end(), lits.begin(), lits.end());
+        program.instructions.push_back({Program::OP_AND, first, static_cast<unsigned>(lits.size())});
+        strash.emplace(h, slot);
+        return Program::makeLiteral(slot);
+    }
+
+    int Program::inputIndex(const Expr &e) const {
+        auto found = input_index.find(e);
+        if (found == input_index.end())
+            return -1;
+        return static_cast<int>(found->second);
+    }
+
+    std::vector<bool> Program::evaluate(const std::vector<bool> &input_values) const {
+        if (input_values.size() != inputs.size())
+            throw std::invalid_argument("Program::evaluate(): wrong number of input values");
+
+        std::vector<std::uint64_t> words(inputs.size());
+        for (std::size_t i = 0; i < inputs.size(); ++i)
+            words[i] = input_values[i] ? ~std::uint64_t(0) : 0;
+
+        std::vector<std::uint64_t> buffer(size());
+        run(words.data(), buffer.data());
+
+        std::vector<bool> res(outputs.size());
+        for (std::size_t k = 0; k < outputs.size(); ++k)
+            res[k] = valueOf(buffer.data(), outputs[k]) & 1u;
+        return res;
+    }
+
+    void Program::run(const std::uint64_t *input_values, std::uint64_t *buffer) const {
+        const auto n = instructions.size();
+        const unsigned *lits = fanin_literals.data();
+        for (std::size_t slot = 0; slot < n; ++slot) {
+            const auto &inst = instructions[slot];
+            switch (inst.op) {
+                case OP_CONST:
+                    buffer[slot] = 0;
+                    break;
+                case OP_INPUT:
+                    buffer[slot] = input_values[inst.first];
+                    break;
+                case OP_AND: {
+                    std::uint64_t v = ~std::uint64_t(0);
+                    const unsigned *p = lits + inst.first;
+                    for (unsigned i = 0; i < inst.count; ++i)
+                        v &= valueOf(buffer, p[i]);
+                    buffer[slot] = v;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::vector<std::uint64_t> Program::run(const std::vector<std::uint64_t> &input_values) const {
+        if (input_values.size() != inputs.size())
+            throw std::invalid_argument("Program::run(): wrong number of input values");
+
+        std::vector<std::uint64_t> buffer(size());
+        run(input_values.data(), buffer.data());
+
+        std::vector<std::uint64_t> res(outputs.size());
+        for (std::size_t k = 0; k < outputs.size(); ++k)
+            res[k] = valueOf(buffer.data(), outputs[k]);
+        return res;
+    }
+
+    Program compile(const Expr &root) {
+        return compile(std::vector<Expr>{root});
+    }
+
+    Program compile(const std::vector<Expr> &roots) {
+        Program program;
+        Compiler compiler(program);
+        for (const auto &root : roots)
+            compiler.addOutput(root);
+        return program;
+    }
+
+    Program compileForSimulation(const Expr &root) {
+        Program program;
+        Compiler compiler(program);
+        compiler.allowOpaqueInputs();
+        compiler.addOutput(root);
+        return program;
+    }
+
+    Program compile(const std::vector<Expr> &roots, const std::vector<Expr> &inputs) {
+        Program program;
+        Compiler compiler(program);
+        for (const auto &input : inputs)
+            compiler.addInput(input);
+        compiler.fixInputs();
+        for (const auto &root : roots)
+            compiler.addOutput(root);
+        return program;
+    }
+
+}// namespace jazz
@@ -0,0 +1,167 @@
+/**
+ * @file compiler.h
+ *
+ * Compile expressions into a flat instruction schedule for fast evaluation.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_COMPILER_H
+#define BOOLEAN_ALGEBRA_COMPILER_H
+
+#include "expr.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace jazz {
+
+    /**
+     * A compiled form of one or more expressions.
+     *
+     * The program is a topologically ordered list of instructions, every instruction writes
+     * exactly one slot of the value buffer. Slot 0 always holds the constant false.
+     *
+     * Operands and outputs are literals: the slot index shifted left by one, with the lowest bit
+     * telling whether the value is complemented. `Or` and `Not` are folded into complemented
+     * `And` operands, so only three kinds of instructions exist.
+     *
+     * Nodes shared by several roots, either by identity or by structure, are compiled once.
+     */
+    class Program {
+        friend class Compiler;
+
+    public:
+        enum OpCode : unsigned char {
+            OP_CONST,
+            OP_INPUT,
+            OP_AND,
+        };
+
+        struct Instruction {
+            OpCode op;
+            unsigned first;///< index of the first fanin, or the input index for OP_INPUT
+            unsigned count;///< number of fanins
+        };
+
+        static constexpr unsigned FALSE_LITERAL = 0;
+        static constexpr unsigned TRUE_LITERAL = 1;
+
+        static unsigned makeLiteral(unsigned slot, bool complemented = false) {
+            return (slot << 1) | (complemented ? 1u : 0u);
+        }
+
+        static unsigned slotOf(unsigned lit) { return lit >> 1; }
+        static bool isComplemented(unsigned lit) { return lit & 1u; }
+
+    public:
+        std::size_t numInputs() const { return inputs.size(); }
+        const Expr &input(std::size_t i) const { return inputs[i]; }
+        unsigned inputSlot(std::size_t i) const { return input_slots[i]; }
+
+        /**
+         * Find the input index of a symbol.
+         * @param e
+         * @return The index, or -1 if the symbol is not an input of the program.
+         */
+        int inputIndex(const Expr &e) const;
+
+        std::size_t numOutputs() const { return outputs.size(); }
+        unsigned output(std::size_t k) const { return outputs[k]; }
+
+        /**
+         * Number of slots in the value buffer.
+         */
+        std::size_t size() const { return instructions.size(); }
+        const Instruction &instruction(std::size_t slot) const { return instructions[slot]; }
+        const unsigned *fanins(std::size_t slot) const { return fanin_literals.data() + instructions[slot].first; }
+
+        /**
+         * Evaluate all outputs for one assignment of the inputs.
+         * @param input_values  One value per input, in input order.
+         * @return One value per output, in output order.
+         */
+        std::vector<bool> evaluate(const std::vector<bool> &input_values) const;
+
+        /**
+         * Evaluate 64 assignments at once.
+         *
+         * Bit i of every word belongs to the i-th assignment.
+         * @param input_values  One word per input, in input order.
+         * @param buffer        Receives one word per slot, must hold size() words.
+         */
+        void run(const std::uint64_t *input_values, std::uint64_t *buffer) const;
+
+        /**
+         * Evaluate 64 assignments at once and collect the output words.
+         * @param input_values  One word per input, in input order.
+         * @return One word per output, in output order.
+         */
+        std::vector<std::uint64_t> run(const std::vector<std::uint64_t> &input_values) const;
+
+        /**
+         * Read the value of a literal from a buffer filled by run().
+         */
+        static std::uint64_t valueOf(const std::uint64_t *buffer, unsigned lit) {
+            return buffer[lit >> 1] ^ (std::uint64_t(0) - (lit & 1u));
+        }
+
+    private:
+        std::vector<Instruction> instructions;
+        std::vector<unsigned> fanin_literals;
+        std::vector<Expr> inputs;
+        std::vector<unsigned> input_slots;
+        std::vector<unsigned> outputs;
+        std::unordered_map<Expr, unsigned, ExprHash, ExprEqual> input_index;
+    };
+
+    /**
+     * Compile a single expression.
+     *
+     * The inputs of the program are the symbols of the expression, in an unspecified order
+     * that may differ between runs, since And and Or order their operands by hash value.
+     * Use the overload taking the inputs to fix it.
+     */
+    Program compile(const Expr &root);
+
+    /**
+     * Compile several expressions into one shared program, output k is roots[k].
+     *
+     * The inputs of the program are the symbols of the expression, in an unspecified order
+     * that may differ between runs, since And and Or order their operands by hash value.
+     * Use the overload taking the inputs to fix it.
+     */
+    Program compile(const std::vector<Expr> &roots);
+
+    /**
+     * Compile several expressions into one shared program with a fixed input order.
+     *
+     * Every symbol met in the roots must be listed in inputs, unused inputs are allowed.
+     */
+    Program compile(const std::vector<Expr> &roots, const std::vector<Expr> &inputs);
+
+    /**
+     * Compile a single expression for simulation. The subexpressions that can not be compiled,
+     * such as a bit-vector compared with a boolean, become inputs of the program like the
+     * symbols.
+     */
+    Program compileForSimulation(const Expr &root);
+
+}// namespace jazz
+
+#endif//BOOLEAN_ALGEBRA_COMPILER_H
@@ -0,0 +1,197 @@
+/**
+ * @file dd_table.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "dd_table.h"
+
+#include <stdexcept>
+
+namespace jazz::dd {
+
+    NodeTable::NodeTable(unsigned num_terminals) : num_terminals(num_terminals) {
+        if (num_terminals == 0)
+            throw std::invalid_argument("NodeTable::NodeTable(): at least one terminal is needed");
+        nodes.resize(num_terminals);
+        for (auto &n: nodes)
+            n = Node{CONSTANT_VAR, 0, 0, 1, 0};
+    }
+
+    unsigned NodeTable::addVar(unsigned level) {
+        if (level > numVars())
+            throw std::out_of_range("NodeTable::addVar(): level out of range");
+
+        auto var = numVars();
+        for (auto &l: perm) {
+            if (l >= level)
+                ++l;
+        }
+        perm.push_back(level);
+        invperm.insert(invperm.begin() + level, var);
+        subtables.emplace_back();
+        subtables.back().buckets.assign(16, 0);
+        return var;
+    }
+
+    Edge NodeTable::findOrAdd(unsigned var, Edge low, Edge high) {
+        auto &table = subtables[var];
+        auto mask = table.buckets.size() - 1;
+        for (auto i = table.buckets[hashOf(low, high) & mask]; i != 0; i = nodes[i].next) {
+            const auto &n = nodes[i];
+            if (n.low == low && n.high == high)
+                return makeEdge(i);
+        }
+
+        auto index = allocateNode();
+        nodes[index] = Node{var, low, high, 0, 0};
+        ref(low);
+        ref(high);
+        ++dead;
+        ++num_nodes;
+        insert(index);
+        return makeEdge(index);
+    }
+
+    std::size_t NodeTable::collectGarbage() {
+        if (dead == 0)
+            return 0;
+
+        // Children are always below their parents, sweeping from the top frees whole dead
+        // sub-diagrams in a single pass.
+        std::size_t freed = 0;
+        for (unsigned level = 0; level < numVars() && dead > 0; ++level)
+            freed += collectGarbage(invperm[level]);
+        return freed;
+    }
+
+    std::size_t NodeTable::collectGarbage(unsigned var) {
+        auto &table = subtables[var];
+        std::size_t freed = 0;
+        for (auto &head: table.buckets) {
+            unsigned *link = &head;
+            while (*link != 0) {
+                auto i = *link;
+                auto &n = nodes[i];
+                if (n.ref != 0) {
+                    link = &n.next;
+                    continue;
+                }
+                *link = n.next;
+                deref(n.low);
+                deref(n.high);
+                --table.keys;
+                freeNode(i);
+                ++freed;
+            }
+        }
+        return freed;
+    }
+
+    std::vector<unsigned> NodeTable::nodesOf(unsigned var) const {
+        std::vector<unsigned> res;
+        res.reserve(subtables[var].keys);
+        for (auto head: subtables[var].buckets) {
+            for (auto i = head; i != 0; i = nodes[i].next)
+                res.push_back(i);
+        }
+        return res;
+    }
+
+    void NodeTable::relabel(unsigned index, unsigned var, Edge low, Edge high) {
+        auto old_low = nodes[index].low;
+        auto old_high = nodes[index].high;
+        unlink(index);
+        nodes[index].var = var;
+        nodes[index].low = low;
+        nodes[index].high = high;
+        insert(index);
+        ref(low);
+        ref(high);
+        deref(old_low);
+        deref(old_high);
+    }
+
+    void NodeTable::swapVars(unsigned level) {
+        if (level + 1 >= numVars())
+            throw std::out_of_range("NodeTable::swapVars(): level out of range");
+        auto x = invperm[level];
+        auto y = invperm[level + 1];
+        invperm[level] = y;
+        invperm[level + 1] = x;
+        perm[x] = level + 1;
+        perm[y] = level;
+    }
+
+    unsigned NodeTable::allocateNode() {
+        if (free_list != 0) {
+            auto index = free_list;
+            free_list = nodes[index].next;
+            return index;
+        }
+        if (nodes.size() >= (1u << 31) - 1)
+            throw std::length_error("NodeTable::allocateNode(): too many nodes");
+        nodes.emplace_back();
+        return static_cast<unsigned>(nodes.size() - 1);
+    }
+
+    void NodeTable::freeNode(unsigned index) {
+        nodes[index].var = CONSTANT_VAR;
+        nodes[index].next = free_list;
+        free_list = index;
+        --dead;
+        --num_nodes;
+    }
+
+    void NodeTable::insert(unsigned index) {
+        auto &n = nodes[index];
+        auto &table = subtables[n.var];
+        if (table.keys >= 2 * table.buckets.size())
+            resize(table);
+        auto &head = table.buckets[hashOf(n.low, n.high) & (table.buckets.size() - 1)];
+        n.next = head;
+        head = index;
+        ++table.keys;
+    }
+
+    void NodeTable::unlink(unsigned index) {
+        auto &n = nodes[index];
+        auto &table = subtables[n.var];
+        unsigned *link = &table.buckets[hashOf(n.low, n.high) & (table.buckets.size() - 1)];
+        while (*link != index)
+            link = &nodes[*link].next;
+        *link = n.next;
+        --table.keys;
+    }
+
+    void NodeTable::resize(Subtable &table) {
+        std::vector<unsigned> buckets(table.buckets.size() * 2, 0);
+        auto mask = buckets.size() - 1;
+        for (auto head: table.buckets) {
+            while (head != 0) {
+                auto next = nodes[head].next;
+                auto &bucket = buckets[hashOf(nodes[head].low, nodes[head].high) & mask];
+                nodes[head].next = bucket;
+                bucket = head;
+                head = next;
+            }
+        }
+        table.buckets.swap(buckets);
+    }
+
+}// namespace jazz::dd
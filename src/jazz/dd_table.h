@@ -0,0 +1,237 @@
+/**
+ * @file dd_table.h
+ *
+ * Node storage shared by the decision diagram packages.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_DD_TABLE_H
+#define BOOLEAN_ALGEBRA_DD_TABLE_H
+
+#include <cstddef>
+#include <vector>
+
+namespace jazz::dd {
+
+    /**
+     * A reference to a node: the node index shifted left by one, with the lowest bit telling
+     * whether the edge is complemented. Packages without complemented edges keep it clear.
+     */
+    using Edge = unsigned;
+
+    inline Edge makeEdge(unsigned index, bool complemented = false) {
+        return (index << 1) | (complemented ? 1u : 0u);
+    }
+
+    inline unsigned indexOf(Edge e) { return e >> 1; }
+    inline bool isComplemented(Edge e) { return e & 1u; }
+    inline Edge regular(Edge e) { return e & ~1u; }
+    inline Edge complement(Edge e) { return e ^ 1u; }
+
+    struct Node {
+        unsigned var;
+        Edge low;
+        Edge high;
+        unsigned ref;
+        unsigned next;///< next node in the same hash chain, or in the free list
+    };
+
+    /**
+     * Nodes, one unique table per variable, reference counts and garbage collection.
+     *
+     * The first nodes are terminals, they are never collected. A node whose reference count
+     * drops to zero is dead but stays in its unique table, so it can be revived for free until
+     * the next collectGarbage().
+     *
+     * Variables are identified by their creation index; their position in the order is their
+     * level, level 0 being the top. Unique tables are per variable so that adjacent levels can
+     * be swapped without rehashing the rest of the diagram.
+     */
+    class NodeTable {
+    public:
+        static constexpr unsigned CONSTANT_VAR = ~0u;
+
+        explicit NodeTable(unsigned num_terminals);
+
+        /**
+         * Create a variable.
+         * @param level  The level of the new variable, the variables below move down by one.
+         * @return The index of the new variable.
+         */
+        unsigned addVar(unsigned level);
+
+        unsigned numVars() const { return static_cast<unsigned>(perm.size()); }
+        unsigned level(unsigned var) const { return perm[var]; }
+        unsigned varAt(unsigned level) const { return invperm[level]; }
+
+        /**
+         * The level of the node an edge points to, terminals are below all variables.
+         */
+        unsigned levelOf(Edge e) const {
+            unsigned var = nodes[indexOf(e)].var;
+            return var == CONSTANT_VAR ? numVars() : perm[var];
+        }
+
+        const Node &node(Edge e) const { return nodes[indexOf(e)]; }
+        bool isTerminal(Edge e) const { return indexOf(e) < num_terminals; }
+
+        /**
+         * Find the node (var, low, high) or create it. Reduction rules are up to the caller.
+         */
+        Edge findOrAdd(unsigned var, Edge low, Edge high);
+
+        void ref(Edge e) {
+            auto &n = nodes[indexOf(e)];
+            if (indexOf(e) >= num_terminals && n.ref++ == 0)
+                --dead;
+        }
+
+        void deref(Edge e) {
+            auto &n = nodes[indexOf(e)];
+            if (indexOf(e) >= num_terminals && --n.ref == 0)
+                ++dead;
+        }
+
+        /**
+         * Number of nodes in the unique tables, dead ones included.
+         */
+        std::size_t numNodes() const { return num_nodes; }
+        std::size_t numDeadNodes() const { return dead; }
+        std::size_t numLiveNodes() const { return num_nodes - dead; }
+
+        /**
+         * Number of nodes of a variable, dead ones included.
+         */
+        std::size_t numNodesOf(unsigned var) const { return subtables[var].keys; }
+
+        /**
+         * Free all dead nodes.
+         * @return The number of nodes freed.
+         */
+        std::size_t collectGarbage();
+
+        /**
+         * Free the dead nodes of one variable. Their children may die in turn, they are left
+         * for a later collection.
+         */
+        std::size_t collectGarbage(unsigned var);
+
+        /**
+         * Indices of the nodes of a variable, dead ones included.
+         */
+        std::vector<unsigned> nodesOf(unsigned var) const;
+
+        /**
+         * Give a node a new variable and new children in place, so that the edges pointing to
+         * it stay valid. The caller is responsible for keeping the diagram canonical.
+         */
+        void relabel(unsigned index, unsigned var, Edge low, Edge high);
+
+        /**
+         * Exchange the variables of two adjacent levels in the order. The nodes are not
+         * touched, see relabel().
+         */
+        void swapVars(unsigned level);
+
+    protected:
+        struct Subtable {
+            std::vector<unsigned> buckets;
+            std::size_t keys = 0;
+        };
+
+        static std::size_t hashOf(Edge low, Edge high) {
+            return (std::size_t(low) * 12582917u) ^ (std::size_t(high) * 4256249u);
+        }
+
+        unsigned allocateNode();
+        void freeNode(unsigned index);
+        void insert(unsigned index);
+        void unlink(unsigned index);
+        void resize(Subtable &table);
+
+    protected:
+        std::vector<Node> nodes;
+        std::vector<Subtable> subtables;
+        std::vector<unsigned> perm;
+        std::vector<unsigned> invperm;
+        unsigned num_terminals;
+        unsigned free_list = 0;
+        std::size_t num_nodes = 0;
+        std::size_t dead = 0;
+    };
+
+    /**
+     * A lossy, direct-mapped cache of operation results, keyed by an operation code and up to
+     * three edges. A colliding insertion simply overwrites the older entry.
+     *
+     * Entries refer to nodes without holding references, so the cache must be cleared
+     * whenever nodes are freed.
+     */
+    class ComputedCache {
+    public:
+        explicit ComputedCache(unsigned bits) : entries(std::size_t(1) << bits) { clear(); }
+
+        bool lookup(unsigned op, Edge f, Edge g, Edge h, Edge &result) {
+            ++num_lookups;
+            const auto &entry = entries[slotOf(op, f, g, h)];
+            if (entry.op != op || entry.f != f || entry.g != g || entry.h != h)
+                return false;
+            ++num_hits;
+            result = entry.result;
+            return true;
+        }
+
+        void insert(unsigned op, Edge f, Edge g, Edge h, Edge result) {
+            entries[slotOf(op, f, g, h)] = Entry{op, f, g, h, result};
+        }
+
+        void clear() {
+            for (auto &entry: entries)
+                entry.op = EMPTY;
+        }
+
+        std::size_t lookups() const { return num_lookups; }
+        std::size_t hits() const { return num_hits; }
+
+    private:
+        static constexpr unsigned EMPTY = ~0u;
+
+        struct Entry {
+            unsigned op;
+            Edge f, g, h;
+            Edge result;
+        };
+
+        std::size_t slotOf(unsigned op, Edge f, Edge g, Edge h) const {
+            std::size_t k = op;
+            k = k * 0x9e3779b1u + f;
+            k = k * 0x85ebca6bu + g;
+            k = k * 0xc2b2ae35u + h;
+            return (k ^ (k >> 15)) & (entries.size() - 1);
+        }
+
+    private:
+        std::vector<Entry> entries;
+        std::size_t num_lookups = 0;
+        std::size_t num_hits = 0;
+    };
+
+}// namespace jazz::dd
+
+#endif//BOOLEAN_ALGEBRA_DD_TABLE_H
@@ -0,0 +1,400 @@
+/**
+ * @file dimacs.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "dimacs.h"
+#include "compiler.h"
+#include "operations.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace jazz {
+
+    namespace {
+        constexpr std::uint8_t POSITIVE = 1;
+        constexpr std::uint8_t NEGATIVE = 2;
+
+        /**
+         * Characters are gathered in a fixed buffer and written to the stream in large blocks.
+         */
+        class DimacsBuffer {
+        public:
+            explicit DimacsBuffer(std::ostream &out) : out(out), buffer(1u << 16) {}
+
+            void put(char c) {
+                if (size == buffer.size())
+                    flush();
+                buffer[size++] = c;
+            }
+
+            void put(const std::string &s) {
+                for (auto c: s)
+                    put(c);
+            }
+
+            void put(std::int64_t v) {
+                if (size + 24 > buffer.size())
+                    flush();
+                auto u = static_cast<std::uint64_t>(v);
+                if (v < 0) {
+                    buffer[size++] = '-';
+                    u = 0 - u;
+                }
+                char digits[20];
+                int n = 0;
+                do {
+                    digits[n++] = static_cast<char>('0' + u % 10);
+                    u /= 10;
+                } while (u);
+                while (n)
+                    buffer[size++] = digits[--n];
+            }
+
+            void flush() {
+                out.write(buffer.data(), static_cast<std::streamsize>(size));
+                size = 0;
+            }
+
+        private:
+            std::ostream &out;
+            std::vector<char> buffer;
+            std::size_t size = 0;
+        };
+
+        /**
+         * The gates of a program, with the polarities they are needed in and their variables.
+         */
+        class CnfEncoder {
+        public:
+            CnfEncoder(const Program &program, CnfEncoding encoding)
+                : program(program), polarity(program.size(), 0), vars(program.size(), 0) {
+                for (std::size_t k = 0; k < program.numOutputs(); ++k) {
+                    auto lit = program.output(k);
+                    polarity[Program::slotOf(lit)] |= Program::isComplemented(lit) ? NEGATIVE : POSITIVE;
+                }
+                for (auto slot = program.size(); slot-- > 1;) {
+                    const auto &inst = program.instruction(slot);
+                    auto p = polarity[slot];
+                    if (inst.op != Program::OP_AND || p == 0)
+                        continue;
+                    if (encoding == CnfEncoding::TSEITIN)
+                        p = polarity[slot] = POSITIVE | NEGATIVE;
+                    auto flipped = static_cast<std::uint8_t>(((p & POSITIVE) << 1) | ((p & NEGATIVE) >> 1));
+                    const unsigned *lits = program.fanins(slot);
+                    for (unsigned i = 0; i < inst.count; ++i)
+                        polarity[Program::slotOf(lits[i])] |= Program::isComplemented(lits[i]) ? flipped : p;
+                }
+
+                for (std::size_t i = 0; i < program.numInputs(); ++i)
+                    vars[program.inputSlot(i)] = ++num_vars;
+                for (std::size_t slot = 1; slot < program.size(); ++slot) {
+                    if (program.instruction(slot).op == Program::OP_AND && polarity[slot])
+                        vars[slot] = ++num_vars;
+                }
+            }
+
+            std::int64_t numVars() const { return num_vars; }
+
+            /**
+             * Hand every clause to emit(literals, size), without the false constants and
+             * skipping the clauses a true constant satisfies.
+             */
+            template<typename Emit>
+            void forEachClause(Emit emit) {
+                for (std::size_t slot = 1; slot < program.size(); ++slot) {
+                    const auto &inst = program.instruction(slot);
+                    if (inst.op != Program::OP_AND || polarity[slot] == 0)
+                        continue;
+                    auto y = vars[slot];
+                    const unsigned *lits = program.fanins(slot);
+                    if (polarity[slot] & POSITIVE) {
+                        // y -> li
+                        for (unsigned i = 0; i < inst.count; ++i) {
+                            clause.assign(1, -y);
+                            if (append(lits[i]))
+                                emit(clause.data(), clause.size());
+                        }
+                    }
+                    if (polarity[slot] & NEGATIVE) {
+                        // l1 & ... & ln -> y
+                        clause.assign(1, y);
+                        bool keep = true;
+                        for (unsigned i = 0; i < inst.count && keep; ++i)
+                            keep = append(lits[i] ^ 1u);
+                        if (keep)
+                            emit(clause.data(), clause.size());
+                    }
+                }
+                for (std::size_t k = 0; k < program.numOutputs(); ++k) {
+                    clause.clear();
+                    if (append(program.output(k)))
+                        emit(clause.data(), clause.size());
+                }
+            }
+
+        private:
+            const Program &program;
+            std::vector<std::uint8_t> polarity;
+            std::vector<std::int64_t> vars;
+            std::int64_t num_vars = 0;
+            std::vector<std::int64_t> clause;
+
+            /**
+             * @return false if the literal is the true constant.
+             */
+            bool append(unsigned lit) {
+                auto slot = Program::slotOf(lit);
+                if (slot == 0)
+                    return !Program::isComplemented(lit);
+                clause.push_back(Program::isComplemented(lit) ? -vars[slot] : vars[slot]);
+                return true;
+            }
+        };
+    }// namespace
+
+    CnfStats writeDimacs(std::ostream &out, const Program &program, CnfEncoding encoding) {
+        CnfEncoder encoder(program, encoding);
+        CnfStats stats;
+        stats.num_vars = static_cast<std::size_t>(encoder.numVars());
+        encoder.forEachClause([&stats](const std::int64_t *, std::size_t) { ++stats.num_clauses; });
+
+        DimacsBuffer buffer(out);
+        for (std::size_t i = 0; i < program.numInputs(); ++i) {
+            std::ostringstream name;
+            name << program.input(i);
+            buffer.put("c input ");
+            buffer.put(static_cast<std::int64_t>(i + 1));
+            buffer.put(' ');
+            buffer.put(name.str());
+            buffer.put('\n');
+        }
+        buffer.put("p cnf ");
+        buffer.put(static_cast<std::int64_t>(stats.num_vars));
+        buffer.put(' ');
+        buffer.put(static_cast<std::int64_t>(stats.num_clauses));
+        buffer.put('\n');
+        encoder.forEachClause([&buffer](const std::int64_t *lits, std::size_t size) {
+            for (std::size_t i = 0; i < size; ++i) {
+                buffer.put(lits[i]);
+                buffer.put(' ');
+            }
+            buffer.put('0');
+            buffer.put('\n');
+        });
+        buffer.flush();
+        return stats;
+    }
+
+    CnfStats writeDimacs(std::ostream &out, const std::vector<Expr> &roots, CnfEncoding encoding) {
+        return writeDimacs(out, compile(roots), encoding);
+    }
+
+    CnfStats writeDimacs(const std::string &path, const std::vector<Expr> &roots, CnfEncoding encoding) {
+        std::ofstream out(path, std::ios::binary);
+        if (!out)
+            throw std::runtime_error("writeDimacs(): cannot open " + path);
+        auto stats = writeDimacs(out, roots, encoding);
+        if (!out.flush())
+            throw std::runtime_error("writeDimacs(): cannot write " + path);
+        return stats;
+    }
+
+    namespace {
+        /**
+         * A hand-rolled scanner: DIMACS files are large and made almost only of integers.
+         */
+        class DimacsScanner {
+        public:
+            DimacsScanner(const char *data, std::size_t size) : begin(data), p(data), end(data + size) {}
+
+            CnfFormula parse() {
+                CnfFormula cnf;
+                std::size_t max_var = 0;
+                bool header = false;
+                while (true) {
+                    skipSpaces();
+                    if (p == end || *p == '%')
+                        break;
+                    if (*p == 'c') {
+                        skipLine();
+                    } else if (*p == 'p') {
+                        if (header)
+                            fail("a second header");
+                        header = true;
+                        ++p;
+                        skipSpaces();
+                        if (end - p < 3 || p[0] != 'c' || p[1] != 'n' || p[2] != 'f')
+                            fail("a header other than p cnf");
+                        p += 3;
+                        cnf.num_vars = readUnsigned();
+                        auto num_clauses = readUnsigned();
+                        // about three literals per clause, but never more than the rest of the
+                        // input can hold, two bytes per literal or clause: the header is not
+                        // to be trusted
+                        auto room = static_cast<std::size_t>(end - p) / 2;
+                        cnf.offsets.reserve(std::min(num_clauses, room) + 1);
+                        cnf.literals.reserve(std::min(3 * std::min(num_clauses, room), room));
+                    } else {
+                        bool negative = *p == '-';
+                        if (negative)
+                            ++p;
+                        auto v = readUnsigned();
+                        if (v > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()))
+                            fail("a literal out of range");
+                        if (v == 0) {
+                            if (negative)
+                                fail("-0");
+                            cnf.offsets.push_back(cnf.literals.size());
+                        } else {
+                            max_var = std::max(max_var, v);
+                            auto lit = static_cast<std::int32_t>(v);
+                            cnf.literals.push_back(negative ? -lit : lit);
+                        }
+                    }
+                }
+                if (cnf.literals.size() != cnf.offsets.back())
+                    cnf.offsets.push_back(cnf.literals.size());
+                cnf.num_vars = std::max(cnf.num_vars, max_var);
+                return cnf;
+            }
+
+        private:
+            const char *begin;
+            const char *p;
+            const char *end;
+
+            void skipSpaces() {
+                while (p != end && (*p == ' ' || *p == '\n' || *p == '\t' || *p == '\r'))
+                    ++p;
+            }
+
+            void skipLine() {
+                while (p != end && *p != '\n')
+                    ++p;
+            }
+
+            std::size_t readUnsigned() {
+                skipSpaces();
+                if (p == end || *p < '0' || *p > '9')
+                    fail("an unexpected character");
+                std::size_t v = 0;
+                while (p != end && *p >= '0' && *p <= '9') {
+                    v = 10 * v + static_cast<std::size_t>(*p++ - '0');
+                    if (v > std::numeric_limits<std::uint32_t>::max())
+                        fail("a number out of range");
+                }
+                return v;
+            }
+
+            [[noreturn]] void fail(const char *what) const {
+                std::size_t line = 1 + static_cast<std::size_t>(std::count(begin, p, '\n'));
+                throw std::runtime_error(std::string("parseDimacs(): ") + what + " at line " + std::to_string(line));
+            }
+        };
+    }// namespace
+
+    CnfFormula parseDimacs(const char *data, std::size_t size) {
+        return DimacsScanner(data, size).parse();
+    }
+
+#ifdef _WIN32
+    CnfFormula readDimacs(const std::string &path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            throw std::runtime_error("readDimacs(): cannot open " + path);
+        std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        return parseDimacs(text.data(), text.size());
+    }
+#else
+    CnfFormula readDimacs(const std::string &path) {
+        struct MappedFile {
+            int fd = -1;
+            void *data = MAP_FAILED;
+            std::size_t size = 0;
+
+            ~MappedFile() {
+                if (data != MAP_FAILED)
+                    munmap(data, size);
+                if (fd >= 0)
+                    close(fd);
+            }
+        } file;
+
+        file.fd = open(path.c_str(), O_RDONLY);
+        struct stat info {};
+        if (file.fd < 0 || fstat(file.fd, &info) != 0)
+            throw std::runtime_error("readDimacs(): cannot open " + path);
+        file.size = static_cast<std::size_t>(info.st_size);
+        if (file.size == 0)
+            return CnfFormula();
+        file.data = mmap(nullptr, file.size, PROT_READ, MAP_PRIVATE, file.fd, 0);
+        if (file.data == MAP_FAILED)
+            throw std::runtime_error("readDimacs(): cannot map " + path);
+        madvise(file.data, file.size, MADV_SEQUENTIAL);
+        return parseDimacs(static_cast<const char *>(file.data), file.size);
+    }
+#endif
+
+    Expr toExpr(const CnfFormula &cnf, std::vector<Expr> symbols) {
+        // the variables that occur, the declared count being untrusted
+        std::size_t max_var = 0;
+        for (auto lit: cnf.literals)
+            max_var = std::max(max_var, static_cast<std::size_t>(lit < 0 ? -static_cast<std::int64_t>(lit) : lit));
+        for (auto v = symbols.size(); v < max_var; ++v)
+            symbols.emplace_back(("x" + std::to_string(v + 1)).c_str());
+        std::vector<Expr> negations(symbols.size());
+
+        std::vector<Expr> clauses;
+        clauses.reserve(cnf.numClauses());
+        std::vector<Expr> operands;
+        for (std::size_t i = 0; i < cnf.numClauses(); ++i) {
+            operands.clear();
+            const auto *lits = cnf.clause(i);
+            for (std::size_t k = 0; k < cnf.clauseSize(i); ++k) {
+                auto v = static_cast<std::size_t>(lits[k] < 0 ? -lits[k] : lits[k]) - 1;
+                if (lits[k] > 0) {
+                    operands.push_back(symbols[v]);
+                } else {
+                    if (negations[v].isTrivial())
+                        negations[v] = !symbols[v];
+                    operands.push_back(negations[v]);
+                }
+            }
+            clauses.push_back(makeOr(operands));
+        }
+        return makeAnd(std::move(clauses));
+    }
+
+}// namespace jazz
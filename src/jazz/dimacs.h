@@ -0,0 +1,108 @@
+/**
+ * @file dimacs.h
+ *
+ * Reading and writing CNF in the DIMACS format.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_DIMACS_H
+#define BOOLEAN_ALGEBRA_DIMACS_H
+
+#include "expr.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace jazz {
+
+    class Program;
+
+    enum class CnfEncoding {
+        /// both implications for every gate, the models are exactly those of the expressions
+        TSEITIN,
+        /// only the implications the polarity of a gate needs, equisatisfiable and smaller
+        PLAISTED_GREENBAUM,
+    };
+
+    struct CnfStats {
+        std::size_t num_vars = 0;
+        std::size_t num_clauses = 0;
+    };
+
+    /**
+     * Write the CNF of the conjunction of some roots.
+     *
+     * The roots are compiled first, so every distinct shared node gets one auxiliary variable.
+     * Input i of the program is DIMACS variable i + 1, and a comment line before the header
+     * names it. The clauses are counted in a first pass over the program and formatted into a
+     * fixed-size buffer in the second one, so memory stays proportional to the program, never
+     * to the number of clauses.
+     */
+    CnfStats writeDimacs(std::ostream &out, const Program &program,
+                         CnfEncoding encoding = CnfEncoding::PLAISTED_GREENBAUM);
+    CnfStats writeDimacs(std::ostream &out, const std::vector<Expr> &roots,
+                         CnfEncoding encoding = CnfEncoding::PLAISTED_GREENBAUM);
+
+    /**
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    CnfStats writeDimacs(const std::string &path, const std::vector<Expr> &roots,
+                         CnfEncoding encoding = CnfEncoding::PLAISTED_GREENBAUM);
+
+    /**
+     * Clauses stored back to back in one array of DIMACS literals: clause i is
+     * literals[offsets[i]] up to literals[offsets[i + 1]].
+     */
+    struct CnfFormula {
+        std::size_t num_vars = 0;
+        std::vector<std::int32_t> literals;
+        std::vector<std::size_t> offsets{0};
+
+        std::size_t numClauses() const { return offsets.size() - 1; }
+        std::size_t clauseSize(std::size_t i) const { return offsets[i + 1] - offsets[i]; }
+        const std::int32_t *clause(std::size_t i) const { return literals.data() + offsets[i]; }
+    };
+
+    /**
+     * Parse DIMACS text. Comment lines are skipped, a final clause without its 0 is accepted,
+     * and so is a '%' line ending the data as in the SATLIB files.
+     * @throws std::runtime_error on malformed input, with the line number.
+     */
+    CnfFormula parseDimacs(const char *data, std::size_t size);
+
+    /**
+     * Read a DIMACS file, memory-mapped where the platform allows it.
+     * @throws std::runtime_error if the file cannot be read or is malformed.
+     */
+    CnfFormula readDimacs(const std::string &path);
+
+    /**
+     * The conjunction of the clauses as a single n-ary And of n-ary Ors.
+     * @param symbols  symbols[i] stands for DIMACS variable i + 1. Fresh symbols named x<i>
+     *                 are made for the variables beyond it that occur in a clause, so
+     *                 no more than the literals whatever the declared number of variables.
+     */
+    Expr toExpr(const CnfFormula &cnf, std::vector<Expr> symbols = {});
+
+}// namespace jazz
+
+#endif//BOOLEAN_ALGEBRA_DIMACS_H
@@ -0,0 +1,137 @@
+/**
+ * @file event_simulator.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "event_simulator.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace jazz {
+
+    EventSimulator::EventSimulator(Program program) : program(std::move(program)) {
+        const auto &prog = this->program;
+        const auto n = prog.size();
+        values.assign(n, 0);
+        levels.assign(n, 0);
+        scheduled.assign(n, 0);
+        fanout_start.assign(n + 1, 0);
+
+        // levels, and the fanout counts
+        unsigned max_level = 0;
+        for (std::size_t slot = 0; slot < n; ++slot) {
+            const auto &inst = prog.instruction(slot);
+            if (inst.op != Program::OP_AND)
+                continue;
+            unsigned level = 0;
+            const unsigned *lits = prog.fanins(slot);
+            for (unsigned i = 0; i < inst.count; ++i) {
+                auto fanin = Program::slotOf(lits[i]);
+                level = std::max(level, levels[fanin]);
+                ++fanout_start[fanin + 1];
+            }
+            levels[slot] = level + 1;
+            max_level = std::max(max_level, level + 1);
+        }
+        buckets.resize(max_level + 1);
+
+        // fanout lists in compressed rows
+        for (std::size_t slot = 0; slot < n; ++slot)
+            fanout_start[slot + 1] += fanout_start[slot];
+        fanouts.resize(fanout_start[n]);
+        std::vector<unsigned> fill(fanout_start.begin(), fanout_start.end() - 1);
+        for (std::size_t slot = 0; slot < n; ++slot) {
+            const auto &inst = prog.instruction(slot);
+            if (inst.op != Program::OP_AND)
+                continue;
+            const unsigned *lits = prog.fanins(slot);
+            for (unsigned i = 0; i < inst.count; ++i)
+                fanouts[fill[Program::slotOf(lits[i])]++] = static_cast<unsigned>(slot);
+        }
+
+        // initial values, all inputs are false
+        for (std::size_t slot = 0; slot < n; ++slot) {
+            if (prog.instruction(slot).op == Program::OP_AND)
+                values[slot] = evaluate(static_cast<unsigned>(slot));
+        }
+    }
+
+    void EventSimulator::setInput(std::size_t i, bool v) {
+        if (i >= program.numInputs())
+            throw std::out_of_range("EventSimulator::setInput(): input index out of range");
+
+        auto slot = program.inputSlot(i);
+        if (bool(values[slot]) == v)
+            return;
+        values[slot] = v;
+        scheduleFanouts(slot);
+    }
+
+    void EventSimulator::setInput(const Expr &symbol, bool v) {
+        int i = program.inputIndex(symbol);
+        if (i < 0)
+            throw std::invalid_argument("EventSimulator::setInput(): not an input of the program");
+        setInput(static_cast<std::size_t>(i), v);
+    }
+
+    void EventSimulator::propagate() {
+        // fanouts always have a higher level, so a single sweep over the levels is enough.
+        for (std::size_t level = 1; level < buckets.size() && pending > 0; ++level) {
+            auto &bucket = buckets[level];
+            // the bucket can not grow while being processed.
+            for (std::size_t j = 0; j < bucket.size(); ++j) {
+                unsigned slot = bucket[j];
+                scheduled[slot] = 0;
+                --pending;
+                ++num_evaluations;
+                char v = evaluate(slot);
+                if (v != values[slot]) {
+                    values[slot] = v;
+                    scheduleFanouts(slot);
+                }
+            }
+            bucket.clear();
+        }
+    }
+
+    void EventSimulator::schedule(unsigned slot) {
+        if (scheduled[slot])
+            return;
+        scheduled[slot] = 1;
+        buckets[levels[slot]].push_back(slot);
+        ++pending;
+    }
+
+    void EventSimulator::scheduleFanouts(unsigned slot) {
+        for (auto i = fanout_start[slot]; i < fanout_start[slot + 1]; ++i)
+            schedule(fanouts[i]);
+    }
+
+    bool EventSimulator::evaluate(unsigned slot) const {
+        const auto &inst = program.instruction(slot);
+        const unsigned *lits = program.fanins(slot);
+        for (unsigned i = 0; i < inst.count; ++i) {
+            if (!(values[Program::slotOf(lits[i])] ^ Program::isComplemented(lits[i])))
+                return false;
+        }
+        return true;
+    }
+
+}// namespace jazz
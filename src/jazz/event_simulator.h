@@ -0,0 +1,107 @@
+/**
+ * @file event_simulator.h
+ *
+ * Event-driven incremental evaluation of compiled programs.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_EVENT_SIMULATOR_H
+#define BOOLEAN_ALGEBRA_EVENT_SIMULATOR_H
+
+#include "compiler.h"
+
+#include <vector>
+
+namespace jazz {
+
+    /**
+     * Keeps the value of every node of a program and updates them when inputs change.
+     *
+     * A changed input schedules its fanouts, the fanouts are re-evaluated level by level and
+     * only the nodes whose value really changed schedule their own fanouts. The cost of a
+     * toggle is thus bounded by the part of the fanout cone that changes, not by the size of
+     * the program.
+     */
+    class EventSimulator {
+    public:
+        /**
+         * Build the fanout lists and levels, and evaluate the program with all inputs false.
+         * @param program
+         */
+        explicit EventSimulator(Program program);
+
+        const Program &getProgram() const { return program; }
+
+        /**
+         * Change an input. The change is propagated lazily, on the next read or propagate().
+         * @param i  The input index.
+         * @param v
+         */
+        void setInput(std::size_t i, bool v);
+
+        /**
+         * Change the input bound to a symbol.
+         */
+        void setInput(const Expr &symbol, bool v);
+
+        void toggleInput(std::size_t i) { setInput(i, !input(i)); }
+
+        bool input(std::size_t i) const { return values[program.inputSlot(i)]; }
+
+        /**
+         * Propagate all the pending input changes.
+         */
+        void propagate();
+
+        bool output(std::size_t k) { return value(program.output(k)); }
+
+        /**
+         * Read the value of a literal of the program.
+         */
+        bool value(unsigned lit) {
+            if (pending)
+                propagate();
+            return values[Program::slotOf(lit)] ^ Program::isComplemented(lit);
+        }
+
+        /**
+         * Number of node evaluations done by propagate() so far.
+         */
+        std::size_t evaluations() const { return num_evaluations; }
+
+    private:
+        void schedule(unsigned slot);
+        void scheduleFanouts(unsigned slot);
+        bool evaluate(unsigned slot) const;
+
+    private:
+        Program program;
+        std::vector<char> values;
+        std::vector<unsigned> levels;
+        std::vector<unsigned> fanout_start;
+        std::vector<unsigned> fanouts;
+        std::vector<std::vector<unsigned>> buckets;
+        std::vector<char> scheduled;
+        std::size_t pending = 0;
+        std::size_t num_evaluations = 0;
+    };
+
+}// namespace jazz
+
+#endif//BOOLEAN_ALGEBRA_EVENT_SIMULATOR_H
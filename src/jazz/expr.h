@@ -84,6 +84,7 @@ namespace jazz {
 
         int compare(const Expr &other) const;
         unsigned hashValue() const { return ptr->hashValue(); }
+        Signature signature() const { return ptr->signatureValue(); }
         void share(const Expr &other) const;
 
         // access to operands
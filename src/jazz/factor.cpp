@@ -0,0 +1,660 @@
+/**
+ * @file factor.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "factor.h"
+#include "op_and.h"
+#include "op_not.h"
+#include "op_or.h"
+#include "operations.h"
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <unordered_map>
+
+namespace jazz {
+
+    namespace algebraic {
+
+        namespace {
+
+            bool contains(const Cube &cube, const Cube &divisor) {
+                return std::includes(cube.begin(), cube.end(), divisor.begin(), divisor.end());
+            }
+
+            Cube without(const Cube &cube, const Cube &divisor) {
+                Cube result;
+                std::set_difference(cube.begin(), cube.end(), divisor.begin(), divisor.end(), std::back_inserter(result));
+                return result;
+            }
+
+            Cube product(const Cube &a, const Cube &b) {
+                Cube result;
+                std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+                return result;
+            }
+
+            /**
+             * Whether a sorted sum of products has a cube.
+             */
+            bool has(const Sop &sorted, const Cube &cube) {
+                return std::binary_search(sorted.begin(), sorted.end(), cube);
+            }
+
+            void findKernels(const Sop &g, const Cube &co_kernel, const std::vector<unsigned> &literals, std::size_t start,
+                             std::vector<Kernel> &result, std::size_t max_kernels) {
+                for (auto i = start; i < literals.size() && result.size() < max_kernels; ++i) {
+                    Sop quotient;
+                    for (const auto &cube: g) {
+                        if (std::binary_search(cube.begin(), cube.end(), literals[i]))
+                            quotient.push_back(without(cube, {literals[i]}));
+                    }
+                    if (quotient.size() < 2)
+                        continue;
+                    auto common = commonCube(quotient);
+                    // found before from the quotient by an earlier literal
+                    bool seen = std::any_of(common.begin(), common.end(), [&](unsigned lit) {
+                        return std::lower_bound(literals.begin(), literals.end(), lit) - literals.begin() <
+                               static_cast<std::ptrdiff_t>(i);
+                    });
+                    if (seen)
+                        continue;
+                    for (auto &cube: quotient)
+                        cube = without(cube, common);
+                    std::sort(quotient.begin(), quotient.end());
+                    findKernels(quotient, product(product(co_kernel, {literals[i]}), common), literals, i + 1, result,
+                                max_kernels);
+                }
+                if (result.size() < max_kernels)
+                    result.push_back({co_kernel, g});
+            }
+
+        }// namespace
+
+        std::size_t numLiterals(const Sop &f) {
+            std::size_t count = 0;
+            for (const auto &cube: f)
+                count += cube.size();
+            return count;
+        }
+
+        Sop normalized(Sop f) {
+            std::sort(f.begin(), f.end(), [](const Cube &a, const Cube &b) {
+                return a.size() < b.size() || (a.size() == b.size() && a < b);
+            });
+            f.erase(std::unique(f.begin(), f.end()), f.end());
+            Sop result;
+            for (auto &cube: f) {
+                // the smaller cubes come first
+                if (std::none_of(result.begin(), result.end(), [&](const Cube &c) { return contains(cube, c); }))
+                    result.push_back(std::move(cube));
+            }
+            std::sort(result.begin(), result.end());
+            return result;
+        }
+
+        Sop multiply(const Sop &f, const Sop &g) {
+            Sop result;
+            result.reserve(f.size() * g.size());
+            for (const auto &a: f) {
+                for (const auto &b: g)
+                    result.push_back(product(a, b));
+            }
+            return normalized(std::move(result));
+        }
+
+        std::pair<Sop, Sop> divide(const Sop &f, const Sop &d) {
+            if (d.empty())
+                return {{}, f};
+            Sop quotient;
+            for (std::size_t i = 0; i < d.size(); ++i) {
+                Sop partial;
+                for (const auto &cube: f) {
+                    if (contains(cube, d[i]))
+                        partial.push_back(without(cube, d[i]));
+                }
+                std::sort(partial.begin(), partial.end());
+                if (i == 0) {
+                    quotient = std::move(partial);
+                } else {
+                    Sop common;
+                    std::set_intersection(quotient.begin(), quotient.end(), partial.begin(), partial.end(),
+                                          std::back_inserter(common));
+                    quotient = std::move(common);
+                }
+                if (quotient.empty())
+                    return {{}, f};
+            }
+            Sop covered;
+            for (const auto &q: quotient) {
+                for (const auto &cube: d)
+                    covered.push_back(product(q, cube));
+            }
+            std::sort(covered.begin(), covered.end());
+            Sop remainder;
+            for (const auto &cube: f) {
+                if (!has(covered, cube))
+                    remainder.push_back(cube);
+            }
+            return {quotient, remainder};
+        }
+
+        Cube commonCube(const Sop &f) {
+            if (f.empty())
+                return {};
+            Cube common = f[0];
+            for (std::size_t i = 1; i < f.size() && !common.empty(); ++i) {
+                Cube both;
+                std::set_intersection(common.begin(), common.end(), f[i].begin(), f[i].end(), std::back_inserter(both));
+                common = std::move(both);
+            }
+            return common;
+        }
+
+        std::vector<Kernel> kernels(const Sop &f, std::size_t max_kernels) {
+            std::vector<Kernel> result;
+            if (f.size() < 2)
+                return result;
+            std::vector<unsigned> literals;
+            for (const auto &cube: f)
+                literals.insert(literals.end(), cube.begin(), cube.end());
+            std::sort(literals.begin(), literals.end());
+            literals.erase(std::unique(literals.begin(), literals.end()), literals.end());
+            auto common = commonCube(f);
+            Sop g;
+            for (const auto &cube: f)
+                g.push_back(without(cube, common));
+            std::sort(g.begin(), g.end());
+            findKernels(g, common, literals, 0, result, max_kernels);
+            return result;
+        }
+
+    }// namespace algebraic
+
+    namespace {
+
+        using algebraic::Cube;
+        using algebraic::Sop;
+        using algebraic::numLiterals;
+        using algebraic::normalized;
+
+        /**
+         * Sums of products over variables, each one an atom or a node.
+         */
+        struct Network {
+            std::vector<Expr> atoms;///< the expression of each variable that is an atom
+            std::vector<bool> is_node;
+            std::vector<Sop> functions;
+            std::vector<unsigned> outputs;///< literals
+
+            unsigned addVar(bool node, Sop function = {}, Expr atom = Expr()) {
+                atoms.push_back(std::move(atom));
+                is_node.push_back(node);
+                functions.push_back(std::move(function));
+                return static_cast<unsigned>(functions.size() - 1);
+            }
+
+            std::size_t numLiterals() const {
+                std::size_t count = 0;
+                for (std::size_t v = 0; v < functions.size(); ++v) {
+                    if (is_node[v])
+                        count += algebraic::numLiterals(functions[v]);
+                }
+                return count;
+            }
+
+            /**
+             * Divide a node by the function of var and use var, if that saves literals.
+             */
+            bool substitute(unsigned node, unsigned var) {
+                auto &f = functions[node];
+                auto [quotient, remainder] = algebraic::divide(f, functions[var]);
+                if (quotient.empty())
+                    return false;
+                for (auto &cube: quotient)
+                    remainder.push_back(algebraic::product(cube, {2 * var}));
+                auto result = normalized(std::move(remainder));
+                if (algebraic::numLiterals(result) >= algebraic::numLiterals(f))
+                    return false;
+                f = std::move(result);
+                return true;
+            }
+
+            /**
+             * Replace the nodes that are a single literal by it.
+             */
+            void collapseBuffers() {
+                std::vector<unsigned> alias(functions.size());
+                for (unsigned v = 0; v < functions.size(); ++v) {
+                    alias[v] = 2 * v;
+                    const auto &f = functions[v];
+                    if (is_node[v] && f.size() == 1 && f[0].size() == 1)
+                        alias[v] = f[0][0];
+                }
+                auto resolve = [&](unsigned lit) {
+                    while (alias[lit / 2] != 2 * (lit / 2))
+                        lit = alias[lit / 2] ^ (lit & 1u);
+                    return lit;
+                };
+                for (unsigned v = 0; v < functions.size(); ++v) {
+                    if (!is_node[v] || alias[v] != 2 * v)
+                        continue;
+                    for (auto &cube: functions[v]) {
+                        for (auto &lit: cube)
+                            lit = resolve(lit);
+                        std::sort(cube.begin(), cube.end());
+                    }
+                    functions[v] = normalized(std::move(functions[v]));
+                }
+                for (auto &lit: outputs)
+                    lit = resolve(lit);
+                for (unsigned v = 0; v < functions.size(); ++v) {
+                    if (is_node[v] && alias[v] != 2 * v) {
+                        is_node[v] = false;
+                        functions[v].clear();
+                    }
+                }
+            }
+        };
+
+        /**
+         * Read expressions into a network.
+         */
+        class NetworkBuilder {
+        public:
+            NetworkBuilder(Network &network, std::size_t max_cubes) : network(network), max_cubes(max_cubes) {}
+
+            void addOutput(const Expr &e) {
+                if (e.isTrivial())
+                    network.outputs.push_back(2 * network.addVar(true, e.trivialValue() ? Sop{Cube{}} : Sop{}));
+                else if (isOperator(e))
+                    network.outputs.push_back(2 * nodeOf(e));
+                else
+                    network.outputs.push_back(2 * atomOf(e));
+            }
+
+            void countReferences(const Expr &e) {
+                if (!isOperator(e) || references[e]++ > 0)
+                    return;
+                for (std::size_t i = 0; i < e.numOperands(); ++i)
+                    countReferences(e.operand(i));
+            }
+
+        private:
+            static bool isOperator(const Expr &e) {
+                return !e.isTrivial() && (is_a<And>(e) || is_a<Or>(e) || is_a<Not>(e));
+            }
+
+            unsigned atomOf(const Expr &e) {
+                auto it = atom_vars.find(e);
+                if (it != atom_vars.end())
+                    return it->second;
+                auto var = network.addVar(false, {}, e);
+                atom_vars.emplace(e, var);
+                return var;
+            }
+
+            unsigned nodeOf(const Expr &e) {
+                auto it = node_vars.find(e);
+                if (it != node_vars.end())
+                    return it->second;
+                return addNode(e, sopOf(e, true));
+            }
+
+            unsigned addNode(const Expr &e, Sop function) {
+                auto var = network.addVar(true, std::move(function));
+                node_vars.emplace(e, var);
+                return var;
+            }
+
+            /**
+             * A shared subexpression: a node unless it is a single product, which stays in
+             * the products using it so that their containment shows.
+             */
+            Sop sharedSopOf(const Expr &e) {
+                auto it = node_vars.find(e);
+                if (it != node_vars.end())
+                    return {{2 * it->second}};
+                auto product = products.find(e);
+                if (product != products.end())
+                    return {product->second};
+                auto function = sopOf(e, true);
+                if (function.size() == 1) {
+                    products.emplace(e, function[0]);
+                    return function;
+                }
+                if (function.empty())
+                    return function;
+                return {{2 * addNode(e, std::move(function))}};
+            }
+
+            Sop sopOf(const Expr &e, bool root) {
+                if (e.isTrivial())
+                    return e.trivialValue() ? Sop{Cube{}} : Sop{};
+                if (!isOperator(e))
+                    return {{2 * atomOf(e)}};
+                if (!root && references[e] > 1)
+                    return sharedSopOf(e);
+                if (is_a<Not>(e)) {
+                    const auto &x = e.operand(0);
+                    if (x.isTrivial())
+                        return x.trivialValue() ? Sop{} : Sop{Cube{}};
+                    return {{2 * (isOperator(x) ? nodeOf(x) : atomOf(x)) + 1}};
+                }
+                if (is_a<Or>(e)) {
+                    Sop result;
+                    for (std::size_t i = 0; i < e.numOperands(); ++i) {
+                        auto operand = sopOf(e.operand(i), false);
+                        result.insert(result.end(), operand.begin(), operand.end());
+                    }
+                    return normalized(std::move(result));
+                }
+                Sop result{Cube{}};
+                for (std::size_t i = 0; i < e.numOperands(); ++i) {
+                    auto operand = sopOf(e.operand(i), false);
+                    if (operand.size() > 1 && result.size() * operand.size() > max_cubes)
+                        operand = {{2 * nodeOf(e.operand(i))}};
+                    Sop expanded;
+                    for (const auto &a: result) {
+                        for (const auto &b: operand) {
+                            auto cube = algebraic::product(a, b);
+                            // x & !x
+                            bool contradiction = false;
+                            for (std::size_t k = 1; k < cube.size() && !contradiction; ++k)
+                                contradiction = (cube[k] ^ cube[k - 1]) == 1u;
+                            if (!contradiction)
+                                expanded.push_back(std::move(cube));
+                        }
+                    }
+                    result = normalized(std::move(expanded));
+                }
+                return result;
+            }
+
+            Network &network;
+            std::size_t max_cubes;
+            std::unordered_map<Expr, unsigned, ExprHash, ExprEqual> references, atom_vars, node_vars;
+            std::unordered_map<Expr, Cube, ExprHash, ExprEqual> products;
+        };
+
+        /**
+         * Greedy extraction of divisors, each one a new node.
+         */
+        class Extractor {
+        public:
+            Extractor(Network &network, const ExtractOptions &options, ExtractStats &stats)
+                : network(network), options(options), stats(stats) {}
+
+            void extractKernels() {
+                std::vector<std::vector<Sop>> cache(network.functions.size());
+                std::vector<bool> valid(network.functions.size());
+                for (;;) {
+                    std::map<Sop, std::vector<unsigned>> occurrences;
+                    for (unsigned v = 0; v < network.functions.size(); ++v) {
+                        if (!network.is_node[v])
+                            continue;
+                        if (!valid[v]) {
+                            cache[v].clear();
+                            for (auto &k: algebraic::kernels(network.functions[v], options.max_kernels))
+                                cache[v].push_back(std::move(k.kernel));
+                            valid[v] = true;
+                        }
+                        for (const auto &kernel: cache[v])
+                            occurrences[kernel].push_back(v);
+                    }
+                    const Sop *best = nullptr;
+                    long best_gain = 0;
+                    for (auto &[kernel, nodes]: occurrences) {
+                        if (nodes.size() < 2)
+                            continue;
+                        nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+                        auto gain = gainOf(kernel, nodes);
+                        if (gain > best_gain) {
+                            best_gain = gain;
+                            best = &kernel;
+                        }
+                    }
+                    if (!best)
+                        return;
+                    auto var = network.addVar(true, *best);
+                    for (unsigned v = 0; v < var; ++v) {
+                        if (network.is_node[v] && network.substitute(v, var))
+                            valid[v] = false;
+                    }
+                    cache.emplace_back();
+                    valid.push_back(false);
+                    ++stats.kernels;
+                }
+            }
+
+            void extractCubes() {
+                for (;;) {
+                    // two-cube divisors, by an estimate of their value from all pairs of cubes
+                    std::map<Sop, Candidate> divisors;
+                    std::map<std::pair<unsigned, unsigned>, long> pairs;
+                    for (unsigned v = 0; v < network.functions.size(); ++v) {
+                        if (!network.is_node[v])
+                            continue;
+                        const auto &f = network.functions[v];
+                        std::size_t budget = options.max_pairs;
+                        for (std::size_t i = 0; i < f.size() && budget; ++i) {
+                            for (std::size_t j = i + 1; j < f.size() && budget; ++j, --budget) {
+                                Cube base;
+                                std::set_intersection(f[i].begin(), f[i].end(), f[j].begin(), f[j].end(),
+                                                      std::back_inserter(base));
+                                Sop divisor{algebraic::without(f[i], base), algebraic::without(f[j], base)};
+                                std::sort(divisor.begin(), divisor.end());
+                                auto &entry = divisors[divisor];
+                                entry.estimate += static_cast<long>(base.size() + numLiterals(divisor)) - 1;
+                                if (entry.nodes.empty() || entry.nodes.back() != v)
+                                    entry.nodes.push_back(v);
+                            }
+                            for (std::size_t a = 0; a < f[i].size(); ++a) {
+                                for (std::size_t b = a + 1; b < f[i].size(); ++b)
+                                    ++pairs[{f[i][a], f[i][b]}];
+                            }
+                        }
+                    }
+
+                    // the exact value of the most promising ones
+                    std::vector<std::pair<const Sop *, const Candidate *>> ranked;
+                    for (const auto &[divisor, candidate]: divisors) {
+                        if (candidate.estimate > static_cast<long>(numLiterals(divisor)))
+                            ranked.emplace_back(&divisor, &candidate);
+                    }
+                    auto top = std::min<std::size_t>(ranked.size(), MAX_EVALUATED);
+                    std::partial_sort(ranked.begin(), ranked.begin() + static_cast<std::ptrdiff_t>(top), ranked.end(),
+                                      [](const auto &a, const auto &b) { return a.second->estimate > b.second->estimate; });
+                    const Sop *best = nullptr;
+                    long best_gain = 0;
+                    for (std::size_t k = 0; k < top; ++k) {
+                        auto gain = gainOf(*ranked[k].first, ranked[k].second->nodes);
+                        if (gain > best_gain) {
+                            best_gain = gain;
+                            best = ranked[k].first;
+                        }
+                    }
+                    // a product of two literals saves one in every cube with both
+                    std::pair<unsigned, unsigned> best_pair;
+                    bool pair_wins = false;
+                    for (const auto &[pair, count]: pairs) {
+                        if (count - 2 > best_gain) {
+                            best_gain = count - 2;
+                            best_pair = pair;
+                            pair_wins = true;
+                        }
+                    }
+                    if (pair_wins) {
+                        auto var = network.addVar(true, {{best_pair.first, best_pair.second}});
+                        Cube divisor{best_pair.first, best_pair.second};
+                        for (unsigned v = 0; v < var; ++v) {
+                            if (!network.is_node[v])
+                                continue;
+                            for (auto &cube: network.functions[v]) {
+                                if (algebraic::contains(cube, divisor))
+                                    cube = algebraic::product(algebraic::without(cube, divisor), {2 * var});
+                            }
+                            network.functions[v] = normalized(std::move(network.functions[v]));
+                        }
+                    } else if (best) {
+                        auto var = network.addVar(true, *best);
+                        for (unsigned v = 0; v < var; ++v) {
+                            if (network.is_node[v])
+                                network.substitute(v, var);
+                        }
+                    } else {
+                        return;
+                    }
+                    ++stats.cubes;
+                }
+            }
+
+        private:
+            /**
+             * A two-cube divisor: the literals it would save in each pair of cubes it divides,
+             * counting a cube in several pairs several times, and the nodes of those pairs.
+             */
+            struct Candidate {
+                long estimate = 0;
+                std::vector<unsigned> nodes;
+            };
+
+            /**
+             * Two-cube divisors whose value is computed exactly, those of the best estimates.
+             */
+            static constexpr std::size_t MAX_EVALUATED = 8;
+
+            /**
+             * The literals saved by a new node for the divisor, in the nodes given.
+             */
+            long gainOf(const Sop &divisor, const std::vector<unsigned> &nodes) const {
+                auto gain = -static_cast<long>(numLiterals(divisor));
+                for (auto v: nodes) {
+                    const auto &f = network.functions[v];
+                    auto [quotient, remainder] = algebraic::divide(f, divisor);
+                    if (quotient.empty())
+                        continue;
+                    auto after = numLiterals(quotient) + quotient.size() + numLiterals(remainder);
+                    gain += static_cast<long>(numLiterals(f)) - static_cast<long>(after);
+                }
+                return gain;
+            }
+
+            Network &network;
+            const ExtractOptions &options;
+            ExtractStats &stats;
+        };
+
+        /**
+         * Write the network back as expressions, each node factored by its most frequent
+         * literals.
+         */
+        class ExprWriter {
+        public:
+            explicit ExprWriter(const Network &network)
+                : network(network), exprs(network.functions.size()), written(network.functions.size()) {}
+
+            Expr literal(unsigned lit) {
+                auto var = lit / 2;
+                if (!written[var]) {
+                    written[var] = true;
+                    exprs[var] = network.is_node[var] ? factor(network.functions[var]) : network.atoms[var];
+                }
+                return lit & 1u ? !exprs[var] : exprs[var];
+            }
+
+        private:
+            Expr product(const Cube &cube) {
+                std::vector<Expr> operands;
+                for (auto lit: cube)
+                    operands.push_back(literal(lit));
+                return makeAnd(std::move(operands));
+            }
+
+            Expr factor(const Sop &f) {
+                if (f.size() < 2)
+                    return f.empty() ? Expr(false) : product(f[0]);
+                std::map<unsigned, std::size_t> counts;
+                for (const auto &cube: f) {
+                    for (auto lit: cube)
+                        ++counts[lit];
+                }
+                auto best = std::max_element(counts.begin(), counts.end(),
+                                             [](const auto &a, const auto &b) { return a.second < b.second; });
+                if (best->second < 2) {
+                    std::vector<Expr> operands;
+                    for (const auto &cube: f)
+                        operands.push_back(product(cube));
+                    return makeOr(std::move(operands));
+                }
+                Sop quotient, remainder;
+                for (const auto &cube: f) {
+                    if (std::binary_search(cube.begin(), cube.end(), best->first))
+                        quotient.push_back(algebraic::without(cube, {best->first}));
+                    else
+                        remainder.push_back(cube);
+                }
+                auto common = algebraic::commonCube(quotient);
+                for (auto &cube: quotient)
+                    cube = algebraic::without(cube, common);
+                common = algebraic::product(common, {best->first});
+                auto factored = makeAnd({product(common), factor(normalized(std::move(quotient)))});
+                return remainder.empty() ? factored : makeOr({factored, factor(remainder)});
+            }
+
+            const Network &network;
+            std::vector<Expr> exprs;
+            std::vector<bool> written;
+        };
+
+    }// namespace
+
+    std::vector<Expr> extractDivisors(const std::vector<Expr> &outputs, const ExtractOptions &options,
+                                      ExtractStats *stats) {
+        Network network;
+        NetworkBuilder builder(network, options.max_cubes);
+        for (const auto &e: outputs)
+            builder.countReferences(e);
+        for (const auto &e: outputs)
+            builder.addOutput(e);
+        network.collapseBuffers();
+
+        ExtractStats local;
+        local.literals_before = network.numLiterals();
+        Extractor extractor(network, options, local);
+        if (options.kernels)
+            extractor.extractKernels();
+        if (options.cubes)
+            extractor.extractCubes();
+        network.collapseBuffers();
+        local.literals_after = network.numLiterals();
+        if (stats)
+            *stats = local;
+
+        ExprWriter writer(network);
+        std::vector<Expr> result;
+        result.reserve(outputs.size());
+        for (auto lit: network.outputs)
+            result.push_back(writer.literal(lit));
+        return result;
+    }
+
+}// namespace jazz
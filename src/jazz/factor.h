@@ -0,0 +1,127 @@
+/**
+ * @file factor.h
+ *
+ * Algebraic factoring: division of sums of products, kernels, and the extraction of divisors
+ * common to several outputs.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_FACTOR_H
+#define BOOLEAN_ALGEBRA_FACTOR_H
+
+#include "expr.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace jazz {
+
+    namespace algebraic {
+
+        /**
+         * A product of literals, sorted: literal 2 * v is variable v and 2 * v + 1 its
+         * complement.
+         */
+        using Cube = std::vector<unsigned>;
+
+        /**
+         * A sum of products, seen as a polynomial: x and !x are unrelated literals.
+         */
+        using Sop = std::vector<Cube>;
+
+        std::size_t numLiterals(const Sop &f);
+
+        /**
+         * The cubes in sorted order, without duplicates and without those containing another.
+         */
+        Sop normalized(Sop f);
+
+        /**
+         * The algebraic product, of two sums of products over disjoint variables for it to be
+         * the boolean one too.
+         */
+        Sop multiply(const Sop &f, const Sop &g);
+
+        /**
+         * Weak division: the largest quotient q with f = q * d + r, q and d over disjoint
+         * variables, and the remainder r.
+         */
+        std::pair<Sop, Sop> divide(const Sop &f, const Sop &d);
+
+        /**
+         * The largest cube dividing every cube of f, empty for a cube-free f.
+         */
+        Cube commonCube(const Sop &f);
+
+        /**
+         * A kernel of f, a cube-free quotient of f by a cube, the co-kernel.
+         */
+        struct Kernel {
+            Cube co_kernel;
+            Sop kernel;
+        };
+
+        /**
+         * The kernels of f, f itself among them if it is cube-free. Each one is found once, by
+         * dividing by the literals in increasing order and skipping the quotients whose common
+         * cube has a literal already tried.
+         * @param max_kernels  Stop after that many.
+         */
+        std::vector<Kernel> kernels(const Sop &f, std::size_t max_kernels = 10000);
+
+    }// namespace algebraic
+
+    struct ExtractOptions {
+        bool kernels = true;           ///< extract kernels common to several nodes, as gkx
+        bool cubes = true;             ///< extract two-cube and single-cube divisors, as fx
+        std::size_t max_cubes = 64;    ///< a subexpression expanding into more cubes stays a node
+        std::size_t max_kernels = 1000;///< kernels enumerated per node
+        std::size_t max_pairs = 20000; ///< pairs of cubes of a node looked at for divisors
+    };
+
+    struct ExtractStats {
+        std::size_t literals_before = 0;///< in the sums of products of the network read
+        std::size_t literals_after = 0; ///< in those of the network written
+        std::size_t kernels = 0;        ///< kernel divisors extracted
+        std::size_t cubes = 0;          ///< two-cube and single-cube divisors extracted
+    };
+
+    /**
+     * Rewrite the outputs over shared divisors, for fewer literals.
+     *
+     * The outputs become a network of sums of products over their atoms, the subexpressions
+     * that are not symbols, negations, conjunctions or disjunctions. A shared subexpression
+     * that is not a single product, or one whose product expands into more than max_cubes
+     * cubes, becomes a node of its own.
+     * Divisors are then extracted greedily, the one saving the most literals first, until
+     * none saves any: first kernels found in several nodes or several times in one, then
+     * pairs of cubes with their common cube removed and pairs of literals. Each divisor is a
+     * new node, and every node it divides algebraically uses it.
+     *
+     * The nodes are factored by their most frequent literals and rebuilt as expressions, each
+     * node once, so that a divisor is the same expression wherever it is used. A divisor that
+     * is a product merges back into the products using it, as conjunctions are flattened.
+     */
+    std::vector<Expr> extractDivisors(const std::vector<Expr> &outputs, const ExtractOptions &options = {},
+                                      ExtractStats *stats = nullptr);
+
+}// namespace jazz
+
+#endif//BOOLEAN_ALGEBRA_FACTOR_H
@@ -30,6 +30,8 @@ namespace jazz {
         STATUS_FLAG_NOT_SHAREABLE = 0x0008,
         STATUS_FLAG_EXPANDED = 0x0010,
         STATUS_FLAG_SIMPLIFIED = 0x0020,
+        STATUS_FLAG_SIGNATURE_CALCULATED = 0x0040,
+        STATUS_FLAG_SIGNATURE_STORED = 0x0080,///< the object has an entry in the signature table
     };
 
     /** Flags to control the behavior of subs(). */
@@ -64,6 +66,9 @@ namespace jazz {
         TYPE_FLAG_RELATIONAL_LESS_OR_EQUAL,
         TYPE_FLAG_RELATIONAL_GREATER,
         TYPE_FLAG_RELATIONAL_GREATER_OR_EQUAL,
+        TYPE_FLAG_REGISTER,
+        TYPE_FLAG_LATCH,
+        TYPE_FLAG_BITVEC,
     };
 }// namespace jazz
 
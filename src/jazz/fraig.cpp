@@ -0,0 +1,432 @@
+/**
+ * @file fraig.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "fraig.h"
+#include "sat.h"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace jazz {
+
+    namespace {
+
+        /**
+         * Builds a swept graph one node at a time.
+         *
+         * The candidate classes are keyed by the simulation of the nodes on the random patterns
+         * and on the words of counterexamples. The counterexamples are collected 64 at a time,
+         * and each full word is simulated once over the graph and splits the classes.
+         *
+         * Only the cones of the pairs tried are loaded into the solver, and the solver starts
+         * over once it holds more than MAX_LOADED nodes, so that propagation does not run
+         * through the whole graph.
+         */
+        class Sweeper {
+            static constexpr unsigned SCAN_PER_PROOF = 16;
+            static constexpr unsigned MAX_LOADED = 1u << 12;
+            static constexpr sat::Var NOT_LOADED = ~sat::Var(0);
+
+        public:
+            explicit Sweeper(const FraigOptions &options) : options(options), rng(options.seed) {
+                // the constant is a candidate too, for the gates that are constant
+                static_sims.assign(options.sim_words, 0);
+                pending.push_back(0);
+                reprs.push_back(Aig::FALSE_LIT);
+                cone_marks.push_back(0);
+                sat_vars.push_back(NOT_LOADED);
+                solver.setConflictLimit(options.conflict_limit);
+                keys.push_back(classKey(0));
+                classes[keys[0]].push_back(0);
+            }
+
+            Aig result;
+            FraigStats stats;
+
+            Aig::Lit addInput(const Expr &symbol) {
+                auto lit = result.addInput(symbol);
+                auto node = Aig::nodeOf(lit);
+                for (unsigned w = 0; w < options.sim_words; ++w)
+                    static_sims.push_back(rng());
+                // no counterexample so far sets it
+                for (auto &words: cex_sims)
+                    words.push_back(0);
+                pending.push_back(0);
+                reprs.push_back(lit);
+                cone_marks.push_back(0);
+                sat_vars.push_back(NOT_LOADED);
+                keys.push_back(classKey(node));
+                classes[keys[node]].push_back(node);
+                return lit;
+            }
+
+            Aig::Lit addAnd(Aig::Lit a, Aig::Lit b) {
+                auto before = result.numNodes();
+                auto lit = result.andOf(a, b);
+                auto node = Aig::nodeOf(lit);
+                if (result.numNodes() == before)
+                    return reprs[node] ^ (lit & 1u);
+
+                for (unsigned w = 0; w < options.sim_words; ++w)
+                    static_sims.push_back(valueOf(static_sims.data() + w, options.sim_words, a) &
+                                          valueOf(static_sims.data() + w, options.sim_words, b));
+                for (auto &words: cex_sims)
+                    words.push_back(valueOf(words.data(), 1, a) & valueOf(words.data(), 1, b));
+                pending.push_back(0);
+                cone_marks.push_back(0);
+                sat_vars.push_back(NOT_LOADED);
+                keys.push_back(classKey(node));
+
+                // the earliest members first, up to max_candidates proofs; the members told
+                // apart by simulation count too, at most SCAN_PER_PROOF of them per proof, so
+                // a large class is never scanned through. A counterexample may move the node to
+                // a smaller class.
+                auto key = keys[node];
+                std::size_t next = 0;
+                unsigned tries = 0;
+                for (unsigned scanned = 0; tries < options.max_candidates && scanned < SCAN_PER_PROOF * options.max_candidates;
+                     ++scanned) {
+                    if (keys[node] != key) {
+                        key = keys[node];
+                        next = 0;
+                    }
+                    auto it = classes.find(key);
+                    if (it == classes.end() || next >= it->second.size())
+                        break;
+                    auto candidate = it->second[next++];
+                    auto other = Aig::makeLit(candidate, (static_sims[node * options.sim_words] ^
+                                                          static_sims[candidate * options.sim_words]) & 1u);
+                    if (!sameSimulation(lit, other))
+                        continue;
+                    if (!samePending(lit, other)) {
+                        ++stats.refuted;
+                        continue;
+                    }
+                    ++tries;
+                    auto res = proveEqual(lit, other);
+                    if (res == sat::Result::UNSATISFIABLE) {
+                        ++stats.proved;
+                        reprs.push_back(other);
+                        return other;
+                    }
+                    if (res == sat::Result::SATISFIABLE)
+                        ++stats.refuted;
+                    else
+                        ++stats.undecided;
+                }
+                classes[keys[node]].push_back(node);
+                reprs.push_back(lit);
+                return lit;
+            }
+
+            /**
+             * Look for an assignment where two literals of the new graph differ. A
+             * counterexample is added to the simulation patterns.
+             */
+            sat::Result proveEqual(Aig::Lit x, Aig::Lit y) {
+                // only the cone of the pair is decided, the rest of what is loaded follows from it
+                loadCone(x, y);
+                auto p = satLit(x), q = satLit(y);
+                auto res = sat::Result::UNSATISFIABLE;
+                for (int phase = 0; phase < 2 && res == sat::Result::UNSATISFIABLE; ++phase) {
+                    res = solver.solve({p, sat::negate(q)});
+                    if (res == sat::Result::SATISFIABLE)
+                        addCounterexample();
+                    std::swap(p, q);
+                }
+                for (auto node: cone)
+                    solver.setDecisionVar(sat_vars[node], false);
+                return res;
+            }
+
+            void setConflictLimit(std::uint64_t limit) {
+                options.conflict_limit = limit;
+                solver.setConflictLimit(limit);
+            }
+
+        private:
+            FraigOptions options;
+            std::mt19937_64 rng;
+
+            std::vector<std::uint64_t> static_sims;           ///< sim_words words per node
+            std::vector<std::vector<std::uint64_t>> cex_sims;///< one word per node in each
+            std::vector<std::uint64_t> pending;               ///< by node, the counterexamples not simulated yet
+            unsigned pending_bits = 0;                        ///< their number
+            std::vector<unsigned> pending_stamps;             ///< by node, the version of its pending word
+            unsigned pending_version = 0;
+
+            std::vector<Aig::Lit> reprs;                                      ///< by node, the literal replacing it
+            std::vector<std::uint64_t> keys;                                  ///< by node, the hash of its simulation
+            std::unordered_map<std::uint64_t, std::vector<unsigned>> classes;///< candidates by simulation
+            sat::Solver solver;
+            std::vector<sat::Var> sat_vars;///< by node, its variable in the solver, or NOT_LOADED
+            std::vector<unsigned> loaded;  ///< the nodes with a variable
+
+            std::vector<unsigned> cone_marks;
+            std::vector<unsigned> cone;
+            unsigned stamp = 0;
+
+            sat::Lit satLit(Aig::Lit lit) const { return sat::makeLit(sat_vars[Aig::nodeOf(lit)], lit & 1u); }
+
+            /**
+             * Load the clauses of the cone of two literals that the solver does not hold yet,
+             * and make the nodes of the cone decision variables.
+             */
+            void loadCone(Aig::Lit x, Aig::Lit y) {
+                if (solver.numVars() > MAX_LOADED) {
+                    solver = sat::Solver();
+                    solver.setConflictLimit(options.conflict_limit);
+                    for (auto node: loaded)
+                        sat_vars[node] = NOT_LOADED;
+                    loaded.clear();
+                }
+                ++stamp;
+                cone.clear();
+                // in postorder, so that the fanins of a gate are loaded before it
+                std::vector<unsigned> stack{Aig::nodeOf(x), Aig::nodeOf(y)};
+                while (!stack.empty()) {
+                    auto node = stack.back();
+                    if (cone_marks[node] == stamp) {
+                        stack.pop_back();
+                        continue;
+                    }
+                    if (result.isAnd(node)) {
+                        bool ready = true;
+                        for (auto fanin: {Aig::nodeOf(result.fanin0(node)), Aig::nodeOf(result.fanin1(node))}) {
+                            if (cone_marks[fanin] != stamp) {
+                                stack.push_back(fanin);
+                                ready = false;
+                            }
+                        }
+                        if (!ready)
+                            continue;
+                    }
+                    stack.pop_back();
+                    cone_marks[node] = stamp;
+                    cone.push_back(node);
+                    if (sat_vars[node] != NOT_LOADED)
+                        continue;
+                    sat_vars[node] = solver.newVar();
+                    loaded.push_back(node);
+                    solver.setDecisionVar(sat_vars[node], false);
+                    auto lit = sat::makeLit(sat_vars[node]);
+                    if (node == 0) {
+                        solver.addClause({sat::negate(lit)});
+                    } else if (result.isAnd(node)) {
+                        auto a = satLit(result.fanin0(node)), b = satLit(result.fanin1(node));
+                        solver.addClause({sat::negate(lit), a});
+                        solver.addClause({sat::negate(lit), b});
+                        solver.addClause({lit, sat::negate(a), sat::negate(b)});
+                    }
+                }
+                for (auto node: cone)
+                    solver.setDecisionVar(sat_vars[node], true);
+            }
+
+            static std::uint64_t valueOf(const std::uint64_t *words, unsigned stride, Aig::Lit lit) {
+                return words[Aig::nodeOf(lit) * stride] ^ (std::uint64_t(0) - (lit & 1u));
+            }
+
+            /**
+             * Complemented if needed so that the first random pattern gives zero, and the same
+             * for the complement of the node.
+             */
+            std::uint64_t flipOf(unsigned node) const {
+                return std::uint64_t(0) - (static_sims[std::size_t(node) * options.sim_words] & 1u);
+            }
+
+            static std::uint64_t mix(std::uint64_t h, std::uint64_t word) { return (h ^ word) * 0x9e3779b97f4a7c15ull; }
+
+            /**
+             * The hash of the simulation of a node on the random patterns and the words of
+             * counterexamples.
+             */
+            std::uint64_t classKey(unsigned node) const {
+                const auto *words = static_sims.data() + std::size_t(node) * options.sim_words;
+                auto flip = flipOf(node);
+                std::uint64_t h = 0;
+                for (unsigned w = 0; w < options.sim_words; ++w)
+                    h = mix(h, words[w] ^ flip);
+                for (const auto &cex: cex_sims)
+                    h = mix(h, cex[node] ^ flip);
+                return h;
+            }
+
+            bool sameSimulation(Aig::Lit x, Aig::Lit y) const {
+                for (unsigned w = 0; w < options.sim_words; ++w) {
+                    if (valueOf(static_sims.data() + w, options.sim_words, x) !=
+                        valueOf(static_sims.data() + w, options.sim_words, y))
+                        return false;
+                }
+                for (const auto &words: cex_sims) {
+                    if (valueOf(words.data(), 1, x) != valueOf(words.data(), 1, y))
+                        return false;
+                }
+                return true;
+            }
+
+            /**
+             * Whether two literals agree on the counterexamples not simulated yet, simulating
+             * their cones on them as far as needed.
+             */
+            bool samePending(Aig::Lit x, Aig::Lit y) {
+                if (pending_bits == 0)
+                    return true;
+                pending_stamps.resize(result.numNodes(), 0);
+                std::vector<unsigned> stack{Aig::nodeOf(x), Aig::nodeOf(y)};
+                while (!stack.empty()) {
+                    auto node = stack.back();
+                    if (pending_stamps[node] == pending_version || !result.isAnd(node)) {
+                        stack.pop_back();
+                        continue;
+                    }
+                    auto a = Aig::nodeOf(result.fanin0(node)), b = Aig::nodeOf(result.fanin1(node));
+                    bool ready = true;
+                    for (auto fanin: {a, b}) {
+                        if (result.isAnd(fanin) && pending_stamps[fanin] != pending_version) {
+                            stack.push_back(fanin);
+                            ready = false;
+                        }
+                    }
+                    if (!ready)
+                        continue;
+                    pending[node] = valueOf(pending.data(), 1, result.fanin0(node)) &
+                                    valueOf(pending.data(), 1, result.fanin1(node));
+                    pending_stamps[node] = pending_version;
+                    stack.pop_back();
+                }
+                auto mask = (std::uint64_t(1) << pending_bits) - 1;
+                return ((valueOf(pending.data(), 1, x) ^ valueOf(pending.data(), 1, y)) & mask) == 0;
+            }
+
+            /**
+             * Store the model of the last call as one more pattern, and simulate the patterns
+             * once there are 64 of them. The inputs outside the cones loaded are random.
+             */
+            void addCounterexample() {
+                ++pending_version;
+                auto bit = std::uint64_t(1) << pending_bits++;
+                auto random = rng();
+                for (std::size_t i = 0; i < result.numInputs(); ++i) {
+                    auto node = result.inputNode(i);
+                    auto var = sat_vars[node];
+                    if (var != NOT_LOADED ? solver.modelValue(var) : ((random >> (i % 64)) & 1u) != 0)
+                        pending[node] |= bit;
+                }
+                if (pending_bits == 64)
+                    splitClasses();
+            }
+
+            /**
+             * Simulate the word of pending counterexamples over the graph, and move every
+             * candidate to the class of its simulation with that word.
+             */
+            void splitClasses() {
+                auto &words = cex_sims.emplace_back(result.numNodes(), 0);
+                for (unsigned node = 1; node < result.numNodes(); ++node) {
+                    if (result.isAnd(node))
+                        words[node] = valueOf(words.data(), 1, result.fanin0(node)) &
+                                      valueOf(words.data(), 1, result.fanin1(node));
+                    else
+                        words[node] = pending[node];
+                    keys[node] = mix(keys[node], words[node] ^ flipOf(node));
+                }
+                keys[0] = mix(keys[0], 0);
+                std::fill(pending.begin(), pending.end(), 0);
+                pending_bits = 0;
+                ++pending_version;
+
+                std::unordered_map<std::uint64_t, std::vector<unsigned>> split;
+                split.reserve(classes.size());
+                for (auto &entry: classes) {
+                    // the common case, a class of one node, keeps its vector
+                    if (entry.second.size() == 1) {
+                        auto &members = split[keys[entry.second.front()]];
+                        if (members.empty())
+                            members = std::move(entry.second);
+                        else
+                            members.push_back(entry.second.front());
+                        continue;
+                    }
+                    for (auto node: entry.second)
+                        split[keys[node]].push_back(node);
+                }
+                classes = std::move(split);
+            }
+        };
+
+    }// namespace
+
+    Aig fraig(const Aig &aig, const FraigOptions &options, FraigStats *stats) {
+        Sweeper sweeper(options);
+        std::vector<Aig::Lit> map(aig.numNodes(), Aig::FALSE_LIT);
+        auto mapped = [&map](Aig::Lit lit) { return map[Aig::nodeOf(lit)] ^ (lit & 1u); };
+        for (unsigned node = 1; node < aig.numNodes(); ++node) {
+            if (aig.isInput(node))
+                map[node] = sweeper.addInput(aig.inputSymbol(static_cast<std::size_t>(aig.inputIndex(node))));
+            else
+                map[node] = sweeper.addAnd(mapped(aig.fanin0(node)), mapped(aig.fanin1(node)));
+        }
+        for (std::size_t k = 0; k < aig.numOutputs(); ++k)
+            sweeper.result.addOutput(mapped(aig.output(k)));
+        if (stats)
+            *stats = sweeper.stats;
+        return sweeper.result.cleanup();
+    }
+
+    bool areEquivalent(const Aig &a, const Aig &b, const FraigOptions &options) {
+        if (a.numOutputs() != b.numOutputs())
+            throw std::invalid_argument("areEquivalent(): the graphs have different numbers of outputs");
+        Sweeper sweeper(options);
+        std::unordered_map<Expr, Aig::Lit, ExprHash, ExprEqual> inputs;
+        auto sweep = [&](const Aig &aig) {
+            std::vector<Aig::Lit> map(aig.numNodes(), Aig::FALSE_LIT);
+            auto mapped = [&map](Aig::Lit lit) { return map[Aig::nodeOf(lit)] ^ (lit & 1u); };
+            for (unsigned node = 1; node < aig.numNodes(); ++node) {
+                if (aig.isInput(node)) {
+                    const auto &symbol = aig.inputSymbol(static_cast<std::size_t>(aig.inputIndex(node)));
+                    auto it = inputs.find(symbol);
+                    if (it == inputs.end())
+                        it = inputs.emplace(symbol, sweeper.addInput(symbol)).first;
+                    map[node] = it->second;
+                } else {
+                    map[node] = sweeper.addAnd(mapped(aig.fanin0(node)), mapped(aig.fanin1(node)));
+                }
+            }
+            std::vector<Aig::Lit> outputs;
+            for (std::size_t k = 0; k < aig.numOutputs(); ++k)
+                outputs.push_back(mapped(aig.output(k)));
+            return outputs;
+        };
+        auto x = sweep(a);
+        auto y = sweep(b);
+        sweeper.setConflictLimit(0);
+        for (std::size_t k = 0; k < x.size(); ++k) {
+            if (x[k] != y[k] && sweeper.proveEqual(x[k], y[k]) != sat::Result::UNSATISFIABLE)
+                return false;
+        }
+        return true;
+    }
+
+}// namespace jazz
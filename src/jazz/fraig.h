@@ -0,0 +1,69 @@
+/**
+ * @file fraig.h
+ *
+ * SAT sweeping: merging the nodes of an and-inverter graph proven equivalent.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_FRAIG_H
+#define BOOLEAN_ALGEBRA_FRAIG_H
+
+#include "aig.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace jazz {
+
+    struct FraigOptions {
+        unsigned sim_words = 4;            ///< 64-bit words of random simulation per node
+        std::uint64_t conflict_limit = 100;///< per proof, the pairs left undecided stay apart
+        unsigned max_candidates = 4;       ///< proofs tried per node before keeping it apart
+        std::uint32_t seed = 1;
+    };
+
+    struct FraigStats {
+        std::size_t proved = 0;   ///< nodes merged into an equivalent one
+        std::size_t refuted = 0;  ///< candidate pairs split by a counterexample
+        std::size_t undecided = 0;///< proofs given up at the conflict limit
+    };
+
+    /**
+     * Merge the functionally equivalent nodes, up to complementation.
+     *
+     * The graph is rebuilt in topological order. Every new gate is simulated on random
+     * patterns, and the earlier nodes with the same simulation, or its complement, are its
+     * candidates. An incremental solver holding the cones of the pairs tried proves a
+     * candidate equal, and the gate is replaced by it, or returns a counterexample. The
+     * counterexamples filter the later candidates, and every 64 of them are simulated as one
+     * more word over the graph, which splits the candidate classes.
+     */
+    Aig fraig(const Aig &aig, const FraigOptions &options = {}, FraigStats *stats = nullptr);
+
+    /**
+     * Whether two graphs compute the same outputs. The inputs are matched by their symbols,
+     * those of one side only are free. The graphs are swept together first, so most outputs
+     * are equal by construction, and the other pairs are left to the solver without a limit.
+     * @throws std::invalid_argument if the numbers of outputs differ.
+     */
+    bool areEquivalent(const Aig &a, const Aig &b, const FraigOptions &options = {});
+
+}// namespace jazz
+
+#endif//BOOLEAN_ALGEBRA_FRAIG_H
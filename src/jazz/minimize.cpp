@@ -0,0 +1,1118 @@
+/**
+ * @file minimize.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "minimize.h"
+#include "aig.h"
+#include "op_and.h"
+#include "op_not.h"
+#include "op_or.h"
+#include "operations.h"
+#include "solutions.h"
+#include "symbol.h"
+#include "truth_table.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+namespace jazz {
+
+    namespace {
+
+        using Word = std::uint64_t;
+
+        unsigned popcount(std::uint32_t x) { return static_cast<unsigned>(std::bitset<32>(x).count()); }
+
+        /**
+         * The bits of x at the positions p with bit j of p clear, packed into the low half.
+         */
+        Word compress(Word x, unsigned j) {
+            x &= ~tt::VAR_MASKS[j];
+            for (unsigned s = j; s + 1 < tt::MAX_VARS; ++s)
+                x = (x | (x >> (1u << s))) & ~tt::VAR_MASKS[s + 1];
+            return x;
+        }
+
+        /**
+         * The inverse of compress(): the low half of x at the positions p with bit j of p clear,
+         * and copied to the positions with it set.
+         */
+        Word spread(Word x, unsigned j) {
+            for (unsigned s = tt::MAX_VARS - 1; s-- > j;)
+                x = (x | (x << (1u << s))) & ~tt::VAR_MASKS[s];
+            return x | (x << (1u << j));
+        }
+
+        /**
+         * Scatter the low bits of bits to the set bits of positions.
+         */
+        std::uint32_t deposit(std::uint32_t bits, std::uint32_t positions) {
+            std::uint32_t result = 0;
+            for (; positions; positions &= positions - 1, bits >>= 1) {
+                if (bits & 1u)
+                    result |= positions & (~positions + 1);
+            }
+            return result;
+        }
+
+        /**
+         * One bit set per mask of dashes, over the values of the other variables packed
+         * together: 3^n bits in all for n variables.
+         */
+        class CubeSets {
+        public:
+            explicit CubeSets(unsigned num_vars) : num_vars(num_vars), offsets((std::size_t(1) << num_vars) + 1) {
+                for (std::uint32_t m = 0; m < (std::uint32_t(1) << num_vars); ++m)
+                    offsets[m + 1] = offsets[m] + numWords(m);
+                words.assign(offsets.back(), 0);
+            }
+
+            unsigned numFree(std::uint32_t mask) const { return num_vars - popcount(mask); }
+            std::size_t numWords(std::uint32_t mask) const {
+                return std::max<std::size_t>(1, (std::size_t(1) << numFree(mask)) / 64);
+            }
+            Word *set(std::uint32_t mask) { return words.data() + offsets[mask]; }
+
+            bool isEmpty(std::uint32_t mask) const {
+                return std::all_of(words.begin() + offsets[mask], words.begin() + offsets[mask + 1],
+                                   [](Word w) { return w == 0; });
+            }
+
+            /**
+             * The implicants with dashes mask | b from those with dashes mask, b being free
+             * variable j of mask: the values both halves of which are in.
+             */
+            void merge(std::uint32_t mask, unsigned j, std::uint32_t larger) {
+                const Word *in = set(mask);
+                Word *out = set(larger);
+                auto f = numFree(mask);
+                if (f <= tt::MAX_VARS) {
+                    out[0] = compress(in[0] & (in[0] >> (1u << j)), j);
+                } else if (j < tt::MAX_VARS) {
+                    for (std::size_t k = 0; k < numWords(mask); ++k)
+                        out[k >> 1] |= compress(in[k] & (in[k] >> (1u << j)), j) << (32 * (k & 1));
+                } else {
+                    std::size_t block = std::size_t(1) << (j - tt::MAX_VARS);
+                    for (std::size_t t = 0; t < numWords(mask) / (2 * block); ++t) {
+                        for (std::size_t r = 0; r < block; ++r)
+                            out[t * block + r] = in[2 * t * block + r] & in[(2 * t + 1) * block + r];
+                    }
+                }
+            }
+
+            /**
+             * Add to covered the implicants with dashes mask that lie in one with dashes
+             * larger = mask | b, b being free variable j of mask.
+             */
+            void expand(std::uint32_t mask, unsigned j, std::uint32_t larger, std::vector<Word> &covered) {
+                const Word *in = set(larger);
+                auto f = numFree(mask);
+                if (f <= tt::MAX_VARS) {
+                    covered[0] |= spread(in[0], j);
+                } else if (j < tt::MAX_VARS) {
+                    for (std::size_t k = 0; k < covered.size(); ++k)
+                        covered[k] |= spread((in[k >> 1] >> (32 * (k & 1))) & 0xffffffffu, j);
+                } else {
+                    std::size_t block = std::size_t(1) << (j - tt::MAX_VARS);
+                    for (std::size_t t = 0; t < covered.size() / (2 * block); ++t) {
+                        for (std::size_t r = 0; r < block; ++r) {
+                            covered[2 * t * block + r] |= in[t * block + r];
+                            covered[(2 * t + 1) * block + r] |= in[t * block + r];
+                        }
+                    }
+                }
+            }
+
+        private:
+            unsigned num_vars;
+            std::vector<std::size_t> offsets;
+            std::vector<Word> words;
+        };
+
+        /**
+         * The position of variable b among the variables not in mask.
+         */
+        unsigned freePosition(std::uint32_t mask, unsigned b) { return b - popcount(mask & ((1u << b) - 1)); }
+
+        void checkNumVars(unsigned num_vars, const char *func) {
+            if (num_vars > MAX_EXACT_VARS)
+                throw std::invalid_argument(std::string(func) + "(): more than " + std::to_string(MAX_EXACT_VARS) +
+                                            " variables");
+        }
+
+        /**
+         * Branch and bound over the primes covering the minterms.
+         *
+         * The uncovered minterms, the uncovered minterms of every prime and the candidates
+         * left to every minterm are kept up to date as primes are chosen and excluded, so a
+         * branch costs about the number of minterms left, and the branches are walked with an
+         * explicit stack, as deep as the cover is large.
+         */
+        class CoverSearch {
+        public:
+            CoverSearch(unsigned num_vars, const std::vector<std::uint32_t> &on, const std::vector<Implicant> &primes,
+                        std::size_t max_branches)
+                : num_vars(num_vars), primes(primes), max_branches(max_branches) {
+                std::vector<int> where(std::size_t(1) << num_vars, -1);
+                for (auto m: on) {
+                    if (m >> num_vars)
+                        throw std::invalid_argument("minimumCover(): a minterm out of range");
+                    if (where[m] < 0) {
+                        where[m] = static_cast<int>(minterm_primes.size());
+                        minterm_primes.emplace_back();
+                    }
+                }
+                prime_minterms.resize(primes.size());
+                for (std::uint32_t p = 0; p < primes.size(); ++p) {
+                    auto dashes = primes[p].dashes;
+                    for (std::uint32_t sub = dashes;; sub = (sub - 1) & dashes) {
+                        auto k = where[primes[p].value | sub];
+                        if (k >= 0) {
+                            prime_minterms[p].push_back(static_cast<std::uint32_t>(k));
+                            minterm_primes[k].push_back(p);
+                        }
+                        if (sub == 0)
+                            break;
+                    }
+                }
+                auto num_minterms = static_cast<std::uint32_t>(minterm_primes.size());
+                for (std::uint32_t k = 0; k < num_minterms; ++k) {
+                    if (minterm_primes[k].empty())
+                        throw std::invalid_argument("minimumCover(): a minterm is in no prime");
+                    available.push_back(minterm_primes[k].size());
+                    position.push_back(k);
+                    open.push_back(k);
+                }
+                covered.assign(num_minterms, 0);
+                for (const auto &minterms: prime_minterms)
+                    gain.push_back(minterms.size());
+                excluded.assign(primes.size(), 0);
+                in_cover.assign(primes.size(), 0);
+                stamps.assign(primes.size(), 0);
+            }
+
+            std::vector<Implicant> run() {
+                // the essential primes
+                std::size_t literals = 0;
+                for (const auto &candidates: minterm_primes) {
+                    if (candidates.size() == 1 && !in_cover[candidates[0]]) {
+                        choose(candidates[0]);
+                        literals += primes[candidates[0]].numLiterals(num_vars);
+                    }
+                }
+                greedy(literals);
+                search(literals);
+                std::vector<Implicant> result;
+                std::sort(best.begin(), best.end());
+                for (auto p: best)
+                    result.push_back(primes[p]);
+                return result;
+            }
+
+        private:
+            void choose(std::uint32_t p) {
+                chosen.push_back(p);
+                in_cover[p] = 1;
+                for (auto k: prime_minterms[p]) {
+                    if (covered[k]++ > 0)
+                        continue;
+                    // no longer open
+                    auto last = open.back();
+                    open[position[k]] = last;
+                    position[last] = position[k];
+                    open.pop_back();
+                    for (auto q: minterm_primes[k])
+                        --gain[q];
+                }
+            }
+
+            void unchoose() {
+                auto p = chosen.back();
+                chosen.pop_back();
+                in_cover[p] = 0;
+                for (auto k: prime_minterms[p]) {
+                    if (--covered[k] > 0)
+                        continue;
+                    position[k] = static_cast<std::uint32_t>(open.size());
+                    open.push_back(k);
+                    for (auto q: minterm_primes[k])
+                        ++gain[q];
+                }
+            }
+
+            void exclude(std::uint32_t p) {
+                excluded[p] = 1;
+                for (auto k: prime_minterms[p])
+                    --available[k];
+            }
+
+            void include(std::uint32_t p) {
+                excluded[p] = 0;
+                for (auto k: prime_minterms[p])
+                    ++available[k];
+            }
+
+            /**
+             * A first cover, taking the prime covering the most minterms left each time, then
+             * the one of fewest literals. The gains only go down, so a stale entry of the
+             * queue is pushed back with its current gain.
+             */
+            void greedy(std::size_t literals) {
+                auto depth = chosen.size();
+                // the gain, the literals and the prime, ordered so that the best is on top
+                using Entry = std::tuple<std::size_t, std::size_t, std::uint32_t>;
+                auto worse = [](const Entry &a, const Entry &b) {
+                    return std::get<0>(a) < std::get<0>(b) ||
+                           (std::get<0>(a) == std::get<0>(b) &&
+                            (std::get<1>(a) > std::get<1>(b) ||
+                             (std::get<1>(a) == std::get<1>(b) && std::get<2>(a) > std::get<2>(b))));
+                };
+                std::priority_queue<Entry, std::vector<Entry>, decltype(worse)> queue(worse);
+                for (std::uint32_t p = 0; p < primes.size(); ++p) {
+                    if (gain[p] > 0)
+                        queue.emplace(gain[p], primes[p].numLiterals(num_vars), p);
+                }
+                while (!open.empty()) {
+                    auto [g, n, p] = queue.top();
+                    queue.pop();
+                    if (g != gain[p]) {
+                        if (gain[p] > 0)
+                            queue.emplace(gain[p], n, p);
+                        continue;
+                    }
+                    choose(p);
+                    literals += n;
+                }
+                best = chosen;
+                best_literals = literals;
+                while (chosen.size() > depth)
+                    unchoose();
+            }
+
+            /**
+             * The number of uncovered minterms, taken fewest candidates first, no two of which
+             * have a candidate in common, counted up to enough.
+             */
+            std::size_t lowerBound(std::size_t enough) {
+                // by counting sort, the counts of candidates are small
+                std::size_t most = 0;
+                for (auto k: open)
+                    most = std::max(most, available[k]);
+                starts.assign(most + 2, 0);
+                for (auto k: open)
+                    ++starts[available[k] + 1];
+                for (std::size_t n = 1; n < starts.size(); ++n)
+                    starts[n] += starts[n - 1];
+                by_candidates.resize(open.size());
+                for (auto k: open)
+                    by_candidates[starts[available[k]]++] = k;
+
+                ++stamp;
+                std::size_t bound = 0;
+                for (auto k: by_candidates) {
+                    const auto &candidates = minterm_primes[k];
+                    bool disjoint = true;
+                    for (auto p: candidates)
+                        disjoint = disjoint && (excluded[p] || stamps[p] != stamp);
+                    if (!disjoint)
+                        continue;
+                    if (++bound >= enough)
+                        break;
+                    for (auto p: candidates)
+                        stamps[p] = stamp;
+                }
+                return bound;
+            }
+
+            /**
+             * A branch of the search, the candidates of which are those of pending from first on.
+             */
+            struct Frame {
+                std::size_t first;
+                std::size_t next;    ///< the candidate to try next
+                std::size_t literals;///< of the primes chosen before the branch
+            };
+
+            /**
+             * Record the cover if complete, or else push the branch on the stack unless it is
+             * pruned.
+             */
+            void enter(std::size_t literals) {
+                if (open.empty()) {
+                    if (chosen.size() < best.size() || (chosen.size() == best.size() && literals < best_literals)) {
+                        best = chosen;
+                        best_literals = literals;
+                    }
+                    return;
+                }
+                if (branches >= max_branches)
+                    return;
+                ++branches;
+
+                std::uint32_t pivot = 0;
+                std::size_t fewest = std::numeric_limits<std::size_t>::max();
+                for (auto k: open) {
+                    auto n = available[k];
+                    if (n == 0)
+                        return;
+                    if (n < fewest || (n == fewest && k < pivot)) {
+                        fewest = n;
+                        pivot = k;
+                    }
+                }
+                // at least one more prime is needed, and the primes still needed must leave a
+                // cover no larger than the best, with fewer literals if as large
+                if (chosen.size() >= best.size())
+                    return;
+                auto enough = best.size() - chosen.size() + (literals < best_literals ? 1 : 0);
+                // the bound cannot exceed the number of uncovered minterms
+                if (open.size() >= enough && lowerBound(enough) >= enough)
+                    return;
+
+                auto first = pending.size();
+                for (auto p: minterm_primes[pivot]) {
+                    if (!excluded[p])
+                        pending.push_back(p);
+                }
+                std::sort(pending.begin() + static_cast<std::ptrdiff_t>(first), pending.end(),
+                          [&](std::uint32_t a, std::uint32_t b) {
+                              return gain[a] > gain[b] || (gain[a] == gain[b] && a < b);
+                          });
+                frames.push_back({first, first, literals});
+            }
+
+            void search(std::size_t literals) {
+                enter(literals);
+                while (!frames.empty()) {
+                    auto &frame = frames.back();
+                    if (frame.next > frame.first) {
+                        // back from the last candidate: the covers with it are all searched
+                        unchoose();
+                        exclude(pending[frame.next - 1]);
+                    }
+                    if (frame.next == pending.size()) {
+                        for (auto i = frame.first; i < pending.size(); ++i)
+                            include(pending[i]);
+                        pending.resize(frame.first);
+                        frames.pop_back();
+                        continue;
+                    }
+                    auto p = pending[frame.next++];
+                    choose(p);
+                    enter(frame.literals + primes[p].numLiterals(num_vars));
+                }
+            }
+
+            unsigned num_vars;
+            const std::vector<Implicant> &primes;
+            std::size_t max_branches;
+            std::size_t branches = 0;
+            std::vector<std::vector<std::uint32_t>> minterm_primes;
+            std::vector<std::vector<std::uint32_t>> prime_minterms;
+            std::vector<std::uint32_t> covered;  ///< the chosen primes covering each minterm
+            std::vector<std::uint32_t> open;     ///< the uncovered minterms
+            std::vector<std::uint32_t> position; ///< of each uncovered minterm in open
+            std::vector<std::size_t> gain;       ///< the uncovered minterms of each prime
+            std::vector<std::size_t> available;  ///< the primes not excluded of each minterm
+            std::vector<char> excluded;
+            std::vector<char> in_cover;
+            std::vector<std::uint32_t> stamps;
+            std::uint32_t stamp = 0;
+            std::vector<std::uint32_t> chosen;
+            std::vector<std::uint32_t> best;
+            std::size_t best_literals = 0;
+            std::vector<Frame> frames;
+            std::vector<std::uint32_t> pending;
+            std::vector<std::uint32_t> by_candidates;
+            std::vector<std::size_t> starts;
+        };
+
+        /**
+         * The minterms of each output of a graph, by simulating all of them 64 at a time.
+         */
+        std::vector<std::vector<std::uint32_t>> mintermsOf(const Aig &aig) {
+            auto n = static_cast<unsigned>(aig.numInputs());
+            std::vector<std::vector<std::uint32_t>> result(aig.numOutputs());
+            std::size_t num_words = std::max<std::size_t>(1, (std::size_t(1) << n) / 64);
+            std::vector<Word> inputs(n);
+            for (std::size_t w = 0; w < num_words; ++w) {
+                for (unsigned i = 0; i < n; ++i)
+                    inputs[i] = i < tt::MAX_VARS ? tt::VAR_MASKS[i] : (w >> (i - tt::MAX_VARS)) & 1u ? ~Word(0) : 0;
+                auto values = aig.simulate(inputs);
+                for (std::size_t k = 0; k < aig.numOutputs(); ++k) {
+                    auto word = Aig::valueOf(values, aig.output(k));
+                    if (n < tt::MAX_VARS)
+                        word &= (Word(1) << (1u << n)) - 1;
+                    for (; word; word &= word - 1) {
+                        unsigned bit = 0;
+                        while (!((word >> bit) & 1u))
+                            ++bit;
+                        result[k].push_back(static_cast<std::uint32_t>(w * 64 + bit));
+                    }
+                }
+            }
+            return result;
+        }
+
+        Expr sumOfProducts(const Aig &aig, const std::vector<Implicant> &cover) {
+            std::vector<Expr> products;
+            for (const auto &cube: cover) {
+                std::vector<Expr> literals;
+                for (unsigned i = 0; i < aig.numInputs(); ++i) {
+                    if ((cube.dashes >> i) & 1u)
+                        continue;
+                    const auto &symbol = aig.inputSymbol(i);
+                    literals.push_back((cube.value >> i) & 1u ? symbol : !symbol);
+                }
+                products.push_back(makeAnd(literals));
+            }
+            return makeOr(products);
+        }
+
+        /**
+         * Pairs of bits per variable, in words of 32 variables, as in Cube.
+         */
+        Word lowBits(unsigned num_vars, std::size_t k) {
+            auto vars = std::min<std::size_t>(32, num_vars - 32 * k);
+            return vars == 32 ? 0x5555555555555555ull : ((Word(1) << (2 * vars)) - 1) & 0x5555555555555555ull;
+        }
+
+        std::size_t numCubeWords(unsigned num_vars) { return std::max(1u, (num_vars + 31) / 32); }
+
+        /**
+         * Cubes stored one after the other, numCubeWords() words each.
+         */
+        class Cover {
+        public:
+            explicit Cover(unsigned num_vars) : num_vars(num_vars), stride(numCubeWords(num_vars)) {
+                for (std::size_t k = 0; k < stride; ++k) {
+                    low.push_back(lowBits(num_vars, k));
+                    full.push_back(low.back() | (low.back() << 1));
+                }
+            }
+
+            unsigned numVars() const { return num_vars; }
+            std::size_t size() const { return words.size() / stride; }
+            bool empty() const { return words.empty(); }
+            Word *operator[](std::size_t i) { return words.data() + i * stride; }
+            const Word *operator[](std::size_t i) const { return words.data() + i * stride; }
+
+            void push(const Word *cube) { words.insert(words.end(), cube, cube + stride); }
+            void pushUniversal() { words.insert(words.end(), full.begin(), full.end()); }
+            void clear() { words.clear(); }
+
+            bool isEmpty(const Word *cube) const {
+                for (std::size_t k = 0; k < stride; ++k) {
+                    if (((cube[k] | (cube[k] >> 1)) & low[k]) != low[k])
+                        return true;
+                }
+                return false;
+            }
+
+            bool isUniversal(const Word *cube) const { return std::equal(full.begin(), full.end(), cube); }
+
+            static bool contains(const Word *a, const Word *b, std::size_t stride) {
+                for (std::size_t k = 0; k < stride; ++k) {
+                    if (b[k] & ~a[k])
+                        return false;
+                }
+                return true;
+            }
+
+            bool contains(const Word *a, const Word *b) const { return contains(a, b, stride); }
+
+            bool intersects(const Word *a, const Word *b) const {
+                for (std::size_t k = 0; k < stride; ++k) {
+                    auto x = a[k] & b[k];
+                    if (((x | (x >> 1)) & low[k]) != low[k])
+                        return false;
+                }
+                return true;
+            }
+
+            unsigned numLiterals(const Word *cube) const {
+                unsigned n = 0;
+                for (std::size_t k = 0; k < stride; ++k) {
+                    auto both = cube[k] & (cube[k] >> 1) & low[k];
+                    n += static_cast<unsigned>(std::bitset<64>(low[k] & ~both).count());
+                }
+                return n;
+            }
+
+            /**
+             * The cofactor of the cubes meeting cube, their literals of its variables dropped.
+             */
+            Cover cofactor(const Word *cube) const {
+                Cover result(num_vars);
+                std::vector<Word> scratch(stride);
+                for (std::size_t i = 0; i < size(); ++i) {
+                    const auto *other = (*this)[i];
+                    if (!intersects(other, cube))
+                        continue;
+                    for (std::size_t k = 0; k < stride; ++k)
+                        scratch[k] = other[k] | (~cube[k] & full[k]);
+                    result.push(scratch.data());
+                }
+                return result;
+            }
+
+            /**
+             * The cofactor for one value of variable v.
+             */
+            Cover cofactor(unsigned v, bool value) const {
+                Cover result(num_vars);
+                std::size_t k = v / 32;
+                auto bit = Word(1) << (2 * (v % 32) + value);
+                auto pair = Word(3) << (2 * (v % 32));
+                for (std::size_t i = 0; i < size(); ++i) {
+                    const auto *cube = (*this)[i];
+                    if (cube[k] & bit) {
+                        result.push(cube);
+                        result.words[result.words.size() - stride + k] |= pair;
+                    }
+                }
+                return result;
+            }
+
+            unsigned num_vars;
+            std::size_t stride;
+            std::vector<Word> low;
+            std::vector<Word> full;
+            std::vector<Word> words;
+        };
+
+        /**
+         * Tautology of covers by unate recursion, a bounded number of splits per check.
+         */
+        class TautologyChecker {
+        public:
+            explicit TautologyChecker(std::size_t split_limit) : split_limit(split_limit) {}
+
+            /**
+             * Whether the cubes of cover contain cube, false also when the check gives up.
+             */
+            bool covers(const Cover &cover, const Word *cube) {
+                for (std::size_t i = 0; i < cover.size(); ++i) {
+                    if (cover.contains(cover[i], cube))
+                        return true;
+                }
+                splits = 0;
+                return isTautology(cover.cofactor(cube));
+            }
+
+        private:
+            bool isTautology(Cover f) {
+                auto n = f.numVars();
+                std::vector<std::uint32_t> zeros(n), ones(n);
+                while (true) {
+                    if (f.empty())
+                        return false;
+                    // the fraction of all minterms in each cube, which add up to 1 at least
+                    double volume = 0;
+                    std::fill(zeros.begin(), zeros.end(), 0);
+                    std::fill(ones.begin(), ones.end(), 0);
+                    for (std::size_t i = 0; i < f.size(); ++i) {
+                        const auto *cube = f[i];
+                        if (f.isUniversal(cube))
+                            return true;
+                        volume += std::ldexp(1.0, -static_cast<int>(f.numLiterals(cube)));
+                        for (std::size_t k = 0; k < f.stride; ++k) {
+                            for (auto zero = cube[k] & ~(cube[k] >> 1) & f.low[k]; zero; zero &= zero - 1)
+                                ++zeros[32 * k + lowestBit(zero) / 2];
+                            for (auto one = (cube[k] >> 1) & ~cube[k] & f.low[k]; one; one &= one - 1)
+                                ++ones[32 * k + lowestBit(one) / 2];
+                        }
+                    }
+                    if (volume < 1 - 1e-9)
+                        return false;
+
+                    // the cubes with a literal of a unate variable do not matter
+                    std::vector<Word> unate(f.stride, 0);
+                    bool any_unate = false;
+                    unsigned split = n;
+                    std::uint32_t most = 0;
+                    for (unsigned v = 0; v < n; ++v) {
+                        if ((zeros[v] == 0) != (ones[v] == 0)) {
+                            unate[v / 32] |= Word(3) << (2 * (v % 32));
+                            any_unate = true;
+                        } else if (zeros[v] + ones[v] > most) {
+                            most = zeros[v] + ones[v];
+                            split = v;
+                        }
+                    }
+                    if (any_unate) {
+                        Cover rest(n);
+                        for (std::size_t i = 0; i < f.size(); ++i) {
+                            const auto *cube = f[i];
+                            bool keep = true;
+                            for (std::size_t k = 0; k < f.stride && keep; ++k)
+                                keep = (cube[k] & unate[k]) == unate[k];
+                            if (keep)
+                                rest.push(cube);
+                        }
+                        f = std::move(rest);
+                        continue;
+                    }
+                    if (split == n || ++splits > split_limit)
+                        return false;
+                    return isTautology(f.cofactor(split, false)) && isTautology(f.cofactor(split, true));
+                }
+            }
+
+            static unsigned lowestBit(Word w) {
+                unsigned bit = 0;
+                while (!((w >> bit) & 1u))
+                    ++bit;
+                return bit;
+            }
+
+            std::size_t split_limit;
+            std::size_t splits = 0;
+        };
+
+        /**
+         * The EXPAND, IRREDUNDANT and REDUCE steps of Espresso on a cover.
+         */
+        class Espresso {
+        public:
+            Espresso(const Cover &on, const Cover &dc, const EspressoOptions &options)
+                : options(options), cover(on.numVars()), dc(dc), care(on.numVars()), checker(options.split_limit) {
+                for (std::size_t i = 0; i < on.size(); ++i) {
+                    if (!on.isEmpty(on[i]))
+                        cover.push(on[i]);
+                }
+                care = cover;
+                for (std::size_t i = 0; i < dc.size(); ++i) {
+                    if (!dc.isEmpty(dc[i]))
+                        care.push(dc[i]);
+                }
+            }
+
+            Cover run() {
+                expand();
+                irredundant();
+                Cover best = cover;
+                for (unsigned round = 0; round < options.max_rounds; ++round) {
+                    reduce();
+                    expand();
+                    irredundant();
+                    if (!isSmaller(cover, best))
+                        break;
+                    best = cover;
+                }
+                return best;
+            }
+
+        private:
+            bool isSmaller(const Cover &a, const Cover &b) const {
+                if (a.size() != b.size())
+                    return a.size() < b.size();
+                return totalLiterals(a) < totalLiterals(b);
+            }
+
+            static std::size_t totalLiterals(const Cover &f) {
+                std::size_t n = 0;
+                for (std::size_t i = 0; i < f.size(); ++i)
+                    n += f.numLiterals(f[i]);
+                return n;
+            }
+
+            /**
+             * The indices of the cubes, those with the fewest literals first.
+             */
+            std::vector<std::size_t> bySize(bool largest_first) const {
+                std::vector<std::pair<unsigned, std::size_t>> keys;
+                for (std::size_t i = 0; i < cover.size(); ++i)
+                    keys.emplace_back(cover.numLiterals(cover[i]), i);
+                std::stable_sort(keys.begin(), keys.end(), [&](const auto &a, const auto &b) {
+                    return largest_first ? a.first < b.first : a.first > b.first;
+                });
+                std::vector<std::size_t> order;
+                for (const auto &key: keys)
+                    order.push_back(key.second);
+                return order;
+            }
+
+            /**
+             * The cover without cube i, and the don't cares.
+             */
+            Cover others(std::size_t i) const {
+                Cover result = dc;
+                for (std::size_t j = 0; j < cover.size(); ++j) {
+                    if (j != i)
+                        result.push(cover[j]);
+                }
+                return result;
+            }
+
+            /**
+             * Drop literals while the cube stays within the care cover, first those of the
+             * variables most other cubes have no literal of, then remove the cubes it contains.
+             */
+            void expand() {
+                auto n = cover.numVars();
+                std::vector<std::size_t> free_count(n, 0);
+                for (std::size_t i = 0; i < cover.size(); ++i) {
+                    for (unsigned v = 0; v < n; ++v)
+                        free_count[v] += varBits(cover[i], v) == 3;
+                }
+                std::vector<unsigned> vars(n);
+                for (unsigned v = 0; v < n; ++v)
+                    vars[v] = v;
+                std::stable_sort(vars.begin(), vars.end(),
+                                 [&](unsigned a, unsigned b) { return free_count[a] > free_count[b]; });
+
+                std::vector<char> removed(cover.size(), 0);
+                std::vector<Word> trial(cover.stride);
+                for (auto i: bySize(true)) {
+                    if (removed[i])
+                        continue;
+                    auto *cube = cover[i];
+                    for (auto v: vars) {
+                        if (varBits(cube, v) == 3)
+                            continue;
+                        std::copy(cube, cube + cover.stride, trial.begin());
+                        trial[v / 32] |= Word(3) << (2 * (v % 32));
+                        if (checker.covers(care, trial.data()))
+                            std::copy(trial.begin(), trial.end(), cube);
+                    }
+                    for (std::size_t j = 0; j < cover.size(); ++j) {
+                        if (j != i && !removed[j] && cover.contains(cube, cover[j]))
+                            removed[j] = 1;
+                    }
+                }
+                keep(removed);
+            }
+
+            /**
+             * Remove the cubes the others cover, trying those with the most literals first.
+             */
+            void irredundant() {
+                std::vector<char> removed(cover.size(), 0);
+                for (auto i: bySize(false)) {
+                    Cover rest = dc;
+                    for (std::size_t j = 0; j < cover.size(); ++j) {
+                        if (j != i && !removed[j])
+                            rest.push(cover[j]);
+                    }
+                    if (checker.covers(rest, cover[i]))
+                        removed[i] = 1;
+                }
+                keep(removed);
+            }
+
+            /**
+             * Shrink each cube to the part the others do not cover, one variable at a time,
+             * the largest cubes first.
+             */
+            void reduce() {
+                auto n = cover.numVars();
+                std::vector<Word> half(cover.stride);
+                for (auto i: bySize(true)) {
+                    auto rest = others(i);
+                    auto *cube = cover[i];
+                    for (unsigned v = 0; v < n; ++v) {
+                        if (varBits(cube, v) != 3)
+                            continue;
+                        for (Word value = 0; value < 2; ++value) {
+                            // the half where v is 1 - value is covered by the rest: keep the other
+                            std::copy(cube, cube + cover.stride, half.begin());
+                            half[v / 32] &= ~(Word(1) << (2 * (v % 32) + value));
+                            if (checker.covers(rest, half.data())) {
+                                cube[v / 32] &= ~(Word(1) << (2 * (v % 32) + (1 - value)));
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+
+            static Word varBits(const Word *cube, unsigned v) { return (cube[v / 32] >> (2 * (v % 32))) & 3u; }
+
+            void keep(const std::vector<char> &removed) {
+                Cover kept(cover.numVars());
+                for (std::size_t i = 0; i < cover.size(); ++i) {
+                    if (!removed[i])
+                        kept.push(cover[i]);
+                }
+                cover = std::move(kept);
+            }
+
+            const EspressoOptions &options;
+            Cover cover;
+            Cover dc;
+            Cover care;
+            TautologyChecker checker;
+        };
+
+        using SymbolIndex = std::unordered_map<Expr, unsigned, ExprHash, ExprEqual>;
+        using Term = std::vector<std::pair<unsigned, bool>>;
+
+        unsigned indexOf(const Expr &symbol, SymbolIndex &index, std::vector<Expr> &symbols) {
+            auto it = index.find(symbol);
+            if (it != index.end())
+                return it->second;
+            index.emplace(symbol, static_cast<unsigned>(symbols.size()));
+            symbols.push_back(symbol);
+            return static_cast<unsigned>(symbols.size() - 1);
+        }
+
+        bool literalOf(const Expr &e, SymbolIndex &index, std::vector<Expr> &symbols, Term &term) {
+            if (is_a<Symbol>(e)) {
+                term.emplace_back(indexOf(e, index, symbols), true);
+                return true;
+            }
+            if (is_a<Not>(e) && is_a<Symbol>(e.operand(0))) {
+                term.emplace_back(indexOf(e.operand(0), index, symbols), false);
+                return true;
+            }
+            return false;
+        }
+
+        bool productOf(const Expr &e, SymbolIndex &index, std::vector<Expr> &symbols, std::vector<Term> &terms) {
+            Term term;
+            if (e.isTrivial()) {
+                if (e.trivialValue())
+                    terms.push_back(term);
+                return true;
+            }
+            if (is_a<And>(e)) {
+                for (std::size_t i = 0; i < e.numOperands(); ++i) {
+                    if (!literalOf(e.operand(i), index, symbols, term))
+                        return false;
+                }
+            } else if (!literalOf(e, index, symbols, term)) {
+                return false;
+            }
+            terms.push_back(term);
+            return true;
+        }
+
+        /**
+         * The products of an expression: its own if it is a sum of products, else disjoint
+         * cubes enumerated from it.
+         */
+        std::vector<Term> termsOf(const Expr &e, SymbolIndex &index, std::vector<Expr> &symbols,
+                                  std::size_t max_terms) {
+            std::vector<Term> terms;
+            bool sop = true;
+            if (is_a<Or>(e)) {
+                for (std::size_t i = 0; i < e.numOperands() && sop; ++i)
+                    sop = productOf(e.operand(i), index, symbols, terms);
+            } else {
+                sop = productOf(e, index, symbols, terms);
+            }
+            if (sop)
+                return terms;
+
+            terms.clear();
+            SolutionRange range(e);
+            for (const auto &cube: range) {
+                if (terms.size() == max_terms)
+                    throw std::length_error("espresso(): more than " + std::to_string(max_terms) +
+                                            " cubes in the initial cover");
+                Term term;
+                for (const auto &entry: cube)
+                    term.emplace_back(indexOf(entry.first, index, symbols), entry.second.trivialValue());
+                terms.push_back(term);
+            }
+            return terms;
+        }
+
+        Cover coverOf(unsigned num_vars, const std::vector<Term> &terms) {
+            Cover cover(num_vars);
+            for (const auto &term: terms) {
+                cover.pushUniversal();
+                auto *cube = cover[cover.size() - 1];
+                for (const auto &literal: term)
+                    cube[literal.first / 32] &= ~(Word(1) << (2 * (literal.first % 32) + !literal.second));
+            }
+            return cover;
+        }
+
+    }// namespace
+
+    unsigned Implicant::numLiterals(unsigned num_vars) const {
+        auto all = num_vars >= 32 ? ~std::uint32_t(0) : (std::uint32_t(1) << num_vars) - 1;
+        return popcount(all & ~dashes);
+    }
+
+    std::vector<Implicant> primeImplicants(unsigned num_vars, const std::vector<std::uint32_t> &on,
+                                           const std::vector<std::uint32_t> &dc) {
+        checkNumVars(num_vars, "primeImplicants");
+        CubeSets sets(num_vars);
+        auto *minterms = sets.set(0);
+        for (const auto *list: {&on, &dc}) {
+            for (auto m: *list) {
+                if (m >> num_vars)
+                    throw std::invalid_argument("primeImplicants(): a minterm out of range");
+                minterms[m / 64] |= Word(1) << (m % 64);
+            }
+        }
+
+        // the implicants with one more dash come from those without the highest of them
+        auto num_masks = std::uint32_t(1) << num_vars;
+        std::vector<char> nonempty(num_masks, 0);
+        nonempty[0] = !sets.isEmpty(0);
+        for (std::uint32_t mask = 1; mask < num_masks; ++mask) {
+            unsigned b = 31;
+            while (!((mask >> b) & 1u))
+                --b;
+            auto smaller = mask & ~(1u << b);
+            if (!nonempty[smaller])
+                continue;
+            sets.merge(smaller, freePosition(smaller, b), mask);
+            nonempty[mask] = !sets.isEmpty(mask);
+        }
+
+        // the primes are the implicants in no implicant with one more dash
+        std::vector<Implicant> primes;
+        std::vector<Word> covered;
+        for (std::uint32_t mask = 0; mask < num_masks; ++mask) {
+            if (!nonempty[mask])
+                continue;
+            covered.assign(sets.numWords(mask), 0);
+            for (unsigned b = 0; b < num_vars; ++b) {
+                auto larger = mask | (1u << b);
+                if (larger != mask && nonempty[larger])
+                    sets.expand(mask, freePosition(mask, b), larger, covered);
+            }
+            const auto *implicants = sets.set(mask);
+            auto free = (num_masks - 1) & ~mask;
+            for (std::size_t k = 0; k < covered.size(); ++k) {
+                for (auto word = implicants[k] & ~covered[k]; word; word &= word - 1) {
+                    unsigned bit = 0;
+                    while (!((word >> bit) & 1u))
+                        ++bit;
+                    primes.push_back({deposit(static_cast<std::uint32_t>(k * 64 + bit), free), mask});
+                }
+            }
+        }
+        std::sort(primes.begin(), primes.end(), [](const Implicant &a, const Implicant &b) {
+            auto x = popcount(a.dashes), y = popcount(b.dashes);
+            return x > y || (x == y && (a.dashes < b.dashes || (a.dashes == b.dashes && a.value < b.value)));
+        });
+        return primes;
+    }
+
+    std::vector<Implicant> minimumCover(unsigned num_vars, const std::vector<std::uint32_t> &on,
+                                        const std::vector<Implicant> &primes, std::size_t max_branches) {
+        checkNumVars(num_vars, "minimumCover");
+        return CoverSearch(num_vars, on, primes, max_branches).run();
+    }
+
+    Expr minimizeExact(const Expr &f, const Expr &dont_care) {
+        auto aig = toAIG(std::vector<Expr>{f, dont_care});
+        if (aig.numInputs() > MAX_EXACT_VARS)
+            throw std::invalid_argument("minimizeExact(): more than " + std::to_string(MAX_EXACT_VARS) + " symbols");
+        auto n = static_cast<unsigned>(aig.numInputs());
+        auto minterms = mintermsOf(aig);
+        std::vector<std::uint32_t> on;
+        std::set_difference(minterms[0].begin(), minterms[0].end(), minterms[1].begin(), minterms[1].end(),
+                            std::back_inserter(on));
+        auto primes = primeImplicants(n, on, minterms[1]);
+        return sumOfProducts(aig, minimumCover(n, on, primes));
+    }
+
+    Cube::Cube(unsigned num_vars) : num_vars(num_vars), bits(numCubeWords(num_vars)) {
+        for (std::size_t k = 0; k < bits.size(); ++k)
+            bits[k] = lowBits(num_vars, k) * 3;
+    }
+
+    int Cube::literal(unsigned i) const {
+        auto pair = (bits.at(i / 32) >> (2 * (i % 32))) & 3u;
+        return pair == 3 ? -1 : pair == 2;
+    }
+
+    void Cube::setLiteral(unsigned i, bool value) {
+        auto &word = bits.at(i / 32);
+        word = (word & ~(Word(3) << (2 * (i % 32)))) | (Word(value ? 2 : 1) << (2 * (i % 32)));
+    }
+
+    void Cube::clearLiteral(unsigned i) { bits.at(i / 32) |= Word(3) << (2 * (i % 32)); }
+
+    unsigned Cube::numLiterals() const {
+        Cover cover(num_vars);
+        return cover.numLiterals(bits.data());
+    }
+
+    bool Cube::isEmpty() const { return Cover(num_vars).isEmpty(bits.data()); }
+
+    bool Cube::contains(const Cube &other) const {
+        return num_vars == other.num_vars && Cover::contains(bits.data(), other.bits.data(), bits.size());
+    }
+
+    std::vector<Cube> espresso(const std::vector<Cube> &on, const std::vector<Cube> &dc,
+                               const EspressoOptions &options) {
+        if (on.empty())
+            return {};
+        auto n = on.front().numVars();
+        Cover on_cover(n), dc_cover(n);
+        for (const auto *cubes: {&on, &dc}) {
+            for (const auto &cube: *cubes) {
+                if (cube.numVars() != n)
+                    throw std::invalid_argument("espresso(): cubes of different numbers of variables");
+                (cubes == &on ? on_cover : dc_cover).push(cube.words().data());
+            }
+        }
+        auto result = Espresso(on_cover, dc_cover, options).run();
+        std::vector<Cube> cubes;
+        for (std::size_t i = 0; i < result.size(); ++i) {
+            Cube cube(n);
+            for (unsigned v = 0; v < n; ++v) {
+                auto pair = (result[i][v / 32] >> (2 * (v % 32))) & 3u;
+                if (pair != 3)
+                    cube.setLiteral(v, pair == 2);
+            }
+            cubes.push_back(cube);
+        }
+        return cubes;
+    }
+
+    Expr espresso(const Expr &f, const Expr &dont_care, const EspressoOptions &options) {
+        SymbolIndex index;
+        std::vector<Expr> symbols;
+        auto on_terms = termsOf(f, index, symbols, options.max_initial_cubes);
+        auto dc_terms = termsOf(dont_care, index, symbols, options.max_initial_cubes);
+        auto n = static_cast<unsigned>(symbols.size());
+        auto result = Espresso(coverOf(n, on_terms), coverOf(n, dc_terms), options).run();
+
+        std::vector<Expr> products;
+        for (std::size_t i = 0; i < result.size(); ++i) {
+            std::vector<Expr> literals;
+            for (unsigned v = 0; v < n; ++v) {
+                auto pair = (result[i][v / 32] >> (2 * (v % 32))) & 3u;
+                if (pair != 3)
+                    literals.push_back(pair == 2 ? symbols[v] : !symbols[v]);
+            }
+            products.push_back(makeAnd(literals));
+        }
+        return makeOr(products);
+    }
+
+}// namespace jazz
@@ -0,0 +1,157 @@
+/**
+ * @file minimize.h
+ *
+ * Two-level minimization: sums of products with few products and literals.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_MINIMIZE_H
+#define BOOLEAN_ALGEBRA_MINIMIZE_H
+
+#include "expr.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace jazz {
+
+    /**
+     * A product over at most 32 variables. Variable i is left out if bit i of dashes is set,
+     * otherwise it occurs positive or negative as bit i of value says. The bits of value
+     * under the dashes are zero.
+     */
+    struct Implicant {
+        std::uint32_t value = 0;
+        std::uint32_t dashes = 0;
+
+        bool covers(std::uint32_t minterm) const { return (minterm & ~dashes) == value; }
+        unsigned numLiterals(unsigned num_vars) const;
+
+        bool operator==(const Implicant &other) const { return value == other.value && dashes == other.dashes; }
+        bool operator!=(const Implicant &other) const { return !(*this == other); }
+    };
+
+    constexpr unsigned MAX_EXACT_VARS = 16;
+
+    /**
+     * The prime implicants of a function of at most MAX_EXACT_VARS variables, true on the
+     * minterms of on and free on those of dc, the largest first.
+     *
+     * Quine-McCluskey on bit sets: the implicants with the same dashes form one bit set over
+     * the values of the other variables, 3^n bits in all. Merging the implicants that differ
+     * in one variable only is an AND of the bit set of one fewer dash with itself shifted by
+     * that variable, word by word, and the implicants merged into a larger one are removed
+     * by the same operations the other way round.
+     */
+    std::vector<Implicant> primeImplicants(unsigned num_vars, const std::vector<std::uint32_t> &on,
+                                           const std::vector<std::uint32_t> &dc = {});
+
+    /**
+     * The fewest primes covering every minterm of on, then the fewest literals.
+     *
+     * The essential primes are taken first. Branch and bound then picks the uncovered
+     * minterm with the fewest candidate primes and tries each of them, pruning the branches
+     * that cannot beat the best cover so far: a set of uncovered minterms no two of which
+     * share a candidate needs that many more primes. A branch costs about the number of
+     * minterms left uncovered. After max_branches branches, the best cover found so far is
+     * returned, which may then not be minimum.
+     */
+    std::vector<Implicant> minimumCover(unsigned num_vars, const std::vector<std::uint32_t> &on,
+                                        const std::vector<Implicant> &primes, std::size_t max_branches = 100000);
+
+    /**
+     * A minimum sum of products of an expression, as an Or of Ands of literals.
+     * @param dont_care  where the value does not matter
+     * @throws std::invalid_argument beyond MAX_EXACT_VARS symbols.
+     */
+    Expr minimizeExact(const Expr &f, const Expr &dont_care = Expr(false));
+
+    /**
+     * A product in positional notation: two bits per variable, the low one set if the variable
+     * may be 0 and the high one if it may be 1, 32 variables to a word. A variable with both
+     * bits set has no literal, one with both clear makes the cube empty.
+     */
+    class Cube {
+    public:
+        explicit Cube(unsigned num_vars = 0);
+
+        unsigned numVars() const { return num_vars; }
+        const std::vector<std::uint64_t> &words() const { return bits; }
+
+        /**
+         * The value of the literal of variable i, or -1 without one.
+         */
+        int literal(unsigned i) const;
+        void setLiteral(unsigned i, bool value);
+        void clearLiteral(unsigned i);
+        unsigned numLiterals() const;
+
+        bool isEmpty() const;
+        bool contains(const Cube &other) const;
+
+        bool operator==(const Cube &other) const { return num_vars == other.num_vars && bits == other.bits; }
+        bool operator!=(const Cube &other) const { return !(*this == other); }
+
+    private:
+        unsigned num_vars;
+        std::vector<std::uint64_t> bits;
+    };
+
+    struct EspressoOptions {
+        /**
+         * The rounds of REDUCE, EXPAND and IRREDUNDANT after the first EXPAND and IRREDUNDANT,
+         * stopping early at the first one that does not improve the cover.
+         */
+        unsigned max_rounds = 8;
+        /**
+         * The splits of one containment check, beyond which the check fails and the cube is
+         * left as it is.
+         */
+        std::size_t split_limit = 4096;
+        /**
+         * The cubes enumerated for an expression that is not a sum of products already.
+         */
+        std::size_t max_initial_cubes = 100000;
+    };
+
+    /**
+     * A small cover of the cubes of on, within those of on and dc, by Espresso's loop: EXPAND
+     * makes each cube prime, removing the cubes it then contains, IRREDUNDANT removes the cubes
+     * the others cover, and REDUCE shrinks each cube to what the others leave for it, so that
+     * the next EXPAND may take another direction. Containment is checked by unate recursive
+     * tautology of cofactors, with no complement of the cover, so that it works on many
+     * variables; each check is bounded by split_limit.
+     * @throws std::invalid_argument if the cubes do not all have the same number of variables.
+     */
+    std::vector<Cube> espresso(const std::vector<Cube> &on, const std::vector<Cube> &dc = {},
+                               const EspressoOptions &options = {});
+
+    /**
+     * A near-minimum sum of products of an expression, as an Or of Ands of literals, for any
+     * number of symbols. A sum of products is taken as the initial cover, another expression is
+     * enumerated into disjoint cubes first.
+     * @param dont_care  where the value does not matter
+     * @throws std::length_error if the initial cover has more than max_initial_cubes cubes.
+     */
+    Expr espresso(const Expr &f, const Expr &dont_care = Expr(false), const EspressoOptions &options = {});
+
+}// namespace jazz
+
+#endif//BOOLEAN_ALGEBRA_MINIMIZE_H
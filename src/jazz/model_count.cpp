@@ -0,0 +1,406 @@
+/**
+ * @file model_count.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "model_count.h"
+#include "bdd.h"
+#include "compiler.h"
+#include "sat.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace jazz {
+
+    namespace {
+
+        using sat::Lit;
+        using sat::Var;
+
+        /**
+         * A DPLL model counter with component decomposition and component caching, over a CNF
+         * with one weight per literal.
+         */
+        template<typename Num>
+        class Counter {
+        public:
+            Counter(std::size_t num_vars, std::vector<Num> positive, std::vector<Num> negative, std::size_t cache_limit)
+                : positive(std::move(positive)), negative(std::move(negative)), occurs(num_vars),
+                  assigns(num_vars, VALUE_UNDEF), var_marks(num_vars, 0), cache_limit(cache_limit) {}
+
+            void addClause(const std::vector<Lit> &clause) {
+                auto c = static_cast<std::uint32_t>(offsets.size() - 1);
+                for (auto lit: clause) {
+                    lits.push_back(lit);
+                    occurs[sat::varOf(lit)].push_back(c);
+                }
+                offsets.push_back(static_cast<std::uint32_t>(lits.size()));
+                clause_marks.push_back(0);
+            }
+
+            Num count() {
+                // the units first, then the components of everything else
+                for (std::uint32_t c = 0; c + 1 < offsets.size(); ++c) {
+                    if (offsets[c + 1] - offsets[c] == 1 && !assign(lits[offsets[c]]))
+                        return Num(0);
+                }
+                Num total = weightOfTrail(0);
+                std::vector<Var> vars;
+                for (Var v = 0; v < assigns.size(); ++v) {
+                    if (assigns[v] == VALUE_UNDEF)
+                        vars.push_back(v);
+                }
+                return total * countSplit(vars);
+            }
+
+        private:
+            static constexpr std::uint8_t VALUE_FALSE = 0;
+            static constexpr std::uint8_t VALUE_TRUE = 1;
+            static constexpr std::uint8_t VALUE_UNDEF = 2;
+
+            struct KeyHash {
+                std::size_t operator()(const std::vector<std::uint32_t> &key) const {
+                    std::size_t h = key.size();
+                    for (auto x: key)
+                        h = h * 0x9e3779b97f4a7c15ull + x;
+                    return h;
+                }
+            };
+
+            std::vector<Num> positive, negative;
+            std::vector<Lit> lits;
+            std::vector<std::uint32_t> offsets{0};
+            std::vector<std::vector<std::uint32_t>> occurs;///< by variable, the clauses it occurs in
+            std::vector<std::uint8_t> assigns;
+            std::vector<Lit> trail;
+
+            std::vector<unsigned> var_marks, clause_marks;
+            unsigned stamp = 0;
+
+            std::unordered_map<std::vector<std::uint32_t>, Num, KeyHash> cache;
+            std::size_t cache_limit;
+
+            std::uint8_t value(Lit lit) const {
+                auto a = assigns[sat::varOf(lit)];
+                return a == VALUE_UNDEF ? a : static_cast<std::uint8_t>(a ^ (lit & 1u));
+            }
+
+            bool isSatisfied(std::uint32_t c) const {
+                for (auto i = offsets[c]; i < offsets[c + 1]; ++i) {
+                    if (value(lits[i]) == VALUE_TRUE)
+                        return true;
+                }
+                return false;
+            }
+
+            /**
+             * Assign a literal and propagate the units it leaves.
+             * @return false on a conflict, the assignments stay on the trail to be undone.
+             */
+            bool assign(Lit lit) {
+                if (value(lit) != VALUE_UNDEF)
+                    return value(lit) == VALUE_TRUE;
+                auto head = trail.size();
+                assigns[sat::varOf(lit)] = static_cast<std::uint8_t>(!sat::isNegative(lit));
+                trail.push_back(lit);
+                for (; head < trail.size(); ++head) {
+                    for (auto c: occurs[sat::varOf(trail[head])]) {
+                        Lit unit = 0;
+                        unsigned open = 0;
+                        bool satisfied = false;
+                        for (auto i = offsets[c]; i < offsets[c + 1] && !satisfied; ++i) {
+                            auto v = value(lits[i]);
+                            satisfied = v == VALUE_TRUE;
+                            if (v == VALUE_UNDEF) {
+                                unit = lits[i];
+                                ++open;
+                            }
+                        }
+                        if (satisfied || open > 1)
+                            continue;
+                        if (open == 0)
+                            return false;
+                        assigns[sat::varOf(unit)] = static_cast<std::uint8_t>(!sat::isNegative(unit));
+                        trail.push_back(unit);
+                    }
+                }
+                return true;
+            }
+
+            void undo(std::size_t size) {
+                while (trail.size() > size) {
+                    assigns[sat::varOf(trail.back())] = VALUE_UNDEF;
+                    trail.pop_back();
+                }
+            }
+
+            Num weightOfTrail(std::size_t from) const {
+                Num w(1);
+                for (auto i = from; i < trail.size(); ++i) {
+                    auto v = sat::varOf(trail[i]);
+                    w *= sat::isNegative(trail[i]) ? negative[v] : positive[v];
+                }
+                return w;
+            }
+
+            /**
+             * Multiply the counts of the connected components of some unassigned variables.
+             * A variable without open clauses is free and weighs both of its literals.
+             */
+            Num countSplit(const std::vector<Var> &vars) {
+                Num total(1);
+                ++stamp;
+                std::vector<std::vector<Var>> components;
+                std::vector<Var> component, stack;
+                for (auto root: vars) {
+                    if (var_marks[root] == stamp)
+                        continue;
+                    var_marks[root] = stamp;
+                    component.clear();
+                    stack.assign(1, root);
+                    while (!stack.empty()) {
+                        auto v = stack.back();
+                        stack.pop_back();
+                        component.push_back(v);
+                        for (auto c: occurs[v]) {
+                            if (clause_marks[c] == stamp || isSatisfied(c))
+                                continue;
+                            clause_marks[c] = stamp;
+                            for (auto i = offsets[c]; i < offsets[c + 1]; ++i) {
+                                auto u = sat::varOf(lits[i]);
+                                if (assigns[u] == VALUE_UNDEF && var_marks[u] != stamp) {
+                                    var_marks[u] = stamp;
+                                    stack.push_back(u);
+                                }
+                            }
+                        }
+                    }
+                    if (component.size() == 1)
+                        total *= positive[root] + negative[root];
+                    else
+                        components.push_back(component);
+                }
+                // the recursion reuses the marks, so count once the whole split is known
+                for (auto &vs: components) {
+                    if (total == Num(0))
+                        break;
+                    total *= countComponent(vs);
+                }
+                return total;
+            }
+
+            /**
+             * The key of a component: its variables, then its open clauses.
+             */
+            std::vector<std::uint32_t> componentKey(std::vector<Var> &vars) {
+                std::sort(vars.begin(), vars.end());
+                std::vector<std::uint32_t> key(vars.begin(), vars.end());
+                key.push_back(~std::uint32_t(0));
+                auto first = key.size();
+                ++stamp;
+                for (auto v: vars) {
+                    for (auto c: occurs[v]) {
+                        if (clause_marks[c] != stamp && !isSatisfied(c)) {
+                            clause_marks[c] = stamp;
+                            key.push_back(c);
+                        }
+                    }
+                }
+                std::sort(key.begin() + static_cast<std::ptrdiff_t>(first), key.end());
+                return key;
+            }
+
+            Num countComponent(std::vector<Var> &vars) {
+                auto key = componentKey(vars);
+                auto it = cache.find(key);
+                if (it != cache.end())
+                    return it->second;
+
+                // branch on the variable in the most open clauses
+                Var best = vars[0];
+                std::size_t best_score = 0;
+                for (auto v: vars) {
+                    std::size_t score = 0;
+                    for (auto c: occurs[v])
+                        score += !isSatisfied(c);
+                    if (score > best_score) {
+                        best = v;
+                        best_score = score;
+                    }
+                }
+
+                Num total(0);
+                std::vector<Var> rest;
+                for (bool negative_branch: {false, true}) {
+                    auto size = trail.size();
+                    if (assign(sat::makeLit(best, negative_branch))) {
+                        rest.clear();
+                        for (auto v: vars) {
+                            if (assigns[v] == VALUE_UNDEF)
+                                rest.push_back(v);
+                        }
+                        auto w = weightOfTrail(size);
+                        total += w * countSplit(rest);
+                    }
+                    undo(size);
+                }
+
+                if (cache.size() >= cache_limit)
+                    cache.clear();
+                cache.emplace(std::move(key), total);
+                return total;
+            }
+        };
+
+        /**
+         * Weighted count of a diagram over all the variables of its manager, level by level.
+         */
+        template<typename Num>
+        class BddCounter {
+        public:
+            BddCounter(bdd::Manager &manager, std::vector<Num> positive, std::vector<Num> negative)
+                : manager(manager), positive(std::move(positive)), negative(std::move(negative)) {}
+
+            Num count(const bdd::Bdd &f) { return gap(0, level(f)) * countFrom(f); }
+
+        private:
+            bdd::Manager &manager;
+            std::vector<Num> positive, negative;///< by variable
+            std::unordered_map<bdd::Edge, Num> memo;
+
+            unsigned level(const bdd::Bdd &f) const {
+                return f.isConstant() ? manager.numVars() : manager.level(f.topVar());
+            }
+
+            /**
+             * The weight of the levels from first to last, excluded, left free.
+             */
+            Num gap(unsigned first, unsigned last) const {
+                Num w(1);
+                for (auto l = first; l < last; ++l) {
+                    auto v = manager.varAt(l);
+                    w *= positive[v] + negative[v];
+                }
+                return w;
+            }
+
+            /**
+             * The count over the levels from the top one of f down.
+             */
+            Num countFrom(const bdd::Bdd &f) {
+                if (f.isConstant())
+                    return Num(f.isOne() ? 1 : 0);
+                auto it = memo.find(f.edge());
+                if (it != memo.end())
+                    return it->second;
+                auto v = f.topVar();
+                auto l = manager.level(v);
+                auto high = f.thenChild(), low = f.elseChild();
+                Num total = positive[v] * gap(l + 1, level(high)) * countFrom(high) +
+                            negative[v] * gap(l + 1, level(low)) * countFrom(low);
+                memo.emplace(f.edge(), total);
+                return total;
+            }
+        };
+
+        /**
+         * Count an expression with weights by symbol, the symbols not in it are free.
+         */
+        template<typename Num>
+        Num countExpr(const Expr &e, const std::unordered_map<Expr, std::pair<Num, Num>, ExprHash, ExprEqual> &weights,
+                      const CountOptions &options) {
+            auto program = compile(e);
+            auto weightOf = [&](const Expr &symbol) {
+                auto it = weights.find(symbol);
+                return it == weights.end() ? std::make_pair(Num(1), Num(1)) : it->second;
+            };
+
+            Num free(1);
+            std::unordered_set<Expr, ExprHash, ExprEqual> inputs;
+            for (std::size_t i = 0; i < program.numInputs(); ++i)
+                inputs.insert(program.input(i));
+            for (const auto &[symbol, w]: weights) {
+                if (!inputs.count(symbol))
+                    free *= w.first + w.second;
+            }
+
+            if (program.numInputs() <= options.bdd_max_vars) {
+                bdd::Manager manager;
+                auto f = bdd::toBDD(manager, e);
+                std::vector<Num> positive, negative;
+                for (unsigned v = 0; v < manager.numVars(); ++v) {
+                    auto w = weightOf(manager.symbolOf(v));
+                    positive.push_back(w.first);
+                    negative.push_back(w.second);
+                }
+                return free * BddCounter<Num>(manager, std::move(positive), std::move(negative)).count(f);
+            }
+
+            // variable i stands for slot i, the gates weigh 1 as their value follows from the inputs
+            std::vector<Num> positive(program.size(), Num(1)), negative(program.size(), Num(1));
+            for (std::size_t i = 0; i < program.numInputs(); ++i) {
+                auto w = weightOf(program.input(i));
+                positive[program.inputSlot(i)] = w.first;
+                negative[program.inputSlot(i)] = w.second;
+            }
+            Counter<Num> counter(program.size(), std::move(positive), std::move(negative), options.cache_limit);
+            counter.addClause({sat::makeLit(0, true)});
+            counter.addClause({program.output(0)});
+            std::vector<Lit> clause;
+            for (std::size_t slot = 0; slot < program.size(); ++slot) {
+                const auto &inst = program.instruction(slot);
+                if (inst.op != Program::OP_AND)
+                    continue;
+                auto y = sat::makeLit(static_cast<Var>(slot));
+                const unsigned *fanins = program.fanins(slot);
+                clause.assign(1, y);
+                for (unsigned i = 0; i < inst.count; ++i) {
+                    counter.addClause({sat::negate(y), fanins[i]});
+                    clause.push_back(sat::negate(fanins[i]));
+                }
+                counter.addClause(clause);
+            }
+            return free * counter.count();
+        }
+
+    }// namespace
+
+    Natural countModels(const Expr &e, const CountOptions &options) {
+        return countExpr<Natural>(e, {}, options);
+    }
+
+    Natural countModels(const Expr &e, const std::vector<Expr> &symbols, const CountOptions &options) {
+        std::unordered_map<Expr, std::pair<Natural, Natural>, ExprHash, ExprEqual> weights;
+        for (const auto &symbol: symbols)
+            weights.emplace(symbol, std::make_pair(Natural(1), Natural(1)));
+        auto program = compile(e);
+        for (std::size_t i = 0; i < program.numInputs(); ++i) {
+            if (!weights.count(program.input(i)))
+                throw std::invalid_argument("countModels(): the expression depends on a symbol not in the list");
+        }
+        return countExpr<Natural>(e, weights, options);
+    }
+
+    double weightedCount(const Expr &e, const LiteralWeights &weights, const CountOptions &options) {
+        return countExpr<double>(e, weights, options);
+    }
+
+}// namespace jazz
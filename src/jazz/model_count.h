@@ -0,0 +1,83 @@
+/**
+ * @file model_count.h
+ *
+ * Exact and weighted model counting.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_MODEL_COUNT_H
+#define BOOLEAN_ALGEBRA_MODEL_COUNT_H
+
+#include "expr.h"
+#include "natural.h"
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace jazz {
+
+    struct CountOptions {
+        /**
+         * Count through a BDD when the expression has at most that many symbols, and with the
+         * component-caching search beyond.
+         */
+        unsigned bdd_max_vars = 16;
+
+        /**
+         * The component cache is cleared once it holds that many entries.
+         */
+        std::size_t cache_limit = std::size_t(1) << 20;
+    };
+
+    /**
+     * The weights of the two literals of a symbol, positive first.
+     */
+    using LiteralWeights = std::unordered_map<Expr, std::pair<double, double>, ExprHash, ExprEqual>;
+
+    /**
+     * The number of satisfying assignments of the symbols of an expression.
+     *
+     * The search branches on the Tseitin encoding of the compiled expression. After every
+     * decision and its unit propagation, the clauses left fall apart into components over
+     * disjoint variables, which are counted separately and multiplied. The count of every
+     * component is cached, keyed by its variables and its clauses still open, so the same
+     * sub-problem reached by other decisions is counted once.
+     */
+    Natural countModels(const Expr &e, const CountOptions &options = {});
+
+    /**
+     * The same over a given set of symbols, the ones the expression does not depend on are
+     * free.
+     * @throws std::invalid_argument if a symbol of the expression is missing.
+     */
+    Natural countModels(const Expr &e, const std::vector<Expr> &symbols, const CountOptions &options = {});
+
+    /**
+     * The sum over the satisfying assignments of the product of the weights of their
+     * literals, over the symbols of the expression and those of the weights. The symbols
+     * without weights weigh 1 in both polarities. With the weights of every symbol summing to
+     * one, it is the probability of the expression.
+     */
+    double weightedCount(const Expr &e, const LiteralWeights &weights, const CountOptions &options = {});
+
+}// namespace jazz
+
+#endif//BOOLEAN_ALGEBRA_MODEL_COUNT_H
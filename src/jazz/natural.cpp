@@ -0,0 +1,153 @@
+/**
+ * @file natural.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "natural.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+#include <stdexcept>
+
+namespace jazz {
+
+    Natural::Natural(std::uint64_t value) {
+        while (value) {
+            limbs.push_back(static_cast<std::uint32_t>(value));
+            value >>= 32;
+        }
+    }
+
+    Natural Natural::pow2(unsigned exponent) {
+        Natural n;
+        n.limbs.assign(exponent / 32 + 1, 0);
+        n.limbs.back() = std::uint32_t(1) << (exponent % 32);
+        return n;
+    }
+
+    void Natural::trim() {
+        while (!limbs.empty() && limbs.back() == 0)
+            limbs.pop_back();
+    }
+
+    Natural &Natural::operator+=(const Natural &other) {
+        if (limbs.size() < other.limbs.size())
+            limbs.resize(other.limbs.size(), 0);
+        std::uint64_t carry = 0;
+        for (std::size_t i = 0; i < limbs.size(); ++i) {
+            carry += limbs[i];
+            if (i < other.limbs.size())
+                carry += other.limbs[i];
+            else if (carry >> 32 == 0) {
+                limbs[i] = static_cast<std::uint32_t>(carry);
+                return *this;
+            }
+            limbs[i] = static_cast<std::uint32_t>(carry);
+            carry >>= 32;
+        }
+        if (carry)
+            limbs.push_back(static_cast<std::uint32_t>(carry));
+        return *this;
+    }
+
+    Natural operator*(const Natural &a, const Natural &b) {
+        Natural product;
+        if (a.isZero() || b.isZero())
+            return product;
+        product.limbs.assign(a.limbs.size() + b.limbs.size(), 0);
+        for (std::size_t i = 0; i < a.limbs.size(); ++i) {
+            std::uint64_t carry = 0;
+            for (std::size_t j = 0; j < b.limbs.size(); ++j) {
+                carry += std::uint64_t(a.limbs[i]) * b.limbs[j] + product.limbs[i + j];
+                product.limbs[i + j] = static_cast<std::uint32_t>(carry);
+                carry >>= 32;
+            }
+            product.limbs[i + b.limbs.size()] = static_cast<std::uint32_t>(carry);
+        }
+        product.trim();
+        return product;
+    }
+
+    Natural &Natural::operator*=(const Natural &other) {
+        return *this = *this * other;
+    }
+
+    bool Natural::operator<(const Natural &other) const {
+        if (limbs.size() != other.limbs.size())
+            return limbs.size() < other.limbs.size();
+        return std::lexicographical_compare(limbs.rbegin(), limbs.rend(), other.limbs.rbegin(), other.limbs.rend());
+    }
+
+    std::size_t Natural::numBits() const {
+        if (limbs.empty())
+            return 0;
+        std::size_t bits = 32 * limbs.size();
+        for (auto top = limbs.back(); !(top & 0x80000000u); top <<= 1)
+            --bits;
+        return bits;
+    }
+
+    std::uint64_t Natural::toUint64() const {
+        if (limbs.size() > 2)
+            throw std::overflow_error("Natural::toUint64(): " + toString() + " does not fit");
+        std::uint64_t value = 0;
+        for (auto i = limbs.size(); i-- > 0;)
+            value = (value << 32) | limbs[i];
+        return value;
+    }
+
+    double Natural::toDouble() const {
+        double value = 0;
+        for (auto i = limbs.size(); i-- > 0;)
+            value = value * 4294967296.0 + limbs[i];
+        return value;
+    }
+
+    std::string Natural::toString() const {
+        if (limbs.empty())
+            return "0";
+        // peel off nine decimal digits at a time
+        std::vector<std::uint32_t> rest = limbs;
+        std::vector<std::uint32_t> chunks;
+        while (!rest.empty()) {
+            std::uint64_t remainder = 0;
+            for (auto i = rest.size(); i-- > 0;) {
+                auto cur = (remainder << 32) | rest[i];
+                rest[i] = static_cast<std::uint32_t>(cur / 1000000000u);
+                remainder = cur % 1000000000u;
+            }
+            chunks.push_back(static_cast<std::uint32_t>(remainder));
+            while (!rest.empty() && rest.back() == 0)
+                rest.pop_back();
+        }
+        std::string s = std::to_string(chunks.back());
+        for (auto i = chunks.size() - 1; i-- > 0;) {
+            auto digits = std::to_string(chunks[i]);
+            s.append(9 - digits.size(), '0');
+            s += digits;
+        }
+        return s;
+    }
+
+    std::ostream &operator<<(std::ostream &out, const Natural &n) {
+        return out << n.toString();
+    }
+
+}// namespace jazz
@@ -0,0 +1,81 @@
+/**
+ * @file natural.h
+ *
+ * Arbitrary-precision natural numbers, for exact counts.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_NATURAL_H
+#define BOOLEAN_ALGEBRA_NATURAL_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace jazz {
+
+    /**
+     * An unsigned integer of any size, stored as 32-bit limbs from the least significant one,
+     * without leading zero limbs.
+     */
+    class Natural {
+    public:
+        Natural(std::uint64_t value = 0);
+
+        static Natural pow2(unsigned exponent);
+
+        Natural &operator+=(const Natural &other);
+        Natural &operator*=(const Natural &other);
+        friend Natural operator+(Natural a, const Natural &b) { return a += b; }
+        friend Natural operator*(const Natural &a, const Natural &b);
+
+        bool operator==(const Natural &other) const { return limbs == other.limbs; }
+        bool operator!=(const Natural &other) const { return limbs != other.limbs; }
+        bool operator<(const Natural &other) const;
+
+        bool isZero() const { return limbs.empty(); }
+        std::size_t numBits() const;
+
+        /**
+         * @throws std::overflow_error if the value does not fit.
+         */
+        std::uint64_t toUint64() const;
+
+        /**
+         * The nearest double, infinity beyond its range.
+         */
+        double toDouble() const;
+
+        /**
+         * In decimal.
+         */
+        std::string toString() const;
+
+    private:
+        std::vector<std::uint32_t> limbs;
+
+        void trim();
+    };
+
+    std::ostream &operator<<(std::ostream &out, const Natural &n);
+
+}// namespace jazz
+
+#endif//BOOLEAN_ALGEBRA_NATURAL_H
@@ -0,0 +1,649 @@
+/**
+ * @file npn.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "npn.h"
+#include "aig_opt.h"
+#include "synthesis.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace jazz {
+
+    namespace {
+
+        using Lit = Aig::Lit;
+
+        /**
+         * The positions of the adjacent swaps going through all the permutations of n
+         * elements, by the Steinhaus-Johnson-Trotter algorithm.
+         */
+        std::vector<unsigned> adjacentSwaps(unsigned n) {
+            std::vector<unsigned> perm(n), swaps;
+            std::vector<int> direction(n, -1);
+            for (unsigned i = 0; i < n; ++i)
+                perm[i] = i;
+            for (;;) {
+                // the largest element whose neighbour in its direction is smaller
+                int mobile = -1;
+                for (unsigned i = 0; i < n; ++i) {
+                    int j = static_cast<int>(i) + direction[perm[i]];
+                    if (j >= 0 && j < static_cast<int>(n) && perm[j] < perm[i] &&
+                        (mobile < 0 || perm[i] > perm[mobile]))
+                        mobile = static_cast<int>(i);
+                }
+                if (mobile < 0)
+                    return swaps;
+                auto element = perm[mobile];
+                int j = mobile + direction[element];
+                std::swap(perm[mobile], perm[j]);
+                swaps.push_back(static_cast<unsigned>(std::min(mobile, j)));
+                for (unsigned e = element + 1; e < n; ++e)
+                    direction[e] = -direction[e];
+            }
+        }
+
+        const std::vector<unsigned> &swapsOf(unsigned n) {
+            static const std::vector<std::vector<unsigned>> all = [] {
+                std::vector<std::vector<unsigned>> swaps;
+                for (unsigned n = 0; n <= tt::MAX_VARS; ++n)
+                    swaps.push_back(adjacentSwaps(n));
+                return swaps;
+            }();
+            return all[n];
+        }
+
+        /**
+         * h(x) with x_i complemented.
+         */
+        inline tt::Table flip(tt::Table h, unsigned i) {
+            auto shift = 1u << i;
+            return ((h & tt::VAR_MASKS[i]) >> shift) | ((h & ~tt::VAR_MASKS[i]) << shift);
+        }
+
+        /**
+         * h(x) with x_i and x_i+1 swapped.
+         */
+        inline tt::Table swapAdjacent(tt::Table h, unsigned i) {
+            auto shift = 1u << i;
+            auto low = tt::VAR_MASKS[i] & ~tt::VAR_MASKS[i + 1];
+            auto high = low << shift;
+            return (h & ~(low | high)) | ((h & low) << shift) | ((h & high) >> shift);
+        }
+
+        /**
+         * Visit every function of the class of f, with the transform giving it from f.
+         */
+        template<typename Visit>
+        void forEachNpn(tt::Table f, unsigned n, Visit &&visit) {
+            auto mask = tt::replicate(~tt::Table(0), n);
+            NpnTransform transform;
+            auto h = tt::replicate(f, n);
+            auto visitBoth = [&] {
+                visit(h, transform);
+                transform.output = true;
+                visit(~h & mask, transform);
+                transform.output = false;
+            };
+            auto visitNegations = [&] {
+                visitBoth();
+                // Gray code order, one input complemented at a time
+                for (unsigned k = 1; k < (1u << n); ++k) {
+                    unsigned i = 0;
+                    while (!((k >> i) & 1u))
+                        ++i;
+                    h = flip(h, i);
+                    for (unsigned j = 0; j < n; ++j) {
+                        if (transform.perm[j] == i)
+                            transform.negations ^= static_cast<std::uint8_t>(1u << j);
+                    }
+                    visitBoth();
+                }
+            };
+            visitNegations();
+            for (auto i: swapsOf(n)) {
+                h = swapAdjacent(h, i);
+                for (unsigned j = 0; j < n; ++j) {
+                    if (transform.perm[j] == i)
+                        transform.perm[j] = static_cast<std::uint8_t>(i + 1);
+                    else if (transform.perm[j] == i + 1)
+                        transform.perm[j] = static_cast<std::uint8_t>(i);
+                }
+                visitNegations();
+            }
+        }
+
+        NpnTransform inverse(const NpnTransform &t, unsigned n) {
+            NpnTransform result;
+            result.output = t.output;
+            for (unsigned j = 0; j < n; ++j) {
+                result.perm[t.perm[j]] = static_cast<std::uint8_t>(j);
+                if ((t.negations >> j) & 1u)
+                    result.negations |= static_cast<std::uint8_t>(1u << t.perm[j]);
+            }
+            return result;
+        }
+
+        /**
+         * The class and transform of every function of 4 variables.
+         */
+        class Npn4Table {
+        public:
+            Npn4Table() : entries(1u << 16) {
+                std::vector<bool> seen(entries.size());
+                // the first function of a class met in increasing order is its representative
+                for (std::uint32_t f = 0; f < entries.size(); ++f) {
+                    if (seen[f])
+                        continue;
+                    auto class_index = static_cast<std::uint8_t>(canonicals.size());
+                    canonicals.push_back(static_cast<std::uint16_t>(f));
+                    forEachNpn(f, 4, [&](tt::Table h, const NpnTransform &t) {
+                        auto member = static_cast<std::uint16_t>(h);
+                        if (seen[member])
+                            return;
+                        seen[member] = true;
+                        std::uint16_t packed = 0;
+                        for (unsigned i = 0; i < 4; ++i)
+                            packed |= static_cast<std::uint16_t>(t.perm[i] << (2 * i));
+                        packed |= static_cast<std::uint16_t>(t.negations << 8);
+                        packed |= static_cast<std::uint16_t>(t.output << 12);
+                        entries[member] = {class_index, packed};
+                    });
+                }
+            }
+
+            unsigned classOf(std::uint16_t truth) const { return entries[truth].class_index; }
+            std::uint16_t canonical(unsigned class_index) const { return canonicals[class_index]; }
+
+            NpnForm form(std::uint16_t truth) const {
+                const auto &entry = entries[truth];
+                NpnForm form;
+                form.canonical = tt::replicate(canonicals[entry.class_index], 4);
+                for (unsigned i = 0; i < 4; ++i)
+                    form.transform.perm[i] = static_cast<std::uint8_t>((entry.transform >> (2 * i)) & 3u);
+                form.transform.negations = static_cast<std::uint8_t>((entry.transform >> 8) & 15u);
+                form.transform.output = (entry.transform >> 12) & 1u;
+                return form;
+            }
+
+        private:
+            struct Entry {
+                std::uint8_t class_index;
+                std::uint16_t transform;///< perm in 2 bits each, then negations, then output
+            };
+
+            std::vector<Entry> entries;
+            std::vector<std::uint16_t> canonicals;
+        };
+
+        const Npn4Table &npn4Table() {
+            static const Npn4Table table;
+            return table;
+        }
+
+        using Entry = NpnDatabase::Entry;
+        static_assert(sizeof(Entry) == 36, "the entries are stored as they are");
+
+        constexpr char MAGIC[8] = {'J', 'A', 'Z', 'Z', 'N', 'P', 'N', '4'};
+
+        /**
+         * The header of a database file, followed by the entries.
+         */
+        struct FileHeader {
+            char magic[8];
+            std::uint32_t num_entries;
+            std::uint32_t entry_size;
+        };
+
+        /**
+         * Simulate an entry on the 16 rows.
+         */
+        std::uint16_t simulate(const Entry &entry) {
+            std::uint16_t values[5 + NpnDatabase::MAX_GATES] = {0};
+            for (unsigned i = 0; i < 4; ++i)
+                values[1 + i] = static_cast<std::uint16_t>(tt::var(i));
+            auto valueOf = [&](unsigned lit) { return static_cast<std::uint16_t>(lit & 1u ? ~values[lit >> 1] : values[lit >> 1]); };
+            for (unsigned g = 0; g < entry.num_gates; ++g)
+                values[5 + g] = valueOf(entry.fanins[2 * g]) & valueOf(entry.fanins[2 * g + 1]);
+            return valueOf(entry.output);
+        }
+
+        Entry makeEntry(std::uint16_t truth, const Aig &aig, bool optimal) {
+            if (aig.numAnds() > NpnDatabase::MAX_GATES)
+                throw std::length_error("NpnDatabase::generate(): too many gates");
+            Entry entry{};
+            entry.truth = truth;
+            entry.num_gates = static_cast<std::uint8_t>(aig.numAnds());
+            entry.optimal = optimal;
+            entry.depth = static_cast<std::uint8_t>(aig.depth());
+            // the inputs are nodes 1 to 4 and the gates follow in order
+            for (unsigned g = 0; g < aig.numAnds(); ++g) {
+                auto node = 5 + g;
+                entry.fanins[2 * g] = static_cast<std::uint8_t>(aig.fanin0(node));
+                entry.fanins[2 * g + 1] = static_cast<std::uint8_t>(aig.fanin1(node));
+            }
+            entry.output = static_cast<std::uint8_t>(aig.output(0));
+            return entry;
+        }
+
+        /**
+         * The entries after the header of a file, if it is a database.
+         */
+        const Entry *checkHeader(const char *data, std::size_t size, const std::string &path) {
+            FileHeader header{};
+            if (size < sizeof(header))
+                throw std::runtime_error("NpnDatabase::load(): truncated file " + path);
+            std::memcpy(&header, data, sizeof(header));
+            if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.entry_size != sizeof(Entry) ||
+                size != sizeof(header) + std::size_t(header.num_entries) * sizeof(Entry))
+                throw std::runtime_error("NpnDatabase::load(): not a database " + path);
+            return reinterpret_cast<const Entry *>(data + sizeof(header));
+        }
+
+        /**
+         * The output of NpnDatabase::generate(100000), in the order of the classes.
+         */
+        const Entry BUILTIN_ENTRIES[] = {
+            {0x0000, 0, 1, 0, 0, {}},
+            {0x0001, 3, 1, 2, 14, {3, 5, 7, 9, 10, 12}},
+            {0x0003, 2, 1, 2, 12, {7, 9, 5, 10}},
+            {0x0006, 5, 1, 3, 18, {3, 4, 2, 5, 7, 9, 11, 13, 14, 17}},
+            {0x0007, 3, 1, 2, 14, {2, 4, 7, 9, 11, 12}},
+            {0x000f, 1, 1, 1, 10, {7, 9}},
+            {0x0016, 7, 1, 4, 22, {2, 6, 3, 7, 9, 11, 4, 13, 5, 12, 17, 19, 14, 20}},
+            {0x0017, 5, 1, 3, 18, {2, 6, 3, 7, 9, 11, 4, 13, 14, 17}},
+            {0x0018, 6, 1, 3, 20, {2, 5, 3, 7, 4, 6, 9, 11, 13, 15, 16, 18}},
+            {0x0019, 5, 1, 3, 18, {2, 5, 2, 7, 9, 11, 4, 13, 14, 17}},
+            {0x001b, 4, 1, 3, 16, {3, 5, 2, 7, 11, 13, 9, 15}},
+            {0x001e, 5, 1, 4, 18, {3, 5, 7, 11, 6, 10, 13, 15, 9, 17}},
+            {0x001f, 3, 1, 3, 14, {3, 5, 6, 11, 9, 13}},
+            {0x003c, 4, 1, 3, 16, {5, 6, 4, 7, 11, 13, 9, 15}},
+            {0x003d, 5, 1, 3, 18, {2, 5, 4, 6, 7, 10, 9, 13, 15, 16}},
+            {0x003f, 2, 1, 2, 12, {4, 6, 9, 11}},
+            {0x0069, 7, 1, 5, 22, {4, 6, 5, 7, 11, 13, 3, 14, 2, 15, 9, 19, 17, 20}},
+            {0x006b, 7, 1, 4, 22, {3, 6, 2, 7, 5, 10, 4, 11, 9, 15, 13, 16, 18, 21}},
+            {0x006f, 5, 1, 4, 18, {2, 4, 3, 5, 11, 13, 6, 15, 9, 17}},
+            {0x007e, 6, 1, 4, 20, {3, 7, 4, 6, 5, 10, 2, 12, 9, 15, 17, 18}},
+            {0x007f, 3, 1, 3, 14, {4, 6, 2, 10, 9, 13}},
+            {0x00ff, 0, 1, 0, 9, {}},
+            {0x0116, 9, 0, 5, 26, {2, 8, 3, 9, 5, 11, 5, 12, 13, 15, 6, 17, 7, 16, 21, 23, 19, 24}},
+            {0x0117, 7, 1, 3, 23, {2, 4, 3, 5, 6, 8, 7, 9, 12, 15, 11, 16, 19, 21}},
+            {0x0118, 8, 0, 4, 24, {2, 5, 6, 8, 7, 9, 3, 14, 4, 15, 13, 17, 11, 19, 20, 22}},
+            {0x0119, 7, 1, 3, 23, {2, 4, 3, 5, 6, 8, 7, 9, 12, 15, 10, 16, 19, 21}},
+            {0x011a, 7, 1, 4, 22, {6, 8, 7, 9, 3, 11, 5, 13, 13, 15, 14, 17, 19, 21}},
+            {0x011b, 6, 1, 3, 21, {3, 5, 2, 9, 6, 8, 7, 12, 10, 15, 17, 19}},
+            {0x011e, 7, 1, 4, 22, {3, 5, 6, 8, 7, 9, 10, 13, 10, 14, 15, 17, 19, 21}},
+            {0x011f, 5, 1, 3, 19, {3, 5, 6, 8, 7, 9, 10, 13, 15, 17}},
+            {0x012c, 8, 0, 4, 24, {3, 6, 2, 8, 7, 9, 5, 11, 13, 15, 15, 17, 5, 19, 21, 23}},
+            {0x012d, 7, 1, 4, 22, {3, 5, 4, 9, 6, 9, 11, 13, 6, 17, 15, 16, 19, 21}},
+            {0x012f, 5, 1, 3, 18, {2, 5, 3, 5, 6, 11, 8, 13, 15, 17}},
+            {0x013c, 7, 1, 4, 23, {4, 6, 5, 7, 9, 13, 8, 12, 11, 14, 3, 16, 19, 21}},
+            {0x013d, 6, 1, 4, 21, {4, 6, 5, 7, 9, 11, 3, 12, 13, 14, 17, 19}},
+            {0x013e, 7, 1, 4, 23, {3, 5, 4, 6, 7, 10, 9, 13, 8, 14, 15, 16, 19, 21}},
+            {0x013f, 5, 1, 3, 19, {3, 7, 4, 6, 5, 10, 9, 13, 15, 17}},
+            {0x0168, 11, 0, 8, 30, {2, 4, 3, 5, 8, 13, 11, 13, 7, 15, 9, 16, 19, 21, 10, 23, 9, 25, 18, 26, 23, 29}},
+            {0x0169, 8, 0, 5, 24, {2, 6, 3, 7, 5, 11, 11, 13, 9, 15, 4, 17, 13, 19, 21, 23}},
+            {0x016a, 9, 0, 5, 26, {2, 6, 3, 7, 3, 9, 4, 11, 8, 13, 5, 15, 13, 16, 21, 23, 19, 25}},
+            {0x016b, 8, 0, 5, 24, {4, 6, 5, 7, 2, 10, 3, 11, 8, 17, 13, 16, 19, 21, 15, 22}},
+            {0x016e, 8, 0, 4, 24, {3, 5, 2, 6, 7, 8, 8, 11, 4, 12, 10, 15, 17, 19, 21, 22}},
+            {0x016f, 6, 1, 4, 20, {2, 4, 3, 5, 8, 13, 11, 13, 6, 17, 15, 19}},
+            {0x017e, 8, 0, 5, 25, {3, 7, 4, 6, 5, 10, 2, 12, 9, 17, 14, 19, 15, 18, 21, 23}},
+            {0x017f, 6, 1, 4, 20, {2, 4, 3, 7, 6, 10, 5, 12, 8, 17, 15, 19}},
+            {0x0180, 7, 1, 3, 23, {3, 5, 2, 6, 4, 9, 7, 8, 12, 14, 10, 16, 19, 21}},
+            {0x0181, 6, 1, 3, 20, {3, 6, 4, 7, 4, 9, 11, 13, 2, 15, 16, 19}},
+            {0x0182, 8, 0, 4, 24, {2, 6, 5, 6, 2, 8, 3, 9, 4, 11, 13, 15, 17, 19, 20, 22}},
+            {0x0183, 6, 1, 3, 20, {2, 6, 5, 6, 2, 8, 4, 11, 13, 15, 17, 18}},
+            {0x0186, 9, 0, 6, 26, {2, 4, 3, 5, 8, 13, 9, 12, 7, 17, 11, 18, 10, 19, 21, 23, 15, 25}},
+            {0x0187, 7, 1, 4, 22, {2, 4, 3, 5, 7, 10, 6, 11, 8, 13, 15, 17, 19, 20}},
+            {0x0189, 5, 1, 3, 19, {2, 4, 3, 5, 9, 10, 7, 12, 15, 17}},
+            {0x018b, 5, 1, 3, 18, {2, 4, 5, 7, 2, 8, 11, 13, 15, 17}},
+            {0x018f, 5, 1, 3, 18, {2, 4, 3, 5, 6, 11, 8, 13, 15, 17}},
+            {0x0196, 11, 0, 6, 31, {5, 6, 4, 7, 11, 13, 3, 15, 2, 14, 17, 19, 5, 7, 3, 22, 9, 21, 8, 24, 27, 29}},
+            {0x0197, 9, 0, 6, 27, {2, 6, 3, 7, 5, 12, 11, 13, 5, 16, 4, 17, 19, 21, 9, 23, 15, 25}},
+            {0x0198, 8, 0, 4, 25, {2, 4, 3, 5, 7, 8, 6, 9, 9, 10, 15, 17, 12, 21, 19, 23}},
+            {0x0199, 6, 1, 3, 20, {3, 4, 4, 9, 6, 8, 2, 13, 11, 15, 17, 18}},
+            {0x019a, 8, 0, 5, 24, {5, 6, 2, 8, 5, 8, 3, 15, 10, 17, 11, 16, 19, 21, 13, 22}},
+            {0x019b, 7, 1, 3, 22, {3, 4, 5, 6, 2, 8, 3, 9, 11, 15, 12, 17, 18, 21}},
+            {0x019e, 10, 0, 5, 29, {3, 5, 9, 11, 8, 10, 13, 15, 2, 4, 11, 19, 9, 21, 7, 17, 6, 22, 25, 27}},
+            {0x019f, 7, 1, 4, 23, {2, 4, 6, 8, 6, 11, 3, 13, 9, 15, 5, 16, 19, 21}},
+            {0x01a8, 6, 1, 3, 20, {5, 7, 3, 8, 2, 9, 10, 13, 11, 15, 17, 19}},
+            {0x01a9, 5, 1, 3, 18, {5, 7, 2, 9, 2, 10, 11, 13, 15, 17}},
+            {0x01aa, 5, 1, 3, 19, {3, 5, 2, 9, 7, 8, 10, 14, 13, 17}},
+            {0x01ab, 4, 1, 3, 16, {5, 7, 2, 8, 3, 11, 13, 15}},
+            {0x01ac, 7, 1, 4, 22, {3, 6, 5, 7, 5, 8, 9, 13, 3, 14, 17, 19, 11, 21}},
+            {0x01ad, 6, 1, 4, 20, {3, 5, 3, 6, 5, 7, 9, 15, 11, 17, 13, 19}},
+            {0x01ae, 6, 1, 4, 21, {4, 7, 7, 8, 3, 11, 9, 15, 12, 14, 17, 19}},
+            {0x01af, 4, 1, 3, 16, {3, 5, 3, 6, 8, 11, 13, 15}},
+            {0x01bc, 8, 0, 4, 25, {3, 4, 5, 7, 6, 10, 9, 13, 8, 12, 15, 16, 3, 18, 21, 23}},
+            {0x01bd, 7, 1, 4, 22, {3, 5, 3, 6, 5, 7, 8, 15, 13, 15, 11, 19, 17, 21}},
+            {0x01be, 8, 0, 5, 25, {3, 5, 5, 9, 8, 11, 7, 13, 6, 12, 3, 17, 15, 21, 19, 23}},
+            {0x01bf, 6, 1, 3, 21, {3, 4, 3, 7, 4, 8, 9, 11, 12, 15, 17, 19}},
+            {0x01e8, 9, 0, 4, 26, {3, 5, 2, 6, 3, 7, 7, 10, 9, 13, 4, 15, 8, 17, 18, 21, 23, 25}},
+            {0x01e9, 7, 1, 4, 23, {4, 6, 5, 7, 3, 11, 9, 13, 12, 14, 15, 16, 19, 21}},
+            {0x01ea, 7, 1, 4, 22, {3, 5, 3, 7, 6, 10, 8, 10, 9, 13, 17, 19, 15, 21}},
+            {0x01eb, 6, 1, 4, 21, {4, 6, 5, 7, 3, 11, 9, 15, 12, 14, 17, 19}},
+            {0x01ee, 5, 1, 3, 19, {3, 5, 7, 8, 9, 11, 10, 12, 15, 17}},
+            {0x01ef, 4, 1, 3, 17, {3, 5, 7, 10, 9, 11, 13, 15}},
+            {0x01fe, 5, 1, 4, 18, {3, 5, 7, 10, 8, 13, 9, 12, 15, 17}},
+            {0x033c, 6, 1, 4, 20, {4, 8, 5, 9, 6, 13, 11, 13, 7, 17, 15, 19}},
+            {0x033d, 7, 1, 4, 22, {4, 6, 5, 7, 2, 12, 8, 13, 9, 14, 11, 17, 19, 20}},
+            {0x033f, 4, 1, 3, 16, {4, 6, 5, 7, 8, 13, 11, 15}},
+            {0x0356, 5, 1, 3, 19, {5, 7, 3, 9, 10, 13, 11, 12, 15, 17}},
+            {0x0357, 3, 1, 2, 15, {5, 7, 3, 9, 11, 13}},
+            {0x0358, 7, 1, 4, 22, {5, 7, 3, 9, 7, 9, 11, 13, 15, 16, 14, 17, 19, 21}},
+            {0x0359, 7, 1, 4, 22, {4, 7, 2, 9, 6, 8, 10, 12, 11, 13, 17, 19, 15, 21}},
+            {0x035a, 6, 1, 4, 21, {3, 9, 4, 8, 6, 10, 11, 13, 7, 16, 15, 19}},
+            {0x035b, 6, 1, 3, 20, {4, 7, 2, 9, 3, 9, 10, 13, 6, 15, 17, 19}},
+            {0x035e, 7, 1, 4, 22, {2, 6, 5, 7, 3, 9, 9, 11, 12, 14, 13, 17, 19, 21}},
+            {0x035f, 4, 1, 3, 17, {3, 9, 4, 8, 7, 13, 11, 15}},
+            {0x0368, 10, 0, 7, 28, {2, 6, 3, 7, 6, 8, 9, 11, 4, 13, 4, 17, 18, 21, 16, 23, 15, 25, 21, 26}},
+            {0x0369, 9, 0, 6, 26, {4, 6, 5, 6, 2, 9, 9, 10, 4, 17, 13, 19, 15, 21, 14, 20, 23, 25}},
+            {0x036a, 8, 0, 5, 25, {4, 6, 5, 8, 2, 10, 3, 11, 7, 12, 9, 15, 17, 20, 19, 23}},
+            {0x036b, 7, 1, 5, 23, {4, 6, 5, 7, 2, 10, 3, 11, 15, 17, 9, 18, 13, 21}},
+            {0x036c, 7, 1, 4, 22, {2, 6, 6, 8, 9, 11, 5, 13, 15, 17, 14, 16, 19, 21}},
+            {0x036d, 9, 0, 5, 27, {2, 9, 7, 11, 6, 10, 13, 15, 2, 6, 9, 19, 5, 17, 4, 20, 23, 25}},
+            {0x036e, 8, 0, 4, 24, {3, 9, 5, 9, 5, 11, 9, 13, 11, 13, 15, 17, 6, 18, 21, 23}},
+            {0x036f, 7, 1, 4, 22, {3, 5, 2, 6, 9, 11, 9, 13, 6, 15, 4, 17, 19, 21}},
+            {0x037c, 7, 1, 4, 22, {2, 6, 5, 7, 4, 10, 8, 13, 9, 12, 15, 19, 17, 20}},
+            {0x037d, 7, 1, 4, 22, {4, 6, 5, 7, 2, 9, 8, 13, 11, 13, 14, 19, 17, 21}},
+            {0x037e, 8, 0, 5, 24, {4, 6, 5, 7, 2, 11, 8, 13, 9, 12, 3, 19, 15, 21, 17, 23}},
+            {0x03c0, 5, 1, 3, 18, {5, 6, 4, 8, 7, 9, 13, 15, 11, 16}},
+            {0x03c1, 6, 1, 3, 21, {5, 7, 2, 9, 4, 9, 10, 13, 6, 14, 17, 19}},
+            {0x03c3, 4, 1, 3, 16, {5, 6, 6, 9, 4, 13, 11, 15}},
+            {0x03c5, 6, 1, 3, 20, {5, 6, 2, 9, 4, 8, 7, 12, 11, 15, 17, 18}},
+            {0x03c6, 6, 1, 4, 21, {3, 9, 4, 9, 7, 11, 5, 14, 12, 15, 17, 19}},
+            {0x03c7, 5, 1, 3, 19, {2, 7, 5, 7, 4, 9, 11, 14, 13, 17}},
+            {0x03cf, 3, 1, 2, 15, {5, 7, 4, 9, 11, 13}},
+            {0x03d4, 7, 1, 4, 23, {4, 6, 5, 7, 2, 11, 9, 13, 8, 12, 15, 16, 19, 21}},
+            {0x03d5, 6, 1, 3, 20, {4, 6, 5, 7, 2, 9, 8, 13, 11, 14, 17, 19}},
+            {0x03d6, 8, 0, 4, 25, {2, 5, 2, 7, 5, 7, 9, 11, 13, 15, 14, 17, 16, 18, 21, 23}},
+            {0x03d7, 5, 1, 4, 19, {4, 6, 5, 7, 2, 11, 9, 15, 13, 17}},
+            {0x03d8, 7, 1, 4, 22, {2, 4, 3, 6, 5, 7, 9, 13, 8, 15, 11, 16, 19, 21}},
+            {0x03d9, 7, 1, 4, 22, {4, 7, 2, 9, 6, 8, 5, 12, 10, 13, 15, 19, 17, 20}},
+            {0x03db, 6, 1, 4, 21, {2, 5, 3, 7, 5, 7, 11, 13, 9, 16, 15, 19}},
+            {0x03dc, 6, 1, 3, 20, {3, 6, 5, 7, 5, 9, 8, 13, 11, 14, 17, 19}},
+            {0x03dd, 5, 1, 3, 19, {2, 5, 5, 8, 9, 11, 7, 12, 15, 17}},
+            {0x03de, 6, 1, 4, 20, {2, 5, 5, 7, 9, 11, 13, 15, 12, 14, 17, 19}},
+            {0x03fc, 4, 1, 3, 17, {5, 7, 9, 11, 8, 10, 13, 15}},
+            {0x0660, 7, 1, 3, 22, {2, 4, 3, 5, 6, 8, 7, 9, 11, 13, 15, 17, 18, 20}},
+            {0x0661, 10, 0, 6, 29, {2, 4, 6, 8, 7, 9, 3, 13, 11, 15, 5, 16, 14, 20, 18, 21, 13, 24, 23, 27}},
+            {0x0662, 7, 1, 4, 22, {3, 4, 2, 5, 6, 8, 7, 9, 10, 17, 13, 19, 15, 21}},
+            {0x0663, 7, 1, 5, 22, {6, 8, 7, 9, 3, 13, 4, 14, 5, 15, 17, 19, 11, 21}},
+            {0x0666, 5, 1, 3, 18, {2, 4, 3, 5, 6, 8, 11, 13, 15, 16}},
+            {0x0667, 7, 1, 3, 22, {2, 4, 3, 5, 6, 8, 7, 9, 11, 15, 12, 17, 18, 21}},
+            {0x0669, 13, 0, 6, 35, {5, 9, 4, 8, 11, 13, 3, 15, 2, 14, 17, 19, 3, 4, 2, 5, 23, 25, 9, 27, 7, 21, 6, 28, 31, 33}},
+            {0x066b, 11, 0, 7, 31, {3, 4, 2, 5, 6, 8, 7, 9, 10, 17, 13, 19, 15, 21, 16, 20, 11, 24, 7, 26, 23, 29}},
+            {0x066f, 7, 1, 4, 22, {3, 4, 2, 5, 6, 8, 7, 9, 11, 17, 13, 18, 15, 21}},
+            {0x0672, 7, 1, 3, 22, {2, 4, 3, 7, 4, 8, 6, 8, 12, 15, 11, 17, 19, 20}},
+            {0x0673, 8, 0, 4, 24, {3, 6, 3, 8, 6, 8, 5, 12, 11, 13, 15, 17, 4, 18, 20, 23}},
+            {0x0676, 6, 1, 3, 20, {2, 4, 3, 5, 6, 8, 7, 12, 11, 15, 17, 18}},
+            {0x0678, 10, 0, 7, 28, {2, 4, 3, 5, 9, 11, 11, 13, 6, 15, 8, 17, 19, 21, 6, 22, 14, 25, 22, 27}},
+            {0x0679, 11, 0, 7, 31, {2, 4, 3, 5, 6, 11, 9, 10, 13, 15, 7, 16, 8, 18, 9, 19, 11, 22, 25, 27, 21, 28}},
+            {0x067a, 8, 0, 6, 24, {6, 8, 7, 9, 4, 13, 2, 14, 7, 15, 3, 18, 11, 21, 17, 22}},
+            {0x067b, 9, 0, 5, 27, {4, 8, 5, 9, 6, 8, 7, 11, 2, 16, 15, 17, 13, 19, 3, 20, 22, 25}},
+            {0x067e, 8, 0, 4, 24, {2, 4, 2, 7, 5, 7, 7, 11, 11, 15, 8, 17, 13, 19, 21, 23}},
+            {0x0690, 8, 0, 5, 24, {2, 4, 3, 5, 7, 9, 11, 13, 6, 16, 8, 17, 19, 21, 15, 22}},
+            {0x0691, 10, 0, 7, 28, {2, 4, 3, 5, 7, 10, 11, 13, 7, 16, 9, 16, 9, 19, 19, 23, 21, 25, 15, 26}},
+            {0x0693, 9, 0, 7, 27, {7, 9, 2, 11, 4, 12, 5, 13, 15, 17, 7, 18, 9, 19, 8, 20, 23, 25}},
+            {0x0696, 7, 1, 4, 22, {3, 4, 2, 5, 6, 9, 11, 13, 6, 17, 15, 16, 19, 21}},
+            {0x0697, 8, 0, 5, 24, {2, 4, 3, 5, 7, 13, 11, 13, 9, 15, 15, 16, 17, 19, 21, 23}},
+            {0x069f, 6, 1, 4, 20, {3, 4, 2, 5, 11, 13, 6, 15, 8, 14, 17, 19}},
+            {0x06b0, 8, 0, 5, 25, {3, 4, 2, 5, 11, 13, 8, 15, 9, 11, 7, 16, 6, 18, 21, 23}},
+            {0x06b1, 9, 0, 6, 27, {2, 4, 3, 5, 3, 9, 6, 15, 13, 17, 8, 18, 9, 19, 11, 20, 23, 25}},
+            {0x06b2, 9, 0, 4, 27, {3, 4, 2, 7, 7, 8, 6, 9, 5, 12, 10, 14, 11, 16, 19, 23, 21, 24}},
+            {0x06b3, 8, 0, 4, 25, {2, 7, 4, 7, 3, 9, 8, 13, 11, 15, 5, 19, 17, 18, 21, 23}},
+            {0x06b4, 8, 0, 5, 25, {5, 8, 3, 4, 2, 10, 13, 15, 9, 13, 7, 17, 6, 18, 21, 23}},
+            {0x06b5, 9, 0, 5, 27, {5, 8, 3, 11, 2, 10, 13, 15, 3, 4, 9, 19, 7, 17, 6, 20, 23, 25}},
+            {0x06b6, 7, 1, 4, 23, {3, 4, 2, 5, 9, 11, 11, 13, 6, 14, 7, 17, 19, 21}},
+            {0x06b7, 8, 0, 5, 25, {3, 4, 2, 7, 7, 10, 4, 12, 8, 13, 17, 19, 11, 20, 15, 23}},
+            {0x06b9, 8, 0, 5, 24, {2, 4, 2, 7, 7, 8, 5, 13, 11, 17, 8, 19, 15, 18, 21, 23}},
+            {0x06bd, 8, 0, 5, 25, {3, 4, 2, 5, 9, 11, 11, 13, 7, 17, 15, 18, 14, 19, 21, 23}},
+            {0x06f0, 7, 1, 4, 22, {5, 7, 2, 8, 8, 11, 7, 13, 14, 17, 15, 16, 19, 21}},
+            {0x06f1, 7, 1, 4, 22, {2, 4, 3, 5, 8, 11, 7, 13, 8, 17, 15, 16, 19, 21}},
+            {0x06f2, 7, 1, 5, 23, {2, 4, 4, 8, 6, 9, 3, 13, 11, 17, 7, 18, 15, 21}},
+            {0x06f6, 6, 1, 4, 21, {3, 4, 2, 5, 6, 9, 11, 13, 7, 17, 15, 19}},
+            {0x06f9, 7, 1, 5, 22, {3, 4, 2, 5, 11, 13, 7, 15, 9, 16, 8, 17, 19, 21}},
+            {0x0776, 7, 1, 3, 22, {2, 4, 3, 5, 6, 8, 7, 9, 11, 15, 12, 16, 18, 21}},
+            {0x0778, 7, 1, 4, 22, {2, 4, 6, 8, 7, 9, 10, 15, 11, 14, 13, 17, 19, 20}},
+            {0x0779, 11, 0, 6, 31, {4, 9, 5, 8, 11, 13, 3, 11, 2, 15, 17, 19, 2, 4, 9, 23, 7, 21, 6, 24, 27, 29}},
+            {0x077a, 7, 1, 4, 22, {2, 4, 6, 8, 7, 9, 2, 14, 11, 15, 17, 19, 13, 21}},
+            {0x077e, 9, 0, 5, 26, {2, 4, 3, 5, 7, 9, 10, 15, 12, 14, 9, 19, 17, 19, 6, 21, 22, 25}},
+            {0x07b0, 7, 1, 3, 23, {2, 4, 3, 4, 7, 8, 6, 9, 11, 14, 13, 16, 19, 21}},
+            {0x07b1, 8, 0, 4, 24, {2, 4, 3, 5, 2, 6, 7, 11, 9, 15, 8, 17, 13, 18, 21, 23}},
+            {0x07b4, 7, 1, 4, 22, {3, 4, 5, 8, 6, 9, 11, 13, 6, 17, 15, 16, 19, 21}},
+            {0x07b5, 7, 1, 5, 23, {5, 8, 6, 9, 2, 11, 4, 15, 7, 15, 12, 17, 19, 21}},
+            {0x07b6, 9, 0, 5, 27, {2, 4, 3, 5, 2, 9, 9, 12, 7, 17, 15, 17, 11, 18, 6, 21, 23, 25}},
+            {0x07bc, 7, 1, 4, 23, {2, 4, 3, 4, 7, 11, 9, 13, 14, 17, 15, 16, 19, 21}},
+            {0x07e0, 7, 1, 3, 23, {2, 4, 3, 5, 7, 8, 6, 9, 11, 14, 13, 16, 19, 21}},
+            {0x07e1, 7, 1, 5, 23, {2, 4, 3, 5, 9, 13, 6, 14, 7, 15, 11, 18, 17, 21}},
+            {0x07e2, 7, 1, 4, 22, {2, 5, 4, 6, 3, 8, 6, 8, 13, 15, 11, 18, 17, 21}},
+            {0x07e3, 7, 1, 4, 22, {3, 5, 3, 8, 9, 11, 7, 13, 6, 15, 4, 16, 19, 21}},
+            {0x07e6, 7, 1, 4, 22, {3, 4, 4, 7, 3, 9, 6, 8, 13, 15, 11, 19, 17, 21}},
+            {0x07e9, 8, 0, 5, 25, {2, 4, 3, 5, 7, 11, 9, 13, 15, 16, 14, 17, 14, 20, 19, 23}},
+            {0x07f0, 5, 1, 3, 19, {2, 4, 7, 8, 6, 9, 11, 12, 15, 17}},
+            {0x07f1, 7, 0, 4, 23, {3, 5, 7, 11, 2, 4, 7, 15, 9, 13, 8, 16, 19, 21}},
+            {0x07f2, 6, 1, 4, 20, {2, 5, 3, 8, 6, 8, 7, 13, 11, 16, 15, 19}},
+            {0x07f8, 5, 1, 4, 19, {2, 4, 7, 11, 9, 13, 8, 12, 15, 17}},
+            {0x0ff0, 3, 1, 2, 15, {7, 8, 6, 9, 11, 13}},
+            {0x1668, 14, 0, 6, 37, {6, 8, 7, 8, 6, 9, 13, 15, 5, 10, 4, 17, 19, 21, 7, 9, 5, 17, 4, 24, 27, 29, 3, 23, 2, 31, 33, 35}},
+            {0x1669, 15, 0, 6, 39, {7, 9, 6, 8, 11, 13, 5, 15, 4, 14, 17, 19, 7, 8, 6, 9, 23, 25, 5, 27, 4, 10, 29, 31, 3, 21, 2, 33, 35, 37}},
+            {0x166a, 12, 0, 6, 33, {4, 8, 5, 8, 5, 9, 6, 15, 10, 15, 2, 18, 3, 19, 17, 23, 16, 22, 21, 24, 25, 27, 27, 29}},
+            {0x166b, 12, 0, 6, 33, {7, 9, 6, 8, 11, 13, 5, 15, 4, 14, 17, 19, 5, 13, 4, 10, 23, 25, 3, 21, 2, 27, 29, 31}},
+            {0x166e, 11, 0, 5, 31, {6, 8, 5, 10, 4, 11, 13, 15, 7, 9, 5, 11, 4, 18, 21, 23, 3, 17, 2, 25, 27, 29}},
+            {0x167e, 11, 0, 6, 30, {2, 6, 3, 7, 4, 10, 4, 11, 5, 11, 13, 15, 8, 19, 17, 21, 20, 23, 13, 27, 25, 29}},
+            {0x1681, 14, 0, 10, 37, {2, 6, 3, 6, 8, 11, 3, 13, 15, 17, 14, 16, 19, 21, 5, 23, 10, 25, 9, 26, 20, 27, 4, 31, 25, 33, 29, 35}},
+            {0x1683, 12, 0, 5, 33, {3, 8, 7, 11, 6, 10, 13, 15, 7, 8, 6, 9, 3, 18, 2, 20, 23, 25, 5, 17, 4, 27, 29, 31}},
+            {0x1686, 10, 0, 6, 29, {2, 4, 3, 5, 9, 11, 8, 13, 11, 13, 6, 17, 15, 20, 19, 21, 7, 25, 23, 27}},
+            {0x1687, 9, 0, 6, 27, {3, 8, 6, 8, 5, 11, 2, 13, 4, 17, 15, 19, 6, 20, 7, 21, 23, 25}},
+            {0x1689, 12, 0, 6, 32, {2, 6, 3, 7, 5, 11, 6, 11, 9, 13, 8, 12, 4, 17, 19, 21, 14, 25, 22, 25, 15, 29, 27, 31}},
+            {0x168b, 11, 0, 5, 31, {3, 8, 7, 11, 6, 10, 13, 15, 7, 8, 3, 18, 2, 9, 21, 23, 5, 17, 4, 25, 27, 29}},
+            {0x168e, 10, 0, 5, 29, {6, 8, 5, 10, 4, 7, 13, 15, 5, 7, 4, 9, 19, 21, 3, 17, 2, 23, 25, 27}},
+            {0x1696, 9, 0, 5, 27, {4, 6, 5, 7, 9, 10, 11, 13, 13, 15, 3, 17, 3, 21, 19, 21, 23, 25}},
+            {0x1697, 10, 0, 6, 29, {2, 4, 3, 5, 9, 10, 8, 12, 13, 15, 11, 17, 6, 19, 7, 20, 23, 25, 25, 26}},
+            {0x1698, 10, 0, 5, 29, {7, 8, 5, 6, 4, 10, 13, 15, 5, 10, 4, 9, 19, 21, 3, 17, 2, 23, 25, 27}},
+            {0x1699, 9, 0, 5, 26, {2, 4, 3, 5, 7, 8, 11, 13, 5, 15, 15, 16, 8, 19, 17, 22, 21, 25}},
+            {0x169a, 9, 0, 5, 26, {5, 6, 4, 8, 2, 11, 6, 12, 11, 13, 2, 19, 15, 18, 17, 23, 21, 24}},
+            {0x169b, 10, 0, 5, 29, {7, 8, 5, 11, 4, 10, 13, 15, 5, 7, 4, 9, 19, 21, 3, 17, 2, 23, 25, 27}},
+            {0x169e, 8, 0, 4, 25, {4, 6, 5, 7, 4, 9, 3, 11, 13, 15, 13, 16, 2, 19, 21, 23}},
+            {0x16a9, 11, 0, 7, 30, {6, 8, 2, 11, 6, 11, 8, 11, 4, 16, 5, 17, 15, 20, 19, 23, 2, 25, 13, 24, 27, 29}},
+            {0x16ac, 9, 0, 4, 26, {3, 6, 5, 7, 2, 8, 5, 8, 12, 14, 13, 15, 10, 17, 19, 21, 23, 25}},
+            {0x16ad, 11, 0, 5, 31, {5, 8, 7, 11, 6, 10, 13, 15, 5, 7, 9, 19, 8, 18, 21, 23, 3, 17, 2, 25, 27, 29}},
+            {0x16bc, 8, 0, 4, 24, {3, 6, 5, 7, 2, 8, 4, 10, 13, 14, 12, 15, 17, 19, 21, 22}},
+            {0x16e9, 9, 0, 6, 27, {5, 7, 4, 6, 11, 13, 3, 15, 2, 11, 17, 19, 9, 21, 8, 20, 23, 25}},
+            {0x177e, 11, 0, 5, 31, {7, 9, 6, 8, 5, 11, 4, 13, 15, 17, 5, 13, 4, 10, 21, 23, 3, 19, 2, 25, 27, 29}},
+            {0x178e, 8, 0, 5, 24, {2, 4, 3, 5, 8, 10, 6, 13, 9, 12, 11, 16, 15, 21, 19, 22}},
+            {0x1796, 9, 0, 6, 27, {2, 4, 3, 5, 11, 13, 7, 14, 9, 15, 13, 17, 6, 18, 19, 21, 23, 25}},
+            {0x1798, 9, 0, 4, 27, {4, 6, 5, 7, 2, 9, 7, 9, 2, 13, 4, 14, 11, 17, 19, 22, 21, 25}},
+            {0x179a, 9, 0, 4, 27, {7, 8, 5, 6, 11, 13, 5, 7, 4, 9, 17, 19, 3, 15, 2, 21, 23, 25}},
+            {0x17ac, 8, 0, 4, 25, {2, 6, 4, 7, 2, 8, 5, 11, 11, 13, 8, 16, 15, 19, 21, 23}},
+            {0x17e8, 7, 1, 5, 23, {2, 4, 3, 5, 6, 13, 11, 15, 9, 17, 8, 16, 19, 21}},
+            {0x18e7, 8, 0, 5, 25, {3, 5, 3, 7, 4, 7, 11, 15, 13, 17, 8, 18, 9, 19, 21, 23}},
+            {0x19e1, 10, 0, 5, 28, {4, 8, 4, 9, 6, 9, 3, 13, 11, 15, 15, 17, 7, 19, 16, 19, 20, 23, 25, 27}},
+            {0x19e3, 10, 0, 7, 28, {2, 6, 7, 9, 2, 11, 5, 11, 13, 15, 8, 18, 13, 21, 16, 22, 17, 23, 25, 27}},
+            {0x19e6, 7, 1, 5, 23, {3, 5, 4, 7, 2, 12, 11, 15, 9, 16, 8, 17, 19, 21}},
+            {0x1bd8, 9, 0, 5, 27, {2, 5, 2, 8, 4, 8, 7, 9, 7, 12, 3, 16, 15, 21, 11, 22, 19, 25}},
+            {0x1be4, 6, 1, 4, 20, {3, 4, 2, 6, 11, 13, 8, 15, 9, 14, 17, 19}},
+            {0x1ee1, 7, 1, 4, 23, {3, 5, 6, 8, 7, 9, 13, 15, 11, 16, 10, 17, 19, 21}},
+            {0x3cc3, 6, 1, 4, 21, {6, 8, 7, 9, 11, 13, 4, 14, 5, 15, 17, 19}},
+            {0x6996, 9, 0, 6, 27, {7, 8, 6, 9, 11, 13, 5, 15, 4, 14, 17, 19, 3, 21, 2, 20, 23, 25}},
+        };
+
+    }// namespace
+
+    NpnForm npnCanonical(tt::Table truth, unsigned n) {
+        if (n > tt::MAX_VARS)
+            throw std::invalid_argument("npnCanonical(): more than " + std::to_string(tt::MAX_VARS) + " variables");
+        NpnForm best;
+        bool first = true;
+        forEachNpn(truth, n, [&](tt::Table h, const NpnTransform &t) {
+            if (first || h < best.canonical) {
+                best.canonical = h;
+                best.transform = t;
+                first = false;
+            }
+        });
+        // the transform gives the representative from the function, and the other way round
+        best.transform = inverse(best.transform, n);
+        return best;
+    }
+
+    tt::Table applyNpn(tt::Table c, unsigned n, const NpnTransform &transform) {
+        if (n > tt::MAX_VARS)
+            throw std::invalid_argument("applyNpn(): more than " + std::to_string(tt::MAX_VARS) + " variables");
+        tt::Table result = 0;
+        for (unsigned x = 0; x < (1u << n); ++x) {
+            unsigned y = 0;
+            for (unsigned i = 0; i < n; ++i)
+                y |= (((x >> transform.perm[i]) ^ (transform.negations >> i)) & 1u) << i;
+            if (((c >> y) & 1u) != transform.output)
+                result |= tt::Table(1) << x;
+        }
+        return tt::replicate(result, n);
+    }
+
+    NpnForm npnCanonical4(std::uint16_t truth) {
+        return npn4Table().form(truth);
+    }
+
+    unsigned npnClass4(std::uint16_t truth) {
+        return npn4Table().classOf(truth);
+    }
+
+    const NpnDatabase &NpnDatabase::builtin() {
+        static const NpnDatabase database(BUILTIN_ENTRIES, sizeof(BUILTIN_ENTRIES) / sizeof(Entry), nullptr);
+        return database;
+    }
+
+    NpnDatabase NpnDatabase::generate(std::uint64_t conflict_limit) {
+        auto entries = std::make_shared<std::vector<Entry>>();
+        for (unsigned c = 0; c < NUM_NPN4_CLASSES; ++c) {
+            auto truth = npn4Table().canonical(c);
+            // the decompositions of rewrite() bound the number of gates
+            Aig library;
+            Lit leaves[4];
+            for (auto &leaf: leaves)
+                leaf = library.addInput();
+            library.addOutput(buildFromLibrary(library, truth, leaves));
+            bool optimal = false;
+            auto bound = std::min<unsigned>(library.numAnds(), MAX_GATES);
+            auto exact = synthesizeAig(truth, 4, bound, conflict_limit, &optimal);
+            if (exact && exact->numAnds() <= library.numAnds())
+                entries->push_back(makeEntry(truth, *exact, optimal));
+            else
+                entries->push_back(makeEntry(truth, library, false));
+        }
+        NpnDatabase database(entries->data(), entries->size(), entries);
+        database.check();
+        return database;
+    }
+
+    void NpnDatabase::check() const {
+        if (num_entries != NUM_NPN4_CLASSES)
+            throw std::runtime_error("NpnDatabase: " + std::to_string(num_entries) + " entries instead of " +
+                                     std::to_string(NUM_NPN4_CLASSES));
+        for (unsigned c = 0; c < num_entries; ++c) {
+            const auto &entry = entries[c];
+            bool valid = entry.truth == npn4Table().canonical(c) && entry.num_gates <= MAX_GATES;
+            for (unsigned g = 0; g < entry.num_gates && valid; ++g)
+                valid = entry.fanins[2 * g] < 2 * (5 + g) && entry.fanins[2 * g + 1] < 2 * (5 + g);
+            valid = valid && entry.output < 2 * (5 + entry.num_gates) && simulate(entry) == entry.truth;
+            if (!valid)
+                throw std::runtime_error("NpnDatabase: invalid entry of class " + std::to_string(c));
+        }
+    }
+
+    Lit NpnDatabase::build(Aig &aig, std::uint16_t truth, const Lit leaves[4]) const {
+        auto form = npnCanonical4(truth);
+        const auto &entry = entries[npnClass4(truth)];
+        Lit signals[5 + MAX_GATES];
+        signals[0] = Aig::FALSE_LIT;
+        // input i of the representative is x_perm[i] ^ n_i
+        for (unsigned i = 0; i < 4; ++i)
+            signals[1 + i] = leaves[form.transform.perm[i]] ^ ((form.transform.negations >> i) & 1u);
+        auto signalOf = [&](unsigned lit) { return signals[lit >> 1] ^ (lit & 1u); };
+        for (unsigned g = 0; g < entry.num_gates; ++g)
+            signals[5 + g] = aig.andOf(signalOf(entry.fanins[2 * g]), signalOf(entry.fanins[2 * g + 1]));
+        return signalOf(entry.output) ^ (form.transform.output ? 1u : 0u);
+    }
+
+    void NpnDatabase::save(const std::string &path) const {
+        std::ofstream out(path, std::ios::binary);
+        FileHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.num_entries = static_cast<std::uint32_t>(num_entries);
+        header.entry_size = sizeof(Entry);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(entries), static_cast<std::streamsize>(num_entries * sizeof(Entry)));
+        if (!out)
+            throw std::runtime_error("NpnDatabase::save(): cannot write " + path);
+    }
+
+#ifdef _WIN32
+    NpnDatabase NpnDatabase::load(const std::string &path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            throw std::runtime_error("NpnDatabase::load(): cannot open " + path);
+        auto text = std::make_shared<std::string>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        const auto *entries = checkHeader(text->data(), text->size(), path);
+        NpnDatabase database(entries, (text->size() - sizeof(FileHeader)) / sizeof(Entry), text);
+        database.check();
+        return database;
+    }
+#else
+    NpnDatabase NpnDatabase::load(const std::string &path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        struct stat info {};
+        if (fd < 0 || fstat(fd, &info) != 0) {
+            if (fd >= 0)
+                close(fd);
+            throw std::runtime_error("NpnDatabase::load(): cannot open " + path);
+        }
+        auto size = static_cast<std::size_t>(info.st_size);
+        if (size < sizeof(FileHeader)) {
+            close(fd);
+            throw std::runtime_error("NpnDatabase::load(): truncated file " + path);
+        }
+        void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        // the mapping stays valid once the file is closed
+        close(fd);
+        if (data == MAP_FAILED)
+            throw std::runtime_error("NpnDatabase::load(): cannot map " + path);
+        std::shared_ptr<const void> storage(data, [size](const void *p) { munmap(const_cast<void *>(p), size); });
+        const auto *entries = checkHeader(static_cast<const char *>(data), size, path);
+        NpnDatabase database(entries, (size - sizeof(FileHeader)) / sizeof(Entry), std::move(storage));
+        database.check();
+        return database;
+    }
+#endif
+
+}// namespace jazz
@@ -0,0 +1,159 @@
+/**
+ * @file npn.h
+ *
+ * NPN canonical forms of small truth tables, and a database of optimal and-inverter graphs
+ * of the classes of functions of 4 variables.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_NPN_H
+#define BOOLEAN_ALGEBRA_NPN_H
+
+#include "aig.h"
+#include "truth_table.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace jazz {
+
+    /**
+     * How a function derives from another one by permuting and complementing the inputs and
+     * complementing the output: f(x) = output ^ c(y), where y_i = x_perm[i] ^ bit i of
+     * negations.
+     */
+    struct NpnTransform {
+        std::uint8_t perm[tt::MAX_VARS] = {0, 1, 2, 3, 4, 5};
+        std::uint8_t negations = 0;
+        bool output = false;
+    };
+
+    /**
+     * The representative of the NPN class of a function, the smallest truth table of the
+     * class, and the transform giving the function from it.
+     */
+    struct NpnForm {
+        tt::Table canonical = 0;
+        NpnTransform transform;
+    };
+
+    /**
+     * The NPN form of a function of n variables, by visiting the whole class: the inputs are
+     * permuted by adjacent swaps and complemented in Gray code order, one word operation per
+     * step, 2 * n! * 2^n steps in all, 7680 for 5 variables.
+     * @throws std::invalid_argument beyond tt::MAX_VARS variables.
+     */
+    NpnForm npnCanonical(tt::Table truth, unsigned n);
+
+    /**
+     * The function of n variables that the transform gives from c.
+     */
+    tt::Table applyNpn(tt::Table c, unsigned n, const NpnTransform &transform);
+
+    constexpr unsigned NUM_NPN4_CLASSES = 222;
+
+    /**
+     * The NPN form of a function of 4 variables from a table of all of them, built on first
+     * use from the 222 classes.
+     */
+    NpnForm npnCanonical4(std::uint16_t truth);
+
+    /**
+     * The index of the class of a function of 4 variables, in the order of the representatives.
+     */
+    unsigned npnClass4(std::uint16_t truth);
+
+    /**
+     * And-inverter graphs of the NPN classes of functions of 4 variables, the fewest AND gates
+     * first and then the smallest depth, looked up in constant time through the table of
+     * npnCanonical4().
+     *
+     * Gates are proven the fewest by exact synthesis when the entry says optimal. Otherwise a
+     * smaller graph was not ruled out within the conflict limit, and the entry is the best one
+     * found, by exact synthesis or by the decompositions of rewrite().
+     */
+    class NpnDatabase {
+    public:
+        static constexpr unsigned MAX_GATES = 15;
+
+        /**
+         * The graph of a representative in the literals of class Aig over node 0, the constant,
+         * nodes 1 to 4, the inputs, and node 5 + g, gate g.
+         */
+        struct Entry {
+            std::uint16_t truth;
+            std::uint8_t num_gates;
+            std::uint8_t optimal;
+            std::uint8_t depth;
+            std::uint8_t output;
+            std::uint8_t fanins[2 * MAX_GATES];
+        };
+
+        /**
+         * The database compiled into the library.
+         */
+        static const NpnDatabase &builtin();
+
+        /**
+         * Compute the database again.
+         * @param conflict_limit  Conflicts per SAT call of the exact synthesis, 0 for none.
+         */
+        static NpnDatabase generate(std::uint64_t conflict_limit);
+
+        /**
+         * Map a database written by save() into memory.
+         * @throws std::runtime_error if the file cannot be read or is no such database.
+         */
+        static NpnDatabase load(const std::string &path);
+
+        /**
+         * Write the entries after a header, in the byte order of the machine.
+         * @throws std::runtime_error if the file cannot be written.
+         */
+        void save(const std::string &path) const;
+
+        std::size_t size() const { return num_entries; }
+        const Entry &operator[](std::size_t class_index) const { return entries[class_index]; }
+
+        /**
+         * The entry of the class of a function.
+         */
+        const Entry &entryOf(std::uint16_t truth) const { return entries[npnClass4(truth)]; }
+
+        /**
+         * Build the graph of a function over the given leaves.
+         */
+        Aig::Lit build(Aig &aig, std::uint16_t truth, const Aig::Lit leaves[4]) const;
+
+    private:
+        NpnDatabase(const Entry *entries, std::size_t num_entries, std::shared_ptr<const void> storage)
+            : entries(entries), num_entries(num_entries), storage(std::move(storage)) {}
+
+        void check() const;
+
+        const Entry *entries;
+        std::size_t num_entries;
+        std::shared_ptr<const void> storage;///< owns the memory of the entries, if any
+    };
+
+}// namespace jazz
+
+#endif//BOOLEAN_ALGEBRA_NPN_H
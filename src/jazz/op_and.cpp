@@ -23,8 +23,10 @@
 #include "boolean.h"
 #include "op_not.h"
 #include "op_or.h"
+#include "simplify.h"
 #include "utils.h"
 #include <algorithm>
+#include <unordered_set>
 
 namespace jazz {
     JAZZ_IMPLEMENT_REGISTERED_CLASS_OPT(And, Basic, print_func<PrintContext>(&And::doPrint));
@@ -52,12 +54,13 @@ bool jazz::And::booleanIsFalse() const {
     return expr_cast<Boolean>(boolean).isFalse();
 }
 void jazz::And::opAnd(const Expr &rhs) {
+    clearFlags(STATUS_FLAG_SIGNATURE_CALCULATED);
     if (booleanIsFalse()) {
         return;
     }
 
     if (is_a<And>(rhs)) {
-        boolean = Expr(booleanIsFalse() && expr_cast<And>(rhs).booleanIsFalse());
+        boolean = Expr(!(booleanIsFalse() || expr_cast<And>(rhs).booleanIsFalse()));
         if (booleanIsFalse()) {
             operands.clear();
         } else {
@@ -111,6 +114,18 @@ jazz::And::And(const jazz::Expr &lhs, const jazz::Expr &rhs) {
 
     simplifyAndList();
 }
+jazz::And::And(std::vector<Expr> list) : boolean(true) {
+    operands.reserve(list.size());
+    for (auto &e : list) {
+        if (is_a<And>(e) && !e.isTrivial()) {
+            const auto &nested = expr_cast<And>(e).operands;
+            operands.insert(operands.end(), nested.begin(), nested.end());
+        } else {
+            operands.push_back(std::move(e));
+        }
+    }
+    simplifyAndList();
+}
 void jazz::And::doPrint(const jazz::PrintContext &context, unsigned int level) const {
     if (precedence() <= level)
         context.os << "(";
@@ -177,15 +192,19 @@ void jazz::And::simplifyAndList() {
 
 
     // p & !p => 0
+    // pairwise for a few operands, through a hash set for many
+    std::unordered_set<Expr, ExprHash, ExprEqual> present;
+    if (operands.size() > 16)
+        present.insert(operands.begin(), operands.end());
+    auto isPresent = [&](const Expr &e) {
+        if (operands.size() > 16)
+            return present.count(e) != 0;
+        return std::any_of(operands.begin(), operands.end(), [&e](const Expr &op) { return op.isEqual(e); });
+    };
     for (auto &operand : operands) {
-        if (is_exactly_a<Not>(operand)) {
-            auto &not_op = expr_cast<Not>(operand);
-            for (auto &op : operands) {
-                if (op.isEqual(expr_cast<Not>(operand).expr)) {
-                    makeTrivialFalse();
-                    return;
-                }
-            }
+        if (is_exactly_a<Not>(operand) && isPresent(expr_cast<Not>(operand).expr)) {
+            makeTrivialFalse();
+            return;
         }
     }
 
@@ -204,6 +223,10 @@ void jazz::And::simplifyAndList() {
     }
 
     operands = std::move(new_operands);
+
+    // p & (p | q) => p, p & (!p | q) => p & q
+    if (simplifyLevel() == SimplifyLevel::SUBSUMPTION && operands.size() > 1 && subsumeOperands(operands, true))
+        makeTrivialFalse();
 }
 
 jazz::Expr jazz::And::subs(const jazz::ExprMap &m, unsigned int options) const {
@@ -251,10 +274,11 @@ bool jazz::And::trivialValue() const {
     }
 }
 void jazz::And::makeTrivialFalse() {
+    clearFlags(STATUS_FLAG_SIGNATURE_CALCULATED);
     boolean = false;
     operands.clear();
 }
 void jazz::And::addOperand(const jazz::Expr &expr) {
     operands.push_back(expr);
-    clearFlags(STATUS_FLAG_SIMPLIFIED);
+    clearFlags(STATUS_FLAG_SIMPLIFIED | STATUS_FLAG_SIGNATURE_CALCULATED);
 }
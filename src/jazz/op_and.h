@@ -33,6 +33,11 @@ namespace jazz {
 
     public:
         And(const Expr &lhs, const Expr &rhs);
+        /**
+         * The conjunction of a whole list, nested conjunctions being flattened, simplified
+         * once instead of once per operand.
+         */
+        explicit And(std::vector<Expr> list);
         unsigned precedence() const override { return 50; }
 
         std::size_t numOperands() const override;
@@ -23,8 +23,10 @@
 #include "op_or.h"
 #include "boolean.h"
 #include "op_not.h"
+#include "simplify.h"
 #include "utils.h"
 #include <algorithm>
+#include <unordered_set>
 
 
 namespace jazz {
@@ -84,7 +86,20 @@ jazz::Or::Or(const jazz::Expr &lhs, const jazz::Expr &rhs) {
 
     simplifyOrList();
 }
+jazz::Or::Or(std::vector<Expr> list) {
+    operands.reserve(list.size());
+    for (auto &e : list) {
+        if (is_a<Or>(e) && !e.isTrivial()) {
+            const auto &nested = expr_cast<Or>(e).operands;
+            operands.insert(operands.end(), nested.begin(), nested.end());
+        } else {
+            operands.push_back(std::move(e));
+        }
+    }
+    simplifyOrList();
+}
 void jazz::Or::opOr(const Expr &rhs) {
+    clearFlags(STATUS_FLAG_SIGNATURE_CALCULATED);
     if (booleanIsTrue())
         return;
 
@@ -182,7 +197,9 @@ jazz::Expr jazz::Or::subs(const jazz::ExprMap &m, unsigned int options) const {
         for (const auto &new_operand : new_operands) {
             expr->opOr(new_operand);
         }
-        return expr->simplified();
+        // take the ownership first, simplified() may return another object.
+        Expr res = *expr;
+        return res.simplified();
     } else {
         return *this;
     }
@@ -215,15 +232,19 @@ void jazz::Or::simplifyOrList() {
     operands.erase(last, operands.end());
 
     // p | !p => 1
+    // pairwise for a few operands, through a hash set for many
+    std::unordered_set<Expr, ExprHash, ExprEqual> present;
+    if (operands.size() > 16)
+        present.insert(operands.begin(), operands.end());
+    auto isPresent = [&](const Expr &e) {
+        if (operands.size() > 16)
+            return present.count(e) != 0;
+        return std::any_of(operands.begin(), operands.end(), [&e](const Expr &op) { return op.isEqual(e); });
+    };
     for (auto &operand : operands) {
-        if (is_exactly_a<Not>(operand)) {
-            auto &not_op = expr_cast<Not>(operand);
-            for (auto &op : operands) {
-                if (op.isEqual(expr_cast<Not>(operand).expr)) {
-                    makeTrivialTrue();
-                    return;
-                }
-            }
+        if (is_exactly_a<Not>(operand) && isPresent(expr_cast<Not>(operand).expr)) {
+            makeTrivialTrue();
+            return;
         }
     }
 
@@ -244,6 +265,10 @@ void jazz::Or::simplifyOrList() {
     }
 
     operands = std::move(new_operands);
+
+    // p | (p & q) => p, p | (!p & q) => p | q
+    if (simplifyLevel() == SimplifyLevel::SUBSUMPTION && operands.size() > 1 && subsumeOperands(operands, false))
+        makeTrivialTrue();
 }
 bool jazz::Or::isTrivial() const {
     return booleanIsTrue() || operands.empty();
@@ -256,12 +281,13 @@ bool jazz::Or::trivialValue() const {
     }
 }
 void jazz::Or::makeTrivialTrue() {
+    clearFlags(STATUS_FLAG_SIGNATURE_CALCULATED);
     boolean = true;
     operands.clear();
 }
 void jazz::Or::addOperand(const jazz::Expr &expr) {
     operands.push_back(expr);
-    clearFlags(STATUS_FLAG_SIMPLIFIED);
+    clearFlags(STATUS_FLAG_SIMPLIFIED | STATUS_FLAG_SIGNATURE_CALCULATED);
 }
 jazz::Expr jazz::Or::simplified() const {
     if (isTrivial()) {
@@ -34,6 +34,11 @@ namespace jazz {
 
     public:
         Or(const Expr &lhs, const Expr &rhs);
+        /**
+         * The disjunction of a whole list, nested disjunctions being flattened, simplified
+         * once instead of once per operand.
+         */
+        explicit Or(std::vector<Expr> list);
         unsigned precedence() const override { return 40; }
         bool isType(unsigned type_flag) const override;
 
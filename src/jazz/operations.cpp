@@ -21,6 +21,7 @@
 #include "op_not.h"
 #include "op_or.h"
 #include "relational.h"
+#include "simplify.h"
 
 
 static int my_ios_index() {
@@ -33,12 +34,22 @@ static inline jazz::PrintContext *get_print_context(std::ios_base &s) {
 }
 
 namespace jazz {
+    /**
+     * The gate, or its only operand once subsumption has dropped the others. The basic
+     * level keeps the gate, as it always did.
+     */
+    inline Expr unwrapped(const Expr &res) {
+        if (simplifyLevel() == SimplifyLevel::BASIC || res.isTrivial())
+            return res;
+        return res.numOperands() == 1 ? res.operand(0) : res;
+    }
+
     inline Expr exOr(const Expr &lhs, const Expr &rhs) {
-        return create<Or>(lhs, rhs);
+        return unwrapped(create<Or>(lhs, rhs));
     }
 
     inline Expr exAnd(const Expr &lhs, const Expr &rhs) {
-        return create<And>(lhs, rhs);
+        return unwrapped(create<And>(lhs, rhs));
     }
 
     Expr operator&(const Expr &lhs, const Expr &rhs) {
@@ -83,7 +94,7 @@ namespace jazz {
     }
     Expr operator!(const Expr &expr) {
         if (expr.isTrivial())
-            return !expr.isTrivial();
+            return !expr.trivialValue();
         else if (is_exactly_a<Not>(expr)) {
             auto &n_expr = expr_cast<Not>(expr);
             if (n_expr.notFlag()) {
@@ -95,6 +106,38 @@ namespace jazz {
         return create<Not>(expr);
     }
 
+    Expr operator^(const Expr &lhs, const Expr &rhs) {
+        if (lhs.isTrivial())
+            return lhs.trivialValue() ? !rhs : rhs;
+        if (rhs.isTrivial())
+            return rhs.trivialValue() ? !lhs : lhs;
+        if (lhs.isEqual(rhs))
+            return false;
+        return (lhs & !rhs) | (!lhs & rhs);
+    }
+
+    Expr makeAnd(std::vector<Expr> operands) {
+        if (operands.empty())
+            return true;
+        if (operands.size() == 1)
+            return operands[0];
+        Expr res = create<And>(std::move(operands));
+        if (res.isTrivial())
+            return res.trivialValue();
+        return res.numOperands() == 1 ? res.operand(0) : res;
+    }
+
+    Expr makeOr(std::vector<Expr> operands) {
+        if (operands.empty())
+            return false;
+        if (operands.size() == 1)
+            return operands[0];
+        Expr res = create<Or>(std::move(operands));
+        if (res.isTrivial())
+            return res.trivialValue();
+        return res.numOperands() == 1 ? res.operand(0) : res;
+    }
+
     std::ostream &operator<<(std::ostream &os, const Expr &e) {
         PrintContext *context = get_print_context(os);
         if (context == nullptr)
@@ -24,6 +24,7 @@
 #define BOOLEAN_ALGEBRA_OPERATORS_H
 
 #include <iosfwd>
+#include <vector>
 
 namespace jazz {
     class Expr;
@@ -35,6 +36,14 @@ namespace jazz {
     Expr operator+(const Expr &lhs, const Expr &rhs);
     Expr operator*(const Expr &lhs, const Expr &rhs);
     Expr operator!(const Expr &expr);
+    Expr operator^(const Expr &lhs, const Expr &rhs);
+
+    /**
+     * The conjunction, resp. disjunction, of a whole list in a single node, instead of folding
+     * operator& or operator| over it, which copies the operands at every step.
+     */
+    Expr makeAnd(std::vector<Expr> operands);
+    Expr makeOr(std::vector<Expr> operands);
 
     // Relational operators
     Expr operator==(const Expr &lhs, const Expr &rhs);
@@ -0,0 +1,193 @@
+/**
+ * @file quantify.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "quantify.h"
+#include "bdd.h"
+#include "boolean.h"
+#include "op_and.h"
+#include "op_not.h"
+#include "op_or.h"
+#include "operations.h"
+#include "symbol.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace jazz {
+
+    static const Basic *nodeOf(const Expr &e) {
+        return &expr_cast<Basic>(e);
+    }
+
+
+    std::size_t CofactorCache::KeyHash::operator()(const Key &key) const {
+        auto h = reinterpret_cast<std::uintptr_t>(key.node) * 0x9e3779b97f4a7c15ull;
+        h ^= reinterpret_cast<std::uintptr_t>(key.var) * 0xc2b2ae3d27d4eb4full + key.value;
+        return static_cast<std::size_t>(h ^ (h >> 29));
+    }
+
+    void CofactorCache::clear() {
+        cofactors.clear();
+        supports.clear();
+    }
+
+    void CofactorCache::Support::add(const Support &other) {
+        mask |= other.mask;
+        low = std::min(low, other.low);
+        high = std::max(high, other.high);
+    }
+
+    /**
+     * The leaves other than the constants count as symbols.
+     */
+    CofactorCache::Support CofactorCache::supportOf(const Expr &e) {
+        Support support;
+        if (e.isTrivial())
+            return support;
+        if (e.numOperands() == 0) {
+            support.mask = std::uint64_t(1) << (e.hashValue() % 64);
+            support.low = support.high = is_a<Symbol>(e) ? expr_cast<Symbol>(e).getSerial() : 0;
+            if (!is_a<Symbol>(e))
+                support.high = ~0u;
+            return support;
+        }
+        auto it = supports.find(nodeOf(e));
+        if (it != supports.end())
+            return it->second.second;
+        for (std::size_t i = 0; i < e.numOperands(); ++i)
+            support.add(supportOf(e.operand(i)));
+        supports.emplace(nodeOf(e), std::make_pair(e, support));
+        return support;
+    }
+
+    bool CofactorCache::mayDependOn(const Expr &f, const Expr &x) {
+        return supportOf(f).mayContain(supportOf(x));
+    }
+
+    Expr CofactorCache::cofactor(const Expr &f, const Expr &x, bool value) {
+        if (!is_a<Symbol>(x))
+            throw std::invalid_argument("CofactorCache::cofactor(): not a symbol");
+        return cofactorRec(f, x, supportOf(x), value);
+    }
+
+    Expr CofactorCache::cofactorRec(const Expr &e, const Expr &x, const Support &symbol, bool value) {
+        if (!supportOf(e).mayContain(symbol))
+            return e;
+        if (e.numOperands() == 0)
+            return e.isEqual(x) ? Expr(value) : e;
+
+        ++num_lookups;
+        Key key{nodeOf(e), nodeOf(x), value};
+        auto it = cofactors.find(key);
+        if (it != cofactors.end()) {
+            ++num_hits;
+            return it->second.result;
+        }
+
+        Expr result;
+        if (is_a<And>(e) || is_a<Or>(e)) {
+            std::vector<Expr> operands;
+            operands.reserve(e.numOperands());
+            bool changed = false;
+            for (std::size_t i = 0; i < e.numOperands(); ++i) {
+                operands.push_back(cofactorRec(e.operand(i), x, symbol, value));
+                changed = changed || nodeOf(operands.back()) != nodeOf(e.operand(i));
+            }
+            if (!changed)
+                result = e;
+            else
+                result = is_a<And>(e) ? makeAnd(std::move(operands)) : makeOr(std::move(operands));
+        } else if (is_a<Not>(e)) {
+            auto operand = cofactorRec(e.operand(0), x, symbol, value);
+            result = nodeOf(operand) == nodeOf(e.operand(0)) ? e : !operand;
+        } else {
+            // relations between bit-vectors and other nodes substitute on their own
+            ExprMap m;
+            m.emplace(x, Expr(value));
+            result = e.subs(m);
+        }
+        cofactors.emplace(key, Entry{e, x, result});
+        return result;
+    }
+
+    Expr CofactorCache::exists(const Expr &f, const std::vector<Expr> &vars) {
+        Expr e = f;
+        for (const auto &x: vars) {
+            if (e.isTrivial())
+                break;
+            if (!mayDependOn(e, x))
+                continue;
+            auto high = cofactor(e, x, true);
+            e = high.isTrivial() && high.trivialValue() ? high : high | cofactor(e, x, false);
+        }
+        return e;
+    }
+
+    Expr CofactorCache::forall(const Expr &f, const std::vector<Expr> &vars) {
+        Expr e = f;
+        for (const auto &x: vars) {
+            if (e.isTrivial())
+                break;
+            if (!mayDependOn(e, x))
+                continue;
+            auto high = cofactor(e, x, true);
+            e = high.isTrivial() && !high.trivialValue() ? high : high & cofactor(e, x, false);
+        }
+        return e;
+    }
+
+    namespace {
+
+        std::vector<unsigned> varsOf(bdd::Manager &manager, const std::vector<Expr> &symbols) {
+            std::vector<unsigned> vars;
+            vars.reserve(symbols.size());
+            for (const auto &x: symbols)
+                vars.push_back(manager.varOf(x));
+            return vars;
+        }
+
+    }// namespace
+
+    Expr cofactor(const Expr &f, const Expr &x, bool value, QuantifyEngine engine) {
+        if (engine == QuantifyEngine::DAG)
+            return CofactorCache().cofactor(f, x, value);
+        bdd::Manager manager;
+        auto g = bdd::toBDD(manager, f);
+        return bdd::toExpr(manager.cofactor(g, manager.varOf(x), value));
+    }
+
+    Expr exists(const Expr &f, const std::vector<Expr> &vars, QuantifyEngine engine) {
+        if (engine == QuantifyEngine::DAG)
+            return CofactorCache().exists(f, vars);
+        bdd::Manager manager;
+        auto g = bdd::toBDD(manager, f);
+        return bdd::toExpr(manager.exists(g, varsOf(manager, vars)));
+    }
+
+    Expr forall(const Expr &f, const std::vector<Expr> &vars, QuantifyEngine engine) {
+        if (engine == QuantifyEngine::DAG)
+            return CofactorCache().forall(f, vars);
+        bdd::Manager manager;
+        auto g = bdd::toBDD(manager, f);
+        return bdd::toExpr(manager.forall(g, varsOf(manager, vars)));
+    }
+
+}// namespace jazz
@@ -0,0 +1,127 @@
+/**
+ * @file quantify.h
+ *
+ * Shannon cofactors, existential and universal quantification.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_QUANTIFY_H
+#define BOOLEAN_ALGEBRA_QUANTIFY_H
+
+#include "expr.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace jazz {
+
+    class Basic;
+
+    enum class QuantifyEngine {
+        DAG,///< on the expression itself, the unaffected sub-expressions stay shared
+        BDD,///< through a decision diagram, the result is its Shannon expansion
+    };
+
+    /**
+     * Cofactors and quantifiers on the expression DAG, with a cache kept across calls.
+     *
+     * Cofactors are cached by node, symbol and value, so a shared sub-expression is
+     * restricted once, whatever the number of paths to it and of calls reaching it. A node
+     * also caches a summary of the symbols below it, a 64-bit mask of their hashes and the
+     * range of their serials: the sub-expressions whose summary excludes the symbol cannot
+     * depend on it and are returned as they are, without being visited. The cache holds
+     * references to the nodes it saw.
+     */
+    class CofactorCache {
+    public:
+        /**
+         * f with x replaced by a constant.
+         */
+        Expr cofactor(const Expr &f, const Expr &x, bool value);
+
+        /**
+         * f|x=0 | f|x=1, for every symbol in turn.
+         */
+        Expr exists(const Expr &f, const std::vector<Expr> &vars);
+
+        /**
+         * f|x=0 & f|x=1, for every symbol in turn.
+         */
+        Expr forall(const Expr &f, const std::vector<Expr> &vars);
+
+        /**
+         * False only if f does not depend on x: x may occur in f and be redundant.
+         */
+        bool mayDependOn(const Expr &f, const Expr &x);
+
+        std::size_t size() const { return cofactors.size(); }
+        std::size_t lookups() const { return num_lookups; }
+        std::size_t hits() const { return num_hits; }
+        void clear();
+
+    private:
+        struct Key {
+            const Basic *node;
+            const Basic *var;
+            bool value;
+
+            bool operator==(const Key &other) const {
+                return node == other.node && var == other.var && value == other.value;
+            }
+        };
+
+        struct KeyHash {
+            std::size_t operator()(const Key &key) const;
+        };
+
+        struct Entry {
+            Expr node;///< keeps the key alive
+            Expr var;
+            Expr result;
+        };
+
+        struct Support {
+            std::uint64_t mask = 0;
+            unsigned low = ~0u;///< smallest serial
+            unsigned high = 0; ///< largest serial
+
+            void add(const Support &other);
+            bool mayContain(const Support &symbol) const {
+                return (mask & symbol.mask) && low <= symbol.low && symbol.high <= high;
+            }
+        };
+
+        std::unordered_map<Key, Entry, KeyHash> cofactors;
+        std::unordered_map<const Basic *, std::pair<Expr, Support>> supports;
+        std::size_t num_lookups = 0;
+        std::size_t num_hits = 0;
+
+        Support supportOf(const Expr &e);
+        Expr cofactorRec(const Expr &e, const Expr &x, const Support &symbol, bool value);
+    };
+
+    Expr cofactor(const Expr &f, const Expr &x, bool value, QuantifyEngine engine = QuantifyEngine::DAG);
+    Expr exists(const Expr &f, const std::vector<Expr> &vars, QuantifyEngine engine = QuantifyEngine::DAG);
+    Expr forall(const Expr &f, const std::vector<Expr> &vars, QuantifyEngine engine = QuantifyEngine::DAG);
+
+}// namespace jazz
+
+#endif//BOOLEAN_ALGEBRA_QUANTIFY_H
@@ -0,0 +1,52 @@
+/**
+ * @file register.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "register.h"
+
+namespace jazz {
+
+    JAZZ_IMPLEMENT_REGISTERED_CLASS_OPT(Register, Symbol, print_func<PrintContext>(&Register::doPrint));
+    JAZZ_IMPLEMENT_COMPARE_SAME_TYPE(Register, other) {
+        return Symbol::compareSameType(other);
+    }
+
+    Register::Register() = default;
+
+    bool Register::isType(unsigned int type_flag) const {
+        return type_flag == TYPE_FLAG_REGISTER || Symbol::isType(type_flag);
+    }
+
+    void Register::doPrint(const jazz::PrintContext &context, unsigned int level) const {
+        context.os << name;
+    }
+
+    JAZZ_IMPLEMENT_REGISTERED_CLASS_OPT(Latch, Register, print_func<PrintContext>(&Latch::doPrint));
+    JAZZ_IMPLEMENT_COMPARE_SAME_TYPE(Latch, other) {
+        return Register::compareSameType(other);
+    }
+
+    Latch::Latch() = default;
+
+    bool Latch::isType(unsigned int type_flag) const {
+        return type_flag == TYPE_FLAG_LATCH || Register::isType(type_flag);
+    }
+
+}// namespace jazz
@@ -0,0 +1,85 @@
+/**
+ * @file register.h
+ *
+ * State elements of sequential circuits.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_REGISTER_H
+#define BOOLEAN_ALGEBRA_REGISTER_H
+
+#include "symbol.h"
+
+namespace jazz {
+
+    /**
+     * The output of an edge-triggered flip-flop.
+     *
+     * Inside combinational logic a register behaves like a symbol holding the current state,
+     * its next state is given by the SequentialNetwork it belongs to.
+     */
+    class Register : public Symbol {
+        JAZZ_DECLARE_REGISTERED_CLASS(Register, Symbol);
+
+    public:
+        explicit Register(std::string name, bool init = false) : Symbol(std::move(name)), init(init) {}
+
+        /**
+         * The state after reset.
+         */
+        bool initValue() const {
+            return init;
+        }
+
+        bool isType(unsigned type_flag) const override;
+
+    protected:
+        void doPrint(const jazz::PrintContext &context, unsigned level) const;
+
+    protected:
+        bool init = false;
+    };
+
+    /**
+     * The output of an enable register, a flip-flop with a load enable.
+     *
+     * At every cycle it loads its data input if its enable input is true, and keeps its state
+     * otherwise. Like any register, the new state is seen at the next cycle only: this is not
+     * a transparent latch, whose output would follow the data within the cycle.
+     */
+    class Latch : public Register {
+        JAZZ_DECLARE_REGISTERED_CLASS(Latch, Register);
+
+    public:
+        explicit Latch(std::string name, bool init = false) : Register(std::move(name), init) {}
+
+        bool isType(unsigned type_flag) const override;
+    };
+
+    inline Expr makeRegister(const char *name, bool init = false) {
+        return Expr(create<Register>(name, init));
+    }
+
+    inline Expr makeLatch(const char *name, bool init = false) {
+        return Expr(create<Latch>(name, init));
+    }
+
+}// namespace jazz
+
+#endif//BOOLEAN_ALGEBRA_REGISTER_H
@@ -21,6 +21,7 @@
  ******************************************************************************/
 
 #include "relational.h"
+#include "bitvec.h"
 #include "hash_seed.h"
 #include "utils.h"
 
@@ -53,6 +53,7 @@ namespace jazz {
 
         Expr left() const { return lhs; }
         Expr right() const { return rhs; }
+        RelationalOp getOp() const { return op; }
 
         bool isType(unsigned type_flag) const override;
 
@@ -0,0 +1,771 @@
+/**
+ * @file sat.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "sat.h"
+#include "aig.h"
+#include "compiler.h"
+#include "fraig.h"
+#include "operations.h"
+#include "signature.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace jazz::sat {
+
+    /**
+     * The Luby sequence 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, ...
+     */
+    static std::uint64_t luby(std::uint64_t i) {
+        std::uint64_t size = 1, seq = 0;
+        while (size < i + 1) {
+            ++seq;
+            size = 2 * size + 1;
+        }
+        while (size - 1 != i) {
+            size = (size - 1) >> 1;
+            --seq;
+            i %= size;
+        }
+        return std::uint64_t(1) << seq;
+    }
+
+    Solver::Solver(const SolverOptions &options) : options(options), max_learnts(options.first_reduce) {}
+
+    Var Solver::newVar() {
+        auto v = static_cast<Var>(assigns.size());
+        assigns.push_back(VALUE_UNDEF);
+        levels.push_back(0);
+        reasons.push_back(NO_REASON);
+        phases.push_back(0);
+        activity.push_back(0);
+        seen.push_back(0);
+        heap_index.push_back(-1);
+        decision.push_back(1);
+        watches.emplace_back();
+        watches.emplace_back();
+        heapInsert(v);
+        return v;
+    }
+
+    void Solver::setDecisionVar(Var v, bool enable) {
+        decision[v] = enable;
+        if (enable && heap_index[v] < 0 && assigns[v] == VALUE_UNDEF)
+            heapInsert(v);
+    }
+
+    float Solver::clauseActivity(CRef c) const {
+        float a;
+        std::memcpy(&a, &arena[c + 2], sizeof a);
+        return a;
+    }
+
+    void Solver::setClauseActivity(CRef c, float a) {
+        std::memcpy(&arena[c + 2], &a, sizeof a);
+    }
+
+    Solver::CRef Solver::allocClause(const Lit *lits, std::size_t size, bool learnt, unsigned lbd) {
+        auto c = static_cast<CRef>(arena.size());
+        arena.push_back(static_cast<std::uint32_t>(size));
+        arena.push_back((lbd << 3) | (learnt ? 1u : 0u));
+        arena.push_back(0);
+        arena.insert(arena.end(), lits, lits + size);
+        return c;
+    }
+
+    void Solver::attachClause(CRef c) {
+        auto lits = clauseLits(c);
+        watches[lits[0]].push_back({c, lits[1]});
+        watches[lits[1]].push_back({c, lits[0]});
+    }
+
+    bool Solver::isLocked(CRef c) {
+        auto first = clauseLits(c)[0];
+        return reasons[varOf(first)] == c && value(first) == VALUE_TRUE;
+    }
+
+    bool Solver::addClause(const Lit *lits, std::size_t size) {
+        if (!ok)
+            return false;
+        cancelUntil(0);
+
+        std::vector<Lit> clause(lits, lits + size);
+        for (auto lit: clause) {
+            while (varOf(lit) >= numVars())
+                newVar();
+        }
+        std::sort(clause.begin(), clause.end());
+        clause.erase(std::unique(clause.begin(), clause.end()), clause.end());
+        std::size_t j = 0;
+        for (std::size_t i = 0; i < clause.size(); ++i) {
+            auto lit = clause[i];
+            if (value(lit) == VALUE_TRUE || (i + 1 < clause.size() && clause[i + 1] == negate(lit)))
+                return true;
+            if (value(lit) != VALUE_FALSE)
+                clause[j++] = lit;
+        }
+        clause.resize(j);
+
+        if (clause.empty())
+            return ok = false;
+        if (clause.size() == 1) {
+            enqueue(clause[0], NO_REASON);
+            return ok = (propagate() == NO_REASON);
+        }
+        auto c = allocClause(clause.data(), clause.size(), false, 0);
+        originals.push_back(c);
+        attachClause(c);
+        return true;
+    }
+
+    void Solver::enqueue(Lit lit, CRef reason) {
+        auto v = varOf(lit);
+        assigns[v] = isNegative(lit) ? VALUE_FALSE : VALUE_TRUE;
+        levels[v] = decisionLevel();
+        reasons[v] = reason;
+        trail.push_back(lit);
+    }
+
+    Solver::CRef Solver::propagate() {
+        CRef conflict = NO_REASON;
+        while (qhead < trail.size()) {
+            auto false_lit = negate(trail[qhead++]);
+            auto &ws = watches[false_lit];
+            ++propagations;
+
+            std::size_t i = 0, j = 0;
+            while (i < ws.size()) {
+                auto w = ws[i];
+                if (value(w.blocker) == VALUE_TRUE) {
+                    ws[j++] = ws[i++];
+                    continue;
+                }
+                ++i;
+                auto lits = clauseLits(w.cref);
+                if (lits[0] == false_lit)
+                    std::swap(lits[0], lits[1]);
+                auto first = lits[0];
+                Watcher fresh{w.cref, first};
+                if (first != w.blocker && value(first) == VALUE_TRUE) {
+                    ws[j++] = fresh;
+                    continue;
+                }
+
+                // look for another literal to watch
+                bool moved = false;
+                for (std::uint32_t k = 2, size = clauseSize(w.cref); k < size; ++k) {
+                    if (value(lits[k]) != VALUE_FALSE) {
+                        lits[1] = lits[k];
+                        lits[k] = false_lit;
+                        watches[lits[1]].push_back(fresh);
+                        moved = true;
+                        break;
+                    }
+                }
+                if (moved)
+                    continue;
+
+                ws[j++] = fresh;
+                if (value(first) == VALUE_FALSE) {
+                    conflict = w.cref;
+                    qhead = trail.size();
+                    while (i < ws.size())
+                        ws[j++] = ws[i++];
+                } else {
+                    enqueue(first, w.cref);
+                }
+            }
+            ws.resize(j);
+        }
+        return conflict;
+    }
+
+    /**
+     * Whether a literal of the learnt clause is implied by the others, following the reasons
+     * back until only literals of the clause are met.
+     */
+    bool Solver::isRedundant(Lit lit) {
+        analyze_stack.assign(1, lit);
+        auto top = analyze_toclear.size();
+        while (!analyze_stack.empty()) {
+            auto c = reasons[varOf(analyze_stack.back())];
+            analyze_stack.pop_back();
+            auto lits = clauseLits(c);
+            for (std::uint32_t k = 1, size = clauseSize(c); k < size; ++k) {
+                auto v = varOf(lits[k]);
+                if (seen[v] || levels[v] == 0)
+                    continue;
+                if (reasons[v] == NO_REASON) {
+                    for (auto i = top; i < analyze_toclear.size(); ++i)
+                        seen[varOf(analyze_toclear[i])] = 0;
+                    analyze_toclear.resize(top);
+                    return false;
+                }
+                seen[v] = 1;
+                analyze_stack.push_back(lits[k]);
+                analyze_toclear.push_back(lits[k]);
+            }
+        }
+        return true;
+    }
+
+    void Solver::analyze(CRef conflict, std::vector<Lit> &learnt, unsigned &backtrack_level, unsigned &lbd) {
+        learnt.assign(1, 0);
+        unsigned paths = 0;
+        bool first = true;
+        Lit p = 0;
+        auto index = trail.size();
+
+        // resolve until a single literal of the conflict level is left
+        do {
+            if (isLearnt(conflict))
+                bumpClause(conflict);
+            auto lits = clauseLits(conflict);
+            for (std::uint32_t k = first ? 0 : 1, size = clauseSize(conflict); k < size; ++k) {
+                auto q = lits[k];
+                auto v = varOf(q);
+                if (seen[v] || levels[v] == 0)
+                    continue;
+                bumpVar(v);
+                seen[v] = 1;
+                if (levels[v] >= decisionLevel())
+                    ++paths;
+                else
+                    learnt.push_back(q);
+            }
+            while (!seen[varOf(trail[--index])]) {
+            }
+            p = trail[index];
+            conflict = reasons[varOf(p)];
+            seen[varOf(p)] = 0;
+            --paths;
+            first = false;
+        } while (paths > 0);
+        learnt[0] = negate(p);
+
+        // drop the literals implied by the others
+        analyze_toclear.assign(learnt.begin(), learnt.end());
+        std::size_t j = 1;
+        for (std::size_t i = 1; i < learnt.size(); ++i) {
+            if (reasons[varOf(learnt[i])] == NO_REASON || !isRedundant(learnt[i]))
+                learnt[j++] = learnt[i];
+        }
+        learnt.resize(j);
+        for (auto lit: analyze_toclear)
+            seen[varOf(lit)] = 0;
+
+        // the second watch goes to the deepest literal, where the solver backtracks to
+        backtrack_level = 0;
+        if (learnt.size() > 1) {
+            std::size_t deepest = 1;
+            for (std::size_t i = 2; i < learnt.size(); ++i) {
+                if (levels[varOf(learnt[i])] > levels[varOf(learnt[deepest])])
+                    deepest = i;
+            }
+            std::swap(learnt[1], learnt[deepest]);
+            backtrack_level = levels[varOf(learnt[1])];
+        }
+
+        if (level_stamps.size() <= decisionLevel())
+            level_stamps.resize(decisionLevel() + 1, 0);
+        ++stamp;
+        lbd = 0;
+        for (auto lit: learnt) {
+            auto level = levels[varOf(lit)];
+            if (level_stamps[level] != stamp) {
+                level_stamps[level] = stamp;
+                ++lbd;
+            }
+        }
+    }
+
+    /**
+     * Collect the assumptions a false assumption follows from, walking the implication graph
+     * back from it. Below the first level every decision is an assumption.
+     */
+    void Solver::analyzeFinal(Lit lit) {
+        failed.assign(1, lit);
+        if (levels[varOf(lit)] == 0)
+            return;
+        seen[varOf(lit)] = 1;
+        for (auto i = trail.size(); i-- > trail_lim[0];) {
+            auto v = varOf(trail[i]);
+            if (!seen[v])
+                continue;
+            auto reason = reasons[v];
+            if (reason == NO_REASON) {
+                failed.push_back(trail[i]);
+            } else {
+                auto lits = clauseLits(reason);
+                for (std::uint32_t k = 1, size = clauseSize(reason); k < size; ++k) {
+                    if (levels[varOf(lits[k])] > 0)
+                        seen[varOf(lits[k])] = 1;
+                }
+            }
+            seen[v] = 0;
+        }
+    }
+
+    void Solver::cancelUntil(unsigned level) {
+        if (decisionLevel() <= level)
+            return;
+        for (auto i = trail.size(); i-- > trail_lim[level];) {
+            auto v = varOf(trail[i]);
+            if (options.phase_saving)
+                phases[v] = static_cast<char>(assigns[v] == VALUE_TRUE);
+            assigns[v] = VALUE_UNDEF;
+            reasons[v] = NO_REASON;
+            if (heap_index[v] < 0 && decision[v])
+                heapInsert(v);
+        }
+        trail.resize(trail_lim[level]);
+        trail_lim.resize(level);
+        qhead = trail.size();
+    }
+
+    Lit Solver::pickBranchLit() {
+        while (!heap.empty()) {
+            auto v = heapPop();
+            if (assigns[v] == VALUE_UNDEF && decision[v])
+                return makeLit(v, !phases[v]);
+        }
+        return ~Lit(0);
+    }
+
+    Solver::SearchResult Solver::search(std::uint64_t max_conflicts) {
+        std::uint64_t local_conflicts = 0;
+        std::vector<Lit> learnt;
+        while (true) {
+            auto conflict = propagate();
+            if (conflict != NO_REASON) {
+                ++conflicts;
+                ++local_conflicts;
+                if (decisionLevel() == 0)
+                    return SearchResult::UNSAT;
+
+                unsigned backtrack_level, lbd;
+                analyze(conflict, learnt, backtrack_level, lbd);
+                cancelUntil(backtrack_level);
+                if (learnt.size() == 1) {
+                    enqueue(learnt[0], NO_REASON);
+                } else {
+                    auto c = allocClause(learnt.data(), learnt.size(), true, lbd);
+                    learnts.push_back(c);
+                    attachClause(c);
+                    bumpClause(c);
+                    enqueue(learnt[0], c);
+                }
+                var_inc /= options.var_decay;
+                clause_inc /= options.clause_decay;
+
+                if (options.conflict_limit && local_conflicts >= options.conflict_limit)
+                    return SearchResult::LIMIT;
+            } else {
+                if (local_conflicts >= max_conflicts)
+                    return SearchResult::RESTART;
+                if (static_cast<double>(learnts.size()) >= max_learnts + static_cast<double>(trail.size()))
+                    reduceLearnts();
+
+                // the assumptions are the first decisions, one level each
+                auto next = ~Lit(0);
+                while (decisionLevel() < assumptions.size()) {
+                    auto p = assumptions[decisionLevel()];
+                    if (value(p) == VALUE_TRUE) {
+                        trail_lim.push_back(trail.size());
+                    } else if (value(p) == VALUE_FALSE) {
+                        analyzeFinal(p);
+                        return SearchResult::FAILED;
+                    } else {
+                        next = p;
+                        break;
+                    }
+                }
+                if (next == ~Lit(0))
+                    next = pickBranchLit();
+                if (next == ~Lit(0))
+                    return SearchResult::SAT;
+                ++decisions;
+                trail_lim.push_back(trail.size());
+                enqueue(next, NO_REASON);
+            }
+        }
+    }
+
+    Result Solver::solve(const std::vector<Lit> &assumptions) {
+        model.clear();
+        failed.clear();
+        if (!ok)
+            return Result::UNSATISFIABLE;
+        this->assumptions = assumptions;
+        for (auto lit: assumptions) {
+            while (varOf(lit) >= numVars())
+                newVar();
+        }
+
+        std::uint64_t spent = 0;
+        for (std::uint64_t round = 0;; ++round) {
+            auto budget = luby(round) * options.restart_unit;
+            if (options.conflict_limit)
+                budget = std::min(budget, options.conflict_limit - spent);
+            auto before = conflicts;
+            auto status = search(budget);
+            spent += conflicts - before;
+            switch (status) {
+                case SearchResult::SAT:
+                    model.resize(numVars());
+                    for (Var v = 0; v < numVars(); ++v)
+                        model[v] = assigns[v] == VALUE_TRUE;
+                    cancelUntil(0);
+                    return Result::SATISFIABLE;
+                case SearchResult::UNSAT:
+                    ok = false;
+                    return Result::UNSATISFIABLE;
+                case SearchResult::FAILED:
+                    cancelUntil(0);
+                    return Result::UNSATISFIABLE;
+                case SearchResult::LIMIT:
+                    cancelUntil(0);
+                    return Result::UNKNOWN;
+                case SearchResult::RESTART:
+                    cancelUntil(0);
+                    ++restarts;
+                    if (options.conflict_limit && spent >= options.conflict_limit)
+                        return Result::UNKNOWN;
+                    break;
+            }
+        }
+    }
+
+    void Solver::reduceLearnts() {
+        // best first: low literal block distance, then high activity
+        std::sort(learnts.begin(), learnts.end(), [this](CRef a, CRef b) {
+            if (clauseLbd(a) != clauseLbd(b))
+                return clauseLbd(a) < clauseLbd(b);
+            return clauseActivity(a) > clauseActivity(b);
+        });
+        std::size_t j = 0;
+        for (std::size_t i = 0; i < learnts.size(); ++i) {
+            auto c = learnts[i];
+            if (i < learnts.size() / 2 || clauseLbd(c) <= 2 || clauseSize(c) == 2 || isLocked(c)) {
+                learnts[j++] = c;
+            } else {
+                arena[c + 1] |= 2u;
+                wasted += 3 + clauseSize(c);
+            }
+        }
+        learnts.resize(j);
+        for (auto &ws: watches) {
+            ws.erase(std::remove_if(ws.begin(), ws.end(), [this](const Watcher &w) { return isDeleted(w.cref); }),
+                     ws.end());
+        }
+        max_learnts += options.reduce_increment;
+        if (wasted * 2 > arena.size())
+            collectGarbage();
+    }
+
+    /**
+     * Compact the arena, moving every live clause and updating the references to it.
+     */
+    void Solver::collectGarbage() {
+        std::vector<std::uint32_t> fresh;
+        fresh.reserve(arena.size() - wasted);
+        auto move = [&](CRef &c) {
+            auto to = static_cast<CRef>(fresh.size());
+            fresh.insert(fresh.end(), arena.begin() + c, arena.begin() + c + 3 + clauseSize(c));
+            // leave a forwarding address in the old copy
+            arena[c + 1] |= 4u;
+            arena[c + 2] = to;
+            c = to;
+        };
+        auto forward = [&](CRef &c) {
+            if (arena[c + 1] & 4u)
+                c = arena[c + 2];
+            else
+                move(c);
+        };
+        for (auto &c: originals)
+            forward(c);
+        for (auto &c: learnts)
+            forward(c);
+        for (auto lit: trail) {
+            auto &reason = reasons[varOf(lit)];
+            if (reason != NO_REASON)
+                forward(reason);
+        }
+        for (auto &ws: watches) {
+            for (auto &w: ws)
+                forward(w.cref);
+        }
+        arena.swap(fresh);
+        wasted = 0;
+    }
+
+    void Solver::bumpVar(Var v) {
+        if ((activity[v] += var_inc) > 1e100) {
+            for (auto &a: activity)
+                a *= 1e-100;
+            var_inc *= 1e-100;
+        }
+        if (heap_index[v] >= 0)
+            heapUp(static_cast<std::size_t>(heap_index[v]));
+    }
+
+    void Solver::bumpClause(CRef c) {
+        auto a = clauseActivity(c) + static_cast<float>(clause_inc);
+        setClauseActivity(c, a);
+        if (a > 1e20f) {
+            for (auto l: learnts)
+                setClauseActivity(l, clauseActivity(l) * 1e-20f);
+            clause_inc *= 1e-20;
+        }
+    }
+
+    void Solver::heapInsert(Var v) {
+        heap_index[v] = static_cast<int>(heap.size());
+        heap.push_back(v);
+        heapUp(heap.size() - 1);
+    }
+
+    Var Solver::heapPop() {
+        auto top = heap[0];
+        heap[0] = heap.back();
+        heap_index[heap[0]] = 0;
+        heap.pop_back();
+        heap_index[top] = -1;
+        if (!heap.empty())
+            heapDown(0);
+        return top;
+    }
+
+    void Solver::heapUp(std::size_t i) {
+        auto v = heap[i];
+        while (i > 0) {
+            auto parent = (i - 1) / 2;
+            if (activity[heap[parent]] >= activity[v])
+                break;
+            heap[i] = heap[parent];
+            heap_index[heap[i]] = static_cast<int>(i);
+            i = parent;
+        }
+        heap[i] = v;
+        heap_index[v] = static_cast<int>(i);
+    }
+
+    void Solver::heapDown(std::size_t i) {
+        auto v = heap[i];
+        while (2 * i + 1 < heap.size()) {
+            auto child = 2 * i + 1;
+            if (child + 1 < heap.size() && activity[heap[child + 1]] > activity[heap[child]])
+                ++child;
+            if (activity[heap[child]] <= activity[v])
+                break;
+            heap[i] = heap[child];
+            heap_index[heap[i]] = static_cast<int>(i);
+            i = child;
+        }
+        heap[i] = v;
+        heap_index[v] = static_cast<int>(i);
+    }
+
+    void encodeProgram(const Program &program, Solver &solver) {
+        while (solver.numVars() < program.size())
+            solver.newVar();
+        solver.addClause({makeLit(0, true)});
+        std::vector<Lit> clause;
+        for (std::size_t slot = 0; slot < program.size(); ++slot) {
+            const auto &inst = program.instruction(slot);
+            if (inst.op != Program::OP_AND)
+                continue;
+            // y <-> l1 & ... & ln
+            auto y = makeLit(static_cast<Var>(slot));
+            const unsigned *lits = program.fanins(slot);
+            clause.assign(1, y);
+            for (unsigned i = 0; i < inst.count; ++i) {
+                solver.addClause({negate(y), lits[i]});
+                clause.push_back(negate(lits[i]));
+            }
+            solver.addClause(clause);
+        }
+    }
+
+}// namespace jazz::sat
+
+namespace jazz {
+
+    /**
+     * Size of the compiled pair from which areEquivalent() sweeps instead of solving a miter.
+     */
+    static constexpr std::size_t SWEEP_THRESHOLD = 2048;
+
+    bool isSatisfiable(const Expr &e) {
+        return findModel(e).has_value();
+    }
+
+    bool isTautology(const Expr &e) {
+        auto program = compile({e});
+        sat::Solver solver;
+        sat::encodeProgram(program, solver);
+        solver.addClause({sat::negate(program.output(0))});
+        return solver.solve() == sat::Result::UNSATISFIABLE;
+    }
+
+    bool areEquivalent(const Expr &a, const Expr &b) {
+        if (!probablyEquivalent(a, b))
+            return false;
+        auto program = compile({a, b});
+        // one miter is slow on large circuits, sweeping them proves the shared parts first
+        if (program.size() > SWEEP_THRESHOLD)
+            return areEquivalent(toAIG(a), toAIG(b));
+        sat::Solver solver;
+        sat::encodeProgram(program, solver);
+        // the outputs differ
+        auto x = program.output(0), y = program.output(1);
+        solver.addClause({x, y});
+        solver.addClause({sat::negate(x), sat::negate(y)});
+        return solver.solve() == sat::Result::UNSATISFIABLE;
+    }
+
+    std::optional<ExprMap> findModel(const Expr &e) {
+        auto program = compile({e});
+        sat::Solver solver;
+        sat::encodeProgram(program, solver);
+        solver.addClause({program.output(0)});
+        if (solver.solve() != sat::Result::SATISFIABLE)
+            return std::nullopt;
+        ExprMap model;
+        for (std::size_t i = 0; i < program.numInputs(); ++i)
+            model.emplace(program.input(i), Expr(solver.modelValue(program.inputSlot(i))));
+        return model;
+    }
+
+    // variable 0 of a session is the constant false, as slot 0 of a program
+    static constexpr sat::Lit FALSE_LIT = 0;
+    static constexpr sat::Lit TRUE_LIT = 1;
+
+    std::size_t Solver::GateHash::operator()(const std::vector<sat::Lit> &fanins) const {
+        std::size_t h = fanins.size();
+        for (auto lit: fanins)
+            h = h * 0x9e3779b97f4a7c15ull + lit;
+        return h;
+    }
+
+    Solver::Solver(const sat::SolverOptions &options) : solver(options) {
+        solver.newVar();
+        solver.addClause({TRUE_LIT});
+    }
+
+    sat::Lit Solver::encode(const Expr &e) {
+        auto program = compile({e});
+        std::vector<sat::Lit> lits(program.size());
+        auto mapped = [&](unsigned lit) { return lits[lit >> 1] ^ (lit & 1u); };
+        std::vector<sat::Lit> fanins, clause;
+        lits[0] = FALSE_LIT;
+        for (std::size_t slot = 1; slot < program.size(); ++slot) {
+            const auto &inst = program.instruction(slot);
+            if (inst.op == Program::OP_INPUT) {
+                auto it = symbol_vars.emplace(program.input(inst.first), 0).first;
+                if (it->second == 0)
+                    it->second = solver.newVar();
+                lits[slot] = sat::makeLit(it->second);
+                continue;
+            }
+            if (inst.op != Program::OP_AND) {
+                lits[slot] = FALSE_LIT;
+                continue;
+            }
+            fanins.clear();
+            const unsigned *in = program.fanins(slot);
+            for (unsigned i = 0; i < inst.count; ++i)
+                fanins.push_back(mapped(in[i]));
+            std::sort(fanins.begin(), fanins.end());
+            fanins.erase(std::unique(fanins.begin(), fanins.end()), fanins.end());
+            // sharing with the earlier constraints can make a fanin constant or complementary
+            if (fanins.front() == FALSE_LIT) {
+                lits[slot] = FALSE_LIT;
+                continue;
+            }
+            if (fanins.front() == TRUE_LIT)
+                fanins.erase(fanins.begin());
+            bool contradiction = false;
+            for (std::size_t i = 1; i < fanins.size(); ++i)
+                contradiction = contradiction || fanins[i] == sat::negate(fanins[i - 1]);
+            if (contradiction) {
+                lits[slot] = FALSE_LIT;
+            } else if (fanins.empty()) {
+                lits[slot] = TRUE_LIT;
+            } else if (fanins.size() == 1) {
+                lits[slot] = fanins[0];
+            } else {
+                auto it = gates.find(fanins);
+                if (it != gates.end()) {
+                    lits[slot] = it->second;
+                    continue;
+                }
+                auto y = sat::makeLit(solver.newVar());
+                clause.assign(1, y);
+                for (auto lit: fanins) {
+                    solver.addClause({sat::negate(y), lit});
+                    clause.push_back(sat::negate(lit));
+                }
+                solver.addClause(clause);
+                gates.emplace(fanins, y);
+                lits[slot] = y;
+            }
+        }
+        return mapped(program.output(0));
+    }
+
+    void Solver::add(const Expr &constraint) {
+        solver.addClause({encode(constraint)});
+    }
+
+    sat::Result Solver::solve(const std::vector<Expr> &assumptions) {
+        std::vector<sat::Lit> lits;
+        lits.reserve(assumptions.size());
+        for (const auto &e: assumptions)
+            lits.push_back(encode(e));
+        auto result = solver.solve(lits);
+        core.clear();
+        if (result == sat::Result::UNSATISFIABLE) {
+            std::vector<char> failed(2 * solver.numVars(), 0);
+            for (auto lit: solver.failedAssumptions())
+                failed[lit] = 1;
+            for (std::size_t i = 0; i < assumptions.size(); ++i) {
+                if (failed[lits[i]])
+                    core.push_back(assumptions[i]);
+            }
+        }
+        return result;
+    }
+
+    bool Solver::modelValue(const Expr &symbol) const {
+        auto it = symbol_vars.find(symbol);
+        return it != symbol_vars.end() && it->second < solver.getModel().size() && solver.modelValue(it->second);
+    }
+
+    ExprMap Solver::getModel() const {
+        ExprMap model;
+        for (const auto &[symbol, v]: symbol_vars)
+            model.emplace(symbol, Expr(modelValue(symbol)));
+        return model;
+    }
+
+}// namespace jazz
@@ -0,0 +1,310 @@
+/**
+ * @file sat.h
+ *
+ * A conflict-driven clause-learning SAT solver, and satisfiability queries over expressions.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_SAT_H
+#define BOOLEAN_ALGEBRA_SAT_H
+
+#include "expr.h"
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace jazz {
+    class Program;
+}
+
+namespace jazz::sat {
+
+    /**
+     * Literals are the variable index shifted left by one, with the lowest bit set for the
+     * negative literal.
+     */
+    using Var = unsigned;
+    using Lit = unsigned;
+
+    inline Lit makeLit(Var v, bool negative = false) { return (v << 1) | (negative ? 1u : 0u); }
+    inline Var varOf(Lit lit) { return lit >> 1; }
+    inline bool isNegative(Lit lit) { return lit & 1u; }
+    inline Lit negate(Lit lit) { return lit ^ 1u; }
+
+    enum class Result {
+        SATISFIABLE,
+        UNSATISFIABLE,
+        UNKNOWN,///< the conflict limit was reached
+    };
+
+    struct SolverOptions {
+        double var_decay = 0.95;      ///< VSIDS activities decay by this factor at every conflict
+        double clause_decay = 0.999;  ///< same for the activities of the learnt clauses
+        unsigned restart_unit = 100;  ///< conflicts per unit of the Luby restart sequence
+        unsigned first_reduce = 2000; ///< learnt clauses kept before the first reduction
+        unsigned reduce_increment = 300;
+        bool phase_saving = true;     ///< branch on the last value of a variable, instead of false
+        std::uint64_t conflict_limit = 0;///< give up after that many conflicts per solve(), 0 for no limit
+    };
+
+    /**
+     * A CDCL solver over clauses stored in one flat arena.
+     *
+     * Propagation watches two literals per clause, with a blocking literal in every watcher.
+     * Decisions follow exponential VSIDS with phase saving, conflicts are analyzed up to the
+     * first unique implication point and the learnt clause is minimized. The solver restarts
+     * along the Luby sequence and regularly drops half of the learnt clauses, keeping those of
+     * low literal block distance.
+     */
+    class Solver {
+    public:
+        explicit Solver(const SolverOptions &options = SolverOptions());
+
+        Var newVar();
+        std::size_t numVars() const { return assigns.size(); }
+
+        /**
+         * Whether the solver may branch on a variable, true for new ones. The solver answers
+         * SATISFIABLE once the decision variables are assigned without conflict: the model is
+         * then partial, the other variables are false unless propagation set them. That is
+         * sound when the clauses over the other variables can always be extended, as the
+         * gates outside a cone of a circuit can.
+         */
+        void setDecisionVar(Var v, bool enable);
+
+        /**
+         * Add a clause between calls to solve().
+         * @return false if the clauses are now known to be unsatisfiable.
+         */
+        bool addClause(const std::vector<Lit> &lits) { return addClause(lits.data(), lits.size()); }
+        bool addClause(const Lit *lits, std::size_t size);
+
+        /**
+         * Solve under assumptions, literals taken as true for this call only. The clauses
+         * learnt meanwhile stay valid without them and are kept for the next calls.
+         */
+        Result solve(const std::vector<Lit> &assumptions = {});
+
+        /**
+         * After solve() answered UNSATISFIABLE under assumptions, a subset of them that is
+         * unsatisfiable together with the clauses. Empty if the clauses alone are.
+         */
+        const std::vector<Lit> &failedAssumptions() const { return failed; }
+
+        /**
+         * The value of a variable in the model found by the last successful solve().
+         */
+        bool modelValue(Var v) const { return model[v]; }
+        const std::vector<bool> &getModel() const { return model; }
+
+        /**
+         * Change SolverOptions::conflict_limit for the next calls.
+         */
+        void setConflictLimit(std::uint64_t limit) { options.conflict_limit = limit; }
+
+        /**
+         * Whether no conflict was found at the top level yet.
+         */
+        bool okay() const { return ok; }
+
+        std::uint64_t numConflicts() const { return conflicts; }
+        std::uint64_t numDecisions() const { return decisions; }
+        std::uint64_t numPropagations() const { return propagations; }
+        std::uint64_t numRestarts() const { return restarts; }
+        std::size_t numClauses() const { return originals.size(); }
+        std::size_t numLearnts() const { return learnts.size(); }
+
+    private:
+        using CRef = std::uint32_t;
+        static constexpr CRef NO_REASON = ~CRef(0);
+        static constexpr std::uint8_t VALUE_FALSE = 0;
+        static constexpr std::uint8_t VALUE_TRUE = 1;
+        static constexpr std::uint8_t VALUE_UNDEF = 2;
+
+        enum class SearchResult { SAT, UNSAT, FAILED, RESTART, LIMIT };
+
+        struct Watcher {
+            CRef cref;
+            Lit blocker;///< another literal of the clause, the clause is skipped while it is true
+        };
+
+        SolverOptions options;
+
+        /*
+         * A clause is a header of three words, the size, the flags (learnt, deleted, moved by
+         * the garbage collector, then the literal block distance from bit 3) and the activity,
+         * followed by the literals. The first two literals are watched.
+         */
+        std::vector<std::uint32_t> arena;
+        std::size_t wasted = 0;
+        std::vector<CRef> originals;
+        std::vector<CRef> learnts;
+        std::vector<std::vector<Watcher>> watches;///< by literal, visited when it becomes false
+
+        std::vector<std::uint8_t> assigns;
+        std::vector<unsigned> levels;
+        std::vector<CRef> reasons;
+        std::vector<char> phases;
+        std::vector<Lit> trail;
+        std::vector<std::size_t> trail_lim;
+        std::size_t qhead = 0;
+
+        std::vector<double> activity;
+        double var_inc = 1;
+        double clause_inc = 1;
+        std::vector<Var> heap;
+        std::vector<int> heap_index;
+        std::vector<char> decision;
+
+        std::vector<char> seen;
+        std::vector<Lit> analyze_stack;
+        std::vector<Lit> analyze_toclear;
+        std::vector<unsigned> level_stamps;
+        unsigned stamp = 0;
+
+        std::vector<Lit> assumptions;
+        std::vector<Lit> failed;
+
+        std::vector<bool> model;
+        bool ok = true;
+        double max_learnts;
+
+        std::uint64_t conflicts = 0;
+        std::uint64_t decisions = 0;
+        std::uint64_t propagations = 0;
+        std::uint64_t restarts = 0;
+
+        std::uint32_t clauseSize(CRef c) const { return arena[c]; }
+        Lit *clauseLits(CRef c) { return arena.data() + c + 3; }
+        bool isLearnt(CRef c) const { return arena[c + 1] & 1u; }
+        bool isDeleted(CRef c) const { return arena[c + 1] & 2u; }
+        unsigned clauseLbd(CRef c) const { return arena[c + 1] >> 3; }
+        float clauseActivity(CRef c) const;
+        void setClauseActivity(CRef c, float a);
+
+        std::uint8_t value(Lit lit) const {
+            auto a = assigns[varOf(lit)];
+            return a == VALUE_UNDEF ? a : static_cast<std::uint8_t>(a ^ (lit & 1u));
+        }
+        unsigned decisionLevel() const { return static_cast<unsigned>(trail_lim.size()); }
+
+        CRef allocClause(const Lit *lits, std::size_t size, bool learnt, unsigned lbd);
+        void attachClause(CRef c);
+        bool isLocked(CRef c);
+        void enqueue(Lit lit, CRef reason);
+        CRef propagate();
+        void analyze(CRef conflict, std::vector<Lit> &learnt, unsigned &backtrack_level, unsigned &lbd);
+        bool isRedundant(Lit lit);
+        void analyzeFinal(Lit lit);
+        void cancelUntil(unsigned level);
+        Lit pickBranchLit();
+        SearchResult search(std::uint64_t max_conflicts);
+        void reduceLearnts();
+        void collectGarbage();
+
+        void bumpVar(Var v);
+        void bumpClause(CRef c);
+        void heapInsert(Var v);
+        Var heapPop();
+        void heapUp(std::size_t i);
+        void heapDown(std::size_t i);
+    };
+
+    /**
+     * Encode a compiled program by Tseitin's transformation: variable i stands for slot i, so
+     * program literals are solver literals. The constant slot is forced false.
+     */
+    void encodeProgram(const Program &program, Solver &solver);
+
+}// namespace jazz::sat
+
+namespace jazz {
+
+    bool isSatisfiable(const Expr &e);
+    bool isTautology(const Expr &e);
+    bool areEquivalent(const Expr &a, const Expr &b);
+
+    /**
+     * A satisfying assignment of an expression.
+     * @return Every symbol the expression depends on, mapped to Expr(true) or Expr(false), or
+     *         nothing if the expression is unsatisfiable.
+     */
+    std::optional<ExprMap> findModel(const Expr &e);
+
+    /**
+     * An incremental satisfiability session over expressions, for many related queries.
+     *
+     * Every constraint is compiled and encoded when it is added. A symbol keeps one variable
+     * for the whole session and equal gates over the same literals are encoded once, so the
+     * later constraints and assumptions reuse what the earlier ones built. The clauses learnt
+     * by a call stay for the next ones.
+     */
+    class Solver {
+    public:
+        explicit Solver(const sat::SolverOptions &options = sat::SolverOptions());
+
+        /**
+         * Assert a constraint for all the later calls.
+         */
+        void add(const Expr &constraint);
+
+        /**
+         * Whether the constraints are satisfiable together with some assumptions, expressions
+         * taken as true for this call only.
+         */
+        sat::Result solve(const std::vector<Expr> &assumptions = {});
+
+        /**
+         * The value of a symbol in the model of the last satisfiable call. The symbols the
+         * session has not seen are free, and reported false.
+         */
+        bool modelValue(const Expr &symbol) const;
+
+        /**
+         * Every symbol of the session mapped to Expr(true) or Expr(false).
+         */
+        ExprMap getModel() const;
+
+        /**
+         * After an unsatisfiable call, the assumptions it depends on, in the order they were
+         * given. Empty if the constraints alone are unsatisfiable.
+         */
+        const std::vector<Expr> &failedAssumptions() const { return core; }
+
+        std::size_t numSymbols() const { return symbol_vars.size(); }
+        const sat::Solver &engine() const { return solver; }
+
+    private:
+        struct GateHash {
+            std::size_t operator()(const std::vector<sat::Lit> &fanins) const;
+        };
+
+        sat::Solver solver;
+        std::unordered_map<Expr, sat::Var, ExprHash, ExprEqual> symbol_vars;
+        std::unordered_map<std::vector<sat::Lit>, sat::Lit, GateHash> gates;///< by sorted fanins
+        std::vector<Expr> core;
+
+        sat::Lit encode(const Expr &e);
+    };
+
+}// namespace jazz
+
+#endif//BOOLEAN_ALGEBRA_SAT_H
@@ -0,0 +1,108 @@
+/**
+ * @file sequential.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "sequential.h"
+#include "operations.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace jazz {
+
+    void SequentialNetwork::checkNewSymbol(const Expr &e) const {
+        auto same = [&e](const Expr &x) { return x.isEqual(e); };
+        if (std::any_of(inputs.begin(), inputs.end(), same) || std::any_of(registers.begin(), registers.end(), same))
+            throw std::invalid_argument("SequentialNetwork: symbol declared twice");
+    }
+
+    void SequentialNetwork::addInput(const Expr &symbol) {
+        if (!symbol.isType(TYPE_FLAG_SYMBOL) || symbol.isType(TYPE_FLAG_REGISTER))
+            throw std::invalid_argument("SequentialNetwork::addInput(): input must be a symbol");
+        checkNewSymbol(symbol);
+        inputs.push_back(symbol);
+    }
+
+    void SequentialNetwork::addOutput(const Expr &e) {
+        outputs.push_back(e);
+    }
+
+    void SequentialNetwork::addRegister(const Expr &reg, const Expr &next) {
+        if (!reg.isType(TYPE_FLAG_REGISTER) || reg.isType(TYPE_FLAG_LATCH))
+            throw std::invalid_argument("SequentialNetwork::addRegister(): not a register");
+        checkNewSymbol(reg);
+        registers.push_back(reg);
+        next_states.push_back(next);
+    }
+
+    void SequentialNetwork::addLatch(const Expr &latch, const Expr &data, const Expr &enable) {
+        if (!latch.isType(TYPE_FLAG_LATCH))
+            throw std::invalid_argument("SequentialNetwork::addLatch(): not a latch");
+        checkNewSymbol(latch);
+        registers.push_back(latch);
+        next_states.push_back((enable & data) | (!enable & latch));
+    }
+
+    CycleSimulator::CycleSimulator(const SequentialNetwork &network)
+        : num_inputs(network.numInputs()), num_outputs(network.numOutputs()) {
+        // outputs first, then the next states; inputs first, then the registers.
+        std::vector<Expr> roots;
+        std::vector<Expr> symbols;
+        roots.reserve(network.numOutputs() + network.numRegisters());
+        symbols.reserve(network.numInputs() + network.numRegisters());
+        for (std::size_t k = 0; k < network.numOutputs(); ++k)
+            roots.push_back(network.output(k));
+        for (std::size_t i = 0; i < network.numRegisters(); ++i)
+            roots.push_back(network.nextState(i));
+        for (std::size_t i = 0; i < network.numInputs(); ++i)
+            symbols.push_back(network.input(i));
+        for (std::size_t i = 0; i < network.numRegisters(); ++i) {
+            symbols.push_back(network.getRegister(i));
+            init_values.push_back(expr_cast<Register>(network.getRegister(i)).initValue());
+        }
+
+        program = compile(roots, symbols);
+        values.assign(symbols.size(), 0);
+        buffer.assign(program.size(), 0);
+        outputs.assign(num_outputs, 0);
+        reset();
+    }
+
+    void CycleSimulator::reset() {
+        for (std::size_t i = 0; i < init_values.size(); ++i)
+            setState(i, init_values[i] ? ~std::uint64_t(0) : 0);
+        num_cycles = 0;
+    }
+
+    void CycleSimulator::step() {
+        program.run(values.data(), buffer.data());
+        for (std::size_t k = 0; k < num_outputs; ++k)
+            outputs[k] = Program::valueOf(buffer.data(), program.output(k));
+        for (std::size_t i = 0; i < init_values.size(); ++i)
+            values[num_inputs + i] = Program::valueOf(buffer.data(), program.output(num_outputs + i));
+        ++num_cycles;
+    }
+
+    void CycleSimulator::run(std::size_t cycles) {
+        for (std::size_t c = 0; c < cycles; ++c)
+            step();
+    }
+
+}// namespace jazz
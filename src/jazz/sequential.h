@@ -0,0 +1,140 @@
+/**
+ * @file sequential.h
+ *
+ * Sequential networks and their cycle-accurate simulation.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_SEQUENTIAL_H
+#define BOOLEAN_ALGEBRA_SEQUENTIAL_H
+
+#include "compiler.h"
+#include "register.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace jazz {
+
+    /**
+     * A synchronous circuit: primary inputs, registers and latches with their next-state
+     * functions, and outputs. Outputs and next states are expressions over the inputs and the
+     * current states.
+     */
+    class SequentialNetwork {
+    public:
+        /**
+         * Declare a primary input.
+         * @param symbol  A symbol which is not a register.
+         */
+        void addInput(const Expr &symbol);
+
+        /**
+         * Declare an output, a function of the inputs and the current states.
+         */
+        void addOutput(const Expr &e);
+
+        /**
+         * Declare a flip-flop.
+         * @param reg   The register, see makeRegister().
+         * @param next  Its state at the next cycle.
+         */
+        void addRegister(const Expr &reg, const Expr &next);
+
+        /**
+         * Declare an enable register, its next state is data if enable is true, its current
+         * state otherwise. The output is the state of the cycle, not data, even while enable is
+         * true.
+         * @param latch  The register, see makeLatch().
+         */
+        void addLatch(const Expr &latch, const Expr &data, const Expr &enable);
+
+        std::size_t numInputs() const { return inputs.size(); }
+        const Expr &input(std::size_t i) const { return inputs[i]; }
+        std::size_t numOutputs() const { return outputs.size(); }
+        const Expr &output(std::size_t k) const { return outputs[k]; }
+        std::size_t numRegisters() const { return registers.size(); }
+        const Expr &getRegister(std::size_t i) const { return registers[i]; }
+        const Expr &nextState(std::size_t i) const { return next_states[i]; }
+
+    private:
+        void checkNewSymbol(const Expr &e) const;
+
+    private:
+        std::vector<Expr> inputs;
+        std::vector<Expr> outputs;
+        std::vector<Expr> registers;
+        std::vector<Expr> next_states;
+    };
+
+    /**
+     * Cycle-accurate simulation of a sequential network.
+     *
+     * The outputs and next-state functions are compiled once into a single program. Every
+     * signal is a 64-bit word, bit i of every word belongs to the i-th of 64 independent runs.
+     */
+    class CycleSimulator {
+    public:
+        explicit CycleSimulator(const SequentialNetwork &network);
+
+        /**
+         * Put every register of every run to its init value.
+         */
+        void reset();
+
+        /**
+         * Set an input, bit i of the word goes to the i-th run.
+         */
+        void setInput(std::size_t i, std::uint64_t word) { values[i] = word; }
+
+        std::uint64_t state(std::size_t i) const { return values[num_inputs + i]; }
+        void setState(std::size_t i, std::uint64_t word) { values[num_inputs + i] = word; }
+
+        /**
+         * Simulate one clock cycle: compute the outputs from the current inputs and states,
+         * then move every register to its next state.
+         */
+        void step();
+
+        /**
+         * Simulate several cycles with the inputs unchanged.
+         */
+        void run(std::size_t cycles);
+
+        /**
+         * The outputs computed by the last step().
+         */
+        std::uint64_t output(std::size_t k) const { return outputs[k]; }
+
+        std::size_t cycles() const { return num_cycles; }
+
+    private:
+        Program program;
+        std::size_t num_inputs;
+        std::size_t num_outputs;
+        std::vector<bool> init_values;
+        std::vector<std::uint64_t> values;
+        std::vector<std::uint64_t> buffer;
+        std::vector<std::uint64_t> outputs;
+        std::size_t num_cycles = 0;
+    };
+
+}// namespace jazz
+
+#endif//BOOLEAN_ALGEBRA_SEQUENTIAL_H
@@ -0,0 +1,56 @@
+/**
+ * @file signature.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "signature.h"
+#include "compiler.h"
+#include "expr.h"
+#include "symbol.h"
+
+#include <vector>
+
+namespace jazz {
+    bool probablyEquivalent(const Expr &a, const Expr &b) {
+        if (are_ex_trivially_equal(a, b))
+            return true;
+        return a.signature() == b.signature();
+    }
+
+    Signature simulate(const Expr &e) {
+        Program program = compileForSimulation(e);
+        std::vector<Signature> inputs;
+        inputs.reserve(program.numInputs());
+        for (std::size_t i = 0; i < program.numInputs(); ++i) {
+            const Expr &input = program.input(i);
+            inputs.push_back(is_a<Symbol>(input) ? input.signature() : Signature::random(input.hashValue()));
+        }
+
+        std::vector<std::uint64_t> words(inputs.size());
+        std::vector<std::uint64_t> buffer(program.size());
+        Signature res{};
+        for (int w = 0; w < JAZZ_SIGNATURE_WORDS; ++w) {
+            for (std::size_t i = 0; i < inputs.size(); ++i)
+                words[i] = inputs[i].words[w];
+            program.run(words.data(), buffer.data());
+            res.words[w] = Program::valueOf(buffer.data(), program.output(0));
+        }
+        return res;
+    }
+}// namespace jazz
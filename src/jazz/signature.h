@@ -0,0 +1,120 @@
+/**
+ * @file signature.h
+ *
+ * Random simulation signatures of expressions.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_SIGNATURE_H
+#define BOOLEAN_ALGEBRA_SIGNATURE_H
+
+#include "config.h"
+#include "jazz/signature_config.h"
+
+#include <cstdint>
+
+namespace jazz {
+
+    class Expr;
+
+    /**
+     * The values of an expression under a fixed set of random input patterns, one bit per pattern.
+     *
+     * The width is JAZZ_SIGNATURE_WORDS * 64 bits, fixed when the library is configured.
+     * Equivalent expressions always have equal signatures, so different signatures prove that
+     * two expressions are not equivalent.
+     */
+    struct Signature {
+        std::uint64_t words[JAZZ_SIGNATURE_WORDS];
+
+        static Signature constant(bool v) {
+            Signature s{};
+            for (auto &w : s.words)
+                w = v ? ~std::uint64_t(0) : 0;
+            return s;
+        }
+
+        /**
+         * The random patterns of a variable.
+         * @param seed  Identifies the variable, the same seed always gives the same patterns.
+         */
+        static Signature random(std::uint64_t seed) {
+            Signature s{};
+            for (auto &w : s.words) {
+                // splitmix64
+                std::uint64_t z = (seed += 0x9e3779b97f4a7c15ull);
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+                w = z ^ (z >> 31);
+            }
+            return s;
+        }
+
+        Signature operator~() const {
+            Signature s{};
+            for (int i = 0; i < JAZZ_SIGNATURE_WORDS; ++i)
+                s.words[i] = ~words[i];
+            return s;
+        }
+
+        Signature &operator&=(const Signature &other) {
+            for (int i = 0; i < JAZZ_SIGNATURE_WORDS; ++i)
+                words[i] &= other.words[i];
+            return *this;
+        }
+
+        Signature &operator|=(const Signature &other) {
+            for (int i = 0; i < JAZZ_SIGNATURE_WORDS; ++i)
+                words[i] |= other.words[i];
+            return *this;
+        }
+
+        bool operator==(const Signature &other) const {
+            for (int i = 0; i < JAZZ_SIGNATURE_WORDS; ++i)
+                if (words[i] != other.words[i])
+                    return false;
+            return true;
+        }
+
+        bool operator!=(const Signature &other) const {
+            return !(*this == other);
+        }
+    };
+
+    /**
+     * Quick filter for semantic equivalence.
+     *
+     * Returns false only if a and b are certainly not equivalent. If it returns true, a and b
+     * agree on all the random patterns and an exact check is worth trying.
+     */
+    bool probablyEquivalent(const Expr &a, const Expr &b);
+
+    /**
+     * Simulate an expression on the random patterns.
+     *
+     * The expression is compiled and the program runs once per word of the signature, so the
+     * whole graph is evaluated bottom-up without recursion. The symbols take their own
+     * signatures, the subexpressions that can not be compiled are variables seeded by their
+     * hash value.
+     */
+    Signature simulate(const Expr &e);
+
+}// namespace jazz
+
+#endif//BOOLEAN_ALGEBRA_SIGNATURE_H
@@ -0,0 +1,188 @@
+/**
+ * @file simplify.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#include "simplify.h"
+#include "op_and.h"
+#include "op_not.h"
+#include "op_or.h"
+#include "operations.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+
+namespace jazz {
+
+    namespace {
+        thread_local SimplifyLevel current_level = SimplifyLevel::BASIC;
+
+        /**
+         * The literals of an operand, sorted, with one bit per literal modulo 64.
+         */
+        struct LiteralSet {
+            std::vector<unsigned> literals;
+            std::uint64_t signature = 0;
+            bool alive = true;
+            bool changed = false;
+            bool queued = false;
+
+            bool has(unsigned literal) const {
+                return std::binary_search(literals.begin(), literals.end(), literal);
+            }
+
+            void sign() {
+                signature = 0;
+                for (auto literal: literals)
+                    signature |= std::uint64_t(1) << (literal % 64);
+            }
+        };
+
+        /**
+         * Whether every literal of a, but flipped in place of skip, is a literal of b.
+         */
+        bool includes(const LiteralSet &a, const LiteralSet &b, unsigned skip, unsigned flipped) {
+            for (auto literal: a.literals) {
+                if (!b.has(literal == skip ? flipped : literal))
+                    return false;
+            }
+            return true;
+        }
+    }// namespace
+
+    SimplifyLevel simplifyLevel() {
+        return current_level;
+    }
+
+    void setSimplifyLevel(SimplifyLevel level) {
+        current_level = level;
+    }
+
+    bool subsumeOperands(std::vector<Expr> &operands, bool conjunction) {
+        // an atom and its complement are the literals 2a and 2a + 1
+        std::unordered_map<Expr, unsigned, ExprHash, ExprEqual> atoms;
+        std::vector<Expr> exprs;
+        auto literalOf = [&](const Expr &e) {
+            bool negative = is_exactly_a<Not>(e) && expr_cast<Not>(e).notFlag();
+            auto it = atoms.emplace(negative ? e.operand(0) : e, static_cast<unsigned>(atoms.size())).first;
+            auto literal = 2 * it->second + (negative ? 1u : 0u);
+            if (exprs.size() <= literal)
+                exprs.resize(2 * atoms.size());
+            exprs[literal] = e;
+            return literal;
+        };
+
+        std::vector<LiteralSet> sets(operands.size());
+        std::vector<std::vector<unsigned>> occurrences;
+        for (std::size_t i = 0; i < operands.size(); ++i) {
+            const auto &operand = operands[i];
+            auto &set = sets[i];
+            if (conjunction ? is_a<Or>(operand) : is_a<And>(operand)) {
+                for (std::size_t j = 0; j < operand.numOperands(); ++j)
+                    set.literals.push_back(literalOf(operand.operand(static_cast<int>(j))));
+            } else
+                set.literals.push_back(literalOf(operand));
+            std::sort(set.literals.begin(), set.literals.end());
+            set.literals.erase(std::unique(set.literals.begin(), set.literals.end()), set.literals.end());
+            set.sign();
+            occurrences.resize(2 * atoms.size());
+            for (auto literal: set.literals)
+                occurrences[literal].push_back(static_cast<unsigned>(i));
+        }
+
+        // the smaller operands first, they subsume the most
+        std::vector<unsigned> queue(operands.size());
+        for (unsigned i = 0; i < queue.size(); ++i) {
+            queue[i] = i;
+            sets[i].queued = true;
+        }
+        std::stable_sort(queue.begin(), queue.end(),
+                         [&sets](unsigned a, unsigned b) { return sets[a].literals.size() < sets[b].literals.size(); });
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            auto c = queue[head];
+            sets[c].queued = false;
+            if (!sets[c].alive)
+                continue;
+            const auto &set = sets[c];
+
+            // subsumption, over the operands sharing the rarest literal
+            auto rarest = *std::min_element(set.literals.begin(), set.literals.end(), [&](unsigned a, unsigned b) {
+                return occurrences[a].size() < occurrences[b].size();
+            });
+            for (auto d: occurrences[rarest]) {
+                auto &other = sets[d];
+                if (d == c || !other.alive || other.literals.size() < set.literals.size() ||
+                    (set.signature & ~other.signature) != 0 || !other.has(rarest))
+                    continue;
+                if (includes(set, other, ~0u, ~0u))
+                    other.alive = false;
+            }
+
+            // self-subsuming resolution, over the operands with the complement of a literal
+            for (auto literal: set.literals) {
+                auto complement = literal ^ 1u;
+                if (complement >= occurrences.size())
+                    continue;
+                std::uint64_t signature = std::uint64_t(1) << (complement % 64);
+                for (auto other_literal: set.literals) {
+                    if (other_literal != literal)
+                        signature |= std::uint64_t(1) << (other_literal % 64);
+                }
+                for (auto d: occurrences[complement]) {
+                    auto &other = sets[d];
+                    if (d == c || !other.alive || other.literals.size() < set.literals.size() ||
+                        (signature & ~other.signature) != 0 || !other.has(complement))
+                        continue;
+                    if (!includes(set, other, literal, complement))
+                        continue;
+                    other.literals.erase(std::lower_bound(other.literals.begin(), other.literals.end(), complement));
+                    if (other.literals.empty())
+                        return true;
+                    other.sign();
+                    other.changed = true;
+                    if (!other.queued) {
+                        other.queued = true;
+                        queue.push_back(d);
+                    }
+                }
+            }
+        }
+
+        std::vector<Expr> result;
+        for (std::size_t i = 0; i < operands.size(); ++i) {
+            const auto &set = sets[i];
+            if (!set.alive)
+                continue;
+            if (!set.changed) {
+                result.push_back(operands[i]);
+                continue;
+            }
+            std::vector<Expr> literals;
+            for (auto literal: set.literals)
+                literals.push_back(exprs[literal]);
+            result.push_back(conjunction ? makeOr(std::move(literals)) : makeAnd(std::move(literals)));
+        }
+        std::sort(result.begin(), result.end(), ExprLess());
+        operands = std::move(result);
+        return false;
+    }
+
+}// namespace jazz
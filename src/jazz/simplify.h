@@ -0,0 +1,77 @@
+/**
+ * @file simplify.h
+ *
+ * How far And and Or simplify their operands, and the subsumption between them.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_SIMPLIFY_H
+#define BOOLEAN_ALGEBRA_SIMPLIFY_H
+
+#include "expr.h"
+
+#include <vector>
+
+namespace jazz {
+
+    enum class SimplifyLevel {
+        BASIC,      ///< duplicates, complementary operands and constants, the default
+        SUBSUMPTION,///< also absorption, subsumption and self-subsuming resolution
+    };
+
+    /**
+     * The level at which the conjunctions and disjunctions built by the current thread are
+     * simplified. An expression keeps the simplification it got when it was built.
+     */
+    SimplifyLevel simplifyLevel();
+    void setSimplifyLevel(SimplifyLevel level);
+
+    /**
+     * Set the simplification level for the lifetime of the guard.
+     */
+    class SimplifyLevelGuard {
+    public:
+        explicit SimplifyLevelGuard(SimplifyLevel level) : saved(simplifyLevel()) { setSimplifyLevel(level); }
+        SimplifyLevelGuard(const SimplifyLevelGuard &) = delete;
+        SimplifyLevelGuard &operator=(const SimplifyLevelGuard &) = delete;
+        ~SimplifyLevelGuard() { setSimplifyLevel(saved); }
+
+    private:
+        SimplifyLevel saved;
+    };
+
+    /**
+     * Simplify the operands of a disjunction, each one a product of literals, or of a
+     * conjunction, each one a clause:
+     * - absorption and subsumption drop an operand containing all the literals of another one,
+     *   p | (p & q) = p;
+     * - self-subsuming resolution drops a literal whose complement is the only difference
+     *   with the literals of another operand, p | (!p & q) = p | q.
+     * An operand is a literal, the complement of an atom being the Not of it. Each operand
+     * is only compared with those sharing its rarest literal, in occurrence lists, and a
+     * 64-bit signature of the literals of each operand rejects most candidates at once.
+     * @param conjunction  Whether the operands are those of a conjunction.
+     * @return Whether an operand became empty, the operation being then constant, true for
+     *         a disjunction and false for a conjunction. The operands are left unspecified.
+     */
+    bool subsumeOperands(std::vector<Expr> &operands, bool conjunction);
+
+}// namespace jazz
+
+#endif//BOOLEAN_ALGEBRA_SIMPLIFY_H
@@ -0,0 +1,198 @@
+/**
+ * @file solutions.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "solutions.h"
+#include "bdd.h"
+#include "compiler.h"
+#include "operations.h"
+#include "sat.h"
+
+#include <vector>
+
+namespace jazz {
+
+    class SolutionRange::Engine {
+    public:
+        virtual ~Engine() = default;
+
+        /**
+         * Produce the next cube.
+         * @return false once there are no more.
+         */
+        virtual bool next(ExprMap &cube) = 0;
+    };
+
+    namespace {
+
+        class BddEngine : public SolutionRange::Engine {
+        public:
+            explicit BddEngine(const Expr &e) : root(bdd::toBDD(manager, e)) {}
+
+            bool next(ExprMap &cube) override {
+                if (!started) {
+                    started = true;
+                    if (!root.isZero())
+                        stack.push_back({root, 0, 0});
+                }
+                while (!stack.empty()) {
+                    auto &top = stack.back();
+                    if (top.f.isOne()) {
+                        cube.clear();
+                        for (std::size_t i = 0; i + 1 < stack.size(); ++i)
+                            cube.emplace(manager.symbolOf(stack[i].var), Expr(stack[i].branch == 1));
+                        stack.pop_back();
+                        return true;
+                    }
+                    if (top.branch == 2) {
+                        stack.pop_back();
+                        continue;
+                    }
+                    // then first, the complement edges make either child the zero one
+                    top.var = top.f.topVar();
+                    auto child = ++top.branch == 1 ? top.f.thenChild() : top.f.elseChild();
+                    if (!child.isZero())
+                        stack.push_back({child, 0, 0});
+                }
+                return false;
+            }
+
+        private:
+            struct Frame {
+                bdd::Bdd f;
+                unsigned var;
+                unsigned branch;///< 1 while below the then child, 2 below the else one
+            };
+
+            bdd::Manager manager;
+            bdd::Bdd root;
+            std::vector<Frame> stack;
+            bool started = false;
+        };
+
+        class SatEngine : public SolutionRange::Engine {
+        public:
+            explicit SatEngine(const Expr &e) {
+                auto program = compile(e);
+                for (std::size_t i = 0; i < program.numInputs(); ++i)
+                    symbols.push_back(program.input(i));
+                models.add(e);
+                counter_models.add(!e);
+            }
+
+            bool next(ExprMap &cube) override {
+                if (!started) {
+                    started = true;
+                } else if (!backtrack()) {
+                    return false;
+                }
+                while (true) {
+                    if (models.solve(prefix) == sat::Result::UNSATISFIABLE) {
+                        if (!backtrack())
+                            return false;
+                        continue;
+                    }
+                    if (counter_models.solve(prefix) == sat::Result::UNSATISFIABLE) {
+                        cube.clear();
+                        for (const auto &branch: stack)
+                            cube.emplace(branch.symbol, Expr(branch.value));
+                        return true;
+                    }
+                    // the branch decides nothing yet, split where the two models disagree
+                    for (const auto &symbol: symbols) {
+                        if (models.modelValue(symbol) != counter_models.modelValue(symbol)) {
+                            auto value = models.modelValue(symbol);
+                            stack.push_back({symbol, value, false});
+                            prefix.push_back(value ? symbol : !symbol);
+                            break;
+                        }
+                    }
+                }
+            }
+
+        private:
+            struct Branch {
+                Expr symbol;
+                bool value;
+                bool flipped;///< the other value was tried first
+            };
+
+            std::vector<Expr> symbols;
+            Solver models;
+            Solver counter_models;
+            std::vector<Branch> stack;
+            std::vector<Expr> prefix;///< the literals of the stack, as assumptions
+            bool started = false;
+
+            /**
+             * Move to the next branch not explored yet.
+             * @return false once the whole tree is.
+             */
+            bool backtrack() {
+                while (!stack.empty() && stack.back().flipped) {
+                    stack.pop_back();
+                    prefix.pop_back();
+                }
+                if (stack.empty())
+                    return false;
+                auto &top = stack.back();
+                top.value = !top.value;
+                top.flipped = true;
+                prefix.back() = top.value ? top.symbol : !top.symbol;
+                return true;
+            }
+        };
+
+    }// namespace
+
+    SolutionRange::SolutionRange(const Expr &e, const SolutionOptions &options) {
+        auto engine_kind = options.engine;
+        if (engine_kind == SolutionEngine::AUTO)
+            engine_kind = compile(e).numInputs() <= options.bdd_max_vars ? SolutionEngine::BDD : SolutionEngine::SAT;
+        if (engine_kind == SolutionEngine::BDD)
+            engine = std::make_unique<BddEngine>(e);
+        else
+            engine = std::make_unique<SatEngine>(e);
+    }
+
+    SolutionRange::~SolutionRange() = default;
+
+    void SolutionRange::advance() {
+        done = !engine->next(cube);
+        if (!done)
+            ++num_cubes;
+    }
+
+    SolutionRange::iterator SolutionRange::begin() {
+        if (!started) {
+            started = true;
+            advance();
+        }
+        return done ? end() : iterator(this);
+    }
+
+    SolutionRange::iterator &SolutionRange::iterator::operator++() {
+        range->advance();
+        if (range->done)
+            range = nullptr;
+        return *this;
+    }
+
+}// namespace jazz
@@ -0,0 +1,114 @@
+/**
+ * @file solutions.h
+ *
+ * Lazy enumeration of the satisfying assignments of an expression, as cubes.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_SOLUTIONS_H
+#define BOOLEAN_ALGEBRA_SOLUTIONS_H
+
+#include "expr.h"
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+
+namespace jazz {
+
+    enum class SolutionEngine {
+        AUTO,///< BDD up to SolutionOptions::bdd_max_vars symbols, SAT beyond
+        BDD, ///< the paths to the one terminal of the diagram
+        SAT, ///< a decision tree pruned by two incremental solvers
+    };
+
+    struct SolutionOptions {
+        SolutionEngine engine = SolutionEngine::AUTO;
+        unsigned bdd_max_vars = 24;
+    };
+
+    /**
+     * The satisfying assignments of an expression, produced one cube at a time.
+     *
+     * A cube maps some of the symbols to Expr(true) or Expr(false); the symbols it leaves out
+     * are free, so one cube stands for all the assignments extending it. The cubes are
+     * pairwise disjoint and together cover exactly the models of the expression.
+     *
+     * Only the current branch of the search is kept, so the memory does not depend on the
+     * number of solutions and stopping early is free. The BDD engine walks the paths of the
+     * diagram depth first. The SAT engine grows a partial assignment: a branch is dropped as
+     * soon as it contradicts the expression, emitted as soon as it implies it, and otherwise
+     * split on a symbol where a model and a counter-model of the branch differ.
+     *
+     * It is an input range: begin() starts the enumeration once, later calls resume it.
+     */
+    class SolutionRange {
+    public:
+        explicit SolutionRange(const Expr &e, const SolutionOptions &options = {});
+        SolutionRange(const SolutionRange &) = delete;
+        SolutionRange &operator=(const SolutionRange &) = delete;
+        ~SolutionRange();
+
+        class iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = ExprMap;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const ExprMap *;
+            using reference = const ExprMap &;
+
+            iterator() = default;
+
+            reference operator*() const { return range->cube; }
+            pointer operator->() const { return &range->cube; }
+            iterator &operator++();
+
+            bool operator==(const iterator &other) const { return range == other.range; }
+            bool operator!=(const iterator &other) const { return range != other.range; }
+
+        private:
+            friend class SolutionRange;
+            explicit iterator(SolutionRange *range) : range(range) {}
+
+            SolutionRange *range = nullptr;
+        };
+
+        iterator begin();
+        iterator end() { return iterator(); }
+
+        /**
+         * Number of cubes produced so far.
+         */
+        std::size_t numCubes() const { return num_cubes; }
+
+        class Engine;
+
+    private:
+        std::unique_ptr<Engine> engine;
+        ExprMap cube;
+        std::size_t num_cubes = 0;
+        bool started = false;
+        bool done = false;
+
+        void advance();
+    };
+
+}// namespace jazz
+
+#endif//BOOLEAN_ALGEBRA_SOLUTIONS_H
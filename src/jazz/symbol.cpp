@@ -48,6 +48,9 @@ namespace jazz {
         setFlags(STATUS_FLAG_HASH_CALCULATED);
         return hash;
     }
+    Signature Symbol::computeSignature() const {
+        return Signature::random(serial);
+    }
     bool Symbol::isType(unsigned int type_flag) const {
         return type_flag == TYPE_FLAG_SYMBOL;
     }
@@ -48,10 +48,19 @@ namespace jazz {
             return name;
         }
 
+        /**
+         * Symbols are numbered in creation order, the number never changes.
+         */
+        unsigned getSerial() const {
+            return serial;
+        }
+
         Expr eval() const override;
 
         unsigned computeHash() const override;
 
+        Signature computeSignature() const override;
+
         bool isType(unsigned type_flag) const override;
 
     protected:
@@ -0,0 +1,378 @@
+/**
+ * @file synthesis.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "synthesis.h"
+#include "aig.h"
+#include "operations.h"
+#include "sat.h"
+#include "truth_table.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace jazz {
+
+    namespace {
+
+        /**
+         * A gate of a chain: its two fanin signals, with bit i of negations set if fanin i
+         * is complemented. An AND gate with both complemented, a NOR, stands for its
+         * complement, an OR.
+         */
+        struct Gate {
+            unsigned first;
+            unsigned second;
+            unsigned negations;
+        };
+
+        using Gates = std::vector<Gate>;
+
+        /**
+         * The value of a signal on one row: known for an input, a solver literal for a gate.
+         */
+        struct Value {
+            bool known = false;
+            bool value = false;
+            sat::Lit lit = 0;
+
+            Value operator!() const { return known ? Value{true, !value, 0} : Value{false, false, sat::negate(lit)}; }
+        };
+
+        enum class GateKind {
+            NAND,///< !(a & b) of any two signals, the same one twice for a NOT
+            AND, ///< a & b of two different signals, either complemented
+        };
+
+        /**
+         * The SAT instance asking for a chain of a given number of gates computing a truth
+         * table with the last one.
+         */
+        class ChainEncoder {
+        public:
+            ChainEncoder(GateKind kind, unsigned num_inputs, tt::Table truth, unsigned num_gates,
+                         std::uint64_t conflict_limit = 0)
+                : kind(kind), num_inputs(num_inputs), num_rows(1u << num_inputs), num_gates(num_gates),
+                  selections(num_gates), values(num_gates) {
+                // gate g + 1 can choose the fanins of gate g, in the same order, and then more
+                for (unsigned g = 0; g < num_gates; ++g) {
+                    for (unsigned k = 0; k < num_inputs + g; ++k) {
+                        if (kind == GateKind::NAND) {
+                            for (unsigned j = 0; j <= k; ++j)
+                                selections[g].push_back({{j, k, 0}, solver.newVar()});
+                        } else {
+                            for (unsigned j = 0; j < k; ++j) {
+                                for (unsigned negations = 0; negations < 4; ++negations)
+                                    selections[g].push_back({{j, k, negations}, solver.newVar()});
+                            }
+                        }
+                    }
+                    for (unsigned t = 0; t < num_rows; ++t)
+                        values[g].push_back(solver.newVar());
+                }
+                solver.setConflictLimit(conflict_limit);
+                encodeGates();
+                breakSymmetries();
+                for (unsigned t = 0; t < num_rows; ++t)
+                    solver.addClause({sat::makeLit(values[num_gates - 1][t], !((truth >> t) & 1u))});
+            }
+
+            /**
+             * A chain of the given depth at most.
+             */
+            std::optional<Gates> solve(unsigned max_depth) {
+                std::vector<sat::Lit> assumptions;
+                if (max_depth < num_gates) {
+                    if (deep.empty())
+                        encodeDepths();
+                    assumptions.push_back(sat::makeLit(deep[num_gates - 1][max_depth + 1], true));
+                }
+                last_result = solver.solve(assumptions);
+                if (last_result != sat::Result::SATISFIABLE)
+                    return std::nullopt;
+                Gates gates;
+                for (const auto &choices: selections) {
+                    auto chosen = std::find_if(choices.begin(), choices.end(),
+                                               [&](const Selection &s) { return solver.modelValue(s.var); });
+                    gates.push_back(chosen->gate);
+                }
+                return gates;
+            }
+
+            /**
+             * Whether the last call to solve() gave up at the conflict limit.
+             */
+            bool gaveUp() const { return last_result == sat::Result::UNKNOWN; }
+
+        private:
+            struct Selection {
+                Gate gate;
+                sat::Var var;
+            };
+
+            Value valueOf(unsigned signal, unsigned row) const {
+                if (signal < num_inputs)
+                    return {true, bool((row >> signal) & 1u), 0};
+                return {false, false, sat::makeLit(values[signal - num_inputs][row])};
+            }
+
+            /**
+             * Add the clause of the selection literal and values, unless a value makes it true.
+             */
+            void addClause(sat::Lit selected, std::initializer_list<Value> terms) {
+                std::vector<sat::Lit> clause{selected};
+                for (const auto &term: terms) {
+                    if (term.known && term.value)
+                        return;
+                    if (!term.known)
+                        clause.push_back(term.lit);
+                }
+                solver.addClause(clause);
+            }
+
+            void encodeGates() {
+                for (unsigned g = 0; g < num_gates; ++g) {
+                    std::vector<sat::Lit> some;
+                    for (const auto &s: selections[g]) {
+                        some.push_back(sat::makeLit(s.var));
+                        auto unselected = sat::makeLit(s.var, true);
+                        for (unsigned t = 0; t < num_rows; ++t) {
+                            // y = a & b, where y is the gate or its complement for a NAND, and
+                            // for a NOR, so that every AND gate can be false on the first row
+                            auto y = valueOf(num_inputs + g, t);
+                            if (kind == GateKind::NAND || s.gate.negations == 3)
+                                y = !y;
+                            auto a = valueOf(s.gate.first, t), b = valueOf(s.gate.second, t);
+                            if (s.gate.negations & 1u)
+                                a = !a;
+                            if (s.gate.negations & 2u)
+                                b = !b;
+                            addClause(unselected, {y, !a, !b});
+                            addClause(unselected, {!y, a});
+                            addClause(unselected, {!y, b});
+                        }
+                    }
+                    // at least one choice: any of several chosen ones would do
+                    solver.addClause(some);
+                    if (kind == GateKind::AND)
+                        solver.addClause({sat::makeLit(values[g][0], true)});
+                }
+            }
+
+            /**
+             * deep[g][d] is implied when gate g is at depth d or more. Only added once a depth
+             * is asked for, the search for the number of gates goes without.
+             */
+            void encodeDepths() {
+                deep.resize(num_gates);
+                for (unsigned g = 0; g < num_gates; ++g) {
+                    for (unsigned d = 0; d <= num_gates; ++d)
+                        deep[g].push_back(solver.newVar());
+                }
+                for (unsigned g = 0; g < num_gates; ++g) {
+                    solver.addClause({sat::makeLit(deep[g][1])});
+                    for (const auto &s: selections[g]) {
+                        for (auto fanin: {s.gate.first, s.gate.second}) {
+                            if (fanin < num_inputs)
+                                continue;
+                            for (unsigned d = 1; d < num_gates; ++d)
+                                solver.addClause({sat::makeLit(s.var, true), sat::makeLit(deep[fanin - num_inputs][d], true),
+                                                  sat::makeLit(deep[g][d + 1])});
+                        }
+                    }
+                }
+            }
+
+            void breakSymmetries() {
+                // every gate but the last feeds a later one
+                for (unsigned g = 0; g + 1 < num_gates; ++g) {
+                    std::vector<sat::Lit> used;
+                    for (unsigned h = g + 1; h < num_gates; ++h) {
+                        for (const auto &s: selections[h]) {
+                            if (s.gate.first == num_inputs + g || s.gate.second == num_inputs + g)
+                                used.push_back(sat::makeLit(s.var));
+                        }
+                    }
+                    solver.addClause(used);
+                }
+                // no two gates with the same fanins
+                for (unsigned g = 0; g < num_gates; ++g) {
+                    for (unsigned h = g + 1; h < num_gates; ++h) {
+                        for (std::size_t i = 0; i < selections[g].size(); ++i)
+                            solver.addClause({sat::makeLit(selections[g][i].var, true),
+                                              sat::makeLit(selections[h][i].var, true)});
+                    }
+                }
+                // two consecutive independent gates could be swapped: keep their fanins in order,
+                // the choices of gate g + 1 without gate g being those of gate g
+                for (unsigned g = 0; g + 1 < num_gates; ++g) {
+                    const auto &earlier = selections[g];
+                    const auto &later = selections[g + 1];
+                    for (std::size_t i = 1; i < earlier.size(); ++i) {
+                        for (std::size_t j = 0; j < i; ++j)
+                            solver.addClause({sat::makeLit(earlier[i].var, true), sat::makeLit(later[j].var, true)});
+                    }
+                }
+            }
+
+            GateKind kind;
+            unsigned num_inputs;
+            unsigned num_rows;
+            unsigned num_gates;
+            sat::Solver solver;
+            std::vector<std::vector<Selection>> selections;
+            std::vector<std::vector<sat::Var>> values;
+            std::vector<std::vector<sat::Var>> deep;
+            sat::Result last_result = sat::Result::UNKNOWN;
+        };
+
+        unsigned depthOf(unsigned num_inputs, const Gates &gates) {
+            std::vector<unsigned> depths(num_inputs, 0);
+            for (const auto &gate: gates)
+                depths.push_back(1 + std::max(depths[gate.first], depths[gate.second]));
+            return depths.back();
+        }
+
+        /**
+         * The fewest gates, then the smallest depth with those.
+         * @param optimal  Cleared if a smaller chain was not ruled out within the conflict limit.
+         */
+        std::optional<Gates> synthesizeChain(GateKind kind, unsigned num_inputs, tt::Table truth, unsigned max_gates,
+                                             std::uint64_t conflict_limit, bool *optimal) {
+            if (optimal)
+                *optimal = true;
+            for (unsigned r = 1; r <= max_gates; ++r) {
+                ChainEncoder encoder(kind, num_inputs, truth, r, conflict_limit);
+                auto gates = encoder.solve(r);
+                if (!gates) {
+                    if (optimal && encoder.gaveUp())
+                        *optimal = false;
+                    continue;
+                }
+                auto depth = depthOf(num_inputs, *gates);
+                while (depth > 1) {
+                    auto shallower = encoder.solve(depth - 1);
+                    if (!shallower)
+                        break;
+                    gates = shallower;
+                    depth = depthOf(num_inputs, *gates);
+                }
+                return gates;
+            }
+            return std::nullopt;
+        }
+
+        NandNetwork makeNetwork(const std::vector<Expr> &inputs, const Gates &gates) {
+            NandNetwork network;
+            network.inputs = inputs;
+            std::vector<Expr> signals(inputs);
+            for (const auto &gate: gates) {
+                network.gates.emplace_back(gate.first, gate.second);
+                signals.push_back(!(signals[gate.first] & signals[gate.second]));
+            }
+            network.output = static_cast<unsigned>(signals.size() - 1);
+            network.depth = depthOf(static_cast<unsigned>(inputs.size()), gates);
+            network.expr = signals.back();
+            return network;
+        }
+
+    }// namespace
+
+    std::optional<NandNetwork> synthesizeNand(const Expr &f, unsigned max_gates) {
+        auto aig = toAIG(f);
+        if (aig.numInputs() > MAX_SYNTHESIS_INPUTS)
+            throw std::invalid_argument("synthesizeNand(): more than " + std::to_string(MAX_SYNTHESIS_INPUTS) +
+                                        " symbols");
+        std::vector<std::uint64_t> words(aig.numInputs());
+        for (std::size_t i = 0; i < words.size(); ++i)
+            words[i] = tt::var(static_cast<unsigned>(i));
+        auto full = Aig::valueOf(aig.simulate(words), aig.output(0));
+
+        // the truth table over the symbols f depends on
+        std::vector<Expr> inputs;
+        std::vector<unsigned> support;
+        for (unsigned i = 0; i < aig.numInputs(); ++i) {
+            if (tt::hasVar(full, i)) {
+                inputs.push_back(aig.inputSymbol(i));
+                support.push_back(i);
+            }
+        }
+        auto n = static_cast<unsigned>(support.size());
+        tt::Table truth = 0;
+        for (unsigned row = 0; row < (1u << n); ++row) {
+            unsigned t = 0;
+            for (unsigned i = 0; i < n; ++i)
+                t |= ((row >> i) & 1u) << support[i];
+            truth |= ((full >> t) & 1u) << row;
+        }
+
+        if (n == 0) {
+            NandNetwork network;
+            network.expr = Expr(bool(full & 1u));
+            return network;
+        }
+        if (n == 1 && truth == 2)
+            return makeNetwork(inputs, {});
+        if (auto gates = synthesizeChain(GateKind::NAND, n, truth, max_gates, 0, nullptr))
+            return makeNetwork(inputs, *gates);
+        return std::nullopt;
+    }
+
+    std::optional<Aig> synthesizeAig(tt::Table truth, unsigned num_inputs, unsigned max_gates,
+                                     std::uint64_t conflict_limit, bool *optimal) {
+        if (num_inputs > MAX_SYNTHESIS_INPUTS)
+            throw std::invalid_argument("synthesizeAig(): more than " + std::to_string(MAX_SYNTHESIS_INPUTS) +
+                                        " inputs");
+        truth = tt::replicate(truth, num_inputs);
+        Aig aig;
+        std::vector<Aig::Lit> signals;
+        for (unsigned i = 0; i < num_inputs; ++i)
+            signals.push_back(aig.addInput());
+        if (optimal)
+            *optimal = true;
+
+        // the gates are false on the first row, the output is complemented if it is not
+        bool complemented = truth & 1u;
+        auto normal = complemented ? ~truth : truth;
+        if (normal == 0) {
+            aig.addOutput(complemented ? Aig::TRUE_LIT : Aig::FALSE_LIT);
+            return aig;
+        }
+        for (unsigned i = 0; i < num_inputs; ++i) {
+            if (normal == tt::var(i)) {
+                aig.addOutput(complemented ? Aig::negate(signals[i]) : signals[i]);
+                return aig;
+            }
+        }
+        auto gates = synthesizeChain(GateKind::AND, num_inputs, normal, max_gates, conflict_limit, optimal);
+        if (!gates)
+            return std::nullopt;
+        for (const auto &gate: *gates) {
+            auto a = signals[gate.first] ^ (gate.negations & 1u);
+            auto b = signals[gate.second] ^ ((gate.negations >> 1) & 1u);
+            // a NOR stands for its complement, as in the instance
+            signals.push_back(aig.andOf(a, b) ^ (gate.negations == 3 ? 1u : 0u));
+        }
+        aig.addOutput(complemented ? Aig::negate(signals.back()) : signals.back());
+        return aig;
+    }
+
+}// namespace jazz
@@ -0,0 +1,86 @@
+/**
+ * @file synthesis.h
+ *
+ * Exact synthesis of small functions as networks of NAND gates and as and-inverter graphs.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_SYNTHESIS_H
+#define BOOLEAN_ALGEBRA_SYNTHESIS_H
+
+#include "aig.h"
+#include "expr.h"
+#include "truth_table.h"
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace jazz {
+
+    constexpr unsigned MAX_SYNTHESIS_INPUTS = 6;
+
+    /**
+     * A network of two-input NAND gates. Signal i < inputs.size() is input i, signal
+     * inputs.size() + g is gate g, the fanins of which are earlier signals.
+     */
+    struct NandNetwork {
+        static constexpr unsigned CONSTANT = ~0u;
+
+        std::vector<Expr> inputs;
+        std::vector<std::pair<unsigned, unsigned>> gates;
+        unsigned output = CONSTANT;///< the signal of the function, CONSTANT for a constant one
+        unsigned depth = 0;        ///< the gates on the longest path to the output
+        Expr expr;                 ///< the network as an expression, with !(a & b) for a gate
+
+        std::size_t numGates() const { return gates.size(); }
+    };
+
+    /**
+     * A network of the fewest NAND gates computing f, if there is one of at most max_gates,
+     * and of the smallest depth among those.
+     *
+     * For r = 1, 2, ..., a SAT instance asks for r gates, each choosing two earlier signals,
+     * whose values on every row of the truth table make the last one equal to f. Symmetric
+     * solutions are cut off: every gate but the last is used, no two gates have the same
+     * fanins, and two consecutive gates not connected to each other come in the order of
+     * their fanins. The depth is then bounded under assumptions on unary depth variables of
+     * the same instance, lowering it until there is no solution.
+     * @throws std::invalid_argument if f has more than MAX_SYNTHESIS_INPUTS symbols.
+     */
+    std::optional<NandNetwork> synthesizeNand(const Expr &f, unsigned max_gates);
+
+    /**
+     * An and-inverter graph of the fewest AND gates computing a truth table over num_inputs
+     * fresh inputs, if there is one of at most max_gates, and of the smallest depth among
+     * those. The same instance as synthesizeNand(), with a choice of complement on each
+     * fanin, and every gate false on the row of all zeros since complements are free.
+     * @param conflict_limit  Conflicts per SAT call, 0 for no limit. A call reaching it counts
+     *                        as no solution.
+     * @param optimal         Set to whether fewer gates were ruled out, that is whether no
+     *                        call reached the limit.
+     * @throws std::invalid_argument beyond MAX_SYNTHESIS_INPUTS inputs.
+     */
+    std::optional<Aig> synthesizeAig(tt::Table truth, unsigned num_inputs, unsigned max_gates,
+                                     std::uint64_t conflict_limit = 0, bool *optimal = nullptr);
+
+}// namespace jazz
+
+#endif//BOOLEAN_ALGEBRA_SYNTHESIS_H
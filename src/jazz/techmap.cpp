@@ -0,0 +1,660 @@
+/**
+ * @file techmap.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "techmap.h"
+#include "aig_cut.h"
+#include "npn.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace jazz {
+
+    using Lit = Aig::Lit;
+
+    /*
+     * Libraries
+     */
+
+    unsigned GateLibrary::addGate(std::string name, unsigned num_inputs, tt::Table function, double area, double delay) {
+        if (num_inputs > tt::MAX_VARS)
+            throw std::invalid_argument("GateLibrary::addGate(): more than " + std::to_string(tt::MAX_VARS) + " inputs");
+        if (lut_size != 0)
+            throw std::invalid_argument("GateLibrary::addGate(): a library of lookup tables has no other gates");
+        if (area < 0 || delay < 0)
+            throw std::invalid_argument("GateLibrary::addGate(): negative area or delay");
+
+        function = tt::replicate(function, num_inputs);
+        auto index = static_cast<unsigned>(gates.size());
+        gates.push_back({std::move(name), num_inputs, function, area, delay});
+        // an inverter with all its pins tied together: INV, but also NAND2 or NOR2
+        if ((function & 1u) && !((function >> ((1u << num_inputs) - 1)) & 1u)) {
+            const auto *best = inverter_gate == NONE ? nullptr : &gates[inverter_gate];
+            if (!best || area < best->area || (area == best->area && delay < best->delay))
+                inverter_gate = index;
+        }
+        for (unsigned i = 0; i < num_inputs; ++i) {
+            // the cuts are reduced to their support, such a gate never matches
+            if (!tt::hasVar(function, i))
+                return index;
+        }
+        if (num_inputs == 0 || function == tt::var(0))
+            return index;
+
+        NpnTransform transform;
+        std::iota(transform.perm, transform.perm + num_inputs, std::uint8_t(0));
+        do {
+            for (unsigned negations = 0; negations < (1u << num_inputs); ++negations) {
+                transform.negations = static_cast<std::uint8_t>(negations);
+                auto &list = match_tables[num_inputs][applyNpn(function, num_inputs, transform)];
+                // the complemented variables, which alone make the cost of a match
+                auto complemented = [num_inputs](const Match &m) {
+                    unsigned mask = 0;
+                    for (unsigned i = 0; i < num_inputs; ++i)
+                        mask |= ((m.negations >> i) & 1u) << m.perm[i];
+                    return mask;
+                };
+                Match match{index, {}, transform.negations};
+                std::copy(transform.perm, transform.perm + tt::MAX_VARS, match.perm);
+                bool known = std::any_of(list.begin(), list.end(), [&](const Match &m) {
+                    return m.gate == index && complemented(m) == complemented(match);
+                });
+                if (!known)
+                    list.push_back(match);
+            }
+        } while (std::next_permutation(transform.perm, transform.perm + num_inputs));
+        return index;
+    }
+
+    GateLibrary GateLibrary::standard() {
+        using tt::var;
+        GateLibrary library;
+        library.addGate("INV", 1, ~var(0), 1, 1);
+        library.addGate("NAND2", 2, ~(var(0) & var(1)), 2, 1);
+        library.addGate("NOR2", 2, ~(var(0) | var(1)), 2, 1);
+        library.addGate("AND2", 2, var(0) & var(1), 3, 2);
+        library.addGate("OR2", 2, var(0) | var(1), 3, 2);
+        library.addGate("XOR2", 2, var(0) ^ var(1), 5, 2);
+        library.addGate("XNOR2", 2, ~(var(0) ^ var(1)), 5, 2);
+        library.addGate("MUX2", 3, (var(0) & var(1)) | (~var(0) & var(2)), 6, 2);
+        return library;
+    }
+
+    GateLibrary GateLibrary::luts(unsigned k, double area, double delay) {
+        if (k < 2 || k > tt::MAX_VARS)
+            throw std::invalid_argument("GateLibrary::luts(): the size must be between 2 and " +
+                                        std::to_string(tt::MAX_VARS));
+        if (area < 0 || delay < 0)
+            throw std::invalid_argument("GateLibrary::luts(): negative area or delay");
+        GateLibrary library;
+        for (unsigned n = 1; n <= k; ++n) {
+            Match match{n - 1, {0, 1, 2, 3, 4, 5}, 0};
+            library.gates.push_back({"LUT" + std::to_string(n), n, 0, area, delay});
+            library.lut_matches[n].push_back(match);
+        }
+        library.lut_size = k;
+        library.inverter_gate = 0;
+        return library;
+    }
+
+    const std::vector<GateLibrary::Match> &GateLibrary::matches(tt::Table function, unsigned n) const {
+        static const std::vector<Match> none;
+        if (n > tt::MAX_VARS)
+            return none;
+        if (lut_size != 0)
+            return lut_matches[n];
+        auto it = match_tables[n].find(function);
+        return it == match_tables[n].end() ? none : it->second;
+    }
+
+    /*
+     * Netlists
+     */
+
+    std::vector<std::uint64_t> Netlist::simulate(const std::vector<std::uint64_t> &input_words) const {
+        if (input_words.size() != num_inputs)
+            throw std::invalid_argument("Netlist::simulate(): wrong number of input words");
+        std::vector<std::uint64_t> words{0, ~std::uint64_t(0)};
+        words.insert(words.end(), input_words.begin(), input_words.end());
+        for (const auto &cell: cells) {
+            auto n = static_cast<unsigned>(cell.fanins.size());
+            std::uint64_t value = 0;
+            for (unsigned m = 0; m < (1u << n); ++m) {
+                if (((cell.function >> m) & 1u) == 0)
+                    continue;
+                auto term = ~std::uint64_t(0);
+                for (unsigned i = 0; i < n; ++i)
+                    term &= (m >> i) & 1u ? words[cell.fanins[i]] : ~words[cell.fanins[i]];
+                value |= term;
+            }
+            words.push_back(value);
+        }
+        return words;
+    }
+
+    /*
+     * Mapping
+     */
+
+    namespace {
+
+        constexpr double INF = std::numeric_limits<double>::infinity();
+        constexpr double EPS = 1e-9;
+
+        /**
+         * The implementation of a literal: a gate and the literals driving its pins. Without
+         * a gate, an input or a constant.
+         */
+        struct Choice {
+            bool valid = false;///< false as long as nothing implements the literal
+            unsigned gate = GateLibrary::NONE;
+            unsigned size = 0;
+            Lit leaves[tt::MAX_VARS] = {};
+            tt::Table function = 0;///< of the gate over its pins, or the constant
+        };
+
+        struct Cost {
+            double arrival = INF;
+            double area = INF;
+        };
+
+        /**
+         * Drop the leaves the function of a cut does not depend on.
+         */
+        void reduceSupport(Cut &cut) {
+            unsigned kept[tt::MAX_VARS];
+            unsigned n = 0;
+            for (unsigned i = 0; i < cut.size; ++i) {
+                if (tt::hasVar(cut.truth, i))
+                    kept[n++] = i;
+            }
+            if (n == cut.size)
+                return;
+            tt::Table truth = 0;
+            for (unsigned m = 0; m < (1u << n); ++m) {
+                unsigned src = 0;
+                for (unsigned i = 0; i < n; ++i)
+                    src |= ((m >> i) & 1u) << kept[i];
+                truth |= ((cut.truth >> src) & 1u) << m;
+            }
+            cut.signature = 0;
+            for (unsigned i = 0; i < n; ++i) {
+                cut.leaves[i] = cut.leaves[kept[i]];
+                cut.signature |= std::uint64_t(1) << (cut.leaves[i] % 64);
+            }
+            cut.size = n;
+            cut.truth = tt::replicate(truth, n);
+        }
+
+        class Mapper {
+        public:
+            Mapper(const Aig &aig, const GateLibrary &library, const MapOptions &options)
+                : aig(aig), library(library), options(options) {
+                k = options.cut_size;
+                if (k == 0) {
+                    k = library.lutSize();
+                    for (std::size_t g = 0; g < library.size(); ++g)
+                        k = std::max(k, library[g].num_inputs);
+                    k = std::max(k, 2u);
+                }
+                if (k < 2 || k > tt::MAX_VARS)
+                    throw std::invalid_argument("techMap(): the cut size must be between 2 and 6");
+                if (options.max_cuts < 2)
+                    throw std::invalid_argument("techMap(): at least two cuts per node are needed");
+                area_first = options.objective == MapObjective::AREA;
+            }
+
+            Netlist run();
+
+        private:
+            bool better(const Cost &a, const Cost &b) const {
+                if (area_first) {
+                    if (a.area < b.area - EPS || a.area > b.area + EPS)
+                        return a.area < b.area;
+                    return a.arrival < b.arrival - EPS;
+                }
+                if (a.arrival < b.arrival - EPS || a.arrival > b.arrival + EPS)
+                    return a.arrival < b.arrival;
+                return a.area < b.area - EPS;
+            }
+
+            bool isInverterOf(const Choice &choice, Lit lit) const {
+                return choice.gate != GateLibrary::NONE && choice.gate == library.inverter() && choice.size == 1 &&
+                       choice.leaves[0] == Aig::negate(lit);
+            }
+
+            double arrivalOf(const Choice &choice) const {
+                if (!choice.valid)
+                    return INF;
+                if (choice.gate == GateLibrary::NONE)
+                    return 0;
+                double arrival = 0;
+                for (unsigned i = 0; i < choice.size; ++i)
+                    arrival = std::max(arrival, arrivals[choice.leaves[i]]);
+                return arrival + library[choice.gate].delay;
+            }
+
+            /**
+             * The area of the cone of a choice, shared among the expected references of its node.
+             */
+            double flowOf(const Choice &choice, unsigned node) const {
+                if (!choice.valid)
+                    return INF;
+                if (choice.gate == GateLibrary::NONE)
+                    return 0;
+                double flow = library[choice.gate].area;
+                for (unsigned i = 0; i < choice.size; ++i)
+                    flow += flows[choice.leaves[i]];
+                return flow / estimates[node];
+            }
+
+            void addMatches(const Cut &cut, Lit lit, std::vector<Choice> &out) const;
+            Choice inverterOf(Lit lit) const;
+            void enumerate(unsigned node);
+            void setChoice(Lit lit, const Choice &choice);
+            void refresh(unsigned node);
+            void select(Lit lit, bool exact);
+            void computeCover();
+            void computeRequired(double target);
+            double reference(const Choice &choice);
+            double dereference(const Choice &choice);
+            Netlist netlist() const;
+
+            const Aig &aig;
+            const GateLibrary &library;
+            MapOptions options;
+            unsigned k = 0;
+            bool area_first = false;
+
+            std::vector<std::vector<Cut>> cuts;///< the priority cuts of every node
+            std::vector<Choice> choices;       ///< by literal
+            std::vector<double> arrivals;
+            std::vector<double> flows;
+            std::vector<double> required;
+            std::vector<double> estimates;///< of the references of every node
+            std::vector<unsigned> refs;   ///< of every literal in the cover
+            std::vector<Choice> candidates;
+            std::vector<Lit> stack;
+        };
+
+        void Mapper::addMatches(const Cut &cut, Lit lit, std::vector<Choice> &out) const {
+            auto function = cut.truth ^ (Aig::isComplemented(lit) ? ~tt::Table(0) : 0);
+            if (cut.size == 0) {
+                Choice constant;
+                constant.valid = true;
+                constant.function = function;
+                out.push_back(constant);
+                return;
+            }
+            for (const auto &match: library.matches(function, cut.size)) {
+                Choice choice;
+                choice.valid = true;
+                choice.gate = match.gate;
+                choice.size = cut.size;
+                for (unsigned i = 0; i < cut.size; ++i)
+                    choice.leaves[i] = Aig::makeLit(cut.leaves[match.perm[i]], (match.negations >> i) & 1u);
+                choice.function = library.lutSize() != 0 ? function : library[match.gate].function;
+                out.push_back(choice);
+            }
+        }
+
+        Choice Mapper::inverterOf(Lit lit) const {
+            Choice choice;
+            choice.valid = true;
+            choice.gate = library.inverter();
+            choice.size = 1;
+            choice.leaves[0] = Aig::negate(lit);
+            choice.function = library.lutSize() != 0 ? ~tt::var(0) : library[choice.gate].function;
+            return choice;
+        }
+
+        void Mapper::setChoice(Lit lit, const Choice &choice) {
+            choices[lit] = choice;
+            arrivals[lit] = arrivalOf(choice);
+            flows[lit] = flowOf(choice, Aig::nodeOf(lit));
+        }
+
+        void Mapper::refresh(unsigned node) {
+            Lit first = Aig::makeLit(node, isInverterOf(choices[Aig::makeLit(node, false)], Aig::makeLit(node, false)));
+            setChoice(first, choices[first]);
+            setChoice(Aig::negate(first), choices[Aig::negate(first)]);
+        }
+
+        /**
+         * The priority cuts of an AND node, and the best choice of both its literals over all
+         * the merged cuts, before pruning.
+         */
+        void Mapper::enumerate(unsigned node) {
+            auto lit0 = aig.fanin0(node), lit1 = aig.fanin1(node);
+            std::vector<Cut> merged;
+            for (const auto &c0: cuts[Aig::nodeOf(lit0)]) {
+                for (const auto &c1: cuts[Aig::nodeOf(lit1)]) {
+                    Cut cut;
+                    if (!mergeCuts(c0, Aig::isComplemented(lit0), c1, Aig::isComplemented(lit1), k, cut))
+                        continue;
+                    reduceSupport(cut);
+                    bool dominated = std::any_of(merged.begin(), merged.end(),
+                                                 [&cut](const Cut &other) { return other.dominates(cut); });
+                    if (dominated)
+                        continue;
+                    merged.erase(std::remove_if(merged.begin(), merged.end(),
+                                                [&cut](const Cut &other) { return cut.dominates(other); }),
+                                 merged.end());
+                    merged.push_back(cut);
+                }
+            }
+
+            Cost best[2];
+            Choice chosen[2];
+            std::vector<Cost> ranks(merged.size());
+            for (std::size_t c = 0; c < merged.size(); ++c) {
+                for (unsigned phase = 0; phase < 2; ++phase) {
+                    candidates.clear();
+                    addMatches(merged[c], Aig::makeLit(node, phase), candidates);
+                    for (const auto &choice: candidates) {
+                        Cost cost{arrivalOf(choice), flowOf(choice, node)};
+                        if (cost.arrival == INF)
+                            continue;
+                        if (better(cost, ranks[c]))
+                            ranks[c] = cost;
+                        if (better(cost, best[phase])) {
+                            best[phase] = cost;
+                            chosen[phase] = choice;
+                        }
+                    }
+                }
+            }
+            for (unsigned phase = 0; phase < 2; ++phase) {
+                Lit lit = Aig::makeLit(node, phase);
+                setChoice(lit, chosen[phase]);
+            }
+            // an inverter where the other literal is cheaper
+            if (library.inverter() != GateLibrary::NONE) {
+                for (unsigned phase = 0; phase < 2; ++phase) {
+                    Lit lit = Aig::makeLit(node, phase);
+                    auto inverter = inverterOf(lit);
+                    Cost cost{arrivalOf(inverter), flowOf(inverter, node)};
+                    if (cost.arrival != INF && !isInverterOf(choices[Aig::negate(lit)], Aig::negate(lit)) &&
+                        better(cost, Cost{arrivals[lit], flows[lit]}))
+                        setChoice(lit, inverter);
+                }
+            }
+
+            // the best cuts first, then the smaller ones, the cuts without a match last
+            std::vector<unsigned> order(merged.size());
+            std::iota(order.begin(), order.end(), 0u);
+            std::stable_sort(order.begin(), order.end(), [&](unsigned a, unsigned b) {
+                if (better(ranks[a], ranks[b]) || better(ranks[b], ranks[a]))
+                    return better(ranks[a], ranks[b]);
+                return merged[a].size < merged[b].size;
+            });
+            if (order.size() > options.max_cuts - 1)
+                order.resize(options.max_cuts - 1);
+            for (auto c: order)
+                cuts[node].push_back(merged[c]);
+        }
+
+        /**
+         * The references of every literal by the cover reachable from the outputs.
+         */
+        void Mapper::computeCover() {
+            std::fill(refs.begin(), refs.end(), 0u);
+            stack.clear();
+            for (std::size_t i = 0; i < aig.numOutputs(); ++i) {
+                auto lit = aig.output(i);
+                if (refs[lit]++ == 0)
+                    stack.push_back(lit);
+            }
+            while (!stack.empty()) {
+                auto lit = stack.back();
+                stack.pop_back();
+                const auto &choice = choices[lit];
+                for (unsigned i = 0; i < choice.size; ++i) {
+                    if (refs[choice.leaves[i]]++ == 0)
+                        stack.push_back(choice.leaves[i]);
+                }
+            }
+        }
+
+        void Mapper::computeRequired(double target) {
+            std::fill(required.begin(), required.end(), INF);
+            for (std::size_t i = 0; i < aig.numOutputs(); ++i)
+                required[aig.output(i)] = std::min(required[aig.output(i)], target);
+            for (auto node = static_cast<unsigned>(aig.numNodes()); node-- > 1;) {
+                // the literal implemented by an inverter over the other one first
+                Lit first = Aig::makeLit(node, isInverterOf(choices[Aig::makeLit(node, true)], Aig::makeLit(node, true)));
+                for (Lit lit: {first, Aig::negate(first)}) {
+                    const auto &choice = choices[lit];
+                    if (refs[lit] == 0 || choice.gate == GateLibrary::NONE)
+                        continue;
+                    for (unsigned i = 0; i < choice.size; ++i) {
+                        auto &r = required[choice.leaves[i]];
+                        r = std::min(r, required[lit] - library[choice.gate].delay);
+                    }
+                }
+            }
+        }
+
+        /**
+         * The area of the cells a choice adds to the cover, referencing them.
+         */
+        double Mapper::reference(const Choice &choice) {
+            double area = 0;
+            stack.clear();
+            auto visit = [&](const Choice &c) {
+                if (c.gate == GateLibrary::NONE)
+                    return;
+                area += library[c.gate].area;
+                for (unsigned i = 0; i < c.size; ++i) {
+                    if (refs[c.leaves[i]]++ == 0)
+                        stack.push_back(c.leaves[i]);
+                }
+            };
+            visit(choice);
+            while (!stack.empty()) {
+                auto lit = stack.back();
+                stack.pop_back();
+                visit(choices[lit]);
+            }
+            return area;
+        }
+
+        /**
+         * The area of the cells only a choice needs, dereferencing them.
+         */
+        double Mapper::dereference(const Choice &choice) {
+            double area = 0;
+            stack.clear();
+            auto visit = [&](const Choice &c) {
+                if (c.gate == GateLibrary::NONE)
+                    return;
+                area += library[c.gate].area;
+                for (unsigned i = 0; i < c.size; ++i) {
+                    if (--refs[c.leaves[i]] == 0)
+                        stack.push_back(c.leaves[i]);
+                }
+            };
+            visit(choice);
+            while (!stack.empty()) {
+                auto lit = stack.back();
+                stack.pop_back();
+                visit(choices[lit]);
+            }
+            return area;
+        }
+
+        /**
+         * Choose again the implementation of a literal among the priority cuts of its node,
+         * the least area flow, or exact area, meeting its required time.
+         */
+        void Mapper::select(Lit lit, bool exact) {
+            auto node = Aig::nodeOf(lit);
+            auto deadline = required[lit];
+            // the other literal relies on this one through an inverter
+            if (isInverterOf(choices[Aig::negate(lit)], Aig::negate(lit)))
+                deadline = std::min(deadline, required[Aig::negate(lit)] - library[library.inverter()].delay);
+
+            candidates.clear();
+            candidates.push_back(choices[lit]);
+            for (const auto &cut: cuts[node]) {
+                if (!cut.isTrivial(node))
+                    addMatches(cut, lit, candidates);
+            }
+            if (library.inverter() != GateLibrary::NONE && !isInverterOf(choices[Aig::negate(lit)], Aig::negate(lit)))
+                candidates.push_back(inverterOf(lit));
+
+            bool referenced = exact && refs[lit] > 0;
+            if (referenced)
+                dereference(choices[lit]);
+            // the current choice when nothing else meets the deadline
+            Cost best;
+            std::size_t chosen = 0;
+            for (std::size_t c = 0; c < candidates.size(); ++c) {
+                Cost cost{arrivalOf(candidates[c]), 0};
+                if (cost.arrival == INF || cost.arrival > deadline + EPS)
+                    continue;
+                if (exact) {
+                    cost.area = reference(candidates[c]);
+                    dereference(candidates[c]);
+                } else
+                    cost.area = flowOf(candidates[c], node);
+                if (cost.area < best.area - EPS || (cost.area <= best.area + EPS && cost.arrival < best.arrival - EPS)) {
+                    best = cost;
+                    chosen = c;
+                }
+            }
+            auto choice = candidates[chosen];
+            if (referenced)
+                reference(choice);
+            setChoice(lit, choice);
+        }
+
+        Netlist Mapper::netlist() const {
+            Netlist result;
+            result.num_inputs = static_cast<unsigned>(aig.numInputs());
+            std::vector<unsigned> signals(2 * aig.numNodes(), ~0u);
+            signals[Aig::FALSE_LIT] = Netlist::FALSE_SIGNAL;
+            signals[Aig::TRUE_LIT] = Netlist::TRUE_SIGNAL;
+            for (unsigned node = 1; node < aig.numNodes(); ++node) {
+                Lit first = Aig::makeLit(node, isInverterOf(choices[Aig::makeLit(node, false)], Aig::makeLit(node, false)));
+                for (Lit lit: {first, Aig::negate(first)}) {
+                    if (refs[lit] == 0)
+                        continue;
+                    const auto &choice = choices[lit];
+                    if (choice.gate == GateLibrary::NONE) {
+                        if (aig.isInput(node))
+                            signals[lit] = result.inputSignal(static_cast<std::size_t>(aig.inputIndex(node)));
+                        else
+                            signals[lit] = choice.function ? Netlist::TRUE_SIGNAL : Netlist::FALSE_SIGNAL;
+                        continue;
+                    }
+                    Netlist::Cell cell;
+                    cell.gate = choice.gate;
+                    cell.function = choice.function;
+                    // an inverter of several inputs has them all tied to its leaf
+                    auto num_pins = std::max(choice.size, library[choice.gate].num_inputs);
+                    for (unsigned i = 0; i < num_pins; ++i)
+                        cell.fanins.push_back(signals[choice.leaves[std::min(i, choice.size - 1)]]);
+                    signals[lit] = result.cellSignal(result.cells.size());
+                    result.cells.push_back(std::move(cell));
+                    result.area += library[choice.gate].area;
+                }
+            }
+            for (std::size_t i = 0; i < aig.numOutputs(); ++i) {
+                result.outputs.push_back(signals[aig.output(i)]);
+                result.delay = std::max(result.delay, arrivals[aig.output(i)]);
+            }
+            return result;
+        }
+
+        Netlist Mapper::run() {
+            auto num_lits = 2 * aig.numNodes();
+            cuts.assign(aig.numNodes(), {});
+            choices.assign(num_lits, Choice());
+            arrivals.assign(num_lits, 0);
+            flows.assign(num_lits, 0);
+            required.assign(num_lits, INF);
+            refs.assign(num_lits, 0);
+            estimates.assign(aig.numNodes(), 0);
+            for (unsigned node = 1; node < aig.numNodes(); ++node) {
+                if (aig.isAnd(node)) {
+                    estimates[Aig::nodeOf(aig.fanin0(node))] += 1;
+                    estimates[Aig::nodeOf(aig.fanin1(node))] += 1;
+                }
+            }
+            for (std::size_t i = 0; i < aig.numOutputs(); ++i)
+                estimates[Aig::nodeOf(aig.output(i))] += 1;
+            for (auto &estimate: estimates)
+                estimate = std::max(estimate, 1.0);
+
+            choices[Aig::FALSE_LIT].valid = choices[Aig::TRUE_LIT].valid = true;
+            choices[Aig::TRUE_LIT].function = ~tt::Table(0);
+            for (unsigned node = 1; node < aig.numNodes(); ++node) {
+                if (aig.isAnd(node))
+                    enumerate(node);
+                else {
+                    setChoice(Aig::makeLit(node, false), Choice{true});
+                    Lit lit = Aig::makeLit(node, true);
+                    setChoice(lit, library.inverter() != GateLibrary::NONE ? inverterOf(lit) : Choice());
+                }
+                cuts[node].push_back(Cut::trivial(node));
+            }
+
+            double target = 0;
+            for (std::size_t i = 0; i < aig.numOutputs(); ++i) {
+                if (arrivals[aig.output(i)] == INF)
+                    throw std::invalid_argument("techMap(): the library cannot implement output " + std::to_string(i));
+                target = std::max(target, arrivals[aig.output(i)]);
+            }
+            if (area_first)
+                target = INF;
+
+            computeCover();
+            for (unsigned pass = 0; pass < options.area_passes; ++pass) {
+                computeRequired(target);
+                // the references of the current cover blended into the estimates
+                for (unsigned node = 1; node < aig.numNodes(); ++node) {
+                    double r = refs[Aig::makeLit(node, false)] + refs[Aig::makeLit(node, true)];
+                    estimates[node] = std::max(1.0, (estimates[node] + 2 * r) / 3);
+                }
+                for (unsigned node = 1; node < aig.numNodes(); ++node) {
+                    if (!aig.isAnd(node))
+                        continue;
+                    // the arrival times of the current choices, their leaves may have changed
+                    refresh(node);
+                    select(Aig::makeLit(node, false), pass > 0);
+                    select(Aig::makeLit(node, true), pass > 0);
+                    refresh(node);
+                }
+                computeCover();
+            }
+            return netlist();
+        }
+
+    }// namespace
+
+    Netlist techMap(const Aig &aig, const GateLibrary &library, const MapOptions &options) {
+        return Mapper(aig, library, options).run();
+    }
+
+}// namespace jazz
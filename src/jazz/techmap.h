@@ -0,0 +1,173 @@
+/**
+ * @file techmap.h
+ *
+ * Technology mapping of an AIG to a library of gates, or to k-input lookup tables, over
+ * priority cuts.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_TECHMAP_H
+#define BOOLEAN_ALGEBRA_TECHMAP_H
+
+#include "aig.h"
+#include "truth_table.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace jazz {
+
+    /**
+     * A cell of a library, with a single output and pin-to-pin delays all equal.
+     */
+    struct Gate {
+        std::string name;
+        unsigned num_inputs = 0;
+        tt::Table function = 0;///< over the inputs, replicated; unused by lookup tables
+        double area = 1;
+        double delay = 1;
+    };
+
+    /**
+     * The gates a mapping may use. Either a set of gates of fixed functions, matched up to a
+     * permutation of their inputs, or lookup tables of 1 to k inputs implementing any function.
+     */
+    class GateLibrary {
+    public:
+        static constexpr unsigned NONE = ~0u;
+
+        GateLibrary() = default;
+
+        /**
+         * Add a gate of fixed function. Constants and buffers are accepted but never used.
+         * @return Its index.
+         * @throws std::invalid_argument beyond tt::MAX_VARS inputs, or on a library of lookup
+         *         tables.
+         */
+        unsigned addGate(std::string name, unsigned num_inputs, tt::Table function, double area = 1, double delay = 1);
+
+        /**
+         * INV, NAND2, NOR2, AND2, OR2, XOR2, XNOR2 and MUX2, the last one selecting its second
+         * input when the first one is 1, with areas in transistor pairs and unit delays
+         * per stage.
+         */
+        static GateLibrary standard();
+
+        /**
+         * Lookup tables of 1 to k inputs, LUT1 to LUTk, of the same area and delay.
+         * @throws std::invalid_argument if k is not between 2 and tt::MAX_VARS.
+         */
+        static GateLibrary luts(unsigned k, double area = 1, double delay = 1);
+
+        std::size_t size() const { return gates.size(); }
+        const Gate &operator[](std::size_t i) const { return gates[i]; }
+
+        /**
+         * The number of inputs of the largest lookup table, 0 for a library of fixed gates.
+         */
+        unsigned lutSize() const { return lut_size; }
+
+        /**
+         * The cheapest inverter, NONE if there is none. A gate of several inputs, such as
+         * NAND2 or NOR2, is one when its inputs are all tied together.
+         */
+        unsigned inverter() const { return inverter_gate; }
+
+        /**
+         * A way to implement a function with a gate: pin i is driven by variable perm[i] of
+         * the function, complemented if bit i of negations is set.
+         */
+        struct Match {
+            unsigned gate;
+            std::uint8_t perm[tt::MAX_VARS];
+            std::uint8_t negations;
+        };
+
+        /**
+         * The matches of a function of n variables depending on all of them, one per gate
+         * and per set of complemented variables.
+         */
+        const std::vector<Match> &matches(tt::Table function, unsigned n) const;
+
+    private:
+        std::vector<Gate> gates;
+        unsigned lut_size = 0;
+        unsigned inverter_gate = NONE;
+        std::unordered_map<tt::Table, std::vector<Match>> match_tables[tt::MAX_VARS + 1];
+        std::vector<Match> lut_matches[tt::MAX_VARS + 1];
+    };
+
+    /**
+     * A mapped circuit. Signal 0 is false, signal 1 true, then come the inputs, and then one
+     * signal per cell, each cell coming after the cells driving its fanins.
+     */
+    struct Netlist {
+        struct Cell {
+            unsigned gate = 0;            ///< the index in the library
+            tt::Table function = 0;       ///< over the fanins, replicated
+            std::vector<unsigned> fanins;///< signals, all the same for an inverter of several inputs
+        };
+
+        static constexpr unsigned FALSE_SIGNAL = 0;
+        static constexpr unsigned TRUE_SIGNAL = 1;
+
+        unsigned num_inputs = 0;
+        std::vector<Cell> cells;
+        std::vector<unsigned> outputs;///< signals
+        double area = 0;               ///< the sum of the areas of the cells
+        double delay = 0;              ///< the latest arrival time of an output
+
+        unsigned inputSignal(std::size_t i) const { return 2 + static_cast<unsigned>(i); }
+        unsigned cellSignal(std::size_t i) const { return 2 + num_inputs + static_cast<unsigned>(i); }
+
+        /**
+         * Simulate 64 input patterns at once.
+         * @return The word of every signal.
+         */
+        std::vector<std::uint64_t> simulate(const std::vector<std::uint64_t> &input_words) const;
+    };
+
+    enum class MapObjective {
+        DELAY,///< the least delay, then the least area at that delay
+        AREA, ///< the least area, whatever the delay
+    };
+
+    struct MapOptions {
+        MapObjective objective = MapObjective::DELAY;
+        unsigned cut_size = 0;   ///< the leaves of a cut, 0 for the largest gate or lookup table
+        unsigned max_cuts = 8;   ///< the priority cuts kept per node, the trivial cut included
+        unsigned area_passes = 2;///< of area recovery: the first by area flow, the others by exact area
+    };
+
+    /**
+     * Map an AIG to the gates of a library. Every node gets its priority cuts, the best
+     * max_cuts of the merges of the cuts of its fanins, ranked by the arrival time and the
+     * area flow of their best matches, so the runtime is linear in the size of the graph.
+     * Both polarities of every node are mapped, a gate taking the complement of a leaf
+     * wherever the library has a match that does, an inverter otherwise. Then the cover is
+     * improved by area recovery without exceeding the required times.
+     * @throws std::invalid_argument if options are out of range, or if the library cannot
+     *         implement an output, e.g. the complement of an input without an inverter.
+     */
+    Netlist techMap(const Aig &aig, const GateLibrary &library, const MapOptions &options = {});
+
+}// namespace jazz
+
+#endif//BOOLEAN_ALGEBRA_TECHMAP_H
@@ -0,0 +1,90 @@
+/**
+ * @file truth_table.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "truth_table.h"
+
+#include <stdexcept>
+
+namespace jazz::tt {
+
+    unsigned Cube::numLiterals() const {
+        unsigned n = 0;
+        for (unsigned bits = pos | neg; bits; bits &= bits - 1)
+            ++n;
+        return n;
+    }
+
+    Table Cube::table() const {
+        Table t = ~Table(0);
+        for (unsigned i = 0; i < MAX_VARS; ++i) {
+            if (pos & (1u << i))
+                t &= VAR_MASKS[i];
+            if (neg & (1u << i))
+                t &= ~VAR_MASKS[i];
+        }
+        return t;
+    }
+
+    static Table isopRec(Table on, Table upper, unsigned n, std::vector<Cube> &cubes) {
+        if (on == 0)
+            return 0;
+        if (upper == ~Table(0)) {
+            cubes.emplace_back();
+            return ~Table(0);
+        }
+
+        // the top variable both bounds depend on
+        unsigned v = n;
+        while (v-- > 0) {
+            if (hasVar(on, v) || hasVar(upper, v))
+                break;
+        }
+
+        auto on0 = cofactor0(on, v), on1 = cofactor1(on, v);
+        auto up0 = cofactor0(upper, v), up1 = cofactor1(upper, v);
+
+        auto first = cubes.size();
+        auto r0 = isopRec(on0 & ~up1, up0, v, cubes);
+        for (auto i = first; i < cubes.size(); ++i)
+            cubes[i].neg |= static_cast<std::uint8_t>(1u << v);
+
+        first = cubes.size();
+        auto r1 = isopRec(on1 & ~up0, up1, v, cubes);
+        for (auto i = first; i < cubes.size(); ++i)
+            cubes[i].pos |= static_cast<std::uint8_t>(1u << v);
+
+        auto r2 = isopRec((on0 & ~r0) | (on1 & ~r1), up0 & up1, v, cubes);
+        return (r0 & ~VAR_MASKS[v]) | (r1 & VAR_MASKS[v]) | r2;
+    }
+
+    std::vector<Cube> isop(Table on, Table upper, unsigned n) {
+        if (n > MAX_VARS)
+            throw std::invalid_argument("isop(): too many variables");
+        on = replicate(on, n);
+        upper = replicate(upper, n);
+        if ((on & ~upper) != 0)
+            throw std::invalid_argument("isop(): the on-set is not contained in the upper bound");
+        std::vector<Cube> cubes;
+        isopRec(on, upper, n, cubes);
+        return cubes;
+    }
+
+}// namespace jazz::tt
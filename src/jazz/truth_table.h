@@ -0,0 +1,104 @@
+/**
+ * @file truth_table.h
+ *
+ * Truth tables of functions of up to six variables, packed in a 64-bit word.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_TRUTH_TABLE_H
+#define BOOLEAN_ALGEBRA_TRUTH_TABLE_H
+
+#include <cstdint>
+#include <vector>
+
+namespace jazz::tt {
+
+    /**
+     * Bit m of a table is the value of the function for the minterm m, variable i being bit i
+     * of m. A function of fewer than six variables is stored replicated, so that the bits of
+     * the unused variables do not matter and every operation works on the whole word.
+     */
+    using Table = std::uint64_t;
+
+    constexpr unsigned MAX_VARS = 6;
+
+    constexpr Table VAR_MASKS[MAX_VARS] = {
+            0xaaaaaaaaaaaaaaaaull,
+            0xccccccccccccccccull,
+            0xf0f0f0f0f0f0f0f0ull,
+            0xff00ff00ff00ff00ull,
+            0xffff0000ffff0000ull,
+            0xffffffff00000000ull,
+    };
+
+    /**
+     * The table of variable i.
+     */
+    inline Table var(unsigned i) { return VAR_MASKS[i]; }
+
+    /**
+     * The table with variable i set to 0, resp. 1, still a function of the same variables.
+     */
+    inline Table cofactor0(Table t, unsigned i) {
+        auto low = t & ~VAR_MASKS[i];
+        return low | (low << (1u << i));
+    }
+
+    inline Table cofactor1(Table t, unsigned i) {
+        auto high = t & VAR_MASKS[i];
+        return high | (high >> (1u << i));
+    }
+
+    inline bool hasVar(Table t, unsigned i) { return cofactor0(t, i) != cofactor1(t, i); }
+
+    /**
+     * Replicate the table of a function of n variables over the whole word.
+     */
+    inline Table replicate(Table t, unsigned n) {
+        for (unsigned i = n; i < MAX_VARS; ++i) {
+            auto shift = 1u << i;
+            t = (t & ((Table(1) << shift) - 1)) | (t << shift);
+        }
+        return t;
+    }
+
+    /**
+     * A product of literals, bit i of pos (resp. neg) tells that variable i appears positive
+     * (resp. negative).
+     */
+    struct Cube {
+        std::uint8_t pos = 0;
+        std::uint8_t neg = 0;
+
+        unsigned numLiterals() const;
+        Table table() const;
+    };
+
+    /**
+     * An irredundant sum of products covering on and contained in upper, by the recursive
+     * Minato-Morreale procedure.
+     * @param on     The minterms which must be covered.
+     * @param upper  The minterms which may be covered, a superset of on.
+     * @param n      The number of variables.
+     */
+    std::vector<Cube> isop(Table on, Table upper, unsigned n);
+
+}// namespace jazz::tt
+
+#endif//BOOLEAN_ALGEBRA_TRUTH_TABLE_H
@@ -0,0 +1,555 @@
+/**
+ * @file zdd.cpp
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "zdd.h"
+#include "op_and.h"
+#include "op_not.h"
+#include "op_or.h"
+#include "operations.h"
+#include "symbol.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace jazz::zdd {
+
+    using dd::indexOf;
+
+    //////////////////////////////////////////////////////////////////////////
+    // Zdd
+    //////////////////////////////////////////////////////////////////////////
+
+    Zdd::Zdd(Manager *manager, Edge e) : manager(manager), e(e) {
+        if (manager)
+            manager->ref(e);
+    }
+
+    Zdd::Zdd(const Zdd &other) : manager(other.manager), e(other.e) {
+        if (manager)
+            manager->ref(e);
+    }
+
+    Zdd::Zdd(Zdd &&other) noexcept : manager(other.manager), e(other.e) {
+        other.manager = nullptr;
+    }
+
+    Zdd &Zdd::operator=(const Zdd &other) {
+        if (other.manager)
+            other.manager->ref(other.e);
+        if (manager)
+            manager->deref(e);
+        manager = other.manager;
+        e = other.e;
+        return *this;
+    }
+
+    Zdd &Zdd::operator=(Zdd &&other) noexcept {
+        if (this != &other) {
+            if (manager)
+                manager->deref(e);
+            manager = other.manager;
+            e = other.e;
+            other.manager = nullptr;
+        }
+        return *this;
+    }
+
+    Zdd::~Zdd() {
+        if (manager)
+            manager->deref(e);
+    }
+
+    bool Zdd::isEmpty() const { return e == Manager::EMPTY; }
+
+    bool Zdd::isBase() const { return e == Manager::BASE; }
+
+    std::uint64_t Zdd::count() const {
+        if (!manager)
+            return 0;
+        const auto &table = manager->table;
+        std::unordered_map<Edge, std::uint64_t> memo{{Manager::EMPTY, 0}, {Manager::BASE, 1}};
+        std::vector<Edge> stack{e};
+        while (!stack.empty()) {
+            auto p = stack.back();
+            if (memo.count(p)) {
+                stack.pop_back();
+                continue;
+            }
+            const auto &n = table.node(p);
+            auto low = memo.find(n.low);
+            auto high = memo.find(n.high);
+            if (low != memo.end() && high != memo.end()) {
+                memo.emplace(p, low->second + high->second);
+                stack.pop_back();
+                continue;
+            }
+            if (low == memo.end())
+                stack.push_back(n.low);
+            if (high == memo.end())
+                stack.push_back(n.high);
+        }
+        return memo[e];
+    }
+
+    std::size_t Zdd::nodeCount() const {
+        if (!manager)
+            return 0;
+        const auto &table = manager->table;
+        std::vector<char> visited;
+        std::vector<Edge> stack{e};
+        std::size_t count = 0;
+        while (!stack.empty()) {
+            auto p = stack.back();
+            stack.pop_back();
+            auto index = indexOf(p);
+            if (index >= visited.size())
+                visited.resize(index + 1, 0);
+            if (visited[index])
+                continue;
+            visited[index] = 1;
+            ++count;
+            if (!table.isTerminal(p)) {
+                stack.push_back(table.node(p).high);
+                stack.push_back(table.node(p).low);
+            }
+        }
+        return count;
+    }
+
+    static void collectSets(const dd::NodeTable &table, Edge p, std::vector<unsigned> &path,
+                            std::vector<std::vector<unsigned>> &res) {
+        if (p == Manager::EMPTY)
+            return;
+        if (p == Manager::BASE) {
+            res.push_back(path);
+            return;
+        }
+        const auto &n = table.node(p);
+        path.push_back(n.var);
+        collectSets(table, n.high, path, res);
+        path.pop_back();
+        collectSets(table, n.low, path, res);
+    }
+
+    std::vector<std::vector<unsigned>> Zdd::sets() const {
+        std::vector<std::vector<unsigned>> res;
+        std::vector<unsigned> path;
+        if (manager)
+            collectSets(manager->table, e, path, res);
+        return res;
+    }
+
+    static Manager *commonManager(const Zdd &p, const Zdd &q, const char *func) {
+        if (!p.getManager() || p.getManager() != q.getManager())
+            throw std::invalid_argument(std::string(func) + ": operands of different managers");
+        return p.getManager();
+    }
+
+    Zdd Zdd::onset(unsigned var) const {
+        if (!manager)
+            throw std::invalid_argument("Zdd::onset(): empty handle");
+        if (var >= manager->numVars())
+            throw std::out_of_range("Zdd::onset(): variable out of range");
+        manager->beginOperation();
+        return {manager, manager->onsetRec(e, var)};
+    }
+
+    Zdd Zdd::offset(unsigned var) const {
+        if (!manager)
+            throw std::invalid_argument("Zdd::offset(): empty handle");
+        if (var >= manager->numVars())
+            throw std::out_of_range("Zdd::offset(): variable out of range");
+        manager->beginOperation();
+        return {manager, manager->offsetRec(e, var)};
+    }
+
+    Zdd Zdd::change(unsigned var) const {
+        if (!manager)
+            throw std::invalid_argument("Zdd::change(): empty handle");
+        if (var >= manager->numVars())
+            throw std::out_of_range("Zdd::change(): variable out of range");
+        manager->beginOperation();
+        return {manager, manager->changeRec(e, var)};
+    }
+
+    Zdd Zdd::operator|(const Zdd &other) const {
+        auto m = commonManager(*this, other, "Zdd::operator|()");
+        m->beginOperation();
+        return {m, m->unionRec(e, other.e)};
+    }
+
+    Zdd Zdd::operator&(const Zdd &other) const {
+        auto m = commonManager(*this, other, "Zdd::operator&()");
+        m->beginOperation();
+        return {m, m->intersectRec(e, other.e)};
+    }
+
+    Zdd Zdd::operator-(const Zdd &other) const {
+        auto m = commonManager(*this, other, "Zdd::operator-()");
+        m->beginOperation();
+        return {m, m->diffRec(e, other.e)};
+    }
+
+    Zdd Zdd::operator*(const Zdd &other) const {
+        auto m = commonManager(*this, other, "Zdd::operator*()");
+        m->beginOperation();
+        return {m, m->productRec(e, other.e)};
+    }
+
+    Zdd Zdd::operator/(const Zdd &other) const {
+        auto m = commonManager(*this, other, "Zdd::operator/()");
+        if (other.isEmpty())
+            throw std::domain_error("Zdd::operator/(): division by the empty family");
+        m->beginOperation();
+        return {m, m->divideRec(e, other.e)};
+    }
+
+    Zdd Zdd::operator%(const Zdd &other) const {
+        auto m = commonManager(*this, other, "Zdd::operator%()");
+        if (other.isEmpty())
+            throw std::domain_error("Zdd::operator%(): division by the empty family");
+        m->beginOperation();
+        auto quotient = m->divideRec(e, other.e);
+        return {m, m->diffRec(e, m->productRec(other.e, quotient))};
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // Manager
+    //////////////////////////////////////////////////////////////////////////
+
+    Manager::Manager(unsigned cache_bits) : table(2), cache(cache_bits) {}
+
+    unsigned Manager::addVar(std::uint64_t key, Expr literal) {
+        // insert above the first element with a greater key
+        unsigned level = 0;
+        while (level < table.numVars() && keys[table.varAt(level)] <= key)
+            ++level;
+        auto v = table.addVar(level);
+        keys.push_back(key);
+        literals.push_back(std::move(literal));
+        return v;
+    }
+
+    unsigned Manager::newVar() {
+        return addVar(~std::uint64_t(0), Expr());
+    }
+
+    unsigned Manager::varOf(const Expr &literal) {
+        Expr symbol = literal;
+        bool negative = false;
+        while (is_a<Not>(symbol)) {
+            negative ^= expr_cast<Not>(symbol).notFlag();
+            symbol = symbol.operand(0);
+        }
+        if (!is_a<Symbol>(symbol))
+            throw std::invalid_argument("Manager::varOf(): not a literal");
+
+        auto it = literal_vars.emplace(symbol, std::array<int, 2>{-1, -1}).first;
+        auto &var = it->second[negative];
+        if (var < 0) {
+            auto key = std::uint64_t(expr_cast<Symbol>(symbol).getSerial()) * 2 + negative;
+            var = static_cast<int>(addVar(key, negative ? !symbol : symbol));
+        }
+        return static_cast<unsigned>(var);
+    }
+
+    Zdd Manager::single(unsigned var) {
+        if (var >= table.numVars())
+            throw std::out_of_range("Manager::single(): variable out of range");
+        return {this, makeNode(var, EMPTY, BASE)};
+    }
+
+    Zdd Manager::cube(const std::vector<unsigned> &vars) {
+        auto sorted = vars;
+        for (auto v: sorted) {
+            if (v >= table.numVars())
+                throw std::out_of_range("Manager::cube(): variable out of range");
+        }
+        std::sort(sorted.begin(), sorted.end(), [this](unsigned a, unsigned b) {
+            return table.level(a) > table.level(b);
+        });
+        sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+        beginOperation();
+        Edge p = BASE;
+        for (auto v: sorted)
+            p = makeNode(v, EMPTY, p);
+        return {this, p};
+    }
+
+    std::size_t Manager::collectGarbage() {
+        auto freed = table.collectGarbage();
+        if (freed)
+            cache.clear();
+        return freed;
+    }
+
+    void Manager::beginOperation() {
+        auto dead = table.numDeadNodes();
+        if (dead > 4096 && dead * 2 > table.numNodes())
+            collectGarbage();
+    }
+
+    Edge Manager::makeNode(unsigned var, Edge low, Edge high) {
+        if (high == EMPTY)
+            return low;
+        return table.findOrAdd(var, low, high);
+    }
+
+    void Manager::cofactors(Edge p, unsigned level, Edge &low, Edge &high) const {
+        if (table.levelOf(p) != level) {
+            low = p;
+            high = EMPTY;
+            return;
+        }
+        low = table.node(p).low;
+        high = table.node(p).high;
+    }
+
+    Edge Manager::unionRec(Edge p, Edge q) {
+        if (p == EMPTY || p == q)
+            return q;
+        if (q == EMPTY)
+            return p;
+        if (p > q)
+            std::swap(p, q);
+
+        Edge r;
+        if (cache.lookup(OP_UNION, p, q, 0, r))
+            return r;
+        auto top = std::min(table.levelOf(p), table.levelOf(q));
+        Edge p0, p1, q0, q1;
+        cofactors(p, top, p0, p1);
+        cofactors(q, top, q0, q1);
+        auto low = unionRec(p0, q0);
+        auto high = unionRec(p1, q1);
+        r = makeNode(table.varAt(top), low, high);
+        cache.insert(OP_UNION, p, q, 0, r);
+        return r;
+    }
+
+    Edge Manager::intersectRec(Edge p, Edge q) {
+        if (p == EMPTY || q == EMPTY)
+            return EMPTY;
+        if (p == q)
+            return p;
+        if (p > q)
+            std::swap(p, q);
+
+        Edge r;
+        if (cache.lookup(OP_INTERSECT, p, q, 0, r))
+            return r;
+        auto lp = table.levelOf(p);
+        auto lq = table.levelOf(q);
+        if (lp < lq) {
+            r = intersectRec(table.node(p).low, q);
+        } else if (lp > lq) {
+            r = intersectRec(p, table.node(q).low);
+        } else {
+            auto low = intersectRec(table.node(p).low, table.node(q).low);
+            auto high = intersectRec(table.node(p).high, table.node(q).high);
+            r = makeNode(table.varAt(lp), low, high);
+        }
+        cache.insert(OP_INTERSECT, p, q, 0, r);
+        return r;
+    }
+
+    Edge Manager::diffRec(Edge p, Edge q) {
+        if (p == EMPTY || p == q)
+            return EMPTY;
+        if (q == EMPTY)
+            return p;
+
+        Edge r;
+        if (cache.lookup(OP_DIFF, p, q, 0, r))
+            return r;
+        auto lp = table.levelOf(p);
+        auto lq = table.levelOf(q);
+        if (lp < lq) {
+            auto high = table.node(p).high;
+            auto low = diffRec(table.node(p).low, q);
+            r = makeNode(table.varAt(lp), low, high);
+        } else if (lp > lq) {
+            r = diffRec(p, table.node(q).low);
+        } else {
+            auto low = diffRec(table.node(p).low, table.node(q).low);
+            auto high = diffRec(table.node(p).high, table.node(q).high);
+            r = makeNode(table.varAt(lp), low, high);
+        }
+        cache.insert(OP_DIFF, p, q, 0, r);
+        return r;
+    }
+
+    Edge Manager::productRec(Edge p, Edge q) {
+        if (p == EMPTY || q == EMPTY)
+            return EMPTY;
+        if (p == BASE)
+            return q;
+        if (q == BASE)
+            return p;
+        if (p > q)
+            std::swap(p, q);
+
+        Edge r;
+        if (cache.lookup(OP_PRODUCT, p, q, 0, r))
+            return r;
+        auto top = std::min(table.levelOf(p), table.levelOf(q));
+        Edge p0, p1, q0, q1;
+        cofactors(p, top, p0, p1);
+        cofactors(q, top, q0, q1);
+        // (v.p1 + p0)(v.q1 + q0) = v.(p1.q1 + p1.q0 + p0.q1) + p0.q0, as v.v = v
+        auto low = productRec(p0, q0);
+        auto high = unionRec(productRec(p1, q1), productRec(p1, q0));
+        high = unionRec(high, productRec(p0, q1));
+        r = makeNode(table.varAt(top), low, high);
+        cache.insert(OP_PRODUCT, p, q, 0, r);
+        return r;
+    }
+
+    Edge Manager::divideRec(Edge p, Edge q) {
+        if (q == BASE)
+            return p;
+        if (p == EMPTY || p == BASE)
+            return EMPTY;
+        if (p == q)
+            return BASE;
+
+        Edge r;
+        if (cache.lookup(OP_DIVIDE, p, q, 0, r))
+            return r;
+        // p / q is the intersection over the cubes of q, split on the top element of q
+        auto v = table.node(q).var;
+        auto q0 = table.node(q).low;
+        auto q1 = table.node(q).high;
+        r = divideRec(onsetRec(p, v), q1);
+        if (r != EMPTY && q0 != EMPTY)
+            r = intersectRec(r, divideRec(offsetRec(p, v), q0));
+        cache.insert(OP_DIVIDE, p, q, 0, r);
+        return r;
+    }
+
+    Edge Manager::onsetRec(Edge p, unsigned var) {
+        auto level = table.level(var);
+        auto lp = table.levelOf(p);
+        if (lp > level)
+            return EMPTY;
+        if (lp == level)
+            return table.node(p).high;
+
+        Edge r;
+        if (cache.lookup(OP_ONSET, p, var, 0, r))
+            return r;
+        auto low = onsetRec(table.node(p).low, var);
+        auto high = onsetRec(table.node(p).high, var);
+        r = makeNode(table.node(p).var, low, high);
+        cache.insert(OP_ONSET, p, var, 0, r);
+        return r;
+    }
+
+    Edge Manager::offsetRec(Edge p, unsigned var) {
+        auto level = table.level(var);
+        auto lp = table.levelOf(p);
+        if (lp > level)
+            return p;
+        if (lp == level)
+            return table.node(p).low;
+
+        Edge r;
+        if (cache.lookup(OP_OFFSET, p, var, 0, r))
+            return r;
+        auto low = offsetRec(table.node(p).low, var);
+        auto high = offsetRec(table.node(p).high, var);
+        r = makeNode(table.node(p).var, low, high);
+        cache.insert(OP_OFFSET, p, var, 0, r);
+        return r;
+    }
+
+    Edge Manager::changeRec(Edge p, unsigned var) {
+        auto level = table.level(var);
+        auto lp = table.levelOf(p);
+        if (lp > level)
+            return makeNode(var, EMPTY, p);
+        if (lp == level)
+            return makeNode(var, table.node(p).high, table.node(p).low);
+
+        Edge r;
+        if (cache.lookup(OP_CHANGE, p, var, 0, r))
+            return r;
+        auto low = changeRec(table.node(p).low, var);
+        auto high = changeRec(table.node(p).high, var);
+        r = makeNode(table.node(p).var, low, high);
+        cache.insert(OP_CHANGE, p, var, 0, r);
+        return r;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // conversions
+    //////////////////////////////////////////////////////////////////////////
+
+    static Zdd cubeOf(Manager &manager, const Expr &term) {
+        std::vector<unsigned> vars;
+        if (is_a<And>(term)) {
+            for (std::size_t i = 0; i < term.numOperands(); ++i)
+                vars.push_back(manager.varOf(term.operand(i)));
+        } else {
+            vars.push_back(manager.varOf(term));
+        }
+        return manager.cube(vars);
+    }
+
+    Zdd toZDD(Manager &manager, const Expr &sop) {
+        if (sop.isTrivial())
+            return sop.trivialValue() ? manager.base() : manager.empty();
+
+        try {
+            if (!is_a<Or>(sop))
+                return cubeOf(manager, sop);
+            auto res = manager.empty();
+            for (std::size_t i = 0; i < sop.numOperands(); ++i)
+                res = res | cubeOf(manager, sop.operand(i));
+            return res;
+        } catch (const std::invalid_argument &) {
+            throw std::invalid_argument("toZDD(): not a sum of products");
+        }
+    }
+
+    Expr toExpr(const Zdd &cubes) {
+        if (!cubes.getManager())
+            throw std::invalid_argument("toExpr(): empty handle");
+        const auto &manager = *cubes.getManager();
+
+        std::vector<Expr> terms;
+        for (const auto &set: cubes.sets()) {
+            std::vector<Expr> literals;
+            for (auto v: set) {
+                const auto &literal = manager.literalOf(v);
+                if (literal.isTrivial())
+                    throw std::invalid_argument("toExpr(): element not bound to a literal");
+                literals.push_back(literal);
+            }
+            terms.push_back(makeAnd(literals));
+        }
+        return makeOr(terms);
+    }
+
+}// namespace jazz::zdd
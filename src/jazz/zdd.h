@@ -0,0 +1,233 @@
+/**
+ * @file zdd.h
+ *
+ * Zero-suppressed decision diagrams over sets of cubes.
+ */
+
+/*******************************************************************************
+ * Copyright (c) 2024 - 2024.  Jiazhen LUO
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef BOOLEAN_ALGEBRA_ZDD_H
+#define BOOLEAN_ALGEBRA_ZDD_H
+
+#include "dd_table.h"
+#include "expr.h"
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace jazz::zdd {
+
+    using dd::Edge;
+
+    class Manager;
+
+    /**
+     * A reference-counted handle to a family of sets of a manager.
+     *
+     * Used for covers, a set is a cube and its elements are literals. Two handles of the same
+     * manager are equal if and only if they represent the same family. Handles must not
+     * outlive their manager.
+     */
+    class Zdd {
+    public:
+        Zdd() = default;
+        Zdd(Manager *manager, Edge e);
+        Zdd(const Zdd &other);
+        Zdd(Zdd &&other) noexcept;
+        Zdd &operator=(const Zdd &other);
+        Zdd &operator=(Zdd &&other) noexcept;
+        ~Zdd();
+
+        Manager *getManager() const { return manager; }
+        Edge edge() const { return e; }
+
+        /**
+         * Whether the family is empty.
+         */
+        bool isEmpty() const;
+
+        /**
+         * Whether the family holds only the empty set, i.e. the tautology cube.
+         */
+        bool isBase() const;
+
+        /**
+         * Number of sets in the family, modulo 2^64.
+         */
+        std::uint64_t count() const;
+
+        /**
+         * Number of nodes, the terminals included.
+         */
+        std::size_t nodeCount() const;
+
+        /**
+         * The sets of the family, each one listing its elements from the top level down.
+         */
+        std::vector<std::vector<unsigned>> sets() const;
+
+        /**
+         * The sets with the element, the element removed; and the sets without it.
+         * @throws std::invalid_argument on an empty handle, std::out_of_range if the element is
+         *         not one of the manager.
+         */
+        Zdd onset(unsigned var) const;
+        Zdd offset(unsigned var) const;
+
+        /**
+         * Toggle the element in every set.
+         * @throws std::invalid_argument on an empty handle, std::out_of_range if the element is
+         *         not one of the manager.
+         */
+        Zdd change(unsigned var) const;
+
+        Zdd operator|(const Zdd &other) const;///< union
+        Zdd operator&(const Zdd &other) const;///< intersection
+        Zdd operator-(const Zdd &other) const;///< difference
+        Zdd operator*(const Zdd &other) const;///< product, {a | b : a in this, b in other}
+        Zdd operator/(const Zdd &other) const;///< weak division
+        Zdd operator%(const Zdd &other) const;///< remainder of the weak division
+
+        bool operator==(const Zdd &other) const { return manager == other.manager && e == other.e; }
+        bool operator!=(const Zdd &other) const { return !(*this == other); }
+
+    private:
+        Manager *manager = nullptr;
+        Edge e = 0;
+    };
+
+    /**
+     * Owns the nodes of a family of zero-suppressed diagrams.
+     *
+     * There are two terminals, EMPTY for the empty family and BASE for the family holding
+     * the empty set; edges are never complemented. A node whose then-edge would point to
+     * EMPTY is never created.
+     *
+     * To represent covers, every literal gets its own variable. Literals are ordered by the
+     * serial of their symbol, the positive literal above the negative one.
+     */
+    class Manager {
+    public:
+        static constexpr Edge EMPTY = 0;
+        static constexpr Edge BASE = 2;
+
+        /**
+         * @param cache_bits  The computed cache has 2^cache_bits entries.
+         */
+        explicit Manager(unsigned cache_bits = 16);
+        Manager(const Manager &) = delete;
+        Manager &operator=(const Manager &) = delete;
+
+        Zdd empty() { return {this, EMPTY}; }
+        Zdd base() { return {this, BASE}; }
+
+        /**
+         * Create an anonymous element at the bottom of the order.
+         */
+        unsigned newVar();
+
+        /**
+         * The element bound to a literal, a symbol or its negation, created on first use.
+         */
+        unsigned varOf(const Expr &literal);
+
+        /**
+         * The literal bound to an element, false for anonymous elements.
+         */
+        const Expr &literalOf(unsigned var) const { return literals.at(var); }
+
+        unsigned numVars() const { return table.numVars(); }
+        unsigned level(unsigned var) const { return table.level(var); }
+        unsigned varAt(unsigned level) const { return table.varAt(level); }
+
+        /**
+         * The family {{var}}.
+         */
+        Zdd single(unsigned var);
+
+        /**
+         * The family holding a single set.
+         */
+        Zdd cube(const std::vector<unsigned> &vars);
+
+        std::size_t numNodes() const { return table.numNodes(); }
+        std::size_t numLiveNodes() const { return table.numLiveNodes(); }
+
+        /**
+         * Free the dead nodes and clear the computed cache.
+         * @return The number of nodes freed.
+         */
+        std::size_t collectGarbage();
+
+        const dd::NodeTable &nodeTable() const { return table; }
+
+    private:
+        friend class Zdd;
+
+        enum Operation : unsigned {
+            OP_UNION,
+            OP_INTERSECT,
+            OP_DIFF,
+            OP_PRODUCT,
+            OP_DIVIDE,
+            OP_ONSET,
+            OP_OFFSET,
+            OP_CHANGE,
+        };
+
+        void ref(Edge e) { table.ref(e); }
+        void deref(Edge e) { table.deref(e); }
+        void beginOperation();
+
+        unsigned addVar(std::uint64_t key, Expr literal);
+        Edge makeNode(unsigned var, Edge low, Edge high);
+        void cofactors(Edge p, unsigned level, Edge &low, Edge &high) const;
+
+        Edge unionRec(Edge p, Edge q);
+        Edge intersectRec(Edge p, Edge q);
+        Edge diffRec(Edge p, Edge q);
+        Edge productRec(Edge p, Edge q);
+        Edge divideRec(Edge p, Edge q);
+        Edge onsetRec(Edge p, unsigned var);
+        Edge offsetRec(Edge p, unsigned var);
+        Edge changeRec(Edge p, unsigned var);
+
+    private:
+        dd::NodeTable table;
+        dd::ComputedCache cache;
+        std::vector<Expr> literals;
+        std::vector<std::uint64_t> keys;///< the order of the literals, by var
+        std::unordered_map<Expr, std::array<int, 2>, ExprHash, ExprEqual> literal_vars;///< by symbol, positive first
+    };
+
+    /**
+     * Build the cube set of a sum of products: an `Or` of `And`s of literals, a single `And`
+     * or literal, or a constant.
+     */
+    Zdd toZDD(Manager &manager, const Expr &sop);
+
+    /**
+     * Convert a cube set back to a sum of products. The elements must be bound to literals.
+     */
+    Expr toExpr(const Zdd &cubes);
+
+}// namespace jazz::zdd
+
+#endif//BOOLEAN_ALGEBRA_ZDD_H
@@ -0,0 +1,112 @@
+/**
+ * @file test_aig.cpp
+ * Test and-inverter graphs.
+ */
+
+#include "jazz/aig.h"
+#include "jazz/bitvec.h"
+#include "jazz/boolean-algebra.h"
+#include "jazz/compiler.h"
+#include <gtest/gtest.h>
+
+using namespace jazz;
+
+TEST(TestAIG, structuralHashing) {
+    Aig aig;
+    auto a = aig.addInput();
+    auto b = aig.addInput();
+
+    auto ab = aig.andOf(a, b);
+    EXPECT_EQ(aig.andOf(b, a), ab);
+    EXPECT_EQ(aig.findAnd(a, b), ab);
+    EXPECT_EQ(aig.findAnd(a, Aig::negate(b)), ~0u);
+    EXPECT_EQ(aig.andOf(a, Aig::negate(a)), Aig::FALSE_LIT);
+    EXPECT_EQ(aig.andOf(a, a), a);
+    EXPECT_EQ(aig.andOf(a, Aig::TRUE_LIT), a);
+    EXPECT_EQ(aig.andOf(Aig::FALSE_LIT, b), Aig::FALSE_LIT);
+    EXPECT_EQ(aig.numAnds(), 1u);
+
+    auto x = aig.xorOf(a, b);
+    EXPECT_EQ(aig.xorOf(a, b), x);
+    EXPECT_EQ(aig.numAnds(), 4u);
+    EXPECT_THROW(aig.andOf(a, Aig::makeLit(100)), std::out_of_range);
+
+    // many gates force the hash table to grow
+    std::vector<Aig::Lit> inputs, gates;
+    auto acc = a;
+    for (int i = 0; i < 1000; ++i) {
+        inputs.push_back(aig.addInput());
+        gates.push_back(acc = aig.andOf(inputs.back(), Aig::negate(acc)));
+    }
+    EXPECT_EQ(aig.numAnds(), 1004u);
+    EXPECT_EQ(aig.andOf(Aig::negate(gates[499]), inputs[500]), gates[500]);
+}
+
+TEST(TestAIG, conversion) {
+    Expr a = makeBitVec("a", 3);
+    Expr b = makeBitVec("b", 3);
+    Expr p("p");
+    std::vector<Expr> roots{a <= b, (a == b) ^ p, p | !p};
+    std::vector<Expr> inputs;
+    for (std::size_t i = 0; i < 3; ++i)
+        inputs.push_back(a.operand(i));
+    for (std::size_t i = 0; i < 3; ++i)
+        inputs.push_back(b.operand(i));
+    inputs.push_back(p);
+
+    auto aig = toAIG(roots);
+    ASSERT_EQ(aig.numOutputs(), 3u);
+    EXPECT_EQ(aig.output(2), Aig::TRUE_LIT);
+    std::vector<int> order;
+    for (const auto &symbol: inputs) {
+        int k = -1;
+        for (std::size_t i = 0; i < aig.numInputs(); ++i) {
+            if (aig.inputSymbol(i).isEqual(symbol))
+                k = static_cast<int>(i);
+        }
+        ASSERT_GE(k, 0);
+        order.push_back(k);
+    }
+
+    std::vector<Expr> back{toExpr(aig, aig.output(0)), toExpr(aig, aig.output(1))};
+    auto program = compile(back, inputs);
+    for (unsigned v = 0; v < 128; ++v) {
+        std::vector<bool> values(aig.numInputs()), ordered;
+        for (unsigned i = 0; i < 7; ++i) {
+            values[order[i]] = (v >> i) & 1u;
+            ordered.push_back((v >> i) & 1u);
+        }
+        unsigned x = v & 7u, y = (v >> 3) & 7u;
+        bool q = (v >> 6) & 1u;
+        auto res = aig.evaluate(values);
+        EXPECT_EQ(res[0], x <= y);
+        EXPECT_EQ(res[1], (x == y) != q);
+        EXPECT_TRUE(res[2]);
+        auto expected = program.evaluate(ordered);
+        EXPECT_EQ(expected[0], x <= y);
+        EXPECT_EQ(expected[1], (x == y) != q);
+    }
+}
+
+TEST(TestAIG, cleanup) {
+    Aig aig;
+    auto a = aig.addInput();
+    auto b = aig.addInput();
+    auto c = aig.addInput();
+    auto ab = aig.andOf(a, b);
+    aig.andOf(ab, c);
+    aig.addOutput(Aig::negate(aig.andOf(ab, Aig::negate(c))));
+    EXPECT_EQ(aig.numAnds(), 3u);
+    EXPECT_EQ(aig.depth(), 2u);
+
+    auto clean = aig.cleanup();
+    EXPECT_EQ(clean.numAnds(), 2u);
+    EXPECT_EQ(clean.numInputs(), 3u);
+    for (unsigned v = 0; v < 8; ++v) {
+        std::vector<bool> values{bool(v & 1u), bool(v & 2u), bool(v & 4u)};
+        EXPECT_EQ(clean.evaluate(values), aig.evaluate(values));
+    }
+
+    auto words = clean.simulate({0xaaaaaaaaaaaaaaaaull, 0xccccccccccccccccull, 0xf0f0f0f0f0f0f0f0ull});
+    EXPECT_EQ(Aig::valueOf(words, clean.output(0)), ~(0xaaaaaaaaaaaaaaaaull & 0xccccccccccccccccull & ~0xf0f0f0f0f0f0f0f0ull));
+}
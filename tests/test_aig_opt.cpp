@@ -0,0 +1,157 @@
+/**
+ * @file test_aig_opt.cpp
+ * Test the optimization passes over and-inverter graphs.
+ */
+
+#include "jazz/aig_cut.h"
+#include "jazz/aig_opt.h"
+#include "jazz/bitvec.h"
+#include "jazz/boolean-algebra.h"
+#include "jazz/truth_table.h"
+#include "test_util.h"
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace jazz;
+
+TEST(TestAIGOpt, truthTables) {
+    using namespace jazz::tt;
+    auto f = (var(0) & var(1)) | var(2);
+    EXPECT_EQ(cofactor1(f, 2), ~Table(0));
+    EXPECT_EQ(cofactor0(f, 2), var(0) & var(1));
+    EXPECT_TRUE(hasVar(f, 1));
+    EXPECT_FALSE(hasVar(f, 3));
+    EXPECT_EQ(replicate(0x8, 2), var(0) & var(1));
+
+    auto cubes = isop(f, f, 3);
+    ASSERT_EQ(cubes.size(), 2u);
+    Table cover = 0;
+    for (const auto &cube: cubes)
+        cover |= cube.table();
+    EXPECT_EQ(cover, f);
+
+    // the don't cares let a single cube cover everything
+    cubes = isop(var(0) & var(1), var(0), 2);
+    ASSERT_EQ(cubes.size(), 1u);
+    EXPECT_EQ(cubes[0].numLiterals(), 1u);
+    EXPECT_THROW(isop(var(0), var(1), 2), std::invalid_argument);
+}
+
+TEST(TestAIGOpt, cuts) {
+    Aig aig;
+    auto a = aig.addInput(), b = aig.addInput(), c = aig.addInput();
+    auto ab = aig.andOf(a, b);
+    auto root = aig.andOf(Aig::negate(ab), c);
+    auto cuts = enumerateCuts(aig, 3);
+    const auto &root_cuts = cuts[Aig::nodeOf(root)];
+    ASSERT_EQ(root_cuts.size(), 3u);
+    // {c, ab}, {a, b, c} and the trivial cut, leaves in node order
+    EXPECT_EQ(root_cuts[0].size, 2u);
+    EXPECT_EQ(root_cuts[0].truth, tt::var(0) & ~tt::var(1));
+    EXPECT_EQ(root_cuts[1].size, 3u);
+    EXPECT_EQ(root_cuts[1].truth, ~(tt::var(0) & tt::var(1)) & tt::var(2));
+    EXPECT_TRUE(root_cuts[2].isTrivial(Aig::nodeOf(root)));
+    EXPECT_TRUE(cuts[0].empty());
+    EXPECT_EQ(cuts[Aig::nodeOf(a)].size(), 1u);
+}
+
+TEST(TestAIGOpt, balance) {
+    Aig chain;
+    auto acc = chain.addInput();
+    for (int i = 1; i < 16; ++i)
+        acc = chain.andOf(acc, chain.addInput());
+    chain.addOutput(acc);
+    EXPECT_EQ(chain.depth(), 15u);
+
+    auto balanced = balance(chain);
+    EXPECT_EQ(balanced.depth(), 4u);
+    EXPECT_EQ(balanced.numAnds(), 15u);
+    EXPECT_TRUE(sameFunctions(chain, balanced));
+
+    // a shared middle node blocks the first effort level but not the second one
+    Aig shared;
+    std::vector<Aig::Lit> in;
+    for (int i = 0; i < 6; ++i)
+        in.push_back(shared.addInput());
+    auto mid = in[0];
+    for (int i = 1; i < 5; ++i)
+        mid = shared.andOf(mid, in[i]);
+    auto top = shared.andOf(mid, in[5]);
+    shared.addOutput(mid);
+    shared.addOutput(top);
+    EXPECT_EQ(balance(shared, 1).depth(), 4u);
+    EXPECT_EQ(balance(shared, 2).depth(), 3u);
+    EXPECT_TRUE(sameFunctions(shared, balance(shared, 2)));
+    EXPECT_EQ(balance(shared, 0).numAnds(), shared.numAnds());
+}
+
+TEST(TestAIGOpt, library) {
+    EXPECT_EQ(libraryCost(0x0000), 0u);
+    EXPECT_EQ(libraryCost(0xaaaa), 0u);
+    EXPECT_EQ(libraryCost(0x8888), 1u);
+    EXPECT_EQ(libraryCost(0xeeee), 1u);
+    EXPECT_EQ(libraryCost(0x6666), 3u);
+    EXPECT_EQ(libraryCost(0x8000), 3u);
+
+    // every library entry implements its function
+    Aig aig;
+    Aig::Lit leaves[4];
+    for (auto &leaf: leaves)
+        leaf = aig.addInput();
+    for (unsigned f = 0; f < (1u << 16); f += 257)
+        aig.addOutput(buildFromLibrary(aig, static_cast<std::uint16_t>(f), leaves));
+    std::vector<std::uint64_t> words(4);
+    for (unsigned v = 0; v < 4; ++v)
+        words[v] = tt::var(v);
+    auto values = aig.simulate(words);
+    for (std::size_t k = 0; k < aig.numOutputs(); ++k)
+        EXPECT_EQ(Aig::valueOf(values, aig.output(k)) & 0xffff, k * 257);
+}
+
+TEST(TestAIGOpt, rewrite) {
+    // (a & b) | (a & c) needs only a & (b | c)
+    Aig aig;
+    auto a = aig.addInput(), b = aig.addInput(), c = aig.addInput();
+    aig.addOutput(aig.orOf(aig.andOf(a, b), aig.andOf(a, c)));
+    EXPECT_EQ(aig.numAnds(), 3u);
+    auto res = rewrite(aig);
+    EXPECT_EQ(res.numAnds(), 2u);
+    EXPECT_TRUE(sameFunctions(aig, res));
+
+    // an XOR written as a sum of products with a redundant term
+    Aig x;
+    auto p = x.addInput(), q = x.addInput(), r = x.addInput();
+    auto t1 = x.andOf(p, Aig::negate(q)), t2 = x.andOf(Aig::negate(p), q);
+    auto t3 = x.andOf(x.andOf(p, Aig::negate(q)), r);
+    x.addOutput(x.orOf(x.orOf(t1, t2), t3));
+    res = rewrite(x, 2);
+    EXPECT_LT(res.numAnds(), x.numAnds());
+    EXPECT_TRUE(sameFunctions(x, res));
+}
+
+TEST(TestAIGOpt, refactor) {
+    // (a & b & c) | (a & b & d) | (a & b & e) is a & b & (c | d | e)
+    Aig aig;
+    std::vector<Aig::Lit> in;
+    for (int i = 0; i < 5; ++i)
+        in.push_back(aig.addInput());
+    Aig::Lit sum = Aig::FALSE_LIT;
+    for (int i = 2; i < 5; ++i)
+        sum = aig.orOf(sum, aig.andOf(aig.andOf(in[0], in[i]), in[1]));
+    aig.addOutput(sum);
+    auto res = refactor(aig);
+    EXPECT_EQ(res.numAnds(), 4u);
+    EXPECT_TRUE(sameFunctions(aig, res));
+}
+
+TEST(TestAIGOpt, optimize) {
+    Expr a = makeBitVec("a", 4);
+    Expr b = makeBitVec("b", 4);
+    auto aig = toAIG(std::vector<Expr>{a < b, a == b, bvAdd(a, b).operand(3)});
+    for (unsigned effort = 1; effort <= 2; ++effort) {
+        auto res = optimize(aig, effort);
+        EXPECT_LE(res.numAnds(), aig.numAnds());
+        EXPECT_TRUE(sameFunctions(aig, res));
+    }
+}
@@ -38,3 +38,27 @@ TEST(TestAnd, equality) {
     EXPECT_TRUE((p & q & r).isEqual(p & r & q));
     EXPECT_TRUE((p & q & r).isEqual(p & r & q & q & p & p & r));
 }
+
+TEST(TestAnd, flatten) {
+    Expr p("p");
+    Expr q("q");
+    Expr r("r");
+    Expr s("s");
+    Expr e = (p & q) & (r & s);
+    EXPECT_FALSE(e.isTrivial());
+    EXPECT_EQ(e.numOperands(), 4u);
+    EXPECT_TRUE(e.isEqual(p & q & r & s));
+    EXPECT_TRUE(((p & q) & (r & !p)).isEqual(false));
+}
+
+TEST(TestAnd, nary) {
+    Expr p("p");
+    Expr q("q");
+    Expr r("r");
+    EXPECT_TRUE(makeAnd({p, q, r}).isEqual(p & q & r));
+    EXPECT_TRUE(makeAnd({p & q, r, q}).isEqual(p & q & r));
+    EXPECT_TRUE(makeAnd({p, true}).isEqual(p));
+    EXPECT_TRUE(makeAnd({p, !p, q}).isEqual(false));
+    EXPECT_TRUE(makeAnd({}).isEqual(true));
+    EXPECT_TRUE(makeAnd({p | q, r}).isEqual((p | q) & r));
+}
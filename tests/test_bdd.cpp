@@ -0,0 +1,181 @@
+/**
+ * @file test_bdd.cpp
+ * Test binary decision diagrams.
+ */
+
+#include "jazz/bdd.h"
+#include "jazz/bitvec.h"
+#include "jazz/boolean-algebra.h"
+#include "jazz/compiler.h"
+#include <gtest/gtest.h>
+
+using namespace jazz;
+
+TEST(TestBDD, canonical) {
+    Expr p("p"), q("q"), r("r");
+    bdd::Manager manager;
+
+    auto f = bdd::toBDD(manager, p & (q | r));
+    auto g = bdd::toBDD(manager, (p & q) | (r & p));
+    EXPECT_EQ(f, g);
+    EXPECT_EQ(bdd::toBDD(manager, !(p & (q | r))), !f);
+    EXPECT_TRUE(bdd::toBDD(manager, p | !p).isOne());
+    EXPECT_TRUE(bdd::toBDD(manager, p & !p).isZero());
+    EXPECT_EQ(bdd::toBDD(manager, p ^ q), manager.ite(manager.var(p), !manager.var(q), manager.var(q)));
+    EXPECT_EQ((f ^ g), manager.zero());
+    EXPECT_EQ(f.nodeCount(), 4u);
+}
+
+TEST(TestBDD, variableOrder) {
+    Expr a("a"), b("b"), c("c");
+    bdd::Manager manager;
+
+    // the order follows the symbol creation order, not the order of use
+    auto vc = manager.varOf(c);
+    auto va = manager.varOf(a);
+    auto vb = manager.varOf(b);
+    EXPECT_EQ(manager.level(va), 0u);
+    EXPECT_EQ(manager.level(vb), 1u);
+    EXPECT_EQ(manager.level(vc), 2u);
+    EXPECT_EQ(manager.findVar(b), static_cast<int>(vb));
+    EXPECT_EQ(manager.findVar(Expr("d")), -1);
+    EXPECT_THROW(manager.varOf(a & b), std::invalid_argument);
+
+    auto f = bdd::toBDD(manager, c & a);
+    EXPECT_EQ(f.topVar(), va);
+    EXPECT_TRUE(f.elseChild().isZero());
+    EXPECT_EQ(f.thenChild(), manager.var(c));
+}
+
+TEST(TestBDD, roundTrip) {
+    Expr a = makeBitVec("a", 3);
+    Expr b = makeBitVec("b", 3);
+    Expr e = a < b;
+    bdd::Manager manager;
+
+    auto f = bdd::toBDD(manager, e);
+    Expr back = bdd::toExpr(f);
+    EXPECT_EQ(bdd::toBDD(manager, back), f);
+
+    std::vector<Expr> inputs;
+    for (std::size_t i = 0; i < 3; ++i)
+        inputs.push_back(a.operand(i));
+    for (std::size_t i = 0; i < 3; ++i)
+        inputs.push_back(b.operand(i));
+    auto program = compile({back}, inputs);
+    for (unsigned v = 0; v < 64; ++v) {
+        std::vector<bool> values;
+        std::vector<bool> assignment(manager.numVars());
+        for (unsigned i = 0; i < 6; ++i) {
+            values.push_back((v >> i) & 1u);
+            assignment[manager.varOf(inputs[i])] = values.back();
+        }
+        EXPECT_EQ(program.evaluate(values)[0], (v & 7u) < (v >> 3));
+        EXPECT_EQ(f.evaluate(assignment), (v & 7u) < (v >> 3));
+    }
+}
+
+TEST(TestBDD, garbageCollection) {
+    bdd::Manager manager;
+    std::vector<bdd::Bdd> vars;
+    for (int i = 0; i < 16; ++i)
+        vars.push_back(manager.var(manager.newVar()));
+
+    auto parity = manager.zero();
+    {
+        // a comparator with a bad order, then dropped
+        auto eq = manager.one();
+        for (int i = 0; i < 8; ++i)
+            eq &= !(vars[i] ^ vars[i + 8]);
+        EXPECT_GT(eq.nodeCount(), 256u);
+    }
+    for (auto &x: vars)
+        parity ^= x;
+
+    EXPECT_GT(manager.collectGarbage(), 0u);
+    EXPECT_EQ(manager.numNodes(), manager.numLiveNodes());
+    EXPECT_EQ(parity.nodeCount(), 17u);
+
+    std::vector<bool> assignment(16, false);
+    assignment[3] = true;
+    EXPECT_TRUE(parity.evaluate(assignment));
+    assignment[12] = true;
+    EXPECT_FALSE(parity.evaluate(assignment));
+}
+
+static bdd::Bdd badComparator(bdd::Manager &manager, unsigned width) {
+    // a[i] == b[i] for all i, with all the a above all the b
+    std::vector<unsigned> a, b;
+    for (unsigned i = 0; i < width; ++i)
+        a.push_back(manager.newVar());
+    for (unsigned i = 0; i < width; ++i)
+        b.push_back(manager.newVar());
+    auto eq = manager.one();
+    for (unsigned i = 0; i < width; ++i)
+        eq &= !(manager.var(a[i]) ^ manager.var(b[i]));
+    return eq;
+}
+
+TEST(TestBDD, swapLevels) {
+    Expr p("p"), q("q"), r("r"), s("s");
+    bdd::Manager manager;
+    Expr e = (p & !q) | (r ^ s) | (q & s & !p);
+    auto f = bdd::toBDD(manager, e);
+
+    std::vector<bool> truth;
+    for (unsigned v = 0; v < 16; ++v) {
+        std::vector<bool> assignment;
+        for (unsigned i = 0; i < 4; ++i)
+            assignment.push_back((v >> i) & 1u);
+        truth.push_back(f.evaluate(assignment));
+    }
+
+    for (unsigned level: {0u, 1u, 2u, 1u, 0u, 2u, 1u}) {
+        manager.swapLevels(level);
+        for (unsigned v = 0; v < 16; ++v) {
+            std::vector<bool> assignment;
+            for (unsigned i = 0; i < 4; ++i)
+                assignment.push_back((v >> i) & 1u);
+            EXPECT_EQ(f.evaluate(assignment), truth[v]);
+        }
+        // still canonical
+        EXPECT_EQ(bdd::toBDD(manager, e), f);
+    }
+    EXPECT_THROW(manager.swapLevels(3), std::out_of_range);
+}
+
+TEST(TestBDD, sifting) {
+    bdd::Manager manager;
+    auto eq = badComparator(manager, 8);
+    auto saved = manager.getOrder();
+    auto before = eq.nodeCount();
+    EXPECT_GT(before, 500u);
+
+    manager.reorder();
+    EXPECT_LE(eq.nodeCount(), 3u * 8 + 1);
+    EXPECT_EQ(manager.numLiveNodes(), eq.nodeCount() - 1);
+
+    std::vector<bool> assignment(16, true);
+    EXPECT_TRUE(eq.evaluate(assignment));
+    assignment[5] = false;
+    EXPECT_FALSE(eq.evaluate(assignment));
+    assignment[13] = false;
+    EXPECT_TRUE(eq.evaluate(assignment));
+
+    manager.setOrder(saved);
+    EXPECT_EQ(manager.getOrder(), saved);
+    EXPECT_EQ(eq.nodeCount(), before);
+    EXPECT_THROW(manager.setOrder({0, 1}), std::invalid_argument);
+}
+
+TEST(TestBDD, autoReorder) {
+    bdd::Manager manager;
+    bdd::SiftingOptions options;
+    options.time_limit = std::chrono::milliseconds(10000);
+    manager.enableAutoReorder(128, options);
+    auto eq = badComparator(manager, 10);
+    EXPECT_GT(manager.numReorderings(), 0u);
+
+    manager.reorder(options);
+    EXPECT_LE(eq.nodeCount(), 3u * 10 + 1);
+}
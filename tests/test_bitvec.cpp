@@ -0,0 +1,93 @@
+/**
+ * @file test_bitvec.cpp
+ * Test bit-vectors and the lowering of relationals.
+ */
+
+#include "jazz/bitvec.h"
+#include "jazz/boolean-algebra.h"
+#include "jazz/compiler.h"
+#include "jazz/signature.h"
+#include <gtest/gtest.h>
+
+using namespace jazz;
+
+TEST(TestBitVec, constantArithmetic) {
+    Expr a = constantBitVec(11, 4);
+    Expr b = constantBitVec(6, 4);
+    EXPECT_TRUE(isConstantBitVec(a));
+    EXPECT_EQ(bitVecValue(bvAdd(a, b)), (11 + 6) % 16);
+    EXPECT_EQ(bitVecValue(bvSub(b, a)), (6 - 11 + 16) % 16);
+    EXPECT_EQ(bitVecValue(bvMul(a, b)), (11 * 6) % 16);
+    EXPECT_EQ(bitVecValue(bvNeg(b)), 10);
+    EXPECT_EQ(bitVecValue(bvXor(a, b)), 11 ^ 6);
+    EXPECT_EQ(bitVecValue(bvShl(a, 1)), (11 << 1) % 16);
+    EXPECT_EQ(bitVecValue(bvShr(a, constantBitVec(2, 2))), 11 >> 2);
+    EXPECT_EQ(bitVecValue(bvMux(true, a, b)), 11);
+    EXPECT_TRUE(bvUlt(b, a).isEqual(true));
+    EXPECT_TRUE(bvEq(a, b).isEqual(false));
+    EXPECT_THROW(bvAdd(a, constantBitVec(1, 3)), std::invalid_argument);
+}
+
+TEST(TestBitVec, symbolicArithmetic) {
+    // a + b - b == a for every assignment
+    Expr a = makeBitVec("a", 3);
+    Expr b = makeBitVec("b", 3);
+    Expr sum = bvSub(bvAdd(a, b), b);
+
+    std::vector<Expr> roots;
+    std::vector<Expr> inputs;
+    for (std::size_t i = 0; i < 3; ++i) {
+        roots.push_back(sum.operand(i));
+        inputs.push_back(a.operand(i));
+    }
+    for (std::size_t i = 0; i < 3; ++i)
+        inputs.push_back(b.operand(i));
+
+    auto program = compile(roots, inputs);
+    for (unsigned v = 0; v < 64; ++v) {
+        std::vector<bool> values;
+        for (int i = 0; i < 6; ++i)
+            values.push_back((v >> i) & 1u);
+        auto res = program.evaluate(values);
+        for (int i = 0; i < 3; ++i)
+            EXPECT_EQ(res[i], values[i]);
+    }
+}
+
+TEST(TestBitVec, relational) {
+    Expr a = makeBitVec("a", 4);
+    Expr b = makeBitVec("b", 4);
+    std::vector<Expr> inputs;
+    for (std::size_t i = 0; i < 4; ++i)
+        inputs.push_back(a.operand(i));
+    for (std::size_t i = 0; i < 4; ++i)
+        inputs.push_back(b.operand(i));
+
+    // relationals over bit-vectors are lowered by the compiler
+    auto program = compile({a == b, a != b, a < b, a <= b, a > b, a >= b}, inputs);
+    for (unsigned x = 0; x < 16; ++x) {
+        for (unsigned y = 0; y < 16; ++y) {
+            std::vector<bool> values;
+            for (int i = 0; i < 4; ++i)
+                values.push_back((x >> i) & 1u);
+            for (int i = 0; i < 4; ++i)
+                values.push_back((y >> i) & 1u);
+            auto res = program.evaluate(values);
+            EXPECT_EQ(res[0], x == y);
+            EXPECT_EQ(res[1], x != y);
+            EXPECT_EQ(res[2], x < y);
+            EXPECT_EQ(res[3], x <= y);
+            EXPECT_EQ(res[4], x > y);
+            EXPECT_EQ(res[5], x >= y);
+        }
+    }
+}
+
+TEST(TestBitVec, booleanRelational) {
+    Expr p("p");
+    Expr q("q");
+    EXPECT_TRUE(probablyEquivalent(p == q, (p & q) | (!p & !q)));
+    EXPECT_TRUE(probablyEquivalent(p < q, !p & q));
+    EXPECT_TRUE(probablyEquivalent(bitblast((p == q) & (p != q)), false));
+    EXPECT_THROW(bitblast(p == makeBitVec("v", 2)), std::invalid_argument);
+}
@@ -0,0 +1,72 @@
+/**
+ * @file test_compiler.cpp
+ * Test the compilation of expressions into programs.
+ */
+
+#include "jazz/boolean-algebra.h"
+#include "jazz/compiler.h"
+#include "jazz/wildcard.h"
+#include <gtest/gtest.h>
+
+using namespace jazz;
+
+static bool evaluateBySubs(const Expr &e, const std::vector<Expr> &symbols, unsigned assignment) {
+    ExprMap m;
+    for (std::size_t i = 0; i < symbols.size(); ++i)
+        m[symbols[i]] = Expr(bool((assignment >> i) & 1u));
+    return e.subs(m).trivialValue();
+}
+
+TEST(TestCompiler, evaluate) {
+    Expr p("p");
+    Expr q("q");
+    Expr r("r");
+    std::vector<Expr> roots{p & (q | r), !(p | !q) | (r & !p), p | true, q & false};
+    auto program = compile(roots, {p, q, r});
+    ASSERT_EQ(program.numInputs(), 3);
+    ASSERT_EQ(program.numOutputs(), roots.size());
+
+    for (unsigned a = 0; a < 8; ++a) {
+        auto res = program.evaluate({bool(a & 1u), bool(a & 2u), bool(a & 4u)});
+        for (std::size_t k = 0; k < roots.size(); ++k)
+            EXPECT_EQ(res[k], evaluateBySubs(roots[k], {p, q, r}, a));
+    }
+}
+
+TEST(TestCompiler, sharing) {
+    Expr p("p");
+    Expr q("q");
+    Expr r("r");
+    Expr shared = (p & q) | (q & r);
+
+    // one constant, three inputs, two products and the shared sum
+    auto single = compile(shared);
+    EXPECT_EQ(single.size(), 7);
+
+    // the shared sum is compiled once, and the structurally equal !(p & q) is found in the table
+    auto multi = compile({shared & p, shared & r, !(p & q)});
+    EXPECT_EQ(multi.size(), 9);
+    EXPECT_TRUE(Program::isComplemented(multi.output(2)));
+}
+
+TEST(TestCompiler, bitParallel) {
+    Expr p("p");
+    Expr q("q");
+    auto program = compile({p & q, p | q, !p}, {p, q});
+    auto out = program.run({0b1100, 0b1010});
+    EXPECT_EQ(out[0] & 0xf, 0b1000);
+    EXPECT_EQ(out[1] & 0xf, 0b1110);
+    EXPECT_EQ(out[2] & 0xf, 0b0011);
+}
+
+TEST(TestCompiler, inputs) {
+    Expr p("p");
+    Expr q("q");
+    EXPECT_THROW(compile({p & q}, {p}), std::invalid_argument);
+    EXPECT_THROW(compile(wildcard(0) & p), std::invalid_argument);
+
+    auto program = compile({p}, {q, p});
+    EXPECT_EQ(program.inputIndex(p), 1);
+    EXPECT_EQ(program.inputIndex(q), 0);
+    EXPECT_EQ(program.inputIndex(Expr("s")), -1);
+}
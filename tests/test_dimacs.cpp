@@ -0,0 +1,226 @@
+/**
+ * @file test_dimacs.cpp
+ * Test the DIMACS writer and reader.
+ */
+
+#include "jazz/bitvec.h"
+#include "jazz/boolean-algebra.h"
+#include "jazz/dimacs.h"
+#include "jazz/op_and.h"
+#include "jazz/sat.h"
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <sstream>
+
+using namespace jazz;
+
+struct ParsedCnf {
+    std::size_t num_vars = 0;
+    std::size_t num_clauses = 0;
+    std::vector<std::string> comments;
+    std::vector<std::vector<long>> clauses;
+};
+
+static ParsedCnf parse(const std::string &text) {
+    ParsedCnf cnf;
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind("c ", 0) == 0) {
+            cnf.comments.push_back(line);
+        } else if (line.rfind("p cnf ", 0) == 0) {
+            std::istringstream header(line.substr(6));
+            header >> cnf.num_vars >> cnf.num_clauses;
+        } else {
+            std::istringstream body(line);
+            std::vector<long> clause;
+            long lit;
+            while (body >> lit && lit != 0)
+                clause.push_back(lit);
+            cnf.clauses.push_back(clause);
+        }
+    }
+    return cnf;
+}
+
+static sat::Result solve(const ParsedCnf &cnf, std::vector<bool> *model = nullptr) {
+    sat::Solver solver;
+    while (solver.numVars() < cnf.num_vars)
+        solver.newVar();
+    for (const auto &clause: cnf.clauses) {
+        std::vector<sat::Lit> lits;
+        for (auto lit: clause)
+            lits.push_back(sat::makeLit(static_cast<sat::Var>(std::labs(lit) - 1), lit < 0));
+        solver.addClause(lits);
+    }
+    auto res = solver.solve();
+    if (model && res == sat::Result::SATISFIABLE)
+        *model = solver.getModel();
+    return res;
+}
+
+TEST(TestDimacs, encodings) {
+    Expr p("p");
+    Expr q("q");
+    Expr r("r");
+    Expr shared = p & q;
+    Expr e = (shared | r) & !(shared & !r);
+
+    std::ostringstream tseitin, pg;
+    auto full = writeDimacs(tseitin, {e}, CnfEncoding::TSEITIN);
+    auto half = writeDimacs(pg, {e});
+    EXPECT_EQ(full.num_vars, half.num_vars);
+    EXPECT_LT(half.num_clauses, full.num_clauses);
+
+    for (const auto *text: {&tseitin, &pg}) {
+        auto cnf = parse(text->str());
+        EXPECT_EQ(cnf.num_vars, full.num_vars);
+        EXPECT_EQ(cnf.clauses.size(), cnf.num_clauses);
+        ASSERT_EQ(cnf.comments.size(), 3u);
+
+        // the inputs come first, so a model of the CNF is a model of the expression
+        std::vector<bool> model;
+        ASSERT_EQ(solve(cnf, &model), sat::Result::SATISFIABLE);
+        ExprMap m;
+        for (std::size_t i = 0; i < cnf.comments.size(); ++i) {
+            auto name = cnf.comments[i].substr(cnf.comments[i].rfind(' ') + 1);
+            for (const auto &symbol: {p, q, r}) {
+                std::ostringstream printed;
+                printed << symbol;
+                if (printed.str() == name)
+                    m[symbol] = Expr(bool(model[i]));
+            }
+        }
+        ASSERT_EQ(m.size(), 3u);
+        EXPECT_TRUE(e.subs(m).trivialValue());
+    }
+
+    // the shared node gets a single variable: 3 inputs, then at most one per distinct gate
+    EXPECT_LE(full.num_vars, 3u + 4u);
+}
+
+TEST(TestDimacs, satisfiability) {
+    Expr a = makeBitVec("a", 4);
+    Expr b = makeBitVec("b", 4);
+    for (auto encoding: {CnfEncoding::TSEITIN, CnfEncoding::PLAISTED_GREENBAUM}) {
+        std::ostringstream unsat, sat;
+        writeDimacs(unsat, {a < b, b < a}, encoding);
+        writeDimacs(sat, {a < b, !(b == a)}, encoding);
+        EXPECT_EQ(solve(parse(unsat.str())), sat::Result::UNSATISFIABLE);
+        EXPECT_EQ(solve(parse(sat.str())), sat::Result::SATISFIABLE);
+    }
+
+    // constant roots
+    std::ostringstream out;
+    auto stats = writeDimacs(out, {Expr(true), Expr(false)});
+    auto cnf = parse(out.str());
+    EXPECT_EQ(stats.num_clauses, 1u);
+    ASSERT_EQ(cnf.clauses.size(), 1u);
+    EXPECT_TRUE(cnf.clauses[0].empty());
+}
+
+TEST(TestDimacs, largeOutput) {
+    // many small constraints over shared variables, streamed in one pass
+    std::vector<Expr> x, roots;
+    for (int i = 0; i < 3002; ++i)
+        x.emplace_back(("x" + std::to_string(i)).c_str());
+    for (int i = 0; i < 3000; ++i)
+        roots.push_back((x[i] & x[i + 1]) | !x[i + 2]);
+    std::ostringstream out;
+    auto stats = writeDimacs(out, roots);
+    auto cnf = parse(out.str());
+    EXPECT_EQ(cnf.clauses.size(), stats.num_clauses);
+    EXPECT_GT(stats.num_clauses, 4000u);
+    EXPECT_EQ(solve(cnf), sat::Result::SATISFIABLE);
+    EXPECT_THROW(writeDimacs("/nonexistent/dir/out.cnf", roots), std::runtime_error);
+}
+
+TEST(TestDimacs, parse) {
+    const std::string text = "c a comment\np cnf 3 3\n1 -2 0\n2 3\n 0 -1\n-3 0\n";
+    auto cnf = parseDimacs(text.data(), text.size());
+    EXPECT_EQ(cnf.num_vars, 3u);
+    ASSERT_EQ(cnf.numClauses(), 3u);
+    EXPECT_EQ(cnf.clauseSize(0), 2u);
+    EXPECT_EQ(cnf.clause(0)[1], -2);
+    EXPECT_EQ(cnf.clauseSize(2), 2u);
+    EXPECT_EQ(cnf.clause(2)[1], -3);
+
+    // SATLIB endings and a last clause without its 0
+    const std::string satlib = "p cnf 2 2\n1 2 0\n-1 -2\n%\n0\n";
+    cnf = parseDimacs(satlib.data(), satlib.size());
+    ASSERT_EQ(cnf.numClauses(), 2u);
+    EXPECT_EQ(cnf.clauseSize(1), 2u);
+
+    // the counts of the header are only hints, a huge one must not be allocated for
+    const std::string huge = "p cnf 1 4294967295\n1 0\n";
+    cnf = parseDimacs(huge.data(), huge.size());
+    ASSERT_EQ(cnf.numClauses(), 1u);
+    EXPECT_EQ(cnf.clause(0)[0], 1);
+    EXPECT_LE(cnf.literals.capacity(), huge.size());
+
+    const std::string bad = "p cnf 2 1\n1 x 0\n";
+    try {
+        parseDimacs(bad.data(), bad.size());
+        FAIL();
+    } catch (const std::runtime_error &e) {
+        EXPECT_NE(std::string(e.what()).find("line 2"), std::string::npos);
+    }
+    const std::string wrong_header = "p dnf 2 1\n";
+    EXPECT_THROW(parseDimacs(wrong_header.data(), wrong_header.size()), std::runtime_error);
+    EXPECT_THROW(readDimacs("/nonexistent/file.cnf"), std::runtime_error);
+}
+
+TEST(TestDimacs, readBack) {
+    Expr a = makeBitVec("a", 4);
+    Expr b = makeBitVec("b", 4);
+    auto path = testing::TempDir() + "jazz_read_back.cnf";
+    auto stats = writeDimacs(path, {a < b, b < a});
+    auto cnf = readDimacs(path);
+    std::remove(path.c_str());
+    EXPECT_EQ(cnf.num_vars, stats.num_vars);
+    EXPECT_EQ(cnf.numClauses(), stats.num_clauses);
+
+    sat::Solver solver;
+    for (std::size_t i = 0; i < cnf.numClauses(); ++i) {
+        std::vector<sat::Lit> lits;
+        for (std::size_t k = 0; k < cnf.clauseSize(i); ++k) {
+            auto lit = cnf.clause(i)[k];
+            lits.push_back(sat::makeLit(static_cast<sat::Var>(std::abs(lit) - 1), lit < 0));
+        }
+        solver.addClause(lits);
+    }
+    EXPECT_EQ(solver.solve(), sat::Result::UNSATISFIABLE);
+}
+
+TEST(TestDimacs, toExpr) {
+    Expr p("p");
+    Expr q("q");
+    Expr r("r");
+    const std::string text = "p cnf 3 3\n1 -2 0\n2 3 0\n-1 -3 2 0\n";
+    auto cnf = parseDimacs(text.data(), text.size());
+    auto e = toExpr(cnf, {p, q, r});
+    ASSERT_TRUE(is_a<And>(e));
+    EXPECT_EQ(e.numOperands(), 3u);
+    EXPECT_TRUE(areEquivalent(e, (p | !q) & (q | r) & (!p | !r | q)));
+    // missing symbols are made up
+    EXPECT_EQ(toExpr(cnf, {p}).numOperands(), 3u);
+
+    // large formulas are built in one pass
+    std::string big = "p cnf 1000 20000\n";
+    for (int i = 0; i < 20000; ++i)
+        big += std::to_string(i % 1000 + 1) + " -" + std::to_string((i * 7) % 1000 + 1) + " " +
+               std::to_string((i * 13) % 1000 + 1) + " 0\n";
+    cnf = parseDimacs(big.data(), big.size());
+    EXPECT_EQ(cnf.numClauses(), 20000u);
+    EXPECT_TRUE(is_a<And>(toExpr(cnf)));
+
+    // only the variables that occur get a symbol, not those the header declares
+    const std::string huge = "p cnf 4000000000 0\n";
+    cnf = parseDimacs(huge.data(), huge.size());
+    EXPECT_EQ(cnf.num_vars, 4000000000u);
+    EXPECT_TRUE(toExpr(cnf).isEqual(true));
+    const std::string sparse = "p cnf 4000000000 1\n-2 0\n";
+    cnf = parseDimacs(sparse.data(), sparse.size());
+    EXPECT_TRUE(toExpr(cnf, {p, q}).isEqual(!q));
+}
@@ -0,0 +1,174 @@
+/**
+ * @file test_factor.cpp
+ * Test algebraic division, kernels and the extraction of common divisors.
+ */
+
+#include "jazz/bitvec.h"
+#include "jazz/boolean-algebra.h"
+#include "jazz/factor.h"
+#include "jazz/op_and.h"
+#include "jazz/op_or.h"
+#include "jazz/sat.h"
+#include "test_util.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+using namespace jazz;
+using algebraic::Cube;
+using algebraic::Sop;
+
+/**
+ * Whether e is a subexpression of f.
+ */
+static bool occursIn(const Expr &e, const Expr &f) {
+    if (e.isEqual(f))
+        return true;
+    if (!is_a<And>(f) && !is_a<Or>(f))
+        return false;
+    for (std::size_t i = 0; i < f.numOperands(); ++i) {
+        if (occursIn(e, f.operand(i)))
+            return true;
+    }
+    return false;
+}
+
+TEST(TestFactor, division) {
+    // the literals of a, b, c, d, e, g
+    const unsigned a = 0, b = 2, c = 4, d = 6, e = 8, g = 10;
+    Sop f{{a, c}, {a, d}, {b, c}, {b, d}, {e}};
+    auto [quotient, remainder] = algebraic::divide(f, {{a}, {b}});
+    EXPECT_EQ(quotient, (Sop{{c}, {d}}));
+    EXPECT_EQ(remainder, (Sop{{e}}));
+    EXPECT_EQ(algebraic::normalized(algebraic::multiply(quotient, {{a}, {b}})), algebraic::normalized({{a, c}, {a, d}, {b, c}, {b, d}}));
+    // nothing divides by a + g
+    auto none = algebraic::divide(f, {{a}, {g}});
+    EXPECT_TRUE(none.first.empty());
+    EXPECT_EQ(none.second, f);
+
+    EXPECT_EQ(algebraic::commonCube({{a, b, c}, {a, c, d}}), (Cube{a, c}));
+    EXPECT_TRUE(algebraic::commonCube(f).empty());
+    EXPECT_EQ(algebraic::normalized({{a, b}, {a}, {c}, {a}}), (Sop{{a}, {c}}));
+    EXPECT_EQ(algebraic::numLiterals(f), 9u);
+
+    // F = ace + bce + de + g has the kernels a + b, ac + bc + d and F itself
+    Sop big{{a, c, e}, {b, c, e}, {d, e}, {g}};
+    auto kernels = algebraic::kernels(big);
+    ASSERT_EQ(kernels.size(), 3u);
+    std::sort(kernels.begin(), kernels.end(), [](const auto &x, const auto &y) { return x.kernel.size() < y.kernel.size(); });
+    EXPECT_EQ(kernels[0].kernel, (Sop{{a}, {b}}));
+    EXPECT_EQ(kernels[0].co_kernel, (Cube{c, e}));
+    EXPECT_EQ(algebraic::normalized(kernels[1].kernel), (Sop{{a, c}, {b, c}, {d}}));
+    EXPECT_EQ(kernels[1].co_kernel, (Cube{e}));
+    EXPECT_EQ(algebraic::normalized(kernels[2].kernel), big);
+    EXPECT_TRUE(kernels[2].co_kernel.empty());
+    EXPECT_TRUE(algebraic::kernels({{a, b}}).empty());
+}
+
+TEST(TestFactor, commonKernel) {
+    auto x = makeSymbols("x", 6);
+    // x0 + x1 is a kernel of both
+    auto f = (x[0] & x[2]) | (x[1] & x[2]) | x[4];
+    auto g = (x[0] & x[3]) | (x[1] & x[3]) | x[5];
+    ExtractStats stats;
+    auto result = extractDivisors({f, g}, {}, &stats);
+    ASSERT_EQ(result.size(), 2u);
+    EXPECT_TRUE(areEquivalent(result[0], f));
+    EXPECT_TRUE(areEquivalent(result[1], g));
+    EXPECT_EQ(stats.literals_before, 10u);
+    EXPECT_EQ(stats.literals_after, 8u);
+    EXPECT_EQ(stats.kernels, 1u);
+    EXPECT_TRUE(occursIn(x[0] | x[1], result[0]));
+    EXPECT_TRUE(occursIn(x[0] | x[1], result[1]));
+
+    // with kernels off, the same divisor as a pair of cubes
+    ExtractOptions options;
+    options.kernels = false;
+    extractDivisors({f, g}, options, &stats);
+    EXPECT_EQ(stats.literals_after, 8u);
+    EXPECT_EQ(stats.kernels, 0u);
+    EXPECT_EQ(stats.cubes, 1u);
+}
+
+TEST(TestFactor, commonCubes) {
+    auto x = makeSymbols("x", 5);
+    // x0 x1 in three products
+    std::vector<Expr> outputs{x[0] & x[1] & x[2], x[0] & x[1] & x[3], x[0] & x[1] & x[4]};
+    ExtractStats stats;
+    auto result = extractDivisors(outputs, {}, &stats);
+    EXPECT_EQ(stats.literals_before, 9u);
+    EXPECT_EQ(stats.literals_after, 8u);
+    EXPECT_EQ(stats.cubes, 1u);
+    for (std::size_t k = 0; k < outputs.size(); ++k)
+        EXPECT_TRUE(areEquivalent(result[k], outputs[k]));
+
+    // nothing to extract, constants and literals
+    auto same = extractDivisors({x[0], !x[1], Expr(true), Expr(false), x[2] | x[3]}, {}, &stats);
+    EXPECT_TRUE(same[0].isEqual(x[0]));
+    EXPECT_TRUE(same[1].isEqual(!x[1]));
+    EXPECT_TRUE(same[2].isEqual(Expr(true)));
+    EXPECT_TRUE(same[3].isEqual(Expr(false)));
+    EXPECT_TRUE(areEquivalent(same[4], x[2] | x[3]));
+    EXPECT_EQ(stats.literals_before, stats.literals_after);
+    EXPECT_TRUE(extractDivisors({}).empty());
+}
+
+TEST(TestFactor, random) {
+    std::mt19937 rng(37);
+    auto x = makeSymbols("x", 10);
+    using Products = std::vector<std::vector<Expr>>;
+    auto randomSop = [&](int cubes, int literals) {
+        Products products(cubes);
+        for (auto &product: products) {
+            for (int j = 0; j < literals; ++j) {
+                const auto &s = x[rng() % x.size()];
+                product.push_back(rng() % 4 ? s : !s);
+            }
+        }
+        return products;
+    };
+    // the products of p * q expanded, the divisors no longer visible
+    auto multiply = [](const Products &p, const Products &q) {
+        Products result;
+        for (const auto &a: p) {
+            for (const auto &b: q) {
+                result.push_back(a);
+                result.back().insert(result.back().end(), b.begin(), b.end());
+            }
+        }
+        return result;
+    };
+    auto toExpr = [](const Products &p) {
+        std::vector<Expr> products;
+        for (const auto &product: p)
+            products.push_back(makeAnd(product));
+        return makeOr(products);
+    };
+    for (int round = 0; round < 10; ++round) {
+        // outputs sharing two sums, multiplied by different ones
+        auto k1 = randomSop(3, 2), k2 = randomSop(2, 2);
+        std::vector<Expr> outputs;
+        for (int i = 0; i < 5; ++i) {
+            auto products = multiply(k1, randomSop(2, 1));
+            auto more = multiply(k2, randomSop(2, 2));
+            products.insert(products.end(), more.begin(), more.end());
+            more = randomSop(2, 3);
+            products.insert(products.end(), more.begin(), more.end());
+            outputs.push_back(toExpr(products));
+        }
+        // one of them inside another, and a relation between bit-vectors as an atom
+        outputs.push_back(outputs[0] & !outputs[1]);
+        Expr a = makeBitVec("a", 3);
+        Expr b = makeBitVec("b", 3);
+        outputs.push_back(((a < b) & toExpr(k1)) | ((a < b) & x[0]));
+
+        ExtractStats stats;
+        auto result = extractDivisors(outputs, {}, &stats);
+        ASSERT_EQ(result.size(), outputs.size());
+        for (std::size_t k = 0; k < outputs.size(); ++k)
+            EXPECT_TRUE(areEquivalent(result[k], outputs[k]));
+        EXPECT_LT(stats.literals_after, stats.literals_before * 5 / 6);
+        EXPECT_GT(stats.kernels, 0u);
+    }
+}
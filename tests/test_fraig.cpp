@@ -0,0 +1,173 @@
+/**
+ * @file test_fraig.cpp
+ * Test SAT sweeping and the equivalence check of graphs.
+ */
+
+#include "jazz/aig.h"
+#include "jazz/boolean-algebra.h"
+#include "jazz/fraig.h"
+#include "jazz/sat.h"
+#include "test_util.h"
+#include <gtest/gtest.h>
+
+#include <random>
+#include <stdexcept>
+
+using namespace jazz;
+
+using Lit = Aig::Lit;
+
+/**
+ * Add a ripple-carry adder of x and y, in one of two gate-level styles.
+ * @param broken_bit  The carry out of that bit is an And instead of the majority.
+ */
+static void addAdder(Aig &aig, const std::vector<Lit> &x, const std::vector<Lit> &y, bool second_style,
+                     int broken_bit = -1) {
+    Lit carry = Aig::FALSE_LIT;
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        Lit half, majority;
+        if (second_style) {
+            half = aig.andOf(aig.orOf(x[i], y[i]), Aig::negate(aig.andOf(x[i], y[i])));
+            majority = aig.orOf(aig.orOf(aig.andOf(x[i], y[i]), aig.andOf(x[i], carry)), aig.andOf(y[i], carry));
+        } else {
+            half = aig.xorOf(x[i], y[i]);
+            majority = aig.orOf(aig.andOf(x[i], y[i]), aig.andOf(carry, aig.orOf(x[i], y[i])));
+        }
+        aig.addOutput(second_style ? aig.orOf(aig.andOf(half, Aig::negate(carry)), aig.andOf(Aig::negate(half), carry))
+                                   : aig.xorOf(half, carry));
+        carry = static_cast<int>(i) == broken_bit ? aig.andOf(x[i], y[i]) : majority;
+    }
+    aig.addOutput(carry);
+}
+
+static Aig makeAdder(const std::vector<Expr> &a, const std::vector<Expr> &b, bool second_style, bool inputs_b_first,
+                     int broken_bit = -1) {
+    Aig aig;
+    std::vector<Lit> x(a.size()), y(b.size());
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (inputs_b_first)
+            y[i] = aig.addInput(b[i]);
+    }
+    for (std::size_t i = 0; i < a.size(); ++i)
+        x[i] = aig.addInput(a[i]);
+    if (!inputs_b_first) {
+        for (std::size_t i = 0; i < b.size(); ++i)
+            y[i] = aig.addInput(b[i]);
+    }
+    addAdder(aig, x, y, second_style, broken_bit);
+    return aig;
+}
+
+TEST(TestFraig, sweep) {
+    const unsigned n = 16;
+    auto a = makeSymbols("a", n);
+    auto b = makeSymbols("b", n);
+    Aig aig;
+    std::vector<Lit> x, y;
+    for (unsigned i = 0; i < n; ++i)
+        x.push_back(aig.addInput(a[i]));
+    for (unsigned i = 0; i < n; ++i)
+        y.push_back(aig.addInput(b[i]));
+    addAdder(aig, x, y, false);
+    addAdder(aig, x, y, true);
+    // a gate that is constant false
+    aig.addOutput(aig.andOf(aig.andOf(x[0], y[0]), Aig::negate(aig.orOf(x[0], y[1]))));
+
+    FraigStats stats;
+    auto swept = fraig(aig, {}, &stats);
+    EXPECT_GT(stats.proved, 0u);
+    EXPECT_EQ(stats.undecided, 0u);
+    EXPECT_LT(swept.numAnds(), aig.numAnds());
+    ASSERT_EQ(swept.numOutputs(), 2 * (n + 1) + 1);
+    for (unsigned k = 0; k <= n; ++k)
+        EXPECT_EQ(swept.output(k), swept.output(k + n + 1));
+    EXPECT_EQ(swept.output(2 * (n + 1)), Aig::FALSE_LIT);
+
+    // the same functions as before
+    std::mt19937_64 rng(7);
+    std::vector<std::uint64_t> words(2 * n);
+    for (auto &w: words)
+        w = rng();
+    auto before = aig.simulate(words);
+    auto after = swept.simulate(words);
+    for (std::size_t k = 0; k < aig.numOutputs(); ++k)
+        EXPECT_EQ(Aig::valueOf(before, aig.output(k)), Aig::valueOf(after, swept.output(k)));
+
+    // sweeping again finds nothing left
+    FraigStats again;
+    EXPECT_EQ(fraig(swept, {}, &again).numAnds(), swept.numAnds());
+    EXPECT_EQ(again.proved, 0u);
+}
+
+TEST(TestFraig, refinement) {
+    // wide conjunctions are false on almost every random pattern, so they all start in the
+    // class of the constant, and the counterexamples split it
+    auto a = makeSymbols("a", 64);
+    Aig aig;
+    std::vector<Lit> x;
+    for (const auto &symbol: a)
+        x.push_back(aig.addInput(symbol));
+    std::mt19937 rng(43);
+    for (int k = 0; k < 400; ++k) {
+        auto lit = x[rng() % x.size()];
+        for (int i = 0; i < 9; ++i)
+            lit = aig.andOf(lit, x[rng() % x.size()] ^ (rng() & 1u));
+        aig.addOutput(lit);
+    }
+    FraigOptions options;
+    options.sim_words = 1;
+    FraigStats stats;
+    auto swept = fraig(aig, options, &stats);
+    EXPECT_GT(stats.refuted, 64u);
+    EXPECT_EQ(stats.undecided, 0u);
+
+    std::mt19937_64 patterns(9);
+    for (int round = 0; round < 16; ++round) {
+        std::vector<std::uint64_t> words(x.size());
+        for (auto &w: words)
+            w = patterns() & patterns() & patterns();
+        auto before = aig.simulate(words);
+        auto after = swept.simulate(words);
+        for (std::size_t k = 0; k < aig.numOutputs(); ++k)
+            EXPECT_EQ(Aig::valueOf(before, aig.output(k)), Aig::valueOf(after, swept.output(k)));
+    }
+}
+
+TEST(TestFraig, equivalence) {
+    const unsigned n = 32;
+    auto a = makeSymbols("a", n);
+    auto b = makeSymbols("b", n);
+    auto reference = makeAdder(a, b, false, false);
+    EXPECT_TRUE(areEquivalent(reference, makeAdder(a, b, true, true)));
+    EXPECT_FALSE(areEquivalent(reference, makeAdder(a, b, true, true, 20)));
+    // the sum bits are the same, only the carry out differs
+    EXPECT_FALSE(areEquivalent(reference, makeAdder(a, b, false, false, static_cast<int>(n) - 1)));
+    EXPECT_THROW(areEquivalent(reference, Aig()), std::invalid_argument);
+
+    // another symbol is free
+    Aig p, q;
+    Expr s("s");
+    Expr t("t");
+    p.addOutput(p.orOf(p.addInput(s), Aig::TRUE_LIT));
+    auto lit = q.addInput(t);
+    q.addOutput(q.orOf(lit, Aig::negate(lit)));
+    EXPECT_TRUE(areEquivalent(p, q));
+    Aig r;
+    r.addOutput(r.addInput(t));
+    EXPECT_FALSE(areEquivalent(p, r));
+}
+
+TEST(TestFraig, largeExpressions) {
+    // large enough for areEquivalent() to sweep instead of solving one miter
+    auto x = makeSymbols("x", 1000);
+    auto y = makeSymbols("y", 1000);
+    std::vector<Expr> clauses, cubes;
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        clauses.push_back(x[i] | y[i]);
+        cubes.push_back(!x[i] & !y[i]);
+    }
+    auto cnf = makeAnd(clauses);
+    EXPECT_TRUE(areEquivalent(cnf, !makeOr(cubes)));
+    cubes.pop_back();
+    EXPECT_FALSE(areEquivalent(cnf, !makeOr(cubes)));
+}
@@ -0,0 +1,301 @@
+/**
+ * @file test_minimize.cpp
+ * Test the exact two-level minimizer.
+ */
+
+#include "jazz/boolean-algebra.h"
+#include "jazz/minimize.h"
+#include "jazz/op_and.h"
+#include "jazz/op_or.h"
+#include "jazz/sat.h"
+#include "test_util.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+
+using namespace jazz;
+
+/**
+ * The number of products of a sum of products, and the number of its literals.
+ */
+static std::pair<std::size_t, std::size_t> sopSize(const Expr &e) {
+    if (e.isTrivial())
+        return {e.trivialValue() ? 1 : 0, 0};
+    auto productSize = [](const Expr &p) -> std::size_t { return is_a<And>(p) ? p.numOperands() : 1; };
+    if (!is_a<Or>(e))
+        return {1, productSize(e)};
+    std::size_t literals = 0;
+    for (std::size_t i = 0; i < e.numOperands(); ++i)
+        literals += productSize(e.operand(i));
+    return {e.numOperands(), literals};
+}
+
+/**
+ * The smallest number of products of the primes that cover the minterms, trying all subsets.
+ */
+static std::size_t bruteForceCover(const std::vector<std::uint32_t> &on, const std::vector<Implicant> &primes) {
+    std::size_t fewest = primes.size();
+    for (std::uint32_t subset = 0; subset < (1u << primes.size()); ++subset) {
+        bool all = true;
+        for (auto m: on) {
+            bool hit = false;
+            for (std::size_t p = 0; p < primes.size() && !hit; ++p)
+                hit = ((subset >> p) & 1u) && primes[p].covers(m);
+            all = all && hit;
+        }
+        std::size_t size = 0;
+        for (auto s = subset; s; s &= s - 1)
+            ++size;
+        if (all && size < fewest)
+            fewest = size;
+    }
+    return fewest;
+}
+
+TEST(TestMinimize, primes) {
+    // the classic example: f = sum m(0, 1, 2, 5, 6, 7) has six primes and two minimum covers
+    std::vector<std::uint32_t> on{0, 1, 2, 5, 6, 7};
+    auto primes = primeImplicants(3, on);
+    EXPECT_EQ(primes.size(), 6u);
+    for (const auto &p: primes) {
+        EXPECT_EQ(p.numLiterals(3), 2u);
+        for (std::uint32_t m = 0; m < 8; ++m) {
+            if (p.covers(m))
+                EXPECT_NE(std::find(on.begin(), on.end(), m), on.end());
+        }
+    }
+    EXPECT_EQ(minimumCover(3, on, primes).size(), 3u);
+
+    // with don't cares, one prime covers everything
+    auto all = primeImplicants(2, {0, 3}, {1, 2});
+    ASSERT_EQ(all.size(), 1u);
+    EXPECT_EQ(all[0].dashes, 3u);
+    EXPECT_TRUE(primeImplicants(4, {}).empty());
+    EXPECT_THROW(primeImplicants(4, {16}), std::invalid_argument);
+    EXPECT_THROW(primeImplicants(17, {}), std::invalid_argument);
+}
+
+TEST(TestMinimize, random) {
+    std::mt19937 rng(23);
+    for (int round = 0; round < 40; ++round) {
+        unsigned n = 3 + rng() % 3;
+        std::vector<std::uint32_t> on, dc;
+        for (std::uint32_t m = 0; m < (1u << n); ++m) {
+            auto r = rng() % 8;
+            if (r < 3)
+                on.push_back(m);
+            else if (r == 3)
+                dc.push_back(m);
+        }
+        auto primes = primeImplicants(n, on, dc);
+        // every prime is an implicant that cannot lose a literal
+        for (const auto &p: primes) {
+            for (unsigned b = 0; b < n; ++b) {
+                if ((p.dashes >> b) & 1u)
+                    continue;
+                Implicant larger{p.value & ~(1u << b), p.dashes | (1u << b)};
+                bool implicant = true;
+                for (std::uint32_t m = 0; m < (1u << n); ++m) {
+                    if (larger.covers(m))
+                        implicant = implicant && (std::count(on.begin(), on.end(), m) || std::count(dc.begin(), dc.end(), m));
+                }
+                EXPECT_FALSE(implicant);
+            }
+        }
+        std::vector<Implicant> useful;
+        for (const auto &p: primes) {
+            if (std::any_of(on.begin(), on.end(), [&](std::uint32_t m) { return p.covers(m); }))
+                useful.push_back(p);
+        }
+        if (useful.size() > 16)
+            continue;
+        EXPECT_EQ(minimumCover(n, on, useful).size(), bruteForceCover(on, useful));
+    }
+}
+
+TEST(TestMinimize, expressions) {
+    auto x = makeSymbols("x", 4);
+    // a redundant sum of products becomes the minimum one
+    Expr f = (x[0] & x[1]) | (x[0] & !x[1] & x[2]) | (x[0] & x[2] & x[3]) | (x[0] & x[1] & !x[3]);
+    auto minimum = minimizeExact(f);
+    EXPECT_TRUE(areEquivalent(minimum, f));
+    EXPECT_EQ(sopSize(minimum), std::make_pair(std::size_t(2), std::size_t(4)));
+
+    // the don't cares make x0 xor x1 into a single literal
+    auto with_dc = minimizeExact(x[0] & !x[1], x[0] & x[1]);
+    EXPECT_TRUE(with_dc.isEqual(x[0]));
+
+    EXPECT_TRUE(minimizeExact(x[0] | !x[0]).isEqual(Expr(true)));
+    EXPECT_TRUE(minimizeExact(x[0] & !x[0]).isEqual(Expr(false)));
+    EXPECT_THROW(minimizeExact(makeOr(makeSymbols("y", 17))), std::invalid_argument);
+
+    std::mt19937 rng(3);
+    for (int round = 0; round < 20; ++round) {
+        std::vector<Expr> products;
+        for (int k = 0; k < 5; ++k) {
+            std::vector<Expr> literals;
+            for (const auto &s: x) {
+                auto r = rng() % 3;
+                if (r < 2)
+                    literals.push_back(r ? s : !s);
+            }
+            products.push_back(makeAnd(literals));
+        }
+        auto g = makeOr(products);
+        auto h = minimizeExact(g);
+        EXPECT_TRUE(areEquivalent(g, h));
+        EXPECT_LE(sopSize(h).first, 5u);
+    }
+}
+
+TEST(TestMinimize, sixteenVariables) {
+    auto x = makeSymbols("x", 16);
+    // the parity of four symbols needs its eight minterms as products
+    Expr parity = x[0];
+    for (unsigned i = 1; i < 4; ++i)
+        parity = (parity & !x[i]) | (!parity & x[i]);
+    std::vector<Expr> clauses;
+    for (unsigned i = 4; i + 1 < 16; i += 2)
+        clauses.push_back(x[i] & x[i + 1]);
+    // or'ed with six products of disjoint pairs
+    auto f = makeOr(clauses) | parity;
+
+    auto start = std::chrono::steady_clock::now();
+    auto minimum = minimizeExact(f);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_TRUE(areEquivalent(minimum, f));
+    EXPECT_EQ(sopSize(minimum), std::make_pair(std::size_t(6 + 8), std::size_t(6 * 2 + 8 * 4)));
+    EXPECT_LT(std::chrono::duration_cast<std::chrono::seconds>(elapsed).count(), 5);
+}
+
+TEST(TestMinimize, sixteenVariablesRandom) {
+    // thousands of primes in the cover, as many levels of search
+    std::mt19937 rng(7);
+    std::vector<std::uint32_t> on;
+    for (std::uint32_t m = 0; m < (1u << 16); ++m) {
+        if (rng() % 8 == 0)
+            on.push_back(m);
+    }
+    auto primes = primeImplicants(16, on);
+    auto start = std::chrono::steady_clock::now();
+    auto cover = minimumCover(16, on, primes);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_GT(cover.size(), 4000u);
+    for (auto m: on) {
+        EXPECT_TRUE(std::any_of(cover.begin(), cover.end(), [&](const Implicant &c) { return c.covers(m); }));
+    }
+    EXPECT_LT(std::chrono::duration_cast<std::chrono::seconds>(elapsed).count(), 10);
+}
+
+TEST(TestMinimize, cubes) {
+    Cube cube(40);
+    EXPECT_EQ(cube.numLiterals(), 0u);
+    cube.setLiteral(3, true);
+    cube.setLiteral(35, false);
+    EXPECT_EQ(cube.literal(3), 1);
+    EXPECT_EQ(cube.literal(35), 0);
+    EXPECT_EQ(cube.literal(4), -1);
+    EXPECT_EQ(cube.numLiterals(), 2u);
+    Cube smaller = cube;
+    smaller.setLiteral(20, true);
+    EXPECT_TRUE(cube.contains(smaller));
+    EXPECT_FALSE(smaller.contains(cube));
+    smaller.clearLiteral(20);
+    EXPECT_EQ(smaller, cube);
+    EXPECT_FALSE(cube.isEmpty());
+
+    // x0 x1' + x0 x1 + x0' x1 becomes x0 + x1
+    std::vector<Cube> on(3, Cube(2));
+    on[0].setLiteral(0, true);
+    on[0].setLiteral(1, false);
+    on[1].setLiteral(0, true);
+    on[1].setLiteral(1, true);
+    on[2].setLiteral(0, false);
+    on[2].setLiteral(1, true);
+    auto cover = espresso(on);
+    ASSERT_EQ(cover.size(), 2u);
+    EXPECT_EQ(cover[0].numLiterals() + cover[1].numLiterals(), 2u);
+    EXPECT_THROW(espresso({Cube(2)}, {Cube(3)}), std::invalid_argument);
+}
+
+TEST(TestMinimize, espressoSmall) {
+    std::mt19937 rng(29);
+    auto x = makeSymbols("x", 6);
+    std::size_t exact_total = 0, heuristic_total = 0;
+    for (int round = 0; round < 30; ++round) {
+        std::vector<Expr> products;
+        for (int k = 0; k < 6; ++k) {
+            std::vector<Expr> literals;
+            for (const auto &s: x) {
+                auto r = rng() % 3;
+                if (r < 2)
+                    literals.push_back(r ? s : !s);
+            }
+            products.push_back(makeAnd(literals));
+        }
+        auto f = makeOr(products);
+        Expr dc = round % 3 ? Expr(false) : x[0] & x[1] & !x[2];
+        auto heuristic = espresso(f, dc);
+        // between the care set and the care set with the don't cares
+        EXPECT_TRUE(isTautology(!(f & !dc) | heuristic));
+        EXPECT_TRUE(isTautology(!heuristic | f | dc));
+        auto exact = sopSize(minimizeExact(f, dc)).first;
+        auto size = sopSize(heuristic).first;
+        EXPECT_GE(size, exact);
+        exact_total += exact;
+        heuristic_total += size;
+    }
+    // close to the minimum on average
+    EXPECT_LE(heuristic_total, exact_total + exact_total / 10);
+
+    // not a sum of products: enumerated first
+    auto y = makeSymbols("y", 3);
+    auto g = (x[0] & (x[1] | x[2])) | (y[0] & !(y[1] & y[2]));
+    auto h = espresso(g);
+    EXPECT_TRUE(areEquivalent(g, h));
+    EXPECT_EQ(sopSize(h), std::make_pair(std::size_t(4), std::size_t(8)));
+    EXPECT_TRUE(espresso(x[0] | !x[0]).isEqual(Expr(true)));
+    EXPECT_TRUE(espresso(Expr(false)).isEqual(Expr(false)));
+}
+
+TEST(TestMinimize, espressoWide) {
+    // twenty products over 48 symbols, hidden among products they contain
+    std::mt19937 rng(31);
+    auto x = makeSymbols("x", 48);
+    std::vector<Expr> base, products;
+    for (int k = 0; k < 20; ++k) {
+        std::vector<Expr> literals, more;
+        for (int j = 0; j < 5; ++j) {
+            const auto &s = x[rng() % x.size()];
+            literals.push_back(rng() & 1u ? s : !s);
+        }
+        base.push_back(makeAnd(literals));
+        products.push_back(base.back());
+        for (int copy = 0; copy < 5; ++copy) {
+            more = literals;
+            for (int j = 0; j < 4; ++j) {
+                const auto &s = x[rng() % x.size()];
+                more.push_back(rng() & 1u ? s : !s);
+            }
+            products.push_back(makeAnd(more));
+        }
+    }
+    std::shuffle(products.begin(), products.end(), rng);
+    auto f = makeOr(products);
+    auto start = std::chrono::steady_clock::now();
+    auto minimized = espresso(f);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_TRUE(areEquivalent(minimized, makeOr(base)));
+    EXPECT_LE(sopSize(minimized).first, 20u);
+    EXPECT_LT(std::chrono::duration_cast<std::chrono::seconds>(elapsed).count(), 5);
+
+    // a limit on the enumerated cubes
+    EspressoOptions options;
+    options.max_initial_cubes = 3;
+    auto parity = (x[0] & !x[1]) | (!x[0] & x[1]);
+    auto parity3 = (parity & !x[2]) | (!parity & x[2]);
+    EXPECT_THROW(espresso(parity3, Expr(false), options), std::length_error);
+}
@@ -0,0 +1,118 @@
+/**
+ * @file test_model_count.cpp
+ * Test the exact and weighted model counters.
+ */
+
+#include "jazz/boolean-algebra.h"
+#include "jazz/model_count.h"
+#include "test_util.h"
+#include <gtest/gtest.h>
+
+#include <random>
+#include <stdexcept>
+
+using namespace jazz;
+
+static std::uint64_t bruteForce(const Expr &e, const std::vector<Expr> &symbols) {
+    std::uint64_t n = 0;
+    for (std::uint32_t a = 0; a < (1u << symbols.size()); ++a) {
+        ExprMap m;
+        for (std::size_t i = 0; i < symbols.size(); ++i)
+            m.emplace(symbols[i], Expr(bool((a >> i) & 1u)));
+        n += e.subs(m).trivialValue();
+    }
+    return n;
+}
+
+TEST(TestModelCount, natural) {
+    EXPECT_EQ(Natural::pow2(100).toString(), "1267650600228229401496703205376");
+    EXPECT_EQ(Natural().toString(), "0");
+    EXPECT_TRUE(Natural().isZero());
+    Natural big(0xffffffffffffffffull);
+    EXPECT_EQ((big + 1).toString(), "18446744073709551616");
+    EXPECT_EQ((big + 1), Natural::pow2(64));
+    EXPECT_EQ((big * big).toString(), "340282366920938463426481119284349108225");
+    EXPECT_EQ(big.toUint64(), 0xffffffffffffffffull);
+    EXPECT_THROW((big + 1).toUint64(), std::overflow_error);
+    EXPECT_EQ(Natural::pow2(64).numBits(), 65u);
+    EXPECT_DOUBLE_EQ(Natural::pow2(70).toDouble(), 1180591620717411303424.0);
+    EXPECT_TRUE(Natural(5) < Natural::pow2(40));
+    EXPECT_FALSE(Natural::pow2(40) < Natural(5));
+    Natural n(1);
+    for (int i = 0; i < 50; ++i)
+        n *= 3;
+    EXPECT_EQ(n.toString(), "717897987691852588770249");
+}
+
+TEST(TestModelCount, small) {
+    Expr p("p");
+    Expr q("q");
+    Expr r("r");
+    EXPECT_EQ(countModels(p | q), 3);
+    EXPECT_EQ(countModels(p | q, {p, q, r}), 6);
+    EXPECT_EQ(countModels(p & !p), 0);
+    EXPECT_EQ(countModels(Expr(true)), 1);
+    EXPECT_EQ(countModels(Expr(true), {p, q}), 4);
+    EXPECT_THROW(countModels(p | q, {p}), std::invalid_argument);
+
+    CountOptions search;
+    search.bdd_max_vars = 0;
+    EXPECT_EQ(countModels(p | q, search), 3);
+    EXPECT_EQ(countModels(p & !q & r, search), 1);
+    EXPECT_EQ(countModels(Expr(false), search), 0);
+
+    std::mt19937 rng(11);
+    std::vector<Expr> symbols;
+    for (int i = 0; i < 7; ++i)
+        symbols.emplace_back(("s" + std::to_string(i)).c_str());
+    for (int round = 0; round < 40; ++round) {
+        auto e = randomExpr(rng, symbols, 5);
+        auto expected = bruteForce(e, symbols);
+        EXPECT_EQ(countModels(e, symbols).toUint64(), expected);
+        EXPECT_EQ(countModels(e, symbols, search).toUint64(), expected);
+    }
+}
+
+TEST(TestModelCount, large) {
+    // 50 independent clauses of two symbols
+    std::vector<Expr> clauses;
+    std::vector<Expr> symbols;
+    for (int i = 0; i < 50; ++i) {
+        Expr x(("x" + std::to_string(i)).c_str());
+        Expr y(("y" + std::to_string(i)).c_str());
+        clauses.push_back(x | y);
+        symbols.push_back(x);
+        symbols.push_back(y);
+    }
+    auto e = makeAnd(clauses);
+    EXPECT_EQ(countModels(e).toString(), "717897987691852588770249");
+    for (int i = 0; i < 10; ++i)
+        symbols.emplace_back(("z" + std::to_string(i)).c_str());
+    EXPECT_EQ(countModels(e, symbols).toString(), "735127539396457050900734976");
+
+    // a chain of overlapping clauses: the strings of 100 bits without two zeros in a row
+    std::vector<Expr> chain_symbols;
+    for (int i = 0; i < 100; ++i)
+        chain_symbols.emplace_back(("c" + std::to_string(i)).c_str());
+    std::vector<Expr> chain;
+    for (int i = 0; i + 1 < 100; ++i)
+        chain.push_back(chain_symbols[i] | chain_symbols[i + 1]);
+    EXPECT_EQ(countModels(makeAnd(chain)).toString(), "927372692193078999176");
+}
+
+TEST(TestModelCount, weighted) {
+    Expr p("p");
+    Expr q("q");
+    Expr r("r");
+    LiteralWeights probabilities{{p, {0.3, 0.7}}, {q, {0.5, 0.5}}, {r, {0.9, 0.1}}};
+    CountOptions search;
+    search.bdd_max_vars = 0;
+    for (const auto &options: {CountOptions(), search}) {
+        EXPECT_NEAR(weightedCount(p | q, probabilities, options), 1 - 0.7 * 0.5, 1e-12);
+        EXPECT_NEAR(weightedCount(p & !r, probabilities, options), 0.3 * 0.1, 1e-12);
+        EXPECT_NEAR(weightedCount((p & q) | (!p & r), probabilities, options), 0.3 * 0.5 + 0.7 * 0.9, 1e-12);
+        EXPECT_NEAR(weightedCount(p, {{p, {2, 3}}, {q, {1, 4}}}, options), 2 * 5, 1e-12);
+        // a symbol without weights counts both of its values
+        EXPECT_NEAR(weightedCount(p | q, {{p, {0.5, 0.5}}}, options), 1.5, 1e-12);
+    }
+}
@@ -32,6 +32,8 @@ TEST(TestNot, constant) {
     EXPECT_TRUE(Expr(false).isEqual(false));
     EXPECT_FALSE(Expr(true).isEqual(false));
     EXPECT_FALSE(Expr(false).isEqual(true));
+    EXPECT_TRUE((!Expr(false)).isEqual(true));
+    EXPECT_TRUE((!Expr(true)).isEqual(false));
 }
 
 TEST(TestNot, symbol) {
@@ -0,0 +1,158 @@
+/**
+ * @file test_npn.cpp
+ * Test NPN canonical forms and the database of optimal graphs.
+ */
+
+#include "jazz/aig.h"
+#include "jazz/aig_opt.h"
+#include "jazz/npn.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <set>
+#include <stdexcept>
+
+using namespace jazz;
+
+using Lit = Aig::Lit;
+
+static NpnTransform randomTransform(std::mt19937 &rng, unsigned n) {
+    NpnTransform t;
+    std::shuffle(t.perm, t.perm + n, rng);
+    t.negations = static_cast<std::uint8_t>(rng() % (1u << n));
+    t.output = rng() & 1u;
+    return t;
+}
+
+TEST(TestNpn, canonical) {
+    std::mt19937 rng(41);
+    for (unsigned n = 0; n <= 5; ++n) {
+        for (int round = 0; round < 20; ++round) {
+            auto f = tt::replicate((tt::Table(rng()) << 32) | rng(), n);
+            auto form = npnCanonical(f, n);
+            EXPECT_EQ(applyNpn(form.canonical, n, form.transform), f);
+            EXPECT_LE(form.canonical, f);
+            // every member of the class has the same representative
+            auto g = applyNpn(f, n, randomTransform(rng, n));
+            EXPECT_EQ(npnCanonical(g, n).canonical, form.canonical);
+        }
+    }
+    // the 14 classes of functions of 3 variables
+    std::set<tt::Table> classes;
+    for (tt::Table f = 0; f < 256; ++f)
+        classes.insert(npnCanonical(f, 3).canonical);
+    EXPECT_EQ(classes.size(), 14u);
+    EXPECT_EQ(npnCanonical(tt::var(0) & tt::var(1), 2).canonical, tt::replicate(0x1, 2));
+    EXPECT_THROW(npnCanonical(0, 7), std::invalid_argument);
+}
+
+TEST(TestNpn, fourVariables) {
+    std::set<tt::Table> classes;
+    std::mt19937 rng(43);
+    for (std::uint32_t f = 0; f < (1u << 16); ++f) {
+        auto form = npnCanonical4(static_cast<std::uint16_t>(f));
+        classes.insert(form.canonical);
+        ASSERT_EQ(applyNpn(form.canonical, 4, form.transform), tt::replicate(f, 4));
+        ASSERT_LT(npnClass4(static_cast<std::uint16_t>(f)), NUM_NPN4_CLASSES);
+        if (f % 97 == 0)
+            EXPECT_EQ(npnCanonical(f, 4).canonical, form.canonical);
+    }
+    EXPECT_EQ(classes.size(), NUM_NPN4_CLASSES);
+    EXPECT_EQ(npnClass4(0), 0u);
+    EXPECT_EQ(npnClass4(0xffff), 0u);
+}
+
+TEST(TestNpn, database) {
+    const auto &database = NpnDatabase::builtin();
+    ASSERT_EQ(database.size(), NUM_NPN4_CLASSES);
+    unsigned optimal = 0;
+    for (unsigned c = 0; c < database.size(); ++c) {
+        EXPECT_LE(database[c].num_gates, libraryCost(database[c].truth));
+        optimal += database[c].optimal;
+    }
+    EXPECT_GT(optimal, 0u);
+    // every function of 4 variables, over its class
+    Aig aig;
+    Lit leaves[4];
+    for (auto &leaf: leaves)
+        leaf = aig.addInput();
+    for (std::uint32_t f = 0; f < (1u << 16); ++f)
+        aig.addOutput(database.build(aig, static_cast<std::uint16_t>(f), leaves));
+    std::vector<std::uint64_t> words(4);
+    for (unsigned i = 0; i < 4; ++i)
+        words[i] = tt::var(i);
+    auto values = aig.simulate(words);
+    for (std::uint32_t f = 0; f < (1u << 16); ++f)
+        ASSERT_EQ(static_cast<std::uint16_t>(Aig::valueOf(values, aig.output(f))), f);
+
+    // the known optimum of a few classes: and, xor, and the and of 4
+    Aig small;
+    for (auto &leaf: leaves)
+        leaf = small.addInput();
+    auto xor2 = static_cast<std::uint16_t>(tt::var(0) ^ tt::var(1));
+    EXPECT_EQ(database.entryOf(xor2).num_gates, 3u);
+    EXPECT_EQ(database.entryOf(static_cast<std::uint16_t>(tt::var(2) & ~tt::var(3))).num_gates, 1u);
+    auto and4 = static_cast<std::uint16_t>(tt::var(0) & tt::var(1) & tt::var(2) & tt::var(3));
+    EXPECT_EQ(database.entryOf(and4).num_gates, 3u);
+    EXPECT_EQ(database.entryOf(and4).depth, 2u);
+    small.addOutput(database.build(small, and4, leaves));
+    EXPECT_EQ(small.numAnds(), 3u);
+    EXPECT_EQ(small.depth(), 2u);
+}
+
+TEST(TestNpn, saveLoad) {
+    const auto &database = NpnDatabase::builtin();
+    auto path = testing::TempDir() + "jazz_npn4.db";
+    database.save(path);
+    auto loaded = NpnDatabase::load(path);
+    ASSERT_EQ(loaded.size(), database.size());
+    for (unsigned c = 0; c < database.size(); ++c)
+        EXPECT_EQ(std::memcmp(&loaded[c], &database[c], sizeof(NpnDatabase::Entry)), 0);
+
+    // a wrong entry is found on loading
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(16 + 36 * 100 + 5);
+        file.put(0);
+    }
+    EXPECT_THROW(NpnDatabase::load(path), std::runtime_error);
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "JAZZNPN4 but not quite";
+    }
+    EXPECT_THROW(NpnDatabase::load(path), std::runtime_error);
+    std::remove(path.c_str());
+    EXPECT_THROW(NpnDatabase::load("/nonexistent/npn4.db"), std::runtime_error);
+}
+
+TEST(TestNpn, rewrite) {
+    // the first class that the decompositions of the library implement with more gates
+    const auto &database = NpnDatabase::builtin();
+    Lit leaves[4];
+    std::uint16_t truth = 0;
+    std::size_t gates = 0;
+    Aig aig;
+    for (unsigned c = 0; c < database.size(); ++c) {
+        aig = Aig();
+        for (auto &leaf: leaves)
+            leaf = aig.addInput();
+        truth = database[c].truth;
+        aig.addOutput(buildFromLibrary(aig, truth, leaves));
+        gates = aig.numAnds();
+        if (gates >= database[c].num_gates + 2u)
+            break;
+    }
+    ASSERT_GE(gates, database.entryOf(truth).num_gates + 2u);
+
+    // enough cuts per node to keep the one over the inputs
+    auto rewritten = rewrite(aig, 2);
+    EXPECT_EQ(rewritten.numAnds(), database.entryOf(truth).num_gates);
+    std::vector<std::uint64_t> words(4);
+    for (unsigned i = 0; i < 4; ++i)
+        words[i] = tt::var(i);
+    EXPECT_EQ(static_cast<std::uint16_t>(Aig::valueOf(rewritten.simulate(words), rewritten.output(0))), truth);
+}
@@ -55,3 +55,15 @@ TEST(TestOr, substitution) {
 
     EXPECT_TRUE(r.subs(p == (p | q | r & true | false)).isEqual(p | q | p | r));
 }
+
+TEST(TestOr, nary) {
+    Expr p("p");
+    Expr q("q");
+    Expr r("r");
+    EXPECT_TRUE(makeOr({p, q, r}).isEqual(p | q | r));
+    EXPECT_TRUE(makeOr({p | q, r, p}).isEqual(p | q | r));
+    EXPECT_TRUE(makeOr({p, false}).isEqual(p));
+    EXPECT_TRUE(makeOr({p, !p, q}).isEqual(true));
+    EXPECT_TRUE(makeOr({}).isEqual(false));
+    EXPECT_TRUE(makeOr({q}).isEqual(q));
+}
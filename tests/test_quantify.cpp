@@ -0,0 +1,109 @@
+/**
+ * @file test_quantify.cpp
+ * Test cofactors and quantifiers, on expressions and on BDDs.
+ */
+
+#include "jazz/bdd.h"
+#include "jazz/bitvec.h"
+#include "jazz/boolean-algebra.h"
+#include "jazz/quantify.h"
+#include "jazz/sat.h"
+#include "test_util.h"
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace jazz;
+
+TEST(TestQuantify, cofactor) {
+    Expr p("p");
+    Expr q("q");
+    Expr r("r");
+    Expr f = (p & q) | (!p & r);
+    for (auto engine: {QuantifyEngine::DAG, QuantifyEngine::BDD}) {
+        EXPECT_TRUE(areEquivalent(cofactor(f, p, true, engine), q));
+        EXPECT_TRUE(areEquivalent(cofactor(f, p, false, engine), r));
+        EXPECT_TRUE(areEquivalent(cofactor(f, q, false, engine), !p & r));
+        EXPECT_TRUE(areEquivalent(exists(f, {p}, engine), q | r));
+        EXPECT_TRUE(areEquivalent(forall(f, {p}, engine), q & r));
+        EXPECT_TRUE(exists(f, {p, q, r}, engine).trivialValue());
+        EXPECT_TRUE(areEquivalent(forall(f, {}, engine), f));
+        EXPECT_FALSE(forall(f, {q, r}, engine).trivialValue());
+    }
+
+    // a relation between bit-vectors is restricted through its bits
+    Expr a = makeBitVec("a", 2);
+    Expr b = makeBitVec("b", 2);
+    Expr less = a < b;
+    Expr a1 = a.operand(1);
+    EXPECT_TRUE(areEquivalent(exists(less, {a1}), exists(less, {a1}, QuantifyEngine::BDD)));
+}
+
+TEST(TestQuantify, random) {
+    std::mt19937 rng(17);
+    std::vector<Expr> symbols;
+    for (int i = 0; i < 6; ++i)
+        symbols.emplace_back(("s" + std::to_string(i)).c_str());
+    for (int round = 0; round < 40; ++round) {
+        auto f = randomExpr(rng, symbols, 5);
+        std::vector<Expr> vars{symbols[rng() % 6], symbols[rng() % 6]};
+        auto dag = exists(f, vars);
+        auto bdd = exists(f, vars, QuantifyEngine::BDD);
+        EXPECT_TRUE(areEquivalent(dag, bdd));
+        EXPECT_TRUE(areEquivalent(forall(f, vars), forall(f, vars, QuantifyEngine::BDD)));
+        // exists x. f is the weakest function over the other symbols implied by f
+        EXPECT_TRUE(isTautology(!f | dag));
+        for (const auto &x: vars)
+            EXPECT_FALSE(CofactorCache().cofactor(dag, x, true).has(x));
+    }
+}
+
+TEST(TestQuantify, cache) {
+    // a large shared part without x and a small one with it
+    std::vector<Expr> symbols;
+    for (int i = 0; i < 200; ++i)
+        symbols.emplace_back(("y" + std::to_string(i)).c_str());
+    std::vector<Expr> clauses;
+    for (int i = 0; i + 1 < 200; ++i)
+        clauses.push_back(symbols[i] | !symbols[i + 1]);
+    Expr big = makeAnd(clauses);
+    Expr x("x");
+    Expr z("z");
+    Expr f = (big & (x | z)) | (!big & (!x | z));
+
+    CofactorCache cache;
+    auto f1 = cache.cofactor(f, x, true);
+    // only the nodes above x are visited
+    EXPECT_LE(cache.size(), 6u);
+    EXPECT_TRUE(areEquivalent(f1, big | z));
+    auto lookups = cache.lookups();
+    auto again = cache.cofactor(f, x, true);
+    EXPECT_TRUE(again.isEqual(f1));
+    EXPECT_EQ(cache.lookups(), lookups + 1);
+    EXPECT_GT(cache.hits(), 0u);
+    EXPECT_FALSE(cache.mayDependOn(big, x));
+    EXPECT_TRUE(cache.mayDependOn(f, x));
+    EXPECT_TRUE(cache.cofactor(big, x, false).isEqual(big));
+    EXPECT_TRUE(areEquivalent(cache.exists(f, {x}), big | !big | z));
+    EXPECT_TRUE(areEquivalent(cache.forall(f, {x}), z));
+    EXPECT_THROW(cache.cofactor(f, x & z, true), std::invalid_argument);
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST(TestQuantify, bdd) {
+    bdd::Manager m;
+    auto x = m.newVar(), y = m.newVar(), z = m.newVar();
+    auto f = (m.var(x) & m.var(y)) | (!m.var(x) & m.var(z));
+    EXPECT_EQ(m.cofactor(f, x, true), m.var(y));
+    EXPECT_EQ(m.cofactor(f, x, false), m.var(z));
+    EXPECT_EQ(m.cofactor(f, z, true), m.var(y) | !m.var(x));
+    EXPECT_EQ(m.exists(f, {x}), m.var(y) | m.var(z));
+    EXPECT_EQ(m.forall(f, {x}), m.var(y) & m.var(z));
+    EXPECT_EQ(m.exists(f, {y, z}), m.one());
+    EXPECT_EQ(m.forall(f, {y, z}), m.zero());
+    EXPECT_EQ(m.exists(f, {}), f);
+    EXPECT_EQ(m.exists(m.var(y), {x, z}), m.var(y));
+    EXPECT_EQ(m.exists(!f, {x}), !(m.var(y) & m.var(z)));
+    EXPECT_THROW(m.exists(f, {7}), std::out_of_range);
+}
@@ -0,0 +1,258 @@
+/**
+ * @file test_sat.cpp
+ * Test the CDCL solver and the satisfiability queries.
+ */
+
+#include "jazz/bitvec.h"
+#include "jazz/boolean-algebra.h"
+#include "jazz/sat.h"
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace jazz;
+using sat::makeLit;
+
+static bool satisfies(const std::vector<std::vector<sat::Lit>> &clauses, const std::vector<bool> &model) {
+    for (const auto &clause: clauses) {
+        bool sat = false;
+        for (auto lit: clause)
+            sat = sat || model[sat::varOf(lit)] != sat::isNegative(lit);
+        if (!sat)
+            return false;
+    }
+    return true;
+}
+
+static bool bruteForce(const std::vector<std::vector<sat::Lit>> &clauses, unsigned n) {
+    std::vector<bool> model(n);
+    for (std::uint32_t a = 0; a < (1u << n); ++a) {
+        for (unsigned v = 0; v < n; ++v)
+            model[v] = (a >> v) & 1u;
+        if (satisfies(clauses, model))
+            return true;
+    }
+    return false;
+}
+
+static bool sameExprs(const std::vector<Expr> &a, const std::vector<Expr> &b) {
+    if (a.size() != b.size())
+        return false;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (!a[i].isEqual(b[i]))
+            return false;
+    }
+    return true;
+}
+
+TEST(TestSAT, pigeonHole) {
+    // 8 pigeons in 7 holes, hard enough for several restarts and clause-database reductions
+    const unsigned pigeons = 8, holes = 7;
+    sat::SolverOptions options;
+    options.first_reduce = 100;
+    sat::Solver solver(options);
+    auto var = [&](unsigned p, unsigned h) { return p * holes + h; };
+    for (unsigned p = 0; p < pigeons; ++p) {
+        std::vector<sat::Lit> clause;
+        for (unsigned h = 0; h < holes; ++h)
+            clause.push_back(makeLit(var(p, h)));
+        solver.addClause(clause);
+    }
+    for (unsigned h = 0; h < holes; ++h) {
+        for (unsigned p = 0; p < pigeons; ++p) {
+            for (unsigned q = p + 1; q < pigeons; ++q)
+                solver.addClause({makeLit(var(p, h), true), makeLit(var(q, h), true)});
+        }
+    }
+    EXPECT_EQ(solver.solve(), sat::Result::UNSATISFIABLE);
+    EXPECT_GT(solver.numRestarts(), 0u);
+    EXPECT_LT(solver.numLearnts(), solver.numConflicts());
+    EXPECT_FALSE(solver.okay());
+    EXPECT_FALSE(solver.addClause({makeLit(0)}));
+}
+
+TEST(TestSAT, random3Sat) {
+    std::mt19937 rng(42);
+    for (int round = 0; round < 60; ++round) {
+        // around the phase transition, so both answers occur
+        const unsigned n = 12, m = 52;
+        std::vector<std::vector<sat::Lit>> clauses;
+        sat::Solver solver;
+        for (unsigned i = 0; i < m; ++i) {
+            std::vector<sat::Lit> clause;
+            for (int k = 0; k < 3; ++k)
+                clause.push_back(makeLit(rng() % n, rng() & 1u));
+            clauses.push_back(clause);
+            solver.addClause(clause);
+        }
+        while (solver.numVars() < n)
+            solver.newVar();
+        auto res = solver.solve();
+        ASSERT_NE(res, sat::Result::UNKNOWN);
+        EXPECT_EQ(res == sat::Result::SATISFIABLE, bruteForce(clauses, n));
+        if (res == sat::Result::SATISFIABLE)
+            EXPECT_TRUE(satisfies(clauses, solver.getModel()));
+    }
+}
+
+TEST(TestSAT, largeInstance) {
+    // a satisfiable planted instance, larger than the restart and reduction intervals
+    std::mt19937 rng(3);
+    const unsigned n = 300, m = 1200;
+    std::vector<bool> planted(n);
+    for (unsigned v = 0; v < n; ++v)
+        planted[v] = rng() & 1u;
+    sat::SolverOptions options;
+    options.first_reduce = 100;
+    options.restart_unit = 20;
+    sat::Solver solver(options);
+    std::vector<std::vector<sat::Lit>> clauses;
+    while (clauses.size() < m) {
+        std::vector<sat::Lit> clause;
+        for (int k = 0; k < 3; ++k)
+            clause.push_back(makeLit(rng() % n, rng() & 1u));
+        clauses.push_back(clause);
+        if (!satisfies({clause}, planted))
+            clauses.pop_back();
+    }
+    for (const auto &clause: clauses)
+        solver.addClause(clause);
+    ASSERT_EQ(solver.solve(), sat::Result::SATISFIABLE);
+    EXPECT_TRUE(satisfies(clauses, solver.getModel()));
+
+    sat::SolverOptions limited;
+    limited.conflict_limit = 1;
+    sat::Solver php(limited);
+    for (unsigned p = 0; p < 9; ++p) {
+        std::vector<sat::Lit> clause;
+        for (unsigned h = 0; h < 8; ++h)
+            clause.push_back(makeLit(p * 8 + h));
+        php.addClause(clause);
+    }
+    for (unsigned h = 0; h < 8; ++h) {
+        for (unsigned p = 0; p < 9; ++p) {
+            for (unsigned q = p + 1; q < 9; ++q)
+                php.addClause({makeLit(p * 8 + h, true), makeLit(q * 8 + h, true)});
+        }
+    }
+    EXPECT_EQ(php.solve(), sat::Result::UNKNOWN);
+}
+
+TEST(TestSAT, assumptions) {
+    sat::Solver solver;
+    // a | b, a -> c, b -> c
+    solver.addClause({makeLit(0), makeLit(1)});
+    solver.addClause({makeLit(0, true), makeLit(2)});
+    solver.addClause({makeLit(1, true), makeLit(2)});
+    solver.newVar();
+    EXPECT_EQ(solver.solve({makeLit(3), makeLit(2, true)}), sat::Result::UNSATISFIABLE);
+    EXPECT_EQ(solver.failedAssumptions(), std::vector<sat::Lit>{makeLit(2, true)});
+    EXPECT_TRUE(solver.okay());
+    EXPECT_EQ(solver.solve({makeLit(0, true), makeLit(3)}), sat::Result::SATISFIABLE);
+    EXPECT_FALSE(solver.modelValue(0));
+    EXPECT_TRUE(solver.modelValue(1));
+    EXPECT_TRUE(solver.modelValue(3));
+    EXPECT_EQ(solver.solve({makeLit(3), makeLit(3, true)}), sat::Result::UNSATISFIABLE);
+    EXPECT_EQ(solver.failedAssumptions().size(), 2u);
+
+    // pigeon-hole clauses switched on by a selector, the learnt clauses survive the calls
+    const unsigned pigeons = 7, holes = 6;
+    sat::Solver php;
+    auto selector = makeLit(0);
+    auto var = [&](unsigned p, unsigned h) { return 1 + p * holes + h; };
+    for (unsigned p = 0; p < pigeons; ++p) {
+        std::vector<sat::Lit> clause{sat::negate(selector)};
+        for (unsigned h = 0; h < holes; ++h)
+            clause.push_back(makeLit(var(p, h)));
+        php.addClause(clause);
+    }
+    for (unsigned h = 0; h < holes; ++h) {
+        for (unsigned p = 0; p < pigeons; ++p) {
+            for (unsigned q = p + 1; q < pigeons; ++q)
+                php.addClause({makeLit(var(p, h), true), makeLit(var(q, h), true)});
+        }
+    }
+    EXPECT_EQ(php.solve({selector}), sat::Result::UNSATISFIABLE);
+    EXPECT_EQ(php.failedAssumptions(), std::vector<sat::Lit>{selector});
+    auto learnts = php.numLearnts();
+    EXPECT_GT(learnts, 0u);
+    auto conflicts = php.numConflicts();
+    EXPECT_EQ(php.solve({selector}), sat::Result::UNSATISFIABLE);
+    EXPECT_LT(php.numConflicts() - conflicts, conflicts);
+    EXPECT_EQ(php.solve(), sat::Result::SATISFIABLE);
+    EXPECT_FALSE(php.modelValue(0));
+    EXPECT_TRUE(php.okay());
+}
+
+TEST(TestSAT, session) {
+    Expr p("p");
+    Expr q("q");
+    Expr r("r");
+    Expr s("s");
+    Solver solver;
+    solver.add(p | q);
+    solver.add(!p | r);
+    EXPECT_EQ(solver.solve(), sat::Result::SATISFIABLE);
+    EXPECT_EQ(solver.numSymbols(), 3u);
+
+    EXPECT_EQ(solver.solve({s, !q, !r}), sat::Result::UNSATISFIABLE);
+    EXPECT_TRUE(sameExprs(solver.failedAssumptions(), {!q, !r}));
+    EXPECT_EQ(solver.solve({!r}), sat::Result::SATISFIABLE);
+    EXPECT_FALSE(solver.modelValue(p));
+    EXPECT_TRUE(solver.modelValue(q));
+    auto model = solver.getModel();
+    EXPECT_EQ(model.size(), 4u);
+    EXPECT_TRUE(((p | q) & (!p | r) & !r).subs(model).trivialValue());
+
+    // assumptions are arbitrary expressions, sharing the gates of the constraints
+    auto before = solver.engine().numVars();
+    EXPECT_EQ(solver.solve({!p | r, s & !q}), sat::Result::SATISFIABLE);
+    EXPECT_EQ(solver.engine().numVars(), before + 1);
+    EXPECT_EQ(solver.solve({Expr(false), p}), sat::Result::UNSATISFIABLE);
+    EXPECT_TRUE(sameExprs(solver.failedAssumptions(), {Expr(false)}));
+
+    solver.add(!r);
+    EXPECT_EQ(solver.solve({p}), sat::Result::UNSATISFIABLE);
+    EXPECT_TRUE(sameExprs(solver.failedAssumptions(), {p}));
+    solver.add(!q);
+    EXPECT_EQ(solver.solve({s}), sat::Result::UNSATISFIABLE);
+    EXPECT_TRUE(solver.failedAssumptions().empty());
+
+    Expr a = makeBitVec("a", 4);
+    Expr b = makeBitVec("b", 4);
+    Solver bits;
+    bits.add(a < b);
+    EXPECT_EQ(bits.solve({b < a}), sat::Result::UNSATISFIABLE);
+    EXPECT_EQ(bits.solve({b >= a}), sat::Result::SATISFIABLE);
+    EXPECT_EQ(bits.numSymbols(), 8u);
+}
+
+TEST(TestSAT, expressions) {
+    Expr p("p");
+    Expr q("q");
+    Expr r("r");
+    EXPECT_TRUE(isSatisfiable(p & !q));
+    EXPECT_FALSE(isSatisfiable((p | q) & !p & !q));
+    EXPECT_TRUE(isTautology(p | !p));
+    EXPECT_TRUE(isTautology((p & q) | !p | !q));
+    EXPECT_FALSE(isTautology(p | q));
+    EXPECT_TRUE(areEquivalent(!(p & q), !p | !q));
+    EXPECT_TRUE(areEquivalent((p & q) | (p & r), p & (q | r)));
+    EXPECT_FALSE(areEquivalent(p & q, p | q));
+    EXPECT_FALSE(isSatisfiable(Expr(false)));
+    EXPECT_TRUE(isTautology(Expr(true)));
+
+    Expr e = (p | q) & (!p | r) & (!r | !q);
+    auto model = findModel(e);
+    ASSERT_TRUE(model.has_value());
+    EXPECT_EQ(model->size(), 3u);
+    EXPECT_TRUE(e.subs(*model).trivialValue());
+    EXPECT_FALSE(findModel(p & !p).has_value());
+
+    // relations between bit-vectors are lowered first
+    Expr a = makeBitVec("a", 4);
+    Expr b = makeBitVec("b", 4);
+    EXPECT_TRUE(areEquivalent(a < b, !(a >= b)));
+    EXPECT_FALSE(isSatisfiable((a < b) & (b < a)));
+    EXPECT_TRUE(isTautology((a <= b) | (b <= a)));
+}
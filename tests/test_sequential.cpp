@@ -0,0 +1,93 @@
+/**
+ * @file test_sequential.cpp
+ * Test sequential networks and the cycle simulator.
+ */
+
+#include "jazz/boolean-algebra.h"
+#include "jazz/sequential.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace jazz;
+
+static Expr exclusiveOr(const Expr &a, const Expr &b) {
+    return (a & !b) | (!a & b);
+}
+
+TEST(TestSequential, registers) {
+    Expr q = makeRegister("q", true);
+    EXPECT_TRUE(q.isType(TYPE_FLAG_SYMBOL));
+    EXPECT_TRUE(q.isType(TYPE_FLAG_REGISTER));
+    EXPECT_FALSE(q.isType(TYPE_FLAG_LATCH));
+    EXPECT_TRUE(makeLatch("l").isType(TYPE_FLAG_REGISTER));
+    EXPECT_TRUE((q & true).isEqual(q));
+    EXPECT_FALSE(q.isEqual(makeRegister("q", true)));
+
+    SequentialNetwork network;
+    EXPECT_THROW(network.addInput(q), std::invalid_argument);
+    EXPECT_THROW(network.addRegister(Expr("p"), q), std::invalid_argument);
+    network.addRegister(q, !q);
+    EXPECT_THROW(network.addRegister(q, q), std::invalid_argument);
+}
+
+TEST(TestSequential, counter) {
+    // a 4-bit counter that counts while en is true
+    SequentialNetwork network;
+    Expr en("en");
+    network.addInput(en);
+
+    std::vector<Expr> bits;
+    for (int i = 0; i < 4; ++i)
+        bits.push_back(makeRegister(("c" + std::to_string(i)).c_str()));
+
+    Expr carry = en;
+    for (int i = 0; i < 4; ++i) {
+        network.addRegister(bits[i], exclusiveOr(bits[i], carry));
+        carry = carry & bits[i];
+    }
+    network.addOutput(carry);
+
+    CycleSimulator sim(network);
+    // even runs count, odd runs hold
+    sim.setInput(0, 0x5555555555555555ull);
+    sim.run(19);
+    EXPECT_EQ(sim.cycles(), 19);
+
+    unsigned even = 0;
+    unsigned odd = 0;
+    for (int i = 0; i < 4; ++i) {
+        even |= unsigned(sim.state(i) & 1u) << i;
+        odd |= unsigned((sim.state(i) >> 1) & 1u) << i;
+    }
+    EXPECT_EQ(even, 19 % 16);
+    EXPECT_EQ(odd, 0);
+
+    // the carry out was seen in the cycle where the counter wrapped
+    sim.reset();
+    sim.run(15);
+    EXPECT_EQ(sim.output(0), 0);
+    sim.step();
+    EXPECT_EQ(sim.output(0), 0x5555555555555555ull);
+}
+
+TEST(TestSequential, latch) {
+    SequentialNetwork network;
+    Expr d("d");
+    Expr en("en");
+    Expr l = makeLatch("l", true);
+    network.addInput(d);
+    network.addInput(en);
+    network.addLatch(l, d, en);
+    network.addOutput(l);
+
+    CycleSimulator sim(network);
+    sim.setInput(0, 0);
+    sim.setInput(1, 0);
+    sim.step();
+    EXPECT_EQ(sim.output(0), ~std::uint64_t(0));
+    EXPECT_EQ(sim.state(0), ~std::uint64_t(0));
+
+    sim.setInput(1, 0xffull);
+    sim.step();
+    EXPECT_EQ(sim.state(0), ~std::uint64_t(0xff));
+}
@@ -0,0 +1,79 @@
+/**
+ * @file test_signature.cpp
+ * Test the random simulation signatures.
+ */
+
+#include "jazz/boolean-algebra.h"
+#include "jazz/signature.h"
+#include <gtest/gtest.h>
+
+using namespace jazz;
+
+TEST(TestSignature, equivalent) {
+    Expr p("p");
+    Expr q("q");
+    Expr r("r");
+    EXPECT_FALSE((p & (q | r)).isEqual((p & q) | (p & r)));
+    EXPECT_TRUE(probablyEquivalent(p & (q | r), (p & q) | (p & r)));
+    EXPECT_TRUE(probablyEquivalent(!(p & q), !p | !q));
+    EXPECT_TRUE(probablyEquivalent(p | (p & q), p));
+    EXPECT_TRUE(probablyEquivalent((p & !q) | (!p & q) | (p & q), p | q));
+}
+
+TEST(TestSignature, inequivalent) {
+    Expr p("p");
+    Expr q("q");
+    Expr r("r");
+    EXPECT_FALSE(probablyEquivalent(p, q));
+    EXPECT_FALSE(probablyEquivalent(p & q, p | q));
+    EXPECT_FALSE(probablyEquivalent(p & (q | r), (p & q) | r));
+    EXPECT_FALSE(probablyEquivalent(p, !p));
+}
+
+TEST(TestSignature, constants) {
+    Expr p("p");
+    EXPECT_TRUE(probablyEquivalent(p | !p, true));
+    EXPECT_TRUE(probablyEquivalent(Expr(false), p & false));
+    EXPECT_TRUE((p | !p).signature() == Signature::constant(true));
+}
+
+TEST(TestSignature, substitution) {
+    Expr p("p");
+    Expr q("q");
+    Expr e = p & q;
+    auto before = e.signature();
+    Expr f = e.subs(q == !p);
+    EXPECT_TRUE(e.signature() == before);
+    EXPECT_TRUE(probablyEquivalent(f, false));
+}
+
+TEST(TestSignature, reusedStorage) {
+    // the signatures are kept aside from the objects, a new object at the address of a
+    // destroyed one must not see the old entry
+    Expr p("p");
+    Expr q("q");
+    for (int i = 0; i < 100; ++i) {
+        Expr conjunction = p & q;
+        EXPECT_TRUE(conjunction.signature() == (p.signature() &= q.signature()));
+        Expr disjunction = p | q;
+        EXPECT_TRUE(disjunction.signature() == (p.signature() |= q.signature()));
+    }
+}
+
+TEST(TestSignature, deepExpression) {
+    // simulated bottom-up over the compiled program, not by recursion through the operands
+    Expr p("p");
+    Expr q("q");
+    Expr e = p;
+    auto expected = p.signature();
+    for (int i = 0; i < 2000; ++i) {
+        if (i % 2) {
+            e = e & q;
+            expected &= q.signature();
+        } else {
+            e = e | !q;
+            expected |= ~q.signature();
+        }
+    }
+    EXPECT_TRUE(e.signature() == expected);
+}
@@ -0,0 +1,111 @@
+/**
+ * @file test_simplify.cpp
+ * Test absorption, subsumption and self-subsuming resolution in And and Or.
+ */
+
+#include "jazz/boolean-algebra.h"
+#include "jazz/op_and.h"
+#include "jazz/op_or.h"
+#include "jazz/sat.h"
+#include "jazz/simplify.h"
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace jazz;
+
+TEST(TestSimplify, levels) {
+    Expr p("p");
+    Expr q("q");
+    EXPECT_EQ(simplifyLevel(), SimplifyLevel::BASIC);
+    // nothing more than before by default, and the same shapes
+    EXPECT_EQ((p | (p & q)).numOperands(), 2u);
+    EXPECT_TRUE(is_a<Or>(p | (p & q)));
+    EXPECT_TRUE(is_a<And>(p & (p | q)));
+    {
+        SimplifyLevelGuard guard(SimplifyLevel::SUBSUMPTION);
+        EXPECT_EQ(simplifyLevel(), SimplifyLevel::SUBSUMPTION);
+        // a gate left with one operand is that operand
+        EXPECT_TRUE((p | (p & q)).isEqual(p));
+        EXPECT_FALSE(is_a<Or>(p | (p & q)));
+        EXPECT_FALSE(is_a<And>(p & (p | q)));
+    }
+    EXPECT_EQ(simplifyLevel(), SimplifyLevel::BASIC);
+}
+
+TEST(TestSimplify, absorption) {
+    SimplifyLevelGuard guard(SimplifyLevel::SUBSUMPTION);
+    Expr p("p");
+    Expr q("q");
+    Expr r("r");
+    Expr s("s");
+    EXPECT_TRUE((p | (p & q)).isEqual(p));
+    EXPECT_TRUE((p & (p | q)).isEqual(p));
+    EXPECT_TRUE(((p & q) | (p & q & r)).isEqual(p & q));
+    EXPECT_TRUE(((p | q) & (p | q | r)).isEqual(p | q));
+    EXPECT_TRUE(makeOr({p & q & r, q & r, s, s & p}).isEqual((q & r) | s));
+    // nothing to drop
+    EXPECT_EQ(((p & q) | (q & r) | (r & s)).numOperands(), 3u);
+}
+
+TEST(TestSimplify, resolution) {
+    SimplifyLevelGuard guard(SimplifyLevel::SUBSUMPTION);
+    Expr p("p");
+    Expr q("q");
+    Expr r("r");
+    EXPECT_TRUE((p | (!p & q)).isEqual(p | q));
+    EXPECT_TRUE((p & (!p | q)).isEqual(p & q));
+    EXPECT_TRUE(((p & q) | (!p & q & r)).isEqual((p & q) | (q & r)));
+    // the resolvent subsumes both operands
+    EXPECT_TRUE(((p & q) | (!p & q)).isEqual(q));
+    EXPECT_TRUE(((p | q) & (!p | q)).isEqual(q));
+    // down to an empty clause
+    EXPECT_TRUE(((p | q) & (p | !q) & !p).isEqual(false));
+    EXPECT_TRUE(((p & q) | (p & !q) | !p).isEqual(true));
+}
+
+TEST(TestSimplify, random) {
+    std::mt19937 rng(61);
+    std::vector<Expr> x;
+    for (int i = 0; i < 8; ++i)
+        x.emplace_back(("x" + std::to_string(i)).c_str());
+    for (int round = 0; round < 40; ++round) {
+        bool conjunction = round % 2;
+        std::vector<Expr> operands;
+        for (int i = 0; i < 12; ++i) {
+            std::vector<Expr> literals;
+            for (auto n = 1 + rng() % 4; n > 0; --n) {
+                const auto &v = x[rng() % x.size()];
+                literals.push_back(rng() % 2 ? v : !v);
+            }
+            operands.push_back(conjunction ? makeOr(literals) : makeAnd(literals));
+        }
+        auto basic = conjunction ? makeAnd(operands) : makeOr(operands);
+        Expr reduced;
+        {
+            SimplifyLevelGuard guard(SimplifyLevel::SUBSUMPTION);
+            reduced = conjunction ? makeAnd(operands) : makeOr(operands);
+        }
+        EXPECT_TRUE(areEquivalent(basic, reduced));
+        EXPECT_LE(reduced.numOperands(), basic.numOperands());
+    }
+}
+
+TEST(TestSimplify, wide) {
+    // a wide disjunction absorbed by its first operand, and a wide chain of resolutions
+    std::vector<Expr> x;
+    for (int i = 0; i < 20000; ++i)
+        x.emplace_back(("x" + std::to_string(i)).c_str());
+    std::vector<Expr> products{x[0]};
+    for (std::size_t i = 1; i < x.size(); ++i)
+        products.push_back(x[0] & x[i]);
+    SimplifyLevelGuard guard(SimplifyLevel::SUBSUMPTION);
+    EXPECT_TRUE(makeOr(products).isEqual(x[0]));
+
+    std::vector<Expr> clauses{x[0]};
+    for (std::size_t i = 1; i < x.size(); ++i)
+        clauses.push_back(!x[0] | x[i]);
+    auto e = makeAnd(clauses);
+    EXPECT_TRUE(e.isEqual(makeAnd(x)));
+    EXPECT_EQ(e.numOperands(), x.size());
+}
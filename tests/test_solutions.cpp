@@ -0,0 +1,94 @@
+/**
+ * @file test_solutions.cpp
+ * Test the lazy enumeration of solutions.
+ */
+
+#include "jazz/boolean-algebra.h"
+#include "jazz/model_count.h"
+#include "jazz/sat.h"
+#include "jazz/solutions.h"
+#include "test_util.h"
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace jazz;
+
+/**
+ * Check that the cubes imply the expression and add up to its number of models, which makes
+ * them a disjoint cover.
+ */
+static void checkCover(const Expr &e, const std::vector<Expr> &symbols, SolutionEngine engine) {
+    SolutionOptions options;
+    options.engine = engine;
+    SolutionRange range(e, options);
+    Natural total;
+    for (const auto &cube: range) {
+        EXPECT_TRUE(isTautology(e.subs(cube)));
+        total += Natural::pow2(static_cast<unsigned>(symbols.size() - cube.size()));
+    }
+    EXPECT_EQ(total, countModels(e, symbols));
+    EXPECT_TRUE(range.begin() == range.end());
+}
+
+TEST(TestSolutions, cover) {
+    std::mt19937 rng(5);
+    std::vector<Expr> symbols;
+    for (int i = 0; i < 6; ++i)
+        symbols.emplace_back(("s" + std::to_string(i)).c_str());
+    for (int round = 0; round < 30; ++round) {
+        auto e = randomExpr(rng, symbols, 5);
+        checkCover(e, symbols, SolutionEngine::BDD);
+        checkCover(e, symbols, SolutionEngine::SAT);
+    }
+}
+
+TEST(TestSolutions, constants) {
+    for (auto engine: {SolutionEngine::BDD, SolutionEngine::SAT}) {
+        SolutionOptions options;
+        options.engine = engine;
+        SolutionRange none(Expr(false), options);
+        EXPECT_TRUE(none.begin() == none.end());
+        SolutionRange all(Expr(true), options);
+        auto it = all.begin();
+        ASSERT_TRUE(it != all.end());
+        EXPECT_TRUE(it->empty());
+        EXPECT_TRUE(++it == all.end());
+        EXPECT_EQ(all.numCubes(), 1u);
+    }
+}
+
+TEST(TestSolutions, compactCubes) {
+    // 2^40 - 1 models, in at most one cube per symbol
+    std::vector<Expr> symbols;
+    for (int i = 0; i < 40; ++i)
+        symbols.emplace_back(("x" + std::to_string(i)).c_str());
+    auto e = makeOr(symbols);
+    for (auto engine: {SolutionEngine::BDD, SolutionEngine::SAT}) {
+        SolutionOptions options;
+        options.engine = engine;
+        SolutionRange range(e, options);
+        Natural total;
+        for (const auto &cube: range)
+            total += Natural::pow2(static_cast<unsigned>(symbols.size() - cube.size()));
+        EXPECT_EQ(total + 1, Natural::pow2(40));
+        EXPECT_LE(range.numCubes(), 40u);
+    }
+
+    // stopping early, and resuming
+    SolutionOptions options;
+    options.engine = SolutionEngine::SAT;
+    SolutionRange range(makeAnd({makeOr(symbols), !symbols[0]}), options);
+    std::size_t n = 0;
+    for (const auto &cube: range) {
+        EXPECT_TRUE(cube.at(symbols[0]).isTrivial());
+        EXPECT_FALSE(cube.at(symbols[0]).trivialValue());
+        if (++n == 3)
+            break;
+    }
+    EXPECT_EQ(range.numCubes(), 3u);
+    auto it = range.begin();
+    ASSERT_TRUE(it != range.end());
+    ++it;
+    EXPECT_EQ(range.numCubes(), 4u);
+}
@@ -0,0 +1,99 @@
+/**
+ * @file test_synthesis.cpp
+ * Test the exact synthesis of NAND networks.
+ */
+
+#include "jazz/boolean-algebra.h"
+#include "jazz/sat.h"
+#include "jazz/synthesis.h"
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+using namespace jazz;
+
+/**
+ * Check the network gate by gate against the function, on every assignment of its inputs.
+ */
+static void checkNetwork(const NandNetwork &network, const Expr &f) {
+    EXPECT_TRUE(areEquivalent(network.expr, f));
+    auto n = network.inputs.size();
+    for (std::uint32_t row = 0; row < (1u << n); ++row) {
+        std::vector<bool> signals;
+        ExprMap assignment;
+        for (std::size_t i = 0; i < n; ++i) {
+            signals.push_back((row >> i) & 1u);
+            assignment.emplace(network.inputs[i], Expr(bool(signals.back())));
+        }
+        for (const auto &gate: network.gates) {
+            ASSERT_LT(gate.first, signals.size());
+            ASSERT_LT(gate.second, signals.size());
+            signals.push_back(!(signals[gate.first] && signals[gate.second]));
+        }
+        EXPECT_EQ(signals[network.output], f.subs(assignment).trivialValue());
+    }
+}
+
+TEST(TestSynthesis, gates) {
+    Expr a("a");
+    Expr b("b");
+    Expr c("c");
+    struct Case {
+        Expr f;
+        std::size_t gates;
+        unsigned depth;
+    };
+    std::vector<Case> cases{
+            {!a, 1, 1},
+            {!(a & b), 1, 1},
+            {a & b, 2, 2},
+            {a | b, 3, 2},
+            {a & !b, 3, 3},
+            {(a & !b) | (!a & b), 4, 3},
+            {(a & b) | (!a & c), 4, 3},
+    };
+    for (const auto &test: cases) {
+        auto network = synthesizeNand(test.f, 8);
+        ASSERT_TRUE(network.has_value());
+        EXPECT_EQ(network->numGates(), test.gates);
+        EXPECT_EQ(network->depth, test.depth);
+        checkNetwork(*network, test.f);
+    }
+}
+
+TEST(TestSynthesis, limits) {
+    Expr a("a");
+    Expr b("b");
+    Expr c("c");
+    auto x = (a & !b) | (!a & b);
+    EXPECT_FALSE(synthesizeNand(x, 3).has_value());
+    // xnor takes one more gate than xor
+    auto xnor = synthesizeNand(!x, 8);
+    ASSERT_TRUE(xnor.has_value());
+    EXPECT_EQ(xnor->numGates(), 5u);
+
+    // a projection, a constant, a symbol that does not matter
+    auto projection = synthesizeNand(a, 0);
+    ASSERT_TRUE(projection.has_value());
+    EXPECT_EQ(projection->numGates(), 0u);
+    EXPECT_TRUE(projection->expr.isEqual(a));
+    auto constant = synthesizeNand(a | !a, 0);
+    ASSERT_TRUE(constant.has_value());
+    EXPECT_EQ(constant->output, NandNetwork::CONSTANT);
+    EXPECT_TRUE(constant->expr.isEqual(Expr(true)));
+    auto partial = synthesizeNand((a & c) | (a & !c), 2);
+    ASSERT_TRUE(partial.has_value());
+    EXPECT_EQ(partial->inputs.size(), 1u);
+
+    // the majority of three
+    auto majority = (a & b) | (a & c) | (b & c);
+    auto network = synthesizeNand(majority, 8);
+    ASSERT_TRUE(network.has_value());
+    checkNetwork(*network, majority);
+    EXPECT_FALSE(synthesizeNand(majority, network->numGates() - 1).has_value());
+
+    std::vector<Expr> symbols;
+    for (int i = 0; i < 7; ++i)
+        symbols.emplace_back(("s" + std::to_string(i)).c_str());
+    EXPECT_THROW(synthesizeNand(makeAnd(symbols), 8), std::invalid_argument);
+}
@@ -0,0 +1,194 @@
+/**
+ * @file test_techmap.cpp
+ * Test technology mapping to gate libraries and lookup tables.
+ */
+
+#include "jazz/aig.h"
+#include "jazz/techmap.h"
+#include "test_util.h"
+#include <gtest/gtest.h>
+
+#include <random>
+#include <stdexcept>
+
+using namespace jazz;
+
+using Lit = Aig::Lit;
+
+static Aig randomAig(std::mt19937 &rng, unsigned inputs, unsigned ands, unsigned outputs) {
+    Aig aig;
+    std::vector<Lit> lits;
+    for (unsigned i = 0; i < inputs; ++i)
+        lits.push_back(aig.addInput());
+    for (unsigned i = 0; i < ands; ++i) {
+        // mostly recent nodes, for some depth
+        auto pick = [&] {
+            auto n = static_cast<unsigned>(lits.size());
+            auto j = rng() % 4 ? n - 1 - rng() % std::min(n, 16u) : rng() % n;
+            return lits[j] ^ (rng() & 1u);
+        };
+        lits.push_back(aig.andOf(pick(), pick()));
+    }
+    for (unsigned i = 0; i < outputs; ++i)
+        aig.addOutput(lits[lits.size() - 1 - rng() % std::min<std::size_t>(lits.size(), 4 * outputs)] ^ (rng() & 1u));
+    return aig;
+}
+
+TEST(TestTechMap, standardCells) {
+    auto library = GateLibrary::standard();
+    Aig aig;
+    auto a = aig.addInput(), b = aig.addInput(), c = aig.addInput();
+    aig.addOutput(aig.xorOf(a, b));
+    aig.addOutput(aig.muxOf(a, b, c));
+    aig.addOutput(Aig::negate(a));
+    aig.addOutput(a);
+    aig.addOutput(Aig::TRUE_LIT);
+    aig.addOutput(Aig::negate(aig.andOf(b, c)));
+    auto netlist = techMap(aig, library);
+    EXPECT_TRUE(sameFunctions(aig, netlist));
+    // XOR2, MUX2, INV and NAND2
+    ASSERT_EQ(netlist.cells.size(), 4u);
+    EXPECT_EQ(library[netlist.cells[0].gate].name, "INV");
+    EXPECT_EQ(netlist.outputs[2], netlist.cellSignal(0));
+    EXPECT_EQ(library[netlist.cells[1].gate].name, "XOR2");
+    EXPECT_EQ(library[netlist.cells[2].gate].name, "MUX2");
+    EXPECT_EQ(library[netlist.cells[3].gate].name, "NAND2");
+    EXPECT_EQ(netlist.outputs[3], netlist.inputSignal(0));
+    EXPECT_EQ(netlist.outputs[4], Netlist::TRUE_SIGNAL);
+    EXPECT_DOUBLE_EQ(netlist.area, 1 + 5 + 6 + 2);
+    EXPECT_DOUBLE_EQ(netlist.delay, 2);
+}
+
+TEST(TestTechMap, luts) {
+    // a balanced AND of 16 inputs in five LUT4 on two levels
+    Aig aig;
+    std::vector<Lit> level;
+    for (int i = 0; i < 16; ++i)
+        level.push_back(aig.addInput());
+    while (level.size() > 1) {
+        std::vector<Lit> next;
+        for (std::size_t i = 0; i < level.size(); i += 2)
+            next.push_back(aig.andOf(level[i], level[i + 1]));
+        level = next;
+    }
+    aig.addOutput(level[0]);
+    aig.addOutput(Aig::negate(level[0]));
+    auto netlist = techMap(aig, GateLibrary::luts(4));
+    EXPECT_TRUE(sameFunctions(aig, netlist));
+    EXPECT_DOUBLE_EQ(netlist.delay, 2);
+    // the complemented output is a second LUT over the same leaves
+    EXPECT_EQ(netlist.cells.size(), 6u);
+    for (const auto &cell: netlist.cells)
+        EXPECT_EQ(cell.fanins.size(), 4u);
+
+    // the same with LUT6, the second level only needs three inputs
+    netlist = techMap(aig, GateLibrary::luts(6));
+    EXPECT_TRUE(sameFunctions(aig, netlist));
+    EXPECT_DOUBLE_EQ(netlist.delay, 2);
+}
+
+TEST(TestTechMap, random) {
+    std::mt19937 rng(53);
+    const GateLibrary libraries[] = {GateLibrary::standard(), GateLibrary::luts(4), GateLibrary::luts(6)};
+    for (const auto &library: libraries) {
+        double delay_mode_delay = 0, delay_mode_area = 0, area_mode_delay = 0, area_mode_area = 0;
+        for (int round = 0; round < 10; ++round) {
+            auto aig = randomAig(rng, 10, 300, 8);
+            MapOptions options;
+            options.area_passes = 0;
+            auto fast = techMap(aig, library, options);
+            EXPECT_TRUE(sameFunctions(aig, fast));
+
+            options.area_passes = 2;
+            auto recovered = techMap(aig, library, options);
+            EXPECT_TRUE(sameFunctions(aig, recovered));
+            // the recovery keeps the delay
+            EXPECT_LE(recovered.delay, fast.delay + 1e-9);
+            EXPECT_LE(recovered.area, fast.area + 1e-9);
+            delay_mode_delay += recovered.delay;
+            delay_mode_area += recovered.area;
+
+            options.objective = MapObjective::AREA;
+            auto small = techMap(aig, library, options);
+            EXPECT_TRUE(sameFunctions(aig, small));
+            area_mode_delay += small.delay;
+            area_mode_area += small.area;
+        }
+        EXPECT_LE(delay_mode_delay, area_mode_delay);
+        EXPECT_LE(area_mode_area, delay_mode_area);
+    }
+}
+
+TEST(TestTechMap, large) {
+    std::mt19937 rng(59);
+    auto aig = randomAig(rng, 64, 20000, 32);
+    auto netlist = techMap(aig, GateLibrary::luts(6));
+    EXPECT_TRUE(sameFunctions(aig, netlist));
+    EXPECT_LT(netlist.cells.size(), aig.numAnds());
+}
+
+TEST(TestTechMap, nandOnly) {
+    // NAND2 with its inputs tied is the inverter
+    GateLibrary nands;
+    auto nand = nands.addGate("NAND2", 2, ~(tt::var(0) & tt::var(1)), 2, 1);
+    EXPECT_EQ(nands.inverter(), nand);
+
+    Aig aig;
+    auto a = aig.addInput(), b = aig.addInput(), c = aig.addInput();
+    aig.addOutput(aig.andOf(a, b));
+    aig.addOutput(aig.orOf(a, Aig::negate(c)));
+    aig.addOutput(aig.xorOf(a, b));
+    aig.addOutput(Aig::negate(c));
+    auto netlist = techMap(aig, nands);
+    EXPECT_TRUE(sameFunctions(aig, netlist));
+    for (const auto &cell: netlist.cells)
+        EXPECT_EQ(cell.fanins.size(), 2u);
+    // the complement of an input is a NAND of it with itself
+    const auto &inverter = netlist.cells[netlist.outputs[3] - netlist.cellSignal(0)];
+    EXPECT_EQ(inverter.fanins[0], netlist.inputSignal(2));
+    EXPECT_EQ(inverter.fanins[1], netlist.inputSignal(2));
+
+    // NOR2 as well, and the cheapest of the two is the inverter
+    GateLibrary both = nands;
+    auto nor = both.addGate("NOR2", 2, ~(tt::var(0) | tt::var(1)), 1.5, 1);
+    EXPECT_EQ(both.inverter(), nor);
+    EXPECT_TRUE(sameFunctions(aig, techMap(aig, both)));
+    // but neither XNOR2 nor MUX2
+    GateLibrary others;
+    others.addGate("XNOR2", 2, ~(tt::var(0) ^ tt::var(1)));
+    others.addGate("MUX2", 3, (tt::var(0) & tt::var(1)) | (~tt::var(0) & tt::var(2)));
+    EXPECT_EQ(others.inverter(), GateLibrary::NONE);
+
+    std::mt19937 rng(67);
+    for (int round = 0; round < 5; ++round) {
+        auto random = randomAig(rng, 8, 100, 6);
+        EXPECT_TRUE(sameFunctions(random, techMap(random, nands)));
+        EXPECT_TRUE(sameFunctions(random, techMap(random, both)));
+    }
+}
+
+TEST(TestTechMap, errors) {
+    EXPECT_THROW(GateLibrary::luts(1), std::invalid_argument);
+    EXPECT_THROW(GateLibrary::luts(7), std::invalid_argument);
+    auto luts = GateLibrary::luts(4);
+    EXPECT_THROW(luts.addGate("AND2", 2, tt::var(0) & tt::var(1)), std::invalid_argument);
+
+    GateLibrary ands;
+    EXPECT_THROW(ands.addGate("AND7", 7, 0), std::invalid_argument);
+    ands.addGate("AND2", 2, tt::var(0) & tt::var(1));
+    EXPECT_EQ(ands.inverter(), GateLibrary::NONE);
+    Aig aig;
+    auto a = aig.addInput(), b = aig.addInput();
+    aig.addOutput(aig.andOf(a, b));
+    EXPECT_TRUE(sameFunctions(aig, techMap(aig, ands)));
+    // no inverter to complement the AND
+    aig.addOutput(Aig::negate(aig.andOf(a, b)));
+    EXPECT_THROW(techMap(aig, ands), std::invalid_argument);
+
+    MapOptions options;
+    options.max_cuts = 1;
+    EXPECT_THROW(techMap(aig, luts, options), std::invalid_argument);
+    options.max_cuts = 8;
+    options.cut_size = 7;
+    EXPECT_THROW(techMap(aig, luts, options), std::invalid_argument);
+}
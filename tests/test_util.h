@@ -0,0 +1,82 @@
+/**
+ * @file test_util.h
+ * Helpers shared by the tests.
+ */
+
+#ifndef BOOLEAN_ALGEBRA_TEST_UTIL_H
+#define BOOLEAN_ALGEBRA_TEST_UTIL_H
+
+#include "jazz/aig.h"
+#include "jazz/boolean-algebra.h"
+#include "jazz/techmap.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * The symbols prefix0 to prefix(n-1).
+ */
+inline std::vector<jazz::Expr> makeSymbols(const char *prefix, unsigned n) {
+    std::vector<jazz::Expr> symbols;
+    for (unsigned i = 0; i < n; ++i)
+        symbols.emplace_back((prefix + std::to_string(i)).c_str());
+    return symbols;
+}
+
+/**
+ * A random tree of And and Or over literals of the symbols, at most depth levels deep.
+ */
+inline jazz::Expr randomExpr(std::mt19937 &rng, const std::vector<jazz::Expr> &symbols, int depth) {
+    if (depth == 0 || rng() % 4 == 0) {
+        const auto &s = symbols[rng() % symbols.size()];
+        return rng() & 1u ? s : !s;
+    }
+    auto a = randomExpr(rng, symbols, depth - 1);
+    auto b = randomExpr(rng, symbols, depth - 1);
+    return rng() & 1u ? a & b : a | b;
+}
+
+/**
+ * Whether two AIGs agree on every output over 1024 random input patterns.
+ */
+inline bool sameFunctions(const jazz::Aig &a, const jazz::Aig &b) {
+    using jazz::Aig;
+    if (a.numInputs() != b.numInputs() || a.numOutputs() != b.numOutputs())
+        return false;
+    std::mt19937_64 rng(7);
+    for (int round = 0; round < 16; ++round) {
+        std::vector<std::uint64_t> words(a.numInputs());
+        for (auto &w: words)
+            w = rng();
+        auto va = a.simulate(words), vb = b.simulate(words);
+        for (std::size_t k = 0; k < a.numOutputs(); ++k) {
+            if (Aig::valueOf(va, a.output(k)) != Aig::valueOf(vb, b.output(k)))
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Whether a mapped netlist agrees with its AIG on every output over 1024 random input patterns.
+ */
+inline bool sameFunctions(const jazz::Aig &aig, const jazz::Netlist &netlist) {
+    using jazz::Aig;
+    if (aig.numInputs() != netlist.num_inputs || aig.numOutputs() != netlist.outputs.size())
+        return false;
+    std::mt19937_64 rng(11);
+    for (int round = 0; round < 16; ++round) {
+        std::vector<std::uint64_t> words(aig.numInputs());
+        for (auto &w: words)
+            w = rng();
+        auto expected = aig.simulate(words), actual = netlist.simulate(words);
+        for (std::size_t k = 0; k < aig.numOutputs(); ++k) {
+            if (Aig::valueOf(expected, aig.output(k)) != actual[netlist.outputs[k]])
+                return false;
+        }
+    }
+    return true;
+}
+
+#endif//BOOLEAN_ALGEBRA_TEST_UTIL_H
@@ -0,0 +1,94 @@
+/**
+ * @file test_zdd.cpp
+ * Test zero-suppressed decision diagrams.
+ */
+
+#include "jazz/boolean-algebra.h"
+#include "jazz/zdd.h"
+#include <gtest/gtest.h>
+
+using namespace jazz;
+
+TEST(TestZDD, setOperations) {
+    zdd::Manager manager;
+    auto a = manager.newVar();
+    auto b = manager.newVar();
+    auto c = manager.newVar();
+
+    auto ab = manager.cube({b, a});
+    auto bc = manager.cube({b, c});
+    auto p = ab | bc | manager.single(c);
+    auto q = bc | manager.single(a) | manager.base();
+
+    EXPECT_EQ(p.count(), 3u);
+    EXPECT_EQ((p | q).count(), 5u);
+    EXPECT_EQ(p & q, bc);
+    EXPECT_EQ((p - q), ab | manager.single(c));
+    EXPECT_TRUE((p - p).isEmpty());
+    EXPECT_EQ(p | manager.empty(), p);
+    EXPECT_TRUE((q & manager.base()).isBase());
+
+    std::vector<std::vector<unsigned>> sets{{a, b}, {b, c}, {c}};
+    auto res = p.sets();
+    std::sort(res.begin(), res.end());
+    EXPECT_EQ(res, sets);
+
+    EXPECT_EQ(p.onset(b), manager.single(a) | manager.single(c));
+    EXPECT_EQ(p.offset(b), manager.single(c));
+    EXPECT_EQ(manager.single(c).change(c), manager.base());
+    EXPECT_EQ(manager.base().change(a), manager.single(a));
+}
+
+TEST(TestZDD, division) {
+    zdd::Manager manager;
+    std::vector<zdd::Zdd> v;
+    for (int i = 0; i < 5; ++i)
+        v.push_back(manager.single(manager.newVar()));
+    auto &a = v[0], &b = v[1], &c = v[2], &d = v[3], &e = v[4];
+
+    auto f = (a | b) * (c | d);
+    EXPECT_EQ(f, (a * c) | (a * d) | (b * c) | (b * d));
+    EXPECT_EQ(f.count(), 4u);
+    EXPECT_EQ(a * a, a);
+
+    auto g = f | e;
+    EXPECT_EQ(g / (c | d), a | b);
+    EXPECT_EQ(g / (a | b), c | d);
+    EXPECT_EQ(g % (c | d), e);
+    EXPECT_TRUE((g / (a * e)).isEmpty());
+    EXPECT_EQ(g / manager.base(), g);
+    EXPECT_THROW(g / manager.empty(), std::domain_error);
+}
+
+TEST(TestZDD, cubeSets) {
+    Expr p("p"), q("q"), r("r");
+    zdd::Manager manager;
+
+    // literals follow the symbol order, the positive one first
+    auto nq = manager.varOf(!q);
+    auto vp = manager.varOf(p);
+    auto vq = manager.varOf(q);
+    EXPECT_LT(manager.level(vp), manager.level(vq));
+    EXPECT_LT(manager.level(vq), manager.level(nq));
+    EXPECT_EQ(manager.varOf(!!q), vq);
+    EXPECT_THROW(manager.varOf(p | q), std::invalid_argument);
+
+    Expr sop = (p & !q) | (q & r) | !r;
+    auto cubes = zdd::toZDD(manager, sop);
+    EXPECT_EQ(cubes.count(), 3u);
+    EXPECT_EQ(cubes.onset(nq), manager.single(vp));
+
+    Expr back = zdd::toExpr(cubes);
+    EXPECT_EQ(zdd::toZDD(manager, back), cubes);
+    EXPECT_TRUE(zdd::toZDD(manager, Expr(true)).isBase());
+    EXPECT_TRUE(zdd::toZDD(manager, Expr(false)).isEmpty());
+    EXPECT_TRUE(zdd::toExpr(manager.empty()).isEqual(false));
+    EXPECT_TRUE(zdd::toExpr(manager.base()).isEqual(true));
+    EXPECT_THROW(zdd::toZDD(manager, p & (q | r)), std::invalid_argument);
+
+    zdd::Zdd none;
+    EXPECT_THROW(none.onset(0), std::invalid_argument);
+    EXPECT_THROW(none.offset(0), std::invalid_argument);
+    EXPECT_THROW(none.change(0), std::invalid_argument);
+    EXPECT_THROW(cubes.onset(manager.numVars()), std::out_of_range);
+}